@@ -9,6 +9,7 @@
 #include <future>
 #include <functional>
 #include <memory>
+#include <mutex>
 #include <optional>
 #include <string>
 #include <string_view>
@@ -17,6 +18,7 @@
 
 class Settings;
 class ILLMClient;
+struct CategorizationRequest;
 namespace spdlog { class logger; }
 
 /**
@@ -38,6 +40,8 @@ public:
     using PromptOverrideProvider = std::function<std::optional<PromptOverride>(const FileEntry&)>;
     /** Supplies an optional suggested rename for an entry during categorization. */
     using SuggestedNameProvider = std::function<std::string(const FileEntry&)>;
+    /** Returns the next batch of entries to categorize, or std::nullopt once the stream has ended. May block. */
+    using EntryBatchSource = std::function<std::optional<std::vector<FileEntry>>()>;
 
     /**
      * @brief Constructs the service with settings, database access, and logging.
@@ -70,6 +74,10 @@ public:
 
     /**
      * @brief Categorizes a list of file entries using the configured LLM workflow.
+     *
+     * Entries are drained from a shared queue by a pool of workers, each with its own
+     * LLM client created via @p llm_factory. Workers claim as many entries at a time as
+     * their client's preferred batch size. Results keep the input order.
      * @param files Entries to categorize.
      * @param is_local_llm True when using a local LLM backend.
      * @param stop_flag Cancellation flag.
@@ -77,7 +85,7 @@ public:
      * @param queue_callback Called when an entry is queued.
      * @param completion_callback Called when an entry has finished processing.
      * @param recategorization_callback Called when an entry must be re-categorized.
-     * @param llm_factory Factory for creating an LLM client.
+     * @param llm_factory Factory for creating an LLM client (called once per worker).
      * @param prompt_override Optional prompt override provider.
      * @param suggested_name_provider Optional suggested-name provider.
      * @return Categorized entries that were successfully processed.
@@ -94,11 +102,45 @@ public:
         const PromptOverrideProvider& prompt_override = {},
         const SuggestedNameProvider& suggested_name_provider = {}) const;
 
+    /**
+     * @brief Categorizes entries as they arrive from @p next_batch.
+     *
+     * Workers pull from the source whenever their queue runs short, so categorization can start
+     * while the producer (e.g. a directory scan) is still running. The source is only called by one
+     * worker at a time. Results keep the arrival order. Parameters match categorize_entries().
+     * @param next_batch Source of entry batches.
+     * @return Categorized entries that were successfully processed.
+     */
+    std::vector<CategorizedFile> categorize_entry_stream(
+        const EntryBatchSource& next_batch,
+        bool is_local_llm,
+        std::atomic<bool>& stop_flag,
+        const ProgressCallback& progress_callback,
+        const QueueCallback& queue_callback,
+        const CompletionCallback& completion_callback,
+        const RecategorizationCallback& recategorization_callback,
+        std::function<std::unique_ptr<ILLMClient>()> llm_factory,
+        const PromptOverrideProvider& prompt_override = {},
+        const SuggestedNameProvider& suggested_name_provider = {}) const;
+
 private:
     using CategoryPair = std::pair<std::string, std::string>;
     using HintHistory = std::deque<CategoryPair>;
     using SessionHistoryMap = std::unordered_map<std::string, HintHistory>;
 
+    /**
+     * @brief Per-entry paths and prompt context shared by the single and batched flows.
+     */
+    struct EntryContext {
+        std::string dir_path;
+        std::string display_path;
+        std::string prompt_name;
+        std::string prompt_path_display;
+        std::string combined_context;
+        bool use_consistency_hints{false};
+        std::string content_fingerprint;  ///< Computed on a name-key cache miss; stored with the result.
+    };
+
     /**
      * @brief Returns a cached categorization when available, otherwise calls the LLM.
      * @param llm LLM client used for the request.
@@ -111,6 +153,8 @@ private:
      * @param file_type File or directory.
      * @param progress_callback Progress updates callback.
      * @param consistency_context Consistency hints block.
+     * @param full_path On-disk path, fingerprinted when the name key misses.
+     * @param content_fingerprint Receives the fingerprint when one was computed.
      * @return Resolved category for the item.
      */
     DatabaseManager::ResolvedCategory categorize_with_cache(
@@ -123,7 +167,9 @@ private:
         const std::string& prompt_path,
         FileType file_type,
         const ProgressCallback& progress_callback,
-        const std::string& consistency_context) const;
+        const std::string& consistency_context,
+        const std::string& full_path,
+        std::string* content_fingerprint) const;
 
     /**
      * @brief Categorizes a single entry and persists the result.
@@ -132,7 +178,6 @@ private:
      * @param entry File entry to categorize.
      * @param prompt_override Optional prompt override.
      * @param suggested_name Optional suggested name for renaming.
-     * @param stop_flag Cancellation flag.
      * @param progress_callback Progress updates callback.
      * @param recategorization_callback Callback for re-categorization events.
      * @param session_history Mutable session history for consistency hints.
@@ -144,10 +189,67 @@ private:
         const FileEntry& entry,
         const std::optional<PromptOverride>& prompt_override,
         const std::string& suggested_name,
+        const ProgressCallback& progress_callback,
+        const RecategorizationCallback& recategorization_callback,
+        SessionHistoryMap& session_history) const;
+
+    /**
+     * @brief Categorizes several entries with one batched LLM call and persists the results.
+     *
+     * Cache hits are served without the LLM. Entries the batch reply leaves empty, or all of them
+     * when the batched call fails, are categorized one by one through categorize_single_entry(). A
+     * BackoffError is rethrown, since the client only raises it once it has stopped retrying.
+     * @param llm LLM client used for the request.
+     * @param is_local_llm True when using a local LLM backend.
+     * @param entries Entries to categorize.
+     * @param prompt_overrides Prompt overrides, parallel to @p entries.
+     * @param suggested_names Suggested names, parallel to @p entries.
+     * @param stop_flag Cancellation flag.
+     * @param progress_callback Progress updates callback.
+     * @param recategorization_callback Callback for re-categorization events.
+     * @param session_history Mutable session history for consistency hints.
+     * @return Per-entry results in input order.
+     */
+    std::vector<std::optional<CategorizedFile>> categorize_entry_batch(
+        ILLMClient& llm,
+        bool is_local_llm,
+        const std::vector<const FileEntry*>& entries,
+        const std::vector<std::optional<PromptOverride>>& prompt_overrides,
+        const std::vector<std::string>& suggested_names,
         std::atomic<bool>& stop_flag,
         const ProgressCallback& progress_callback,
         const RecategorizationCallback& recategorization_callback,
         SessionHistoryMap& session_history) const;
+    /**
+     * @brief Resolves display/prompt paths and the consistency-hint context for an entry.
+     * @param entry File entry to categorize.
+     * @param prompt_override Optional prompt override.
+     * @param session_history Session history for consistency hints.
+     * @return Prepared entry context.
+     */
+    EntryContext build_entry_context(const FileEntry& entry,
+                                     const std::optional<PromptOverride>& prompt_override,
+                                     const SessionHistoryMap& session_history) const;
+    /**
+     * @brief Handles empty results or persists a resolved category and builds the result entry.
+     * @param entry File entry being categorized.
+     * @param context Prepared entry context.
+     * @param resolved Resolved category data.
+     * @param is_local_llm True when using a local LLM backend.
+     * @param suggested_name Suggested rename value.
+     * @param recategorization_callback Callback for re-categorization events.
+     * @param session_history Session history for consistency hints.
+     * @param deferred_writes When set, the database row is queued here instead of written immediately.
+     * @return Categorized entry when successful.
+     */
+    std::optional<CategorizedFile> finalize_entry(const FileEntry& entry,
+                                                  const EntryContext& context,
+                                                  const DatabaseManager::ResolvedCategory& resolved,
+                                                  bool is_local_llm,
+                                                  const std::string& suggested_name,
+                                                  const RecategorizationCallback& recategorization_callback,
+                                                  SessionHistoryMap& session_history,
+                                                  std::vector<DatabaseManager::CategorizationRecord>* deferred_writes = nullptr) const;
 
     /**
      * @brief Combines language, whitelist, and hint blocks into a single prompt context.
@@ -172,6 +274,7 @@ private:
      * @param prompt_path Path used in the prompt.
      * @param progress_callback Progress updates callback.
      * @param combined_context Combined prompt context.
+     * @param content_fingerprint Receives the entry's fingerprint when one was computed.
      * @return Resolved category for the item.
      */
     DatabaseManager::ResolvedCategory run_categorization_with_cache(
@@ -183,7 +286,8 @@ private:
         const std::string& prompt_name,
         const std::string& prompt_path,
         const ProgressCallback& progress_callback,
-        const std::string& combined_context) const;
+        const std::string& combined_context,
+        std::string* content_fingerprint) const;
     /**
      * @brief Handles empty or invalid categorization results.
      * @param entry File entry being categorized.
@@ -208,14 +312,33 @@ private:
      * @param resolved Resolved category data.
      * @param used_consistency_hints True if hints were applied.
      * @param suggested_name Suggested rename value.
+     * @param content_fingerprint Content fingerprint to store; empty keeps the stored one.
      * @param session_history Session history for consistency hints.
+     * @param deferred_writes When set, the database row is queued here instead of written immediately.
      */
     void update_storage_with_result(const FileEntry& entry,
                                     const std::string& dir_path,
                                     const DatabaseManager::ResolvedCategory& resolved,
                                     bool used_consistency_hints,
                                     const std::string& suggested_name,
-                                    SessionHistoryMap& session_history) const;
+                                    const std::string& content_fingerprint,
+                                    SessionHistoryMap& session_history,
+                                    std::vector<DatabaseManager::CategorizationRecord>* deferred_writes = nullptr) const;
+
+    /**
+     * @brief Finds cached rows with the same content whose file no longer exists.
+     *
+     * Those rows belong to a file that was moved or renamed to @p entry; they are removed in the
+     * same transaction that stores the entry's row.
+     * @param entry File entry being stored.
+     * @param dir_path Directory path of the entry.
+     * @param content_fingerprint Fingerprint of the entry; empty skips the lookup.
+     * @return (directory, file name) keys of the moved rows.
+     */
+    std::vector<std::pair<std::string, std::string>> collect_moved_rows(
+        const FileEntry& entry,
+        const std::string& dir_path,
+        const std::string& content_fingerprint) const;
 
     /**
      * @brief Runs the LLM request with a timeout for the given item.
@@ -240,6 +363,13 @@ private:
      * @return Timeout in seconds.
      */
     int resolve_llm_timeout(bool is_local_llm) const;
+    /**
+     * @brief Resolves how many categorization workers to run for a batch.
+     * @param is_local_llm True when using a local LLM backend.
+     * @param item_count Number of entries queued for categorization.
+     * @return Worker count in the range [1, item_count].
+     */
+    std::size_t resolve_worker_count(bool is_local_llm, std::size_t item_count) const;
     /**
      * @brief Launches an asynchronous LLM categorization request.
      * @param llm LLM client used for the request.
@@ -254,7 +384,6 @@ private:
                                               const std::string& item_path,
                                               FileType file_type,
                                               const std::string& consistency_context) const;
-
     /**
      * @brief Builds a whitelist context block for the prompt.
      * @return Whitelist prompt section.
@@ -288,6 +417,8 @@ private:
      * @param dir_path Full directory path for cache lookup.
      * @param file_type File or directory.
      * @param progress_callback Progress updates callback.
+     * @param full_path On-disk path, fingerprinted when the name key misses.
+     * @param content_fingerprint Receives the fingerprint when one was computed; may be null.
      * @return Resolved category when cache is valid.
      */
     std::optional<DatabaseManager::ResolvedCategory> try_cached_categorization(
@@ -296,7 +427,21 @@ private:
         const std::string& categorization_path,
         const std::string& dir_path,
         FileType file_type,
-        const ProgressCallback& progress_callback) const;
+        const ProgressCallback& progress_callback,
+        const std::string& full_path,
+        std::string* content_fingerprint) const;
+    /**
+     * @brief Looks up a cached file with the same content as @p full_path.
+     *
+     * Read-only: rows of moved files are re-keyed when the new result is stored.
+     * @param full_path On-disk path of the entry.
+     * @param file_type Only files are fingerprinted.
+     * @param content_fingerprint Cached fingerprint for the entry; computed and stored here when empty.
+     * @return The matching cached row.
+     */
+    std::optional<CategorizedFile> find_cached_by_fingerprint(const std::string& full_path,
+                                                              FileType file_type,
+                                                              std::string* content_fingerprint) const;
 
     /**
      * @brief Ensures remote credentials are present and reports errors via progress callback.
@@ -332,6 +477,24 @@ private:
         const ProgressCallback& progress_callback,
         const std::string& consistency_context) const;
 
+    /**
+     * @brief Parses, validates, and resolves a raw LLM response for an item.
+     * @param llm LLM client used for label translation.
+     * @param response Raw LLM response.
+     * @param display_name Display name for logging.
+     * @param display_path Display path for logging.
+     * @param prompt_path Path used in the prompt.
+     * @param progress_callback Progress updates callback.
+     * @return Resolved category, or taxonomy id -1 when the labels are invalid.
+     */
+    DatabaseManager::ResolvedCategory resolve_llm_response(
+        ILLMClient& llm,
+        const std::string& response,
+        const std::string& display_name,
+        const std::string& display_path,
+        const std::string& prompt_path,
+        const ProgressCallback& progress_callback) const;
+
     /**
      * @brief Emits a formatted progress message for a categorization event.
      * @param progress_callback Progress updates callback.
@@ -388,6 +551,8 @@ private:
     Settings& settings;
     DatabaseManager& db_manager;
     std::shared_ptr<spdlog::logger> core_logger;
+    // Serializes database and session-history access between categorization workers.
+    mutable std::mutex storage_mutex;
 };
 
 #endif
@@ -0,0 +1,43 @@
+#ifndef CONTENT_FINGERPRINT_HPP
+#define CONTENT_FINGERPRINT_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+
+/**
+ * @brief Cheap content identity for files, used to recognize moved, renamed and duplicate files.
+ *
+ * The fingerprint is an XXH64 hash of the first and last 64 KiB of the file, seeded with the
+ * file size, so a file costs at most two reads regardless of its length. It is not a
+ * cryptographic digest; two files only collide when they share their size, head and tail.
+ */
+class ContentFingerprint {
+public:
+    static constexpr std::size_t kSampleBytes = 64 * 1024;
+    /** Smaller files are too likely to be placeholders with identical contents. */
+    static constexpr std::uintmax_t kMinFileBytes = 1024;
+
+    /**
+     * @brief Fingerprints the file at @p path.
+     * @param path UTF-8 path of a regular file.
+     * @return Text of the form `<size hex>-<hash hex>`, or std::nullopt when the file is
+     *         unreadable or smaller than kMinFileBytes.
+     */
+    static std::optional<std::string> compute(const std::string& path);
+
+    /**
+     * @brief Whether cache lookups may fall back to fingerprints.
+     *
+     * On unless AI_FILE_SORTER_CONTENT_FINGERPRINT is set to 0/false/off.
+     */
+    static bool enabled();
+
+    /**
+     * @brief XXH64 of @p size bytes at @p data.
+     */
+    static std::uint64_t xxh64(const void* data, std::size_t size, std::uint64_t seed);
+};
+
+#endif
@@ -0,0 +1,76 @@
+#ifndef CURL_SESSION_HPP
+#define CURL_SESSION_HPP
+
+#include <curl/curl.h>
+
+#include <mutex>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Keeps a cURL easy handle alive across requests so connections are reused.
+ *
+ * Open connections stay with the session's own handle. Every session also attaches to a
+ * process-wide share handle that caches DNS lookups and TLS sessions, so a client created
+ * per worker resumes TLS instead of running a full handshake once any of them has talked
+ * to the endpoint. HTTP/2 is negotiated over TLS when the server supports it.
+ */
+class CurlSession {
+public:
+    /**
+     * @brief Raw HTTP result of a request.
+     */
+    struct Response {
+        long http_code{0};
+        std::string body;
+        // Seconds from a Retry-After response header (0 when absent).
+        int retry_after_seconds{0};
+    };
+
+    /**
+     * @brief Creates a session; @p log_label names the backend in error logs.
+     * @param log_label Backend label such as "remote" or "Gemini".
+     */
+    explicit CurlSession(std::string log_label);
+    ~CurlSession();
+
+    CurlSession(const CurlSession&) = delete;
+    CurlSession& operator=(const CurlSession&) = delete;
+
+    /**
+     * @brief Sends a JSON POST request over a pooled connection.
+     * @param url Target URL.
+     * @param payload JSON request body.
+     * @param headers Extra request headers ("Name: value").
+     * @param timeout_seconds Total request timeout.
+     * @return HTTP status code and response body.
+     * @throws std::runtime_error on initialization or transport failures.
+     */
+    Response post_json(const std::string& url,
+                       const std::string& payload,
+                       const std::vector<std::string>& headers,
+                       long timeout_seconds);
+
+    /**
+     * @brief Applies the shared DNS/TLS-session cache, HTTP/2 and keep-alive options.
+     * @param handle Easy handle to configure.
+     * @throws std::runtime_error when the CA bundle cannot be staged (Windows).
+     */
+    static void apply_connection_defaults(CURL* handle);
+    /**
+     * @brief Routes the response body and headers of @p handle into @p response.
+     * @param handle Easy handle to configure.
+     * @param response Response that receives the body and Retry-After value.
+     */
+    static void bind_response(CURL* handle, Response& response);
+
+private:
+    CURL* acquire_handle();
+
+    std::string log_label_;
+    CURL* handle_{nullptr};
+    // Serializes requests when a timed-out call is still running on the same client.
+    std::mutex mutex_;
+};
+
+#endif // CURL_SESSION_HPP
@@ -2,7 +2,11 @@
 #define DATABASEMANAGER_HPP
 
 #include "CategoryLanguage.hpp"
+#include "TaxonomyMatchIndex.hpp"
 #include "Types.hpp"
+#include <cstdint>
+#include <memory>
+#include <mutex>
 #include <string>
 #include <map>
 #include <vector>
@@ -38,6 +42,23 @@ public:
                                      const std::string& category,
                                      const std::string& subcategory);
 
+    /**
+     * @brief One row for insert_or_update_files_with_categorization().
+     */
+    struct CategorizationRecord {
+        std::string file_name;
+        std::string file_type;
+        std::string dir_path;
+        ResolvedCategory resolved;
+        bool used_consistency_hints{false};
+        std::string suggested_name;
+        bool rename_only{false};
+        bool rename_applied{false};
+        std::string content_fingerprint;  ///< Empty keeps the stored fingerprint.
+        /// (directory, file name) rows this file was moved from; removed together with the write.
+        std::vector<std::pair<std::string, std::string>> moved_from;
+    };
+
     bool insert_or_update_file_with_categorization(const std::string& file_name,
                                                    const std::string& file_type,
                                                    const std::string& dir_path,
@@ -45,7 +66,18 @@ public:
                                                    bool used_consistency_hints,
                                                    const std::string& suggested_name = "",
                                                    bool rename_only = false,
-                                                   bool rename_applied = false);
+                                                   bool rename_applied = false,
+                                                   const std::string& content_fingerprint = "");
+    /**
+     * @brief Stores many categorization results in a single transaction.
+     *
+     * Taxonomy frequencies are refreshed once per distinct taxonomy id after all rows are written
+     * instead of once per row. Rows listed in a record's @c moved_from are removed in the same
+     * transaction. Either every record is stored or none is.
+     * @param records Rows to insert or update.
+     * @return True when the transaction committed.
+     */
+    bool insert_or_update_files_with_categorization(const std::vector<CategorizationRecord>& records);
     std::vector<std::string> get_dir_contents_from_db(const std::string &dir_path);
     bool remove_file_categorization(const std::string& dir_path,
                                     const std::string& file_name,
@@ -69,6 +101,17 @@ public:
         get_categorization_from_db(const std::string& dir_path,
                                    const std::string& file_name,
                                    FileType file_type);
+    /**
+     * @brief Finds categorized files with the given content fingerprint, newest first.
+     *
+     * Used when the name key misses, so a moved, renamed or duplicated file reuses the cached
+     * category instead of going back to the LLM. Rows with empty labels are skipped.
+     * @param content_fingerprint Fingerprint from ContentFingerprint::compute().
+     * @param max_entries Maximum number of rows returned.
+     * @return Matching rows, possibly under other directories or names.
+     */
+    std::vector<CategorizedFile> find_categorizations_by_fingerprint(const std::string& content_fingerprint,
+                                                                     std::size_t max_entries = 8);
     void increment_taxonomy_frequency(int taxonomy_id);
     std::vector<std::pair<std::string, std::string>>
         get_taxonomy_snapshot(std::size_t max_entries,
@@ -77,6 +120,12 @@ public:
         get_recent_categories_for_extension(const std::string& extension,
                                             FileType file_type,
                                             std::size_t limit) const;
+    /**
+     * @brief Forgets the cached categorizations and document analyses of a folder.
+     * @param dir_path Folder whose entries are cleared.
+     * @param recursive Whether entries in subfolders are cleared as well.
+     * @return True when both caches were cleared.
+     */
     bool clear_directory_categorizations(const std::string& dir_path,
                                          bool recursive = false);
     bool has_categorization_style_conflict(const std::string& dir_path,
@@ -84,6 +133,81 @@ public:
                                            bool recursive = false) const;
     std::optional<bool> get_directory_categorization_style(const std::string& dir_path) const;
 
+    /**
+     * @brief One child of a directory recorded in a scan snapshot.
+     */
+    struct ScanSnapshotEntry {
+        std::string file_name;
+        std::optional<FileType> file_type; ///< Set when the scan reports the entry.
+        bool descend{false};               ///< Whether a recursive scan lists it as a subdirectory.
+        std::uint64_t inode{0};            ///< 0 when unknown.
+    };
+
+    /**
+     * @brief A directory's stamp and children as of the last scan.
+     */
+    struct ScanSnapshotDirectory {
+        std::string dir_path;
+        std::int64_t mtime_ns{0};
+        std::uint64_t inode{0};
+        std::vector<ScanSnapshotEntry> children;
+    };
+
+    /**
+     * @brief Every directory listed by the last scan of a root with a given option mask.
+     */
+    struct ScanSnapshot {
+        std::int64_t scanned_at_ns{0};
+        std::unordered_map<std::string, ScanSnapshotDirectory> directories;
+    };
+
+    /**
+     * @brief Loads the persisted scan snapshot for @p root_path.
+     *
+     * Directories whose stored child count does not match their rows are left out, so they are
+     * listed again.
+     * @param root_path Scan root exactly as passed to the scanner.
+     * @param scan_options FileScanOptions mask the snapshot was taken with.
+     * @return The snapshot, or std::nullopt when the root was never scanned with these options.
+     */
+    std::optional<ScanSnapshot> load_scan_snapshot(const std::string& root_path, int scan_options);
+    /**
+     * @brief Applies the directories re-listed by a scan to the persisted snapshot in one transaction.
+     * @param root_path Scan root exactly as passed to the scanner.
+     * @param scan_options FileScanOptions mask of the scan.
+     * @param scanned_at_ns When the scan started, on the same clock as the directory mtimes.
+     * @param changed_directories Directories to insert or replace.
+     * @param removed_directories Directories that no longer belong to the tree.
+     * @return True when the transaction committed.
+     */
+    bool update_scan_snapshot(const std::string& root_path,
+                              int scan_options,
+                              std::int64_t scanned_at_ns,
+                              const std::vector<ScanSnapshotDirectory>& changed_directories,
+                              const std::vector<std::string>& removed_directories);
+
+    /**
+     * @brief Stored result of document analysis for one file.
+     */
+    struct DocumentAnalysisRecord {
+        std::string file_path;
+        std::int64_t file_size{0};
+        std::int64_t mtime_ns{0};
+        std::string content_fingerprint;  ///< Empty when the file was not fingerprinted.
+        std::string excerpt_hash;
+        std::string summary;
+        std::string suggested_name;
+    };
+
+    /**
+     * @brief Loads the stored document analysis for @p file_path (full UTF-8 path).
+     */
+    std::optional<DocumentAnalysisRecord> get_document_analysis(const std::string& file_path);
+    /**
+     * @brief Inserts or replaces the stored document analysis for record.file_path.
+     */
+    bool upsert_document_analysis(const DocumentAnalysisRecord& record);
+
 private:
     struct TaxonomyEntry {
         int id;
@@ -93,8 +217,35 @@ private:
         std::string normalized_subcategory;
     };
 
+    class StatementCache;
+    class CachedStatement;
+
+    void configure_connection();
+    /**
+     * @brief Returns a ready-to-bind statement for @p sql from the per-connection statement cache.
+     *
+     * The statement is reset and its bindings cleared when the returned handle goes out of scope.
+     * If the cached statement is already checked out (nested or concurrent use), a one-off
+     * statement is prepared instead.
+     * @param sql SQL text; also the cache key.
+     * @return Statement handle; empty when preparation fails.
+     */
+    CachedStatement prepare_cached(const char* sql) const;
+    bool execute_statement(const char* sql, const char* description);
+    bool upsert_file_categorization(const CategorizationRecord& record);
+    bool clear_directory_document_analyses(const std::string& dir_path, bool recursive);
     void initialize_schema();
+    /**
+     * @brief Fills the extension column for rows written before it existed (or by older builds).
+     */
+    void backfill_file_extensions();
     void initialize_taxonomy_schema();
+    void initialize_scan_snapshot_schema();
+    void initialize_document_analysis_schema();
+    void open_snapshot_connection();
+    CachedStatement prepare_snapshot_statement(const char* sql) const;
+    bool execute_snapshot_statement(const char* sql, const char* description);
+    std::optional<std::int64_t> find_scan_snapshot_id(const std::string& root_path, int scan_options) const;
     void load_taxonomy_cache();
     void load_translation_cache();
     std::string normalize_label(const std::string& input) const;
@@ -133,24 +284,29 @@ private:
     bool file_exists_in_db(const std::string &file_name, const std::string &file_path);
 
     sqlite3* db;
+    // Prepared statements keyed by SQL; released before the connection is closed.
+    std::unique_ptr<StatementCache> statement_cache;
+    // Scan snapshots are bulk reads and writes; their own connection keeps those transactions
+    // apart from categorization batches running on `db` at the same time.
+    sqlite3* snapshot_db{nullptr};
+    std::mutex snapshot_mutex;
     const std::string config_dir;
     const std::string db_file;
     std::vector<TaxonomyEntry> taxonomy_entries;
     std::unordered_map<std::string, int> canonical_lookup;
     std::unordered_map<std::string, int> alias_lookup;
     std::unordered_map<int, size_t> taxonomy_index;
+    // Approximate-match index over taxonomy_entries positions, kept in step with the cache.
+    TaxonomyMatchIndex taxonomy_match_index;
     std::unordered_map<std::string, ResolvedCategory> translation_entries;
     std::unordered_map<std::string, int> translation_lookup;
 
     static bool is_duplicate_category(
         const std::vector<std::pair<std::string, std::string>>& results,
         const std::pair<std::string, std::string>& candidate);
-    std::optional<std::pair<std::string, std::string>> build_recent_category_candidate(
-        const char* file_name_text,
+    static std::optional<std::pair<std::string, std::string>> build_recent_category_candidate(
         const char* category_text,
-        const char* subcategory_text,
-        const std::string& normalized_extension,
-        bool has_extension) const;
+        const char* subcategory_text);
 };
 
 #endif
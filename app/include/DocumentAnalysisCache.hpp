@@ -0,0 +1,55 @@
+#ifndef DOCUMENT_ANALYSIS_CACHE_HPP
+#define DOCUMENT_ANALYSIS_CACHE_HPP
+
+#include "DocumentTextAnalyzer.hpp"
+
+#include <optional>
+#include <string>
+
+class DatabaseManager;
+
+/**
+ * @brief Reuses document summaries and rename suggestions across runs.
+ *
+ * Results are stored per full path together with the file size and mtime. A document is
+ * unchanged when both still match. When only the mtime moved, a stored content fingerprint
+ * (see ContentFingerprint) can still confirm it. Documents that changed on disk can still skip
+ * inference when their extracted excerpt hashes the same as before.
+ */
+class DocumentAnalysisCache {
+public:
+    explicit DocumentAnalysisCache(DatabaseManager& db);
+
+    /**
+     * @brief Stored result for an unchanged document, without extracting it.
+     * @param full_path UTF-8 path of the document.
+     */
+    std::optional<DocumentAnalysisResult> lookup(const std::string& full_path);
+
+    /**
+     * @brief Stored result for a changed document whose excerpt is still the same.
+     *
+     * On a match the stored size and mtime are refreshed so the next lookup() hits.
+     * @param full_path UTF-8 path of the document.
+     * @param excerpt Excerpt just extracted from the document.
+     */
+    std::optional<DocumentAnalysisResult> lookup_excerpt(const std::string& full_path,
+                                                         const std::string& excerpt);
+
+    /**
+     * @brief Records the analysis of @p excerpt for the document at @p full_path.
+     */
+    void store(const std::string& full_path,
+               const std::string& excerpt,
+               const DocumentAnalysisResult& result);
+
+    /**
+     * @brief Hex XXH64 of an excerpt, as stored in the cache.
+     */
+    static std::string hash_excerpt(const std::string& excerpt);
+
+private:
+    DatabaseManager& db_;
+};
+
+#endif
@@ -0,0 +1,86 @@
+#ifndef DOCUMENT_EXCERPT_PIPELINE_HPP
+#define DOCUMENT_EXCERPT_PIPELINE_HPP
+
+#include <condition_variable>
+#include <cstddef>
+#include <filesystem>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief Extracts document excerpts on a small thread pool ahead of the LLM consumer.
+ *
+ * Workers run the extractor for the queued paths in order while the consumer calls next(),
+ * which hands results back in the same order. Workers never get more than @c lookahead
+ * documents ahead of the consumer, so at most that many excerpts are held in memory.
+ */
+class DocumentExcerptPipeline {
+public:
+    using Extractor = std::function<std::string(const std::filesystem::path&)>;
+
+    struct Excerpt {
+        std::filesystem::path path;
+        /** Extracted text; empty when the document had none. */
+        std::string text;
+        /** Message of the exception thrown by the extractor, if any. */
+        std::optional<std::string> error;
+    };
+
+    /**
+     * @param paths Documents to extract, in the order next() returns them.
+     * @param extractor Called concurrently from the worker threads.
+     * @param threads Number of worker threads (at least one).
+     * @param lookahead Maximum number of documents extracted but not yet taken (at least one).
+     */
+    DocumentExcerptPipeline(std::vector<std::filesystem::path> paths,
+                            Extractor extractor,
+                            std::size_t threads,
+                            std::size_t lookahead);
+    /**
+     * @brief Cancels pending work and joins the workers.
+     */
+    ~DocumentExcerptPipeline();
+
+    DocumentExcerptPipeline(const DocumentExcerptPipeline&) = delete;
+    DocumentExcerptPipeline& operator=(const DocumentExcerptPipeline&) = delete;
+
+    /**
+     * @brief Waits for the next document's excerpt.
+     * @return std::nullopt once every document was returned or the pipeline was cancelled.
+     */
+    std::optional<Excerpt> next();
+
+    /**
+     * @brief Stops handing out new documents; extractions already running still finish.
+     */
+    void cancel();
+
+    /**
+     * @brief Worker count for document extraction.
+     *
+     * Defaults to the hardware concurrency capped at 4; AI_FILE_SORTER_DOCUMENT_THREADS
+     * overrides it.
+     */
+    static std::size_t resolve_thread_count();
+
+private:
+    void run_worker();
+
+    std::vector<std::filesystem::path> paths_;
+    Extractor extractor_;
+    std::size_t lookahead_;
+    std::mutex mutex_;
+    std::condition_variable work_cv_;
+    std::condition_variable ready_cv_;
+    std::vector<std::optional<Excerpt>> results_;
+    std::size_t next_to_extract_{0};
+    std::size_t next_to_return_{0};
+    bool cancelled_{false};
+    std::vector<std::thread> workers_;
+};
+
+#endif
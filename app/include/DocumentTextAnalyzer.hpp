@@ -62,6 +62,27 @@ public:
     DocumentAnalysisResult analyze(const std::filesystem::path& document_path,
                                    ILLMClient& llm) const;
 
+    /**
+     * @brief Extracts the excerpt that analyze() sends to the LLM.
+     *
+     * Safe to call from several threads at once, so excerpts can be prepared ahead of
+     * inference.
+     * @param document_path Path to the document to read.
+     * @return Excerpt limited to Settings::max_characters; empty when there is no text.
+     */
+    std::string extract_excerpt(const std::filesystem::path& document_path) const;
+
+    /**
+     * @brief Runs the LLM step of analyze() on an excerpt from extract_excerpt().
+     * @param excerpt Excerpt of the document; must not be empty.
+     * @param document_path Path of the document the excerpt came from.
+     * @param llm LLM client used to generate the summary and filename.
+     * @return Analysis result containing summary and suggested filename.
+     */
+    DocumentAnalysisResult analyze_excerpt(const std::string& excerpt,
+                                           const std::filesystem::path& document_path,
+                                           ILLMClient& llm) const;
+
     /**
      * @brief Returns true if the file extension is supported for document analysis.
      * @param path Document path to inspect.
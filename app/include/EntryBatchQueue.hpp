@@ -0,0 +1,58 @@
+#ifndef ENTRY_BATCH_QUEUE_HPP
+#define ENTRY_BATCH_QUEUE_HPP
+
+#include "Types.hpp"
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <mutex>
+#include <optional>
+#include <vector>
+
+/**
+ * @brief Bounded hand-off of FileEntry batches from a producer thread to consumers.
+ *
+ * The producer blocks once @c capacity batches are waiting, so a fast scan cannot run far
+ * ahead of a slow consumer and memory stays bounded.
+ */
+class EntryBatchQueue {
+public:
+    /**
+     * @brief Creates a queue holding at most @p capacity batches (at least one).
+     */
+    explicit EntryBatchQueue(std::size_t capacity);
+
+    /**
+     * @brief Adds a batch, waiting while the queue is full.
+     * @return False when the queue was cancelled and the batch was dropped.
+     */
+    bool push(std::vector<FileEntry>&& batch);
+
+    /**
+     * @brief Takes the next batch, waiting until one is available.
+     * @return std::nullopt once the queue is closed and drained, or cancelled.
+     */
+    std::optional<std::vector<FileEntry>> pop();
+
+    /**
+     * @brief Marks the end of the stream; queued batches can still be popped.
+     */
+    void close();
+
+    /**
+     * @brief Drops queued batches and wakes both sides; later pushes fail.
+     */
+    void cancel();
+
+private:
+    std::mutex mutex_;
+    std::condition_variable not_full_;
+    std::condition_variable not_empty_;
+    std::deque<std::vector<FileEntry>> batches_;
+    std::size_t capacity_;
+    bool closed_{false};
+    bool cancelled_{false};
+};
+
+#endif
@@ -1,13 +1,19 @@
 #ifndef FILE_SCANNER_HPP
 #define FILE_SCANNER_HPP
 
+#include <cstddef>
+#include <cstdint>
 #include <filesystem>
+#include <functional>
+#include <memory>
 #include <string>
+#include <thread>
 #include <vector>
 #include <optional>
 #include "Types.hpp"
 
 namespace fs = std::filesystem;
+namespace spdlog { class logger; }
 
 class FileScanner {
 public:
@@ -16,14 +22,141 @@ public:
         get_directory_entries(const std::string &directory_path,
                               FileScanOptions options);
 
+    /** Receives a batch of scanned entries; returning false stops the scan. */
+    using EntryBatchSink = std::function<bool(std::vector<FileEntry>&&)>;
+
+    /**
+     * @brief Scans like get_directory_entries() but hands entries over in batches while scanning.
+     *
+     * Entries arrive in the same order as get_directory_entries() returns them. Recursive scans walk
+     * one directory at a time while a DirectoryPrefetcher lists the next few ahead, so memory is
+     * bounded by the batch size and a handful of listings rather than the whole tree.
+     * @param directory_path Directory to scan.
+     * @param options File scan options.
+     * @param batch_size Maximum number of entries per batch; the last batch may be smaller.
+     * @param sink Called with each batch.
+     */
+    void scan_directory_entries(const std::string& directory_path,
+                                FileScanOptions options,
+                                std::size_t batch_size,
+                                const EntryBatchSink& sink);
+
+    /**
+     * @brief One directory as the scanner sees it.
+     */
+    struct DirectoryContents {
+        std::vector<FileEntry> entries;            ///< Entries a scan reports, in listing order.
+        std::vector<std::uint64_t> entry_inodes;   ///< Parallel to entries; 0 when the backend has none.
+        std::vector<std::string> subdirectories;   ///< Directories a recursive scan descends into (UTF-8).
+        bool complete{true};                       ///< False when listing stopped on a filesystem error.
+    };
+
+    /**
+     * @brief Lists a single directory with the same filtering as get_directory_entries().
+     *
+     * Subdirectories are only reported when @p options includes Recursive. Inode numbers come for free
+     * with the getdents64 backend and are 0 otherwise.
+     * @param directory_path Directory to list.
+     * @param options File scan options.
+     * @param is_scan_root Whether an unreadable directory throws instead of being skipped.
+     */
+    DirectoryContents list_directory_contents(const std::string& directory_path,
+                                              FileScanOptions options,
+                                              bool is_scan_root);
+
+    /**
+     * @brief Lists directories of a recursive walk ahead of time on a small thread pool.
+     *
+     * A walker requests directories as it discovers them and takes their contents when it gets there,
+     * so the walk keeps its order while listings overlap. The pool has as many threads as
+     * get_directory_entries() uses (AI_FILE_SORTER_SCAN_THREADS). Only a few listings per thread are
+     * held at once, so a slow walker does not buffer the whole tree. With one thread every take()
+     * lists inline.
+     */
+    class DirectoryPrefetcher {
+    public:
+        /**
+         * @param scanner Scanner that lists the directories.
+         * @param options File scan options for every listing.
+         * @param scan_root Directory whose listing throws instead of being skipped when unreadable.
+         */
+        DirectoryPrefetcher(FileScanner& scanner, FileScanOptions options, std::string scan_root);
+        ~DirectoryPrefetcher();
+        DirectoryPrefetcher(const DirectoryPrefetcher&) = delete;
+        DirectoryPrefetcher& operator=(const DirectoryPrefetcher&) = delete;
+
+        /**
+         * @brief Queues @p directory for listing; the most recent request is listed first.
+         */
+        void request(const std::string& directory);
+
+        /**
+         * @brief Returns the listing of @p directory, waiting for it or listing it inline.
+         * @throws std::filesystem::filesystem_error When the scan root cannot be listed.
+         */
+        DirectoryContents take(const std::string& directory);
+
+    private:
+        struct State;
+        void run();
+
+        FileScanner& scanner;
+        FileScanOptions options;
+        std::string scan_root;
+        std::unique_ptr<State> state;
+        std::vector<std::thread> threads;
+    };
+
 private:
     struct ScanContext;
+    static ScanContext make_scan_context(FileScanOptions options,
+                                         std::shared_ptr<spdlog::logger> logger);
     void scan_non_recursive(const fs::path& scan_path,
                             const ScanContext& context,
                             std::vector<FileEntry>& results);
+    struct DirectoryListing;
     void scan_recursive(const fs::path& scan_path,
                         const ScanContext& context,
                         std::vector<FileEntry>& results);
+    /**
+     * @brief Recursive scan that lists directories on a work-stealing thread pool.
+     *
+     * Produces the same entries in the same order as scan_recursive().
+     * @param scan_path Root directory; an unreadable root throws like the sequential scan.
+     * @param context Scan flags and logger.
+     * @param results Output entries, appended in deterministic order.
+     * @param thread_count Number of threads including the caller (at least 2).
+     */
+    void scan_recursive_parallel(const fs::path& scan_path,
+                                 const ScanContext& context,
+                                 std::vector<FileEntry>& results,
+                                 std::size_t thread_count);
+    /**
+     * @brief Lists one directory, appending accepted entries and the subdirectories to descend into.
+     * @param entry_inodes Optional; receives one inode number (or 0) per appended entry.
+     * @return False when the listing stopped on a filesystem error.
+     */
+    bool list_directory(const fs::path& directory,
+                        bool is_scan_root,
+                        const ScanContext& context,
+                        std::vector<FileEntry>& entries,
+                        std::vector<fs::path>& subdirectories,
+                        std::vector<std::uint64_t>* entry_inodes = nullptr);
+#ifdef __linux__
+    /**
+     * @brief list_directory() backend that reads entries with getdents64 and classifies them by d_type.
+     *
+     * Only DT_UNKNOWN and symlink entries are stat'ed. Paths are built from the raw name bytes.
+     * @param subdirectories Receives directories to descend into; nullptr for non-recursive scans.
+     * @param entry_inodes Optional; receives d_ino for each appended entry.
+     */
+    bool list_directory_native(const fs::path& directory,
+                               bool is_scan_root,
+                               const ScanContext& context,
+                               std::vector<FileEntry>& entries,
+                               std::vector<fs::path>* subdirectories,
+                               std::vector<std::uint64_t>* entry_inodes = nullptr);
+#endif
     void log_scan_warning(const ScanContext& context,
                           const fs::path& path,
                           const std::error_code& error,
@@ -41,6 +174,7 @@ private:
     bool is_file_hidden(const fs::path &path) const;
     bool is_junk_file(const std::string& name) const;
     bool is_file_bundle(const fs::path& path, bool is_directory) const;
+    bool is_bundle_name(const std::string& file_name) const;
 };
 
 #endif
@@ -0,0 +1,119 @@
+#ifndef FOLDER_WATCHER_HPP
+#define FOLDER_WATCHER_HPP
+
+#include "FileScanner.hpp"
+#include "Types.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief Watches a folder and reports entries that appear in it.
+ *
+ * On Linux changes come from inotify; elsewhere, or when inotify is unavailable, the folder is
+ * rescanned periodically. Events are coalesced per path and held back until the folder has been
+ * quiet for the debounce interval, then resolved through the FileScanner filters and handed to
+ * the callback in small batches on the watcher thread.
+ */
+class FolderWatcher {
+public:
+    enum class Backend {
+        Inotify,
+        Polling
+    };
+
+    struct Options {
+        std::chrono::milliseconds debounce{2000};       ///< Quiet period before pending paths are flushed.
+        std::chrono::milliseconds max_delay{15000};     ///< Flush at the latest this long after the first event.
+        std::chrono::milliseconds poll_interval{10000}; ///< Rescan interval of the polling backend.
+        std::size_t batch_size{8};                      ///< Maximum entries per callback.
+        bool force_polling{false};                      ///< Skip inotify even where it is available.
+    };
+
+    /** Receives new or changed entries; called on the watcher thread. */
+    using BatchCallback = std::function<void(std::vector<FileEntry>&&)>;
+
+    /**
+     * @brief Prepares a watcher for @p root_path; nothing is watched until start().
+     * @param scanner Scanner whose filters decide which entries are reported.
+     * @param root_path Folder to watch.
+     * @param scan_options Same options as a scan of the folder; Recursive watches subfolders too.
+     * @param options Timing and batching options.
+     */
+    FolderWatcher(FileScanner& scanner,
+                  std::string root_path,
+                  FileScanOptions scan_options,
+                  Options options);
+    ~FolderWatcher();
+
+    FolderWatcher(const FolderWatcher&) = delete;
+    FolderWatcher& operator=(const FolderWatcher&) = delete;
+
+    /**
+     * @brief Starts watching on a background thread and returns without waiting for it.
+     *
+     * The initial walk that sets up the watches (or the polling baseline) runs on the watcher
+     * thread; only changes made after it finished are reported. See wait_until_watching().
+     * @param on_batch Called with each batch of entries.
+     * @throws std::filesystem::filesystem_error When the folder is not a directory.
+     */
+    void start(BatchCallback on_batch);
+    /**
+     * @brief Waits until the initial walk finished and changes are being watched.
+     * @param timeout Longest time to wait.
+     * @return False on timeout, or when the watcher stopped or failed to set up.
+     */
+    bool wait_until_watching(std::chrono::milliseconds timeout) const;
+    /**
+     * @brief Stops watching and waits for the watcher thread, including a running callback.
+     *
+     * Callers on a UI thread should run this elsewhere; a callback can take as long as its batch.
+     */
+    void stop();
+    /**
+     * @brief Reports @p entries again with the next flush, as if they had just changed.
+     *
+     * Used for batches the callback could not handle yet; entries that are gone by then are dropped.
+     * @param entries Entries previously handed to the callback.
+     */
+    void requeue(const std::vector<FileEntry>& entries);
+    bool is_running() const;
+    Backend backend() const;
+    const std::string& watched_path() const;
+    FileScanOptions watched_scan_options() const;
+
+    class EventSource;
+
+private:
+    std::unique_ptr<EventSource> open_source();
+    void run();
+    std::vector<FileEntry> resolve_entries(const std::vector<std::string>& paths);
+    void dispatch(std::vector<FileEntry>&& entries);
+
+    FileScanner& scanner;
+    const std::string root_path;
+    const FileScanOptions scan_options;
+    const Options options;
+    BatchCallback on_batch;
+    // Guards source and watching; the source is created on the watcher thread.
+    mutable std::mutex source_mutex;
+    mutable std::condition_variable watching_changed;
+    std::unique_ptr<EventSource> source;
+    bool watching{false};
+    std::atomic<Backend> active_backend{Backend::Polling};
+    std::atomic<bool> stop_requested{false};
+    std::atomic<bool> running{false};
+    std::mutex requeue_mutex;
+    std::vector<std::string> requeued_paths;
+    std::thread worker;
+};
+
+#endif
@@ -1,6 +1,20 @@
 #pragma once
 #include "Types.hpp"
+#include <cstddef>
+#include <future>
+#include <iterator>
+#include <memory>
+#include <optional>
 #include <string>
+#include <thread>
+#include <vector>
+
+struct CategorizationRequest {
+    std::string file_name;
+    std::string file_path;
+    FileType file_type;
+    std::string consistency_context;
+};
 
 class ILLMClient {
 public:
@@ -12,4 +26,70 @@ public:
     virtual std::string complete_prompt(const std::string& prompt,
                                         int max_tokens) = 0;
     virtual void set_prompt_logging_enabled(bool enabled) = 0;
+    // Limits categorization output to whitelisted labels when the client can enforce it while decoding.
+    virtual void set_category_whitelist(const std::vector<std::string>& categories,
+                                        const std::vector<std::string>& subcategories) {
+        (void)categories;
+        (void)subcategories;
+    }
+
+    // Starts categorize_file() without blocking the caller. The default runs it on a detached
+    // thread; remote clients override this to multiplex requests on a shared event loop.
+    virtual std::future<std::string> categorize_file_async(const std::string& file_name,
+                                                           const std::string& file_path,
+                                                           FileType file_type,
+                                                           const std::string& consistency_context) {
+        auto promise = std::make_shared<std::promise<std::string>>();
+        std::future<std::string> future = promise->get_future();
+        std::thread([this, promise, file_name, file_path, file_type, consistency_context]() {
+            try {
+                promise->set_value(categorize_file(file_name, file_path, file_type, consistency_context));
+            } catch (...) {
+                try {
+                    promise->set_exception(std::current_exception());
+                } catch (...) {
+                    // no-op
+                }
+            }
+        }).detach();
+        return future;
+    }
+
+    // Number of requests the client prefers to receive per categorize_files() call.
+    virtual std::size_t preferred_batch_size() const { return 1; }
+    // Categorizes several items at once; responses are returned in request order.
+    virtual std::vector<std::string> categorize_files(const std::vector<CategorizationRequest>& requests) {
+        std::vector<std::string> responses;
+        responses.reserve(requests.size());
+        for (const auto& request : requests) {
+            responses.push_back(categorize_file(request.file_name,
+                                                request.file_path,
+                                                request.file_type,
+                                                request.consistency_context));
+        }
+        return responses;
+    }
+
+    // Starts a batch without blocking the caller. Slots left empty are retried one item at a time
+    // by the caller. The default runs categorize_files() on a detached thread; remote clients
+    // override this to send the batch on the shared event loop.
+    virtual std::future<std::vector<std::optional<std::string>>> categorize_files_async(
+        const std::vector<CategorizationRequest>& requests) {
+        auto promise = std::make_shared<std::promise<std::vector<std::optional<std::string>>>>();
+        auto future = promise->get_future();
+        std::thread([this, promise, requests]() {
+            try {
+                auto responses = categorize_files(requests);
+                promise->set_value(std::vector<std::optional<std::string>>(
+                    std::make_move_iterator(responses.begin()), std::make_move_iterator(responses.end())));
+            } catch (...) {
+                try {
+                    promise->set_exception(std::current_exception());
+                } catch (...) {
+                    // no-op
+                }
+            }
+        }).detach();
+        return future;
+    }
 };
@@ -0,0 +1,100 @@
+#ifndef INCREMENTAL_SCANNER_HPP
+#define INCREMENTAL_SCANNER_HPP
+
+#include "DatabaseManager.hpp"
+#include "FileScanner.hpp"
+#include "Types.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Rescans directory trees against a snapshot persisted in the categorization cache.
+ *
+ * Every directory's mtime and inode are recorded together with its children. On the next scan
+ * of the same root, a directory whose stamp is unchanged is rebuilt from the snapshot and only
+ * changed directories are listed again, so an untouched tree costs one stat per directory.
+ * On request the scan also reports what was added, removed or renamed since the previous scan.
+ */
+class IncrementalScanner {
+public:
+    /**
+     * @brief Constructs a scanner that lists through @p scanner and persists through @p db_manager.
+     */
+    IncrementalScanner(FileScanner& scanner, DatabaseManager& db_manager);
+
+    /**
+     * @brief An entry that moved within the tree while keeping its inode.
+     */
+    struct RenamedEntry {
+        FileEntry from;
+        FileEntry to;
+    };
+
+    /**
+     * @brief Result of a scan compared with the previous snapshot.
+     */
+    struct ScanDelta {
+        std::vector<FileEntry> entries;       ///< Current entries in get_directory_entries() order.
+        std::vector<FileEntry> added;         ///< Filled only when changes are tracked.
+        std::vector<FileEntry> removed;       ///< Filled only when changes are tracked.
+        std::vector<RenamedEntry> renamed;    ///< Filled only when changes are tracked.
+        std::size_t directories_listed{0};    ///< Directories read from disk.
+        std::size_t directories_reused{0};    ///< Directories rebuilt from the snapshot.
+        bool had_snapshot{false};             ///< False on the first scan of a root; nothing is "added" then.
+    };
+
+    /**
+     * @brief Scans @p directory_path, reusing unchanged directories from the stored snapshot.
+     *
+     * Produces the same entries as FileScanner::get_directory_entries() and stores the updated
+     * snapshot afterwards.
+     * @param directory_path Scan root.
+     * @param options File scan options.
+     * @param track_changes Whether to fill the added, removed and renamed lists.
+     * @return Current entries and the delta against the previous scan.
+     * @throws std::filesystem::filesystem_error When the root cannot be listed.
+     */
+    ScanDelta scan(const std::string& directory_path, FileScanOptions options, bool track_changes = true);
+
+    /**
+     * @brief Streaming variant of scan() that hands entries over in batches as directories are visited.
+     *
+     * The returned delta leaves `entries` empty. When @p sink stops the scan, the snapshot is not updated.
+     * @param directory_path Scan root.
+     * @param options File scan options.
+     * @param batch_size Maximum number of entries per batch.
+     * @param sink Receives the batches; returning false stops the scan.
+     * @param track_changes Whether to fill the added, removed and renamed lists.
+     */
+    ScanDelta scan(const std::string& directory_path,
+                   FileScanOptions options,
+                   std::size_t batch_size,
+                   const FileScanner::EntryBatchSink& sink,
+                   bool track_changes = true);
+
+private:
+    struct DirectoryStamp {
+        std::int64_t mtime_ns{0};
+        std::uint64_t inode{0};
+    };
+
+    ScanDelta run_scan(const std::string& directory_path,
+                       FileScanOptions options,
+                       std::size_t batch_size,
+                       const FileScanner::EntryBatchSink* sink,
+                       bool track_changes);
+    static std::optional<DirectoryStamp> stat_directory(const std::string& directory_path);
+    static std::int64_t current_time_ns();
+    static void match_renames(ScanDelta& delta,
+                              std::vector<std::uint64_t>& added_inodes,
+                              std::vector<std::uint64_t>& removed_inodes);
+
+    FileScanner& scanner;
+    DatabaseManager& db_manager;
+};
+
+#endif
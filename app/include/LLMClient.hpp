@@ -3,7 +3,15 @@
 
 #include "ILLMClient.hpp"
 #include <Types.hpp>
+#include <atomic>
+#include <future>
+#include <memory>
+#include <optional>
 #include <string>
+#include <vector>
+
+class CurlSession;
+class RemoteRequestEngine;
 
 class LLMClient : public ILLMClient {
 public:
@@ -19,14 +27,41 @@ public:
     std::string complete_prompt(const std::string& prompt,
                                 int max_tokens) override;
     void set_prompt_logging_enabled(bool enabled) override;
+    /**
+     * @brief Queues the categorization on the shared remote request engine.
+     * @return Future that yields the raw reply or rethrows transport/API errors.
+     */
+    std::future<std::string> categorize_file_async(const std::string& file_name,
+                                                   const std::string& file_path,
+                                                   FileType file_type,
+                                                   const std::string& consistency_context) override;
+    /**
+     * @brief Number of files packed into one batched request (AI_FILE_SORTER_REMOTE_BATCH_SIZE).
+     */
+    std::size_t preferred_batch_size() const override;
+    /**
+     * @brief Categorizes several files with a single structured (JSON schema) request.
+     *
+     * Items the reply leaves out or garbles are re-sent individually through categorize_file().
+     * @return One raw reply per request, in request order.
+     */
+    std::vector<std::string> categorize_files(const std::vector<CategorizationRequest>& requests) override;
+    /**
+     * @brief Queues a structured batch request on the shared remote request engine.
+     * @return Future with one slot per request; slots the reply leaves out or garbles are empty.
+     */
+    std::future<std::vector<std::optional<std::string>>> categorize_files_async(
+        const std::vector<CategorizationRequest>& requests) override;
 
 private:
     std::string api_key;
     std::string send_api_request(std::string json_payload);
+    std::vector<std::string> auth_headers() const;
     std::string make_payload(const std::string &file_name,
                              const std::string &file_path,
                                 const FileType file_type,
                                 const std::string& consistency_context);
+    std::string make_batch_payload(const std::vector<CategorizationRequest>& requests, bool structured);
     std::string make_generic_payload(const std::string& system_prompt,
                                      const std::string& user_prompt,
                                      int max_tokens) const;
@@ -39,6 +74,14 @@ private:
     std::string last_prompt;
     std::string model;
     std::string base_url;
+    std::size_t batch_size{1};
+    // Cleared once the endpoint rejects response_format; batches then rely on the prompt alone.
+    // Shared with in-flight requests, which clear it from the engine thread.
+    std::shared_ptr<std::atomic<bool>> structured_batches;
+    // Pooled HTTP handle so consecutive requests reuse the same connection.
+    std::unique_ptr<CurlSession> http_session;
+    // Shared curl_multi event loop used by categorize_file_async().
+    std::shared_ptr<RemoteRequestEngine> request_engine;
 };
 
 #endif
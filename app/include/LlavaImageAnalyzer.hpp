@@ -52,6 +52,13 @@ public:
         bool use_gpu = true;
         /** @brief Enable verbose visual model logging. */
         bool log_visual_output = false;
+        /**
+         * @brief Ask for the filename in the same context as the description.
+         *
+         * The filename question is appended after the generated description instead of
+         * re-prompting from an empty context, so the prompt is not evaluated twice.
+         */
+        bool single_pass = true;
         /**
          * @brief Optional callback for image batch progress.
          * @param current_batch Batch index (1-based).
@@ -110,6 +117,11 @@ private:
      * @return Prompt string.
      */
     std::string build_filename_prompt(const std::string& description) const;
+    /**
+     * @brief Builds the filename question appended after a generated description.
+     * @return Prompt string.
+     */
+    std::string build_filename_followup_prompt() const;
 #ifdef AI_FILE_SORTER_HAS_MTMD
     /**
      * @brief Runs inference on the given bitmap.
@@ -121,6 +133,19 @@ private:
     std::string infer_text(mtmd_bitmap* bitmap,
                            const std::string& prompt,
                            int32_t max_tokens);
+    /**
+     * @brief Appends a prompt to the current context and generates a reply.
+     * @param prompt Text appended after the previous response.
+     * @param max_tokens Maximum tokens to generate.
+     * @return Model response text, or std::nullopt when the context cannot hold it.
+     */
+    std::optional<std::string> continue_text(const std::string& prompt, int32_t max_tokens);
+    /**
+     * @brief Samples up to @p max_tokens tokens from the current context.
+     * @param max_tokens Maximum tokens to generate.
+     * @return Model response text.
+     */
+    std::string generate_response(int32_t max_tokens);
 #else
     /**
      * @brief Runs inference on the given bitmap (stub for non-MTMD builds).
@@ -205,5 +230,6 @@ private:
 namespace LlavaImageAnalyzerTestAccess {
 int32_t default_visual_batch_size(bool gpu_enabled, std::string_view backend_name);
 int32_t visual_model_n_gpu_layers_for_model(const std::string& model_path);
+bool resolve_single_pass(bool configured);
 }
 #endif
@@ -5,7 +5,9 @@
 #include "llama.h"
 #include <functional>
 #include <memory>
+#include <optional>
 #include <string>
+#include <vector>
 
 namespace spdlog { class logger; }
 
@@ -31,6 +33,18 @@ public:
      * @return True to retry on CPU; false to abort.
      */
     using FallbackDecisionCallback = std::function<bool(const std::string& reason)>;
+    /**
+     * @brief Wall-clock breakdown of the most recent generation request.
+     */
+    struct RequestTimings {
+        double setup_ms{0.0};
+        double prompt_eval_ms{0.0};
+        double generation_ms{0.0};
+        int prompt_tokens{0};
+        int reused_prompt_tokens{0};
+        int generated_tokens{0};
+        bool reused_context{false};
+    };
 
     explicit LocalLLMClient(const std::string& model_path,
                             FallbackDecisionCallback fallback_decision_callback = {});
@@ -43,7 +57,8 @@ public:
     std::string generate_response(const std::string& prompt,
                                   int n_predict,
                                   bool apply_sanitizer = true,
-                                  const std::string& system_prompt = {});
+                                  const std::string& system_prompt = {},
+                                  const std::string& grammar = {});
     std::string categorize_file(const std::string& file_name,
                                 const std::string& file_path,
                                 FileType file_type,
@@ -51,6 +66,24 @@ public:
     std::string complete_prompt(const std::string& prompt,
                                 int max_tokens) override;
     void set_prompt_logging_enabled(bool enabled) override;
+    /**
+     * @brief Restricts grammar-constrained categorization output to the given labels.
+     * @param categories Allowed main categories (empty allows any label).
+     * @param subcategories Allowed subcategories (empty allows any label).
+     */
+    void set_category_whitelist(const std::vector<std::string>& categories,
+                                const std::vector<std::string>& subcategories) override;
+    /**
+     * @brief Returns how many files are decoded together as parallel sequences.
+     * @return Batch size (1 disables batched decoding).
+     */
+    std::size_t preferred_batch_size() const override;
+    /**
+     * @brief Categorizes several files at once using one sequence per file in a shared llama_batch.
+     * @param requests Items to categorize.
+     * @return Sanitized responses in request order.
+     */
+    std::vector<std::string> categorize_files(const std::vector<CategorizationRequest>& requests) override;
     /**
      * @brief Registers a status callback for runtime events.
      * @param callback Callback to invoke when status events occur.
@@ -61,6 +94,11 @@ public:
      * @param callback Callback to invoke when a GPU failure is detected.
      */
     void set_fallback_decision_callback(FallbackDecisionCallback callback);
+    /**
+     * @brief Returns the timing breakdown recorded by the last generation request.
+     * @return Setup, prompt-eval, and generation timings.
+     */
+    const RequestTimings& last_request_timings() const;
 
 private:
     void load_model_if_needed();
@@ -69,6 +107,38 @@ private:
     llama_model_params load_model_or_throw(llama_model_params model_params,
                                            const std::shared_ptr<spdlog::logger>& logger);
     void configure_context(int context_length, const llama_model_params& model_params);
+    /**
+     * @brief Creates the sampler chain once, or resets it for a new request.
+     * @param grammar GBNF grammar constraining the output (empty for unconstrained sampling).
+     */
+    void prepare_sampler(const std::string& grammar);
+    /**
+     * @brief Returns the categorization grammar, or an empty string when grammar decoding is disabled.
+     */
+    const std::string& category_grammar() const;
+    /**
+     * @brief Frees the persistent context and sampler (e.g. before reloading the model).
+     */
+    void release_context();
+    /**
+     * @brief Creates (or grows) the multi-sequence context used for batched decoding.
+     * @param n_seq Number of parallel sequences required.
+     * @return True when the batch context is ready.
+     */
+    bool ensure_batch_context(std::size_t n_seq);
+    /**
+     * @brief Decodes several prompts as parallel sequences, retiring each one on EOG.
+     * @param prompts User prompts, one per sequence.
+     * @param n_predict Maximum tokens to generate per sequence.
+     * @param system_prompt System prompt shared by all sequences.
+     * @param grammar GBNF grammar applied to every sequence (empty for unconstrained sampling).
+     * @return Raw outputs in prompt order, or std::nullopt when the caller should fall back to
+     *         sequential generation.
+     */
+    std::optional<std::vector<std::string>> generate_batch_responses(const std::vector<std::string>& prompts,
+                                                                     int n_predict,
+                                                                     const std::string& system_prompt,
+                                                                     const std::string& grammar);
     /**
      * @brief Emits a status event to the registered callback.
      * @param status Status event to emit.
@@ -76,13 +146,22 @@ private:
     void notify_status(Status status) const;
 
     std::string model_path;
-    llama_model* model;
-    llama_context* ctx;
-    const llama_vocab *vocab;
-    llama_sampler* smpl;
+    llama_model* model{nullptr};
+    llama_context* ctx{nullptr};
+    const llama_vocab *vocab{nullptr};
+    llama_sampler* smpl{nullptr};
+    std::string sampler_grammar_;
+    std::string category_grammar_;
+    bool grammar_enabled_{true};
+    llama_context* batch_ctx{nullptr};
+    std::size_t batch_ctx_seqs{0};
+    std::size_t batch_size{1};
     std::string sanitize_output(const std::string& output);
     llama_context_params ctx_params;
     bool prompt_logging_enabled{false};
     StatusCallback status_callback_;
     FallbackDecisionCallback fallback_decision_callback_;
+    RequestTimings last_timings_;
+    // Tokens currently held in the KV cache (sequence 0), used for prompt-prefix reuse.
+    std::vector<llama_token> kv_tokens_;
 };
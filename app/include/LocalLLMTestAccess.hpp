@@ -3,7 +3,9 @@
 #ifdef AI_FILE_SORTER_TEST_BUILD
 
 #include <string>
+#include <vector>
 #include "llama.h"
+#include "Types.hpp"
 
 namespace LocalLLMTestAccess {
 
@@ -25,6 +27,12 @@ bool configure_cuda_backend(const std::string& model_path,
                             llama_model_params& params);
 llama_model_params prepare_model_params_for_testing(const std::string& model_path);
 std::string sanitize_output_for_testing(const std::string& output);
+std::string build_category_grammar_for_testing(const std::vector<std::string>& categories,
+                                               const std::vector<std::string>& subcategories);
+std::string make_prompt_for_testing(const std::string& file_name,
+                                    const std::string& file_path,
+                                    FileType file_type,
+                                    const std::string& consistency_context);
 
 } // namespace LocalLLMTestAccess
 
@@ -8,6 +8,8 @@
 #include "ConsistencyPassService.hpp"
 #include "ResultsCoordinator.hpp"
 #include "FileScanner.hpp"
+#include "FolderWatcher.hpp"
+#include "IncrementalScanner.hpp"
 #include "ILLMClient.hpp"
 #include "Settings.hpp"
 #include "WhitelistStore.hpp"
@@ -26,7 +28,9 @@
 
 #include <atomic>
 #include <functional>
+#include <future>
 #include <memory>
+#include <mutex>
 #include <optional>
 #include <thread>
 #include <unordered_set>
@@ -160,6 +164,26 @@ private:
     void initialize_whitelists();
 
     void on_analyze_clicked();
+    bool ensure_llm_available(const std::string& folder_path);
+    /**
+     * @brief Starts or stops categorizing new files in the selected folder as they appear.
+     */
+    void set_folder_watch_enabled(bool enabled);
+    /**
+     * @brief Restarts an active watch when the folder or scan options changed, or stops it for an invalid folder.
+     * @param force Restart even when nothing changed, e.g. after another model was selected.
+     */
+    void refresh_folder_watch(bool force = false);
+    void requeue_deferred_watch_entries();
+    struct WatchSession;
+    /**
+     * @brief Stops the active watcher without blocking the UI thread.
+     *
+     * The watcher is joined on a background task, since a batch in flight may still be talking to
+     * the model; the task is waited for when the window is destroyed.
+     */
+    void retire_folder_watcher();
+    void categorize_watched_entries(std::vector<FileEntry>&& entries, WatchSession& session);
     void on_directory_selected(const QString& path,
         bool user_initiated = false);
     void ensure_one_checkbox_active(QCheckBox* changed_checkbox);
@@ -214,6 +238,19 @@ private:
     void prune_empty_cached_entries_for(const std::string& directory_path);
     void log_cached_highlights();
     void log_pending_queue();
+    void log_queued_entries(const std::vector<FileEntry>& entries);
+    /**
+     * @brief Scans @p directory_path on a background thread and categorizes uncached entries as they arrive.
+     * @return Categorization results in scan order.
+     */
+    std::vector<CategorizedFile> stream_scan_and_categorize(
+        const std::string& directory_path,
+        FileScanOptions scan_options,
+        const std::unordered_set<std::string>& cached_file_names,
+        bool use_full_path_keys,
+        bool categorize_files,
+        const CategorizationService::SuggestedNameProvider& suggested_name_provider,
+        std::optional<std::vector<FileEntry>>& scanned_entries);
     void run_consistency_pass();
     void handle_development_prompt_logging(bool checked);
     void record_categorized_metrics(int count);
@@ -247,6 +284,7 @@ private:
     Settings& settings;
     DatabaseManager db_manager;
     FileScanner dirscanner;
+    IncrementalScanner incremental_scanner;
     bool using_local_llm{false};
 
     std::vector<CategorizedFile> already_categorized_files;
@@ -306,6 +344,7 @@ private:
     QMenu* help_menu{nullptr};
     QAction* file_quit_action{nullptr};
     QAction* run_benchmark_action{nullptr};
+    QAction* watch_folder_action{nullptr};
     QAction* copy_action{nullptr};
     QAction* cut_action{nullptr};
     QAction* paste_action{nullptr};
@@ -358,6 +397,22 @@ private:
     FileScanOptions file_scan_options{FileScanOptions::None};
     std::thread analyze_thread;
     std::atomic<bool> stop_analysis{false};
+    // One watch session; its watcher's callback shares it, so a retired watcher can finish its batch.
+    struct WatchSession {
+        // One client serves the whole session so a local model is loaded once, not per batch.
+        std::unique_ptr<ILLMClient> llm;
+        std::atomic<bool> stop_batch{false};
+        bool retired{false};  ///< Guarded by deferred_watch_mutex_.
+    };
+    std::mutex deferred_watch_mutex_;
+    // Watched entries that arrived during a full analysis; handed back to the watcher afterwards.
+    std::vector<FileEntry> deferred_watch_entries_;
+    std::shared_ptr<WatchSession> watch_session_;
+    std::unique_ptr<FolderWatcher> folder_watcher_;
+    // Held while entries are categorized so watched batches never overlap a full analysis.
+    std::mutex categorization_run_mutex_;
+    // Declared last so retired watchers are joined before anything their batches use goes away.
+    std::vector<std::future<void>> retiring_watchers_;
     bool analysis_in_progress_{false};
     bool status_is_ready_{true};
     bool suppress_explorer_sync_{false};
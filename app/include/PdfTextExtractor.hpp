@@ -0,0 +1,98 @@
+#ifndef PDF_TEXT_EXTRACTOR_HPP
+#define PDF_TEXT_EXTRACTOR_HPP
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <filesystem>
+#include <future>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief Process-wide PDF text extraction through PDFium.
+ *
+ * PDFium is not thread-safe, so every request is handed to one worker thread that owns the
+ * library for the life of the process. Callers on any thread block on extract() until their
+ * document is done. Each request runs within a budget of characters, pages and wall-clock
+ * time, so a huge scanned PDF cannot hold up the documents queued behind it.
+ */
+class PdfTextExtractor {
+public:
+    struct Budget {
+        /** Stop once this many bytes of UTF-8 text were extracted. */
+        std::size_t max_characters = 8000;
+        /** Stop after this many pages, whether or not they had text. */
+        int max_pages = 50;
+        /** Stop starting new pages once this much time has passed. */
+        std::chrono::milliseconds max_duration{5000};
+    };
+
+    struct Metrics {
+        std::uint64_t documents = 0;
+        std::uint64_t pages = 0;
+        /** Documents cut short by the page or time budget. */
+        std::uint64_t budget_stops = 0;
+        std::chrono::nanoseconds busy{0};
+
+        double pages_per_second() const;
+    };
+
+    /**
+     * @brief The shared extractor; its worker starts on first use.
+     */
+    static PdfTextExtractor& instance();
+
+    /**
+     * @brief Whether this build includes PDFium; extract() returns nothing otherwise.
+     */
+    static bool available();
+
+    /**
+     * @brief Extracts text from the first pages of the PDF at @p path.
+     * @return UTF-8 text with pages separated by newlines; empty when the document could not
+     *         be opened or has no text layer.
+     */
+    std::string extract(const std::filesystem::path& path, const Budget& budget);
+
+    /**
+     * @brief Totals over every extraction so far.
+     */
+    Metrics metrics() const;
+
+    /**
+     * @brief Appends UTF-16 code units to @p out as UTF-8; unpaired surrogates become U+FFFD.
+     */
+    static void append_utf16(const std::uint16_t* data, std::size_t count, std::string& out);
+
+    ~PdfTextExtractor();
+
+    PdfTextExtractor(const PdfTextExtractor&) = delete;
+    PdfTextExtractor& operator=(const PdfTextExtractor&) = delete;
+
+private:
+    struct Job {
+        std::filesystem::path path;
+        Budget budget;
+        std::promise<std::string> result;
+    };
+
+    PdfTextExtractor();
+    void run();
+    std::string extract_on_worker(const std::filesystem::path& path, const Budget& budget);
+
+    mutable std::mutex mutex_;
+    std::condition_variable jobs_cv_;
+    std::deque<Job> jobs_;
+    bool stopping_{false};
+    Metrics metrics_;
+    // Only touched by the worker; kept across pages and documents to avoid reallocating.
+    std::vector<std::uint16_t> utf16_buffer_;
+    std::thread worker_;
+};
+
+#endif
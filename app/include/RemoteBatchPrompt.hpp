@@ -0,0 +1,89 @@
+#pragma once
+
+#include "ILLMClient.hpp"
+
+#include <cstddef>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace spdlog { class logger; }
+
+/**
+ * @brief Prompt and response helpers shared by the remote clients' multi-file categorization mode.
+ *
+ * A batch lists every item once under a numeric id and asks for a JSON object of the form
+ * {"items":[{"id":1,"category":"...","subcategory":"..."}]}, so the system prompt is paid once per
+ * batch instead of once per file.
+ */
+namespace RemoteBatchPrompt {
+
+/**
+ * @brief Number of files packed into one remote request (AI_FILE_SORTER_REMOTE_BATCH_SIZE).
+ * @return Batch size between 1 and 50; defaults to 20.
+ */
+std::size_t resolve_batch_size();
+
+/**
+ * @brief System instructions for a batched categorization request.
+ */
+const std::string& system_prompt();
+
+/**
+ * @brief Builds the user prompt listing @p requests under ids 1..N.
+ *
+ * Blank-line separated context blocks shared by every request are stated once; the rest of each
+ * request's context is attached to its item.
+ * @param requests Items to categorize, in order.
+ * @return Prompt text.
+ */
+std::string build_user_prompt(const std::vector<CategorizationRequest>& requests);
+
+/**
+ * @brief OpenAI-compatible `response_format` value enforcing the batch reply schema.
+ * @return Compact JSON object.
+ */
+const std::string& openai_response_format();
+
+/**
+ * @brief Gemini `generationConfig.responseSchema` value enforcing the batch reply schema.
+ * @return Compact JSON object.
+ */
+const std::string& gemini_response_schema();
+
+/**
+ * @brief Request timeout for a batch of @p item_count items.
+ * @param base_timeout_seconds Timeout used for a single-file request.
+ * @param item_count Number of items in the batch.
+ * @return Timeout in seconds.
+ */
+long batch_timeout_seconds(long base_timeout_seconds, std::size_t item_count);
+
+/**
+ * @brief Tells whether a request error means the endpoint does not accept the batch response schema.
+ *
+ * Only these rejections turn structured batches off; authentication, quota and other request
+ * errors are reported as they are.
+ * @param error_message Error text thrown by the client's response parser.
+ * @return True for a bad-request reply that names the schema or response format.
+ */
+bool is_schema_rejection(const std::string& error_message);
+
+/**
+ * @brief Parses a batched reply into one "<Category> : <Subcategory>" line per request.
+ *
+ * Accepts the JSON object (optionally wrapped in a Markdown code fence), a bare JSON array, or
+ * "<id> => <Category> : <Subcategory>" lines. Items that are missing, malformed or duplicated
+ * are left empty so callers can retry them individually.
+ *
+ * @param response Raw model reply.
+ * @param item_count Number of items in the batch.
+ * @param logger Optional logger for skipped entries.
+ * @return One slot per item, in request order.
+ */
+std::vector<std::optional<std::string>> parse_response(const std::string& response,
+                                                       std::size_t item_count,
+                                                       const std::shared_ptr<spdlog::logger>& logger);
+
+} // namespace RemoteBatchPrompt
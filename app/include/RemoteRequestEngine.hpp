@@ -0,0 +1,89 @@
+#ifndef REMOTE_REQUEST_ENGINE_HPP
+#define REMOTE_REQUEST_ENGINE_HPP
+
+#include "CurlSession.hpp"
+
+#include <chrono>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @brief Runs remote HTTP requests asynchronously on a single curl_multi event loop.
+ *
+ * Up to a bounded number of transfers are kept in flight (multiplexed over HTTP/2 where
+ * possible); the rest wait in a FIFO queue. Each request carries its own deadline, and
+ * 429/503 replies with a Retry-After that still fits in the deadline are retried by the
+ * loop without blocking any caller thread. The engine is shared by all remote clients and
+ * stops once the last client releases it.
+ */
+class RemoteRequestEngine {
+public:
+    /**
+     * @brief A JSON POST request.
+     */
+    struct Request {
+        std::string url;
+        std::string payload;
+        std::vector<std::string> headers;
+        long timeout_seconds{10};
+    };
+    /**
+     * @brief Completion callback, invoked on the engine thread with either a response or an error.
+     *
+     * Completions must not block and must not own a reference to the engine; they may call
+     * submit() through a plain pointer to chain a follow-up request.
+     */
+    using Completion = std::function<void(CurlSession::Response, std::exception_ptr)>;
+
+    /**
+     * @brief Returns the shared engine, starting its event loop when needed.
+     * @return Shared engine instance.
+     */
+    static std::shared_ptr<RemoteRequestEngine> acquire();
+
+    ~RemoteRequestEngine();
+    RemoteRequestEngine(const RemoteRequestEngine&) = delete;
+    RemoteRequestEngine& operator=(const RemoteRequestEngine&) = delete;
+
+    /**
+     * @brief Queues a request; @p on_complete runs on the engine thread when it finishes.
+     * @param request Request to send.
+     * @param on_complete Completion callback (must not block).
+     */
+    void submit(Request request, Completion on_complete);
+
+    /**
+     * @brief Returns the maximum number of concurrent transfers.
+     */
+    std::size_t max_in_flight() const { return max_in_flight_; }
+
+private:
+    struct Transfer;
+
+    explicit RemoteRequestEngine(std::size_t max_in_flight);
+    void run();
+    void start_transfer(std::unique_ptr<Transfer> transfer);
+    void finish_transfer(CURL* easy, CURLcode result);
+    void fail_all(const std::string& reason);
+
+    const std::size_t max_in_flight_;
+    CURLM* multi_{nullptr};
+    std::thread loop_thread_;
+    std::mutex mutex_;
+    bool stopping_{false};
+    std::deque<std::unique_ptr<Transfer>> queued_;
+    // Owned by the loop thread.
+    std::unordered_map<CURL*, std::unique_ptr<Transfer>> active_;
+    std::vector<std::unique_ptr<Transfer>> delayed_;
+    std::vector<CURL*> idle_handles_;
+};
+
+#endif // REMOTE_REQUEST_ENGINE_HPP
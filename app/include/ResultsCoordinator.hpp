@@ -3,7 +3,9 @@
 
 #include "Types.hpp"
 #include "FileScanner.hpp"
+#include "IncrementalScanner.hpp"
 
+#include <cstddef>
 #include <unordered_set>
 #include <vector>
 
@@ -12,14 +14,18 @@
  *
  * The coordinator relies on a FileScanner to list directory contents and then
  * filters/merges those results against cached or newly categorized entries.
+ * When an IncrementalScanner is supplied, listings go through it so unchanged
+ * directories are served from the persisted scan snapshot.
  */
 class ResultsCoordinator {
 public:
     /**
      * @brief Constructs a coordinator that uses the provided scanner.
      * @param scanner FileScanner used to enumerate directory entries.
+     * @param incremental_scanner Optional snapshot-backed scanner used instead of @p scanner.
      */
-    explicit ResultsCoordinator(FileScanner& scanner);
+    explicit ResultsCoordinator(FileScanner& scanner,
+                                IncrementalScanner* incremental_scanner = nullptr);
 
     /**
      * @brief Lists entries in a directory using the provided scan options.
@@ -35,12 +41,35 @@ public:
      * @param directory_path Directory path to scan.
      * @param options File scan options (files, directories, hidden files).
      * @param cached_files Set of cached file names to exclude.
+     * @param scanned_entries Receives every scanned entry, cached ones included, when not null.
      * @return Vector of FileEntry objects that are not in the cache.
      */
     std::vector<FileEntry> find_files_to_categorize(const std::string& directory_path,
                                                     FileScanOptions options,
                                                     const std::unordered_set<std::string>& cached_files,
-                                                    bool use_full_path_keys) const;
+                                                    bool use_full_path_keys,
+                                                    std::vector<FileEntry>* scanned_entries = nullptr) const;
+
+    /**
+     * @brief Streaming variant of find_files_to_categorize().
+     *
+     * Cached entries are dropped as each scanned batch arrives, so only uncached entries reach @p sink.
+     * @param directory_path Directory path to scan.
+     * @param options File scan options (files, directories, hidden files).
+     * @param cached_files Set of cached file names to exclude.
+     * @param batch_size Number of scanned entries filtered per step.
+     * @param sink Receives each batch of uncached entries, empty when the whole batch was cached;
+     *             returning false stops the scan.
+     * @param scanned_entries Receives every scanned entry, cached ones included, when not null.
+     * @return False when @p sink stopped the scan before the whole tree was listed.
+     */
+    bool stream_files_to_categorize(const std::string& directory_path,
+                                    FileScanOptions options,
+                                    const std::unordered_set<std::string>& cached_files,
+                                    bool use_full_path_keys,
+                                    std::size_t batch_size,
+                                    const FileScanner::EntryBatchSink& sink,
+                                    std::vector<FileEntry>* scanned_entries = nullptr) const;
 
     /**
      * @brief Filters categorized results to those still present on disk.
@@ -69,6 +98,10 @@ private:
      * @brief Scanner used to read directory entries.
      */
     FileScanner& scanner;
+    /**
+     * @brief Snapshot-backed scanner; nullptr to always scan the full tree.
+     */
+    IncrementalScanner* incremental_scanner;
 };
 
 #endif
@@ -0,0 +1,93 @@
+#ifndef TAXONOMY_MATCH_INDEX_HPP
+#define TAXONOMY_MATCH_INDEX_HPP
+
+#include <cstddef>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief Approximate-match index over normalized taxonomy labels.
+ *
+ * Entries are grouped by normalized category in a BK-tree keyed on edit distance; each group
+ * keeps a second BK-tree over its subcategories. A query only scores entries whose distances can
+ * still reach the requested similarity, so lookups no longer scan the whole taxonomy.
+ * Similarity is `1 - distance / max(length)`, matching the previous linear scan exactly.
+ */
+class TaxonomyMatchIndex {
+public:
+    struct Match {
+        std::size_t position;
+        double score;
+    };
+
+    /**
+     * @brief Removes every entry.
+     */
+    void clear();
+
+    /**
+     * @brief Adds an entry.
+     * @param position Caller-defined slot (e.g. index into the taxonomy cache); ties prefer the lowest.
+     * @param normalized_category Normalized category label.
+     * @param normalized_subcategory Normalized subcategory label.
+     */
+    void insert(std::size_t position,
+                const std::string& normalized_category,
+                const std::string& normalized_subcategory);
+
+    /**
+     * @brief Finds the entry with the highest mean category/subcategory similarity.
+     * @param normalized_category Normalized category to match.
+     * @param normalized_subcategory Normalized subcategory to match.
+     * @param threshold Minimum mean similarity in [0, 1].
+     * @return Best entry at or above @p threshold, or std::nullopt.
+     */
+    std::optional<Match> find_best_match(const std::string& normalized_category,
+                                         const std::string& normalized_subcategory,
+                                         double threshold) const;
+
+    /**
+     * @brief Number of indexed entries.
+     */
+    std::size_t size() const { return entry_count_; }
+
+    /**
+     * @brief Levenshtein distance over bytes, bit-parallel (Myers) for inputs up to 64 bytes.
+     */
+    static std::size_t edit_distance(std::string_view a, std::string_view b);
+
+    /**
+     * @brief Normalized similarity `1 - distance / max(length)`; 1.0 for equal strings.
+     */
+    static double similarity(std::string_view a, std::string_view b);
+
+private:
+    // BK-tree over distinct labels. Each node carries the caller's payload values for that label.
+    class LabelTree {
+    public:
+        std::size_t insert(const std::string& label);
+        std::vector<std::pair<std::size_t, std::size_t>> find_within(std::string_view query,
+                                                                     std::size_t radius) const;
+        std::vector<std::size_t>& payload(std::size_t node) { return nodes_[node].payload; }
+        const std::vector<std::size_t>& payload(std::size_t node) const { return nodes_[node].payload; }
+        const std::string& label(std::size_t node) const { return nodes_[node].label; }
+        void clear() { nodes_.clear(); }
+
+    private:
+        struct Node {
+            std::string label;
+            std::vector<std::pair<std::size_t, std::size_t>> children; // (distance, node)
+            std::vector<std::size_t> payload;
+        };
+        std::vector<Node> nodes_;
+    };
+
+    LabelTree categories_;
+    std::vector<LabelTree> subcategories_; // one tree per category node
+    std::size_t entry_count_{0};
+};
+
+#endif
@@ -0,0 +1,73 @@
+#ifndef XML_TEXT_STREAM_HPP
+#define XML_TEXT_STREAM_HPP
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+/**
+ * @brief Incremental extractor for the character data of an XML document.
+ *
+ * Chunks of raw XML are fed in as they are decompressed; markup is skipped, entities are
+ * decoded, whitespace is collapsed and separate text runs are joined with a single space.
+ * Output stops at a fixed byte budget, so callers can stop reading the part once full()
+ * turns true instead of inflating and parsing it completely. Chunks may split markup or
+ * entities at any byte.
+ */
+class XmlTextStream {
+public:
+    /**
+     * @param max_bytes Maximum size of the extracted text in bytes.
+     */
+    explicit XmlTextStream(std::size_t max_bytes);
+
+    /**
+     * @brief Consumes the next chunk of XML.
+     * @return False once the budget is met; further chunks are ignored.
+     */
+    bool feed(std::string_view chunk);
+
+    /**
+     * @brief Whether the byte budget has been reached.
+     */
+    bool full() const { return full_; }
+
+    /**
+     * @brief Text extracted so far, never ending in a partial UTF-8 sequence once full.
+     */
+    const std::string& text() const { return text_; }
+
+    /**
+     * @brief Moves the extracted text out and resets the stream for another document.
+     */
+    std::string take();
+
+private:
+    enum class State {
+        Text,
+        Entity,
+        MarkupStart,
+        Tag,
+        Skip,
+        CData
+    };
+
+    void put(char ch);
+    void put_decoded(std::string_view value);
+    void finish_entity();
+    void classify_markup();
+    void begin_skip(std::string_view terminator);
+    void mark_full();
+
+    std::size_t max_bytes_;
+    std::string text_;
+    State state_ = State::Text;
+    std::string pending_;
+    char quote_ = '\0';
+    std::string_view terminator_;
+    std::size_t terminator_match_ = 0;
+    bool pending_space_ = false;
+    bool full_ = false;
+};
+
+#endif
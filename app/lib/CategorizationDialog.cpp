@@ -1234,6 +1234,8 @@ void CategorizationDialog::record_categorization_to_db()
                                                         category_language_);
     };
 
+    // Rows are written in one transaction after the scan; per-row commits stall the dialog on large reviews.
+    std::vector<DatabaseManager::CategorizationRecord> pending_writes;
     for (int row = 0; row < model->rowCount(); ++row) {
         auto* file_item = model->item(row, ColumnFile);
         if (!file_item) {
@@ -1315,8 +1317,8 @@ void CategorizationDialog::record_categorization_to_db()
                 entry_is_unchanged(*cached_entry, resolved, suggested_name, rename_only, used_consistency)) {
                 continue;
             }
-            db_manager->insert_or_update_file_with_categorization(
-                file_name, file_type_label, file_path, resolved, used_consistency, suggested_name, true);
+            pending_writes.push_back(DatabaseManager::CategorizationRecord{
+                file_name, file_type_label, file_path, resolved, used_consistency, suggested_name, true});
             continue;
         }
 
@@ -1331,8 +1333,8 @@ void CategorizationDialog::record_categorization_to_db()
             entry_is_unchanged(*cached_entry, resolved, suggested_name, rename_only, used_consistency)) {
             continue;
         }
-        db_manager->insert_or_update_file_with_categorization(
-            file_name, file_type_label, file_path, resolved, used_consistency, suggested_name);
+        pending_writes.push_back(DatabaseManager::CategorizationRecord{
+            file_name, file_type_label, file_path, resolved, used_consistency, suggested_name});
 
         const auto display_resolved = db_manager->localize_category(resolved, category_language_);
         update_category_roles(category_item,
@@ -1348,6 +1350,11 @@ void CategorizationDialog::record_categorization_to_db()
                                   kCanonicalSubcategoryRole);
         }
     }
+
+    if (!pending_writes.empty() &&
+        !db_manager->insert_or_update_files_with_categorization(pending_writes) && db_logger) {
+        db_logger->error("Failed to store {} reviewed categorization(s).", pending_writes.size());
+    }
 }
 
 
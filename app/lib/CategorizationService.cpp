@@ -1,4 +1,5 @@
 #include "CategorizationService.hpp"
+#include "ContentFingerprint.hpp"
 
 #include "Settings.hpp"
 #include "CategoryLanguage.hpp"
@@ -22,8 +23,10 @@
 #include <cctype>
 #include <chrono>
 #include <cstdlib>
+#include <exception>
 #include <future>
 #include <memory>
+#include <mutex>
 #include <sstream>
 #include <thread>
 #include <vector>
@@ -32,6 +35,10 @@ namespace {
 constexpr const char* kLocalTimeoutEnv = "AI_FILE_SORTER_LOCAL_LLM_TIMEOUT";
 constexpr const char* kRemoteTimeoutEnv = "AI_FILE_SORTER_REMOTE_LLM_TIMEOUT";
 constexpr const char* kCustomTimeoutEnv = "AI_FILE_SORTER_CUSTOM_LLM_TIMEOUT";
+constexpr const char* kLocalWorkersEnv = "AI_FILE_SORTER_LOCAL_LLM_WORKERS";
+constexpr const char* kRemoteWorkersEnv = "AI_FILE_SORTER_REMOTE_LLM_WORKERS";
+constexpr std::size_t kDefaultRemoteWorkers = 4;
+constexpr std::size_t kMaxWorkers = 32;
 constexpr size_t kMaxConsistencyHints = 5;
 constexpr size_t kMaxLabelLength = 80;
 std::string to_lower_copy_str(std::string value);
@@ -623,52 +630,314 @@ std::vector<CategorizedFile> CategorizationService::categorize_entries(
     const PromptOverrideProvider& prompt_override,
     const SuggestedNameProvider& suggested_name_provider) const
 {
-    std::vector<CategorizedFile> categorized;
     if (files.empty()) {
-        return categorized;
+        return {};
     }
+
+    bool delivered = false;
+    const EntryBatchSource single_batch = [&files, &delivered]() -> std::optional<std::vector<FileEntry>> {
+        if (delivered) {
+            return std::nullopt;
+        }
+        delivered = true;
+        return files;
+    };
+    return categorize_entry_stream(single_batch,
+                                   is_local_llm,
+                                   stop_flag,
+                                   progress_callback,
+                                   queue_callback,
+                                   completion_callback,
+                                   recategorization_callback,
+                                   std::move(llm_factory),
+                                   prompt_override,
+                                   suggested_name_provider);
+}
+
+std::vector<CategorizedFile> CategorizationService::categorize_entry_stream(
+    const EntryBatchSource& next_batch,
+    bool is_local_llm,
+    std::atomic<bool>& stop_flag,
+    const ProgressCallback& progress_callback,
+    const QueueCallback& queue_callback,
+    const CompletionCallback& completion_callback,
+    const RecategorizationCallback& recategorization_callback,
+    std::function<std::unique_ptr<ILLMClient>()> llm_factory,
+    const PromptOverrideProvider& prompt_override,
+    const SuggestedNameProvider& suggested_name_provider) const
+{
+    std::vector<CategorizedFile> categorized;
     if (stop_flag.load()) {
         return categorized;
     }
 
+    // queue_mutex guards the pending queue and the pool; source_mutex serializes next_batch(),
+    // which may block on a scan, so claiming queued entries never waits behind it.
+    std::mutex queue_mutex;
+    std::mutex source_mutex;
+    std::deque<std::pair<std::size_t, FileEntry>> pending;
+    std::size_t received = 0;
+    bool source_exhausted = false;
+    const auto pull_batch = [&]() {
+        auto batch = next_batch();
+        std::lock_guard<std::mutex> lock(queue_mutex);
+        if (!batch) {
+            source_exhausted = true;
+            return;
+        }
+        for (auto& entry : *batch) {
+            pending.emplace_back(received++, std::move(entry));
+        }
+    };
+    // The first batch sizes the initial worker pool and avoids creating clients for an empty stream.
+    while (pending.empty() && !source_exhausted) {
+        pull_batch();
+    }
+    if (pending.empty()) {
+        return categorized;
+    }
+
     auto llm = llm_factory ? llm_factory() : nullptr;
     if (!llm) {
         throw std::runtime_error("Failed to create LLM client.");
     }
 
-    categorized.reserve(files.size());
-    SessionHistoryMap session_history;
+    const bool use_whitelist = settings.get_use_whitelist();
+    const auto allowed_categories = use_whitelist ? settings.get_allowed_categories() : std::vector<std::string>();
+    const auto allowed_subcategories =
+        use_whitelist ? settings.get_allowed_subcategories() : std::vector<std::string>();
+    // Factories may load a model, so clients are built before any lock is taken.
+    const auto make_client = [&]() -> std::unique_ptr<ILLMClient> {
+        try {
+            auto extra = llm_factory();
+            if (extra) {
+                extra->set_category_whitelist(allowed_categories, allowed_subcategories);
+            }
+            return extra;
+        } catch (const std::exception& ex) {
+            if (core_logger) {
+                core_logger->warn("Failed to create additional LLM client ({}); no more workers will be added.",
+                                  ex.what());
+            }
+            return nullptr;
+        }
+    };
 
-    for (const auto& entry : files) {
-        if (stop_flag.load()) {
+    // Reused clients (a watch session's, pooled local contexts) keep their grammar between runs, so
+    // a disabled whitelist is applied as empty lists rather than skipped.
+    llm->set_category_whitelist(allowed_categories, allowed_subcategories);
+    // Clients live in a deque so workers keep valid references while the pool grows.
+    std::deque<std::unique_ptr<ILLMClient>> clients;
+    clients.push_back(std::move(llm));
+    // The first batch has cached entries filtered out, so on a mostly cached rerun it can be tiny.
+    // The pool starts at its size and grows towards max_workers while later batches leave a backlog.
+    const std::size_t max_workers = resolve_worker_count(is_local_llm, kMaxWorkers);
+    const std::size_t requested_workers = resolve_worker_count(is_local_llm, pending.size());
+    bool can_grow = true;
+    while (clients.size() < requested_workers) {
+        auto extra = make_client();
+        if (!extra) {
+            can_grow = false;
             break;
         }
+        clients.push_back(std::move(extra));
+    }
+
+    SessionHistoryMap session_history;
 
-        if (queue_callback) {
-            queue_callback(entry);
+    if (core_logger && clients.size() > 1) {
+        core_logger->info("Categorizing {}{} item(s) with {} worker(s).",
+                          pending.size(),
+                          source_exhausted ? "" : "+",
+                          clients.size());
+    }
+
+    // Callbacks may touch UI state or non-thread-safe providers, so workers take turns invoking them.
+    std::mutex callback_mutex;
+    const ProgressCallback serialized_progress = progress_callback
+        ? ProgressCallback([&](const std::string& message) {
+              std::lock_guard<std::mutex> lock(callback_mutex);
+              progress_callback(message);
+          })
+        : ProgressCallback();
+    const RecategorizationCallback serialized_recategorization = recategorization_callback
+        ? RecategorizationCallback([&](const CategorizedFile& entry, const std::string& reason) {
+              std::lock_guard<std::mutex> lock(callback_mutex);
+              recategorization_callback(entry, reason);
+          })
+        : RecategorizationCallback();
+
+    // Slots are indexed by arrival order.
+    std::mutex slots_mutex;
+    std::deque<std::optional<CategorizedFile>> slots;
+    std::atomic<bool> abort_workers{false};
+    std::exception_ptr first_error;
+
+    // Worker threads are started and joined under queue_mutex, which also guards clients.
+    std::deque<std::thread> workers;
+    std::function<void(ILLMClient&)> worker;
+    // Only one worker builds an extra client at a time; the others keep categorizing meanwhile.
+    std::mutex grow_mutex;
+
+    const auto needs_entries = [&](std::size_t claim_size) {
+        std::lock_guard<std::mutex> lock(queue_mutex);
+        return pending.size() < claim_size && !source_exhausted;
+    };
+
+    const auto grow_pool = [&]() {
+        std::unique_lock<std::mutex> grow_lock(grow_mutex, std::try_to_lock);
+        if (!grow_lock.owns_lock()) {
+            return;
+        }
+        auto extra = make_client();
+        std::lock_guard<std::mutex> lock(queue_mutex);
+        if (!extra) {
+            can_grow = false;
+            return;
         }
+        if (clients.size() < max_workers && !stop_flag.load() && !abort_workers.load()) {
+            clients.push_back(std::move(extra));
+            workers.emplace_back(worker, std::ref(*clients.back()));
+        }
+    };
 
-        const std::string suggested_name = suggested_name_provider
-            ? suggested_name_provider(entry)
-            : std::string();
-        const auto override_value = prompt_override ? prompt_override(entry) : std::nullopt;
-        if (auto categorized_entry = categorize_single_entry(*llm,
-                                                             is_local_llm,
-                                                             entry,
-                                                             override_value,
-                                                             suggested_name,
-                                                             stop_flag,
-                                                             progress_callback,
-                                                             recategorization_callback,
-                                                             session_history)) {
-            categorized.push_back(*categorized_entry);
+    const auto claim = [&](std::size_t claim_size, std::vector<std::pair<std::size_t, FileEntry>>& claimed) {
+        if (needs_entries(claim_size) && !stop_flag.load()) {
+            std::lock_guard<std::mutex> source_lock(source_mutex);
+            while (needs_entries(claim_size) && !stop_flag.load()) {
+                pull_batch();
+            }
+        }
+        bool grow = false;
+        {
+            std::lock_guard<std::mutex> lock(queue_mutex);
+            while (!pending.empty() && claimed.size() < claim_size) {
+                claimed.push_back(std::move(pending.front()));
+                pending.pop_front();
+            }
+            grow = !pending.empty() && can_grow && clients.size() < max_workers &&
+                   !stop_flag.load() && !abort_workers.load();
         }
+        if (grow) {
+            grow_pool();
+        }
+    };
+
+    worker = [&](ILLMClient& client) {
+        // Clients that decode several prompts together (e.g. multi-sequence local inference) claim that many entries.
+        const std::size_t claim_size = std::max<std::size_t>(1, client.preferred_batch_size());
+        std::vector<std::pair<std::size_t, FileEntry>> claimed;
+        while (!stop_flag.load() && !abort_workers.load()) {
+            claimed.clear();
+            claim(claim_size, claimed);
+            if (claimed.empty()) {
+                return;
+            }
+
+            std::vector<const FileEntry*> entries;
+            std::vector<std::string> suggested_names(claimed.size());
+            std::vector<std::optional<PromptOverride>> overrides(claimed.size());
+            entries.reserve(claimed.size());
+            {
+                std::lock_guard<std::mutex> lock(callback_mutex);
+                for (std::size_t offset = 0; offset < claimed.size(); ++offset) {
+                    const FileEntry& entry = claimed[offset].second;
+                    entries.push_back(&entry);
+                    if (queue_callback) {
+                        queue_callback(entry);
+                    }
+                    if (suggested_name_provider) {
+                        suggested_names[offset] = suggested_name_provider(entry);
+                    }
+                    if (prompt_override) {
+                        overrides[offset] = prompt_override(entry);
+                    }
+                }
+            }
+
+            std::vector<std::optional<CategorizedFile>> results;
+            try {
+                if (entries.size() == 1) {
+                    results.push_back(categorize_single_entry(client,
+                                                              is_local_llm,
+                                                              *entries.front(),
+                                                              overrides.front(),
+                                                              suggested_names.front(),
+                                                              serialized_progress,
+                                                              serialized_recategorization,
+                                                              session_history));
+                } else {
+                    results = categorize_entry_batch(client,
+                                                     is_local_llm,
+                                                     entries,
+                                                     overrides,
+                                                     suggested_names,
+                                                     stop_flag,
+                                                     serialized_progress,
+                                                     serialized_recategorization,
+                                                     session_history);
+                }
+            } catch (...) {
+                std::lock_guard<std::mutex> lock(callback_mutex);
+                if (!first_error) {
+                    first_error = std::current_exception();
+                }
+                abort_workers = true;
+                return;
+            }
 
-        if (completion_callback) {
-            completion_callback(entry);
+            {
+                std::lock_guard<std::mutex> lock(slots_mutex);
+                for (std::size_t offset = 0; offset < results.size(); ++offset) {
+                    const std::size_t index = claimed[offset].first;
+                    if (slots.size() <= index) {
+                        slots.resize(index + 1);
+                    }
+                    slots[index] = std::move(results[offset]);
+                }
+            }
+
+            if (completion_callback) {
+                std::lock_guard<std::mutex> lock(callback_mutex);
+                for (const FileEntry* entry : entries) {
+                    completion_callback(*entry);
+                }
+            }
+        }
+    };
+
+    {
+        std::lock_guard<std::mutex> lock(queue_mutex);
+        for (std::size_t i = 1; i < clients.size(); ++i) {
+            workers.emplace_back(worker, std::ref(*clients[i]));
         }
     }
+    worker(*clients.front());
+    // A running worker may still add another one, so pick up threads until none are left.
+    for (std::size_t joined = 0;; ++joined) {
+        std::thread* thread = nullptr;
+        {
+            std::lock_guard<std::mutex> lock(queue_mutex);
+            if (joined < workers.size()) {
+                thread = &workers[joined];
+            }
+        }
+        if (!thread) {
+            break;
+        }
+        thread->join();
+    }
+
+    if (first_error) {
+        std::rethrow_exception(first_error);
+    }
 
+    categorized.reserve(slots.size());
+    for (auto& slot : slots) {
+        if (slot) {
+            categorized.push_back(std::move(*slot));
+        }
+    }
     return categorized;
 }
 
@@ -735,11 +1004,21 @@ std::optional<DatabaseManager::ResolvedCategory> CategorizationService::try_cach
     const std::string& categorization_path,
     const std::string& dir_path,
     FileType file_type,
-    const ProgressCallback& progress_callback) const
+    const ProgressCallback& progress_callback,
+    const std::string& full_path,
+    std::string* content_fingerprint) const
 {
-    const auto cached = db_manager.get_categorization_from_db(dir_path, item_name, file_type);
+    std::unique_lock<std::mutex> lock(storage_mutex);
+    auto cached = db_manager.get_categorization_from_db(dir_path, item_name, file_type);
     if (cached.size() < 2) {
-        return std::nullopt;
+        // The name key missed; the file may have been moved, renamed or copied from a cached one.
+        lock.unlock();
+        auto match = find_cached_by_fingerprint(full_path, file_type, content_fingerprint);
+        if (!match) {
+            return std::nullopt;
+        }
+        cached = {match->category, match->subcategory};
+        lock.lock();
     }
 
     const std::string sanitized_category = Utils::sanitize_path_label(cached[0]);
@@ -769,6 +1048,38 @@ std::optional<DatabaseManager::ResolvedCategory> CategorizationService::try_cach
     return db_manager.resolve_category(sanitized_category, sanitized_subcategory);
 }
 
+std::optional<CategorizedFile> CategorizationService::find_cached_by_fingerprint(
+    const std::string& full_path,
+    FileType file_type,
+    std::string* content_fingerprint) const
+{
+    if (file_type != FileType::File || full_path.empty() || !content_fingerprint ||
+        !ContentFingerprint::enabled()) {
+        return std::nullopt;
+    }
+    if (content_fingerprint->empty()) {
+        *content_fingerprint = ContentFingerprint::compute(full_path).value_or(std::string());
+    }
+    if (content_fingerprint->empty()) {
+        return std::nullopt;
+    }
+
+    std::lock_guard<std::mutex> lock(storage_mutex);
+    const auto matches = db_manager.find_categorizations_by_fingerprint(*content_fingerprint);
+    if (matches.empty()) {
+        return std::nullopt;
+    }
+
+    if (core_logger) {
+        core_logger->info("Reusing cached category '{} / {}' for '{}' (same content as '{}')",
+                          matches.front().category,
+                          matches.front().subcategory,
+                          full_path,
+                          matches.front().file_name);
+    }
+    return matches.front();
+}
+
 bool CategorizationService::ensure_remote_credentials_for_request(
     const std::string& item_name,
     const ProgressCallback& progress_callback) const
@@ -826,41 +1137,12 @@ DatabaseManager::ResolvedCategory CategorizationService::categorize_via_llm(
     try {
         const std::string category_subcategory =
             run_llm_with_timeout(llm, prompt_name, prompt_path, file_type, is_local_llm, consistency_context);
-
-        auto [category, subcategory] = split_category_subcategory(category_subcategory);
-        auto resolved = db_manager.resolve_category(category, subcategory);
-        if (settings.get_use_whitelist()) {
-            const auto allowed_categories = settings.get_allowed_categories();
-            const auto allowed_subcategories = settings.get_allowed_subcategories();
-            if (!is_allowed(resolved.category, allowed_categories)) {
-                resolved.category = first_allowed_or_blank(allowed_categories);
-            }
-            if (!is_allowed(resolved.subcategory, allowed_subcategories)) {
-                resolved.subcategory = first_allowed_or_blank(allowed_subcategories);
-            }
-        }
-        const auto validation = validate_labels(resolved.category, resolved.subcategory);
-        if (!validation.valid) {
-            if (progress_callback) {
-                progress_callback(fmt::format("[LLM-ERROR] {} (invalid category/subcategory: {})",
-                                              display_name,
-                                              validation.error));
-            }
-            if (core_logger) {
-                core_logger->warn("Invalid LLM output for '{}': {} (cat='{}', sub='{}')",
-                                  display_name,
-                                  validation.error,
-                                  resolved.category,
-                                  resolved.subcategory);
-            }
-            return DatabaseManager::ResolvedCategory{-1, "", ""};
-        }
-        if (resolved.category.empty()) {
-            resolved.category = "Uncategorized";
-        }
-        const auto display_resolved = localize_resolved_category(llm, resolved);
-        emit_progress_message(progress_callback, "AI", display_name, display_resolved, display_path, prompt_path);
-        return resolved;
+        return resolve_llm_response(llm,
+                                    category_subcategory,
+                                    display_name,
+                                    display_path,
+                                    prompt_path,
+                                    progress_callback);
     } catch (const std::exception& ex) {
         const std::string err_msg = fmt::format("[LLM-ERROR] {} ({})", display_name, ex.what());
         if (progress_callback) {
@@ -873,6 +1155,53 @@ DatabaseManager::ResolvedCategory CategorizationService::categorize_via_llm(
     }
 }
 
+DatabaseManager::ResolvedCategory CategorizationService::resolve_llm_response(
+    ILLMClient& llm,
+    const std::string& response,
+    const std::string& display_name,
+    const std::string& display_path,
+    const std::string& prompt_path,
+    const ProgressCallback& progress_callback) const
+{
+    auto [category, subcategory] = split_category_subcategory(response);
+    auto resolved = [&] {
+        std::lock_guard<std::mutex> lock(storage_mutex);
+        return db_manager.resolve_category(category, subcategory);
+    }();
+    if (settings.get_use_whitelist()) {
+        const auto allowed_categories = settings.get_allowed_categories();
+        const auto allowed_subcategories = settings.get_allowed_subcategories();
+        if (!is_allowed(resolved.category, allowed_categories)) {
+            resolved.category = first_allowed_or_blank(allowed_categories);
+        }
+        if (!is_allowed(resolved.subcategory, allowed_subcategories)) {
+            resolved.subcategory = first_allowed_or_blank(allowed_subcategories);
+        }
+    }
+    const auto validation = validate_labels(resolved.category, resolved.subcategory);
+    if (!validation.valid) {
+        if (progress_callback) {
+            progress_callback(fmt::format("[LLM-ERROR] {} (invalid category/subcategory: {})",
+                                          display_name,
+                                          validation.error));
+        }
+        if (core_logger) {
+            core_logger->warn("Invalid LLM output for '{}': {} (cat='{}', sub='{}')",
+                              display_name,
+                              validation.error,
+                              resolved.category,
+                              resolved.subcategory);
+        }
+        return DatabaseManager::ResolvedCategory{-1, "", ""};
+    }
+    if (resolved.category.empty()) {
+        resolved.category = "Uncategorized";
+    }
+    const auto display_resolved = localize_resolved_category(llm, resolved);
+    emit_progress_message(progress_callback, "AI", display_name, display_resolved, display_path, prompt_path);
+    return resolved;
+}
+
 void CategorizationService::emit_progress_message(const ProgressCallback& progress_callback,
                                                   std::string_view source,
                                                   const std::string& item_name,
@@ -907,14 +1236,18 @@ DatabaseManager::ResolvedCategory CategorizationService::categorize_with_cache(
     const std::string& prompt_path,
     FileType file_type,
     const ProgressCallback& progress_callback,
-    const std::string& consistency_context) const
+    const std::string& consistency_context,
+    const std::string& full_path,
+    std::string* content_fingerprint) const
 {
     if (auto cached = try_cached_categorization(display_name,
                                                 display_path,
                                                 prompt_path,
                                                 dir_path,
                                                 file_type,
-                                                progress_callback)) {
+                                                progress_callback,
+                                                full_path,
+                                                content_fingerprint)) {
         const auto display_resolved = localize_resolved_category(llm, *cached);
         emit_progress_message(progress_callback, "CACHE", display_name, display_resolved, display_path, prompt_path);
         return *cached;
@@ -941,96 +1274,231 @@ std::optional<CategorizedFile> CategorizationService::categorize_single_entry(
     const FileEntry& entry,
     const std::optional<PromptOverride>& prompt_override,
     const std::string& suggested_name,
-    std::atomic<bool>& stop_flag,
     const ProgressCallback& progress_callback,
     const RecategorizationCallback& recategorization_callback,
     SessionHistoryMap& session_history) const
 {
-    (void)stop_flag;
+    EntryContext context = build_entry_context(entry, prompt_override, session_history);
+
+    // Remote clients already wait out Retry-After responses; a BackoffError here means they gave up.
+    const DatabaseManager::ResolvedCategory resolved = run_categorization_with_cache(llm,
+                                                                                     is_local_llm,
+                                                                                     entry,
+                                                                                     context.display_path,
+                                                                                     context.dir_path,
+                                                                                     context.prompt_name,
+                                                                                     context.prompt_path_display,
+                                                                                     progress_callback,
+                                                                                     context.combined_context,
+                                                                                     &context.content_fingerprint);
+
+    return finalize_entry(entry,
+                          context,
+                          resolved,
+                          is_local_llm,
+                          suggested_name,
+                          recategorization_callback,
+                          session_history);
+}
 
+CategorizationService::EntryContext CategorizationService::build_entry_context(
+    const FileEntry& entry,
+    const std::optional<PromptOverride>& prompt_override,
+    const SessionHistoryMap& session_history) const
+{
+    EntryContext context;
     const std::filesystem::path entry_path = Utils::utf8_to_path(entry.full_path);
-    const std::string dir_path = Utils::path_to_utf8(entry_path.parent_path());
-    const std::string display_path = Utils::abbreviate_user_path(entry.full_path);
-    const std::string prompt_name = prompt_override ? prompt_override->name : entry.file_name;
+    context.dir_path = Utils::path_to_utf8(entry_path.parent_path());
+    context.display_path = Utils::abbreviate_user_path(entry.full_path);
+    context.prompt_name = prompt_override ? prompt_override->name : entry.file_name;
     const std::string prompt_path = prompt_override ? prompt_override->path : entry.full_path;
-    const std::string prompt_path_display = Utils::abbreviate_user_path(prompt_path);
-    const bool use_consistency_hints = settings.get_use_consistency_hints();
-    const std::string extension = extract_extension(entry.file_name);
-    const std::string signature = make_file_signature(entry.type, extension);
+    context.prompt_path_display = Utils::abbreviate_user_path(prompt_path);
+    context.use_consistency_hints = settings.get_use_consistency_hints();
     std::string hint_block;
-    if (use_consistency_hints) {
+    if (context.use_consistency_hints) {
+        const std::string extension = extract_extension(entry.file_name);
+        const std::string signature = make_file_signature(entry.type, extension);
+        std::lock_guard<std::mutex> lock(storage_mutex);
         const auto hints = collect_consistency_hints(signature, session_history, extension, entry.type);
         hint_block = format_hint_block(hints);
     }
-    const std::string combined_context = build_combined_context(hint_block);
-
-    DatabaseManager::ResolvedCategory resolved;
-    bool retried_after_backoff = false;
-    while (true) {
-        try {
-            resolved = run_categorization_with_cache(llm,
-                                                     is_local_llm,
-                                                     entry,
-                                                     display_path,
-                                                     dir_path,
-                                                     prompt_name,
-                                                     prompt_path_display,
-                                                     progress_callback,
-                                                     combined_context);
-            break;
-        } catch (const BackoffError& backoff) {
-            const int wait_seconds = backoff.retry_after_seconds() > 0 ? backoff.retry_after_seconds() : 60;
-            if (progress_callback) {
-                progress_callback(fmt::format(
-                    "[REMOTE] Rate limit hit. Waiting {}s before retrying {}...",
-                    wait_seconds,
-                    entry.file_name));
-            }
-            if (core_logger) {
-                core_logger->warn("Rate limit hit for '{}'; retrying in {}s", entry.file_name, wait_seconds);
-            }
-            for (int remaining = wait_seconds; remaining > 0; --remaining) {
-                if (stop_flag.load()) {
-                    return std::nullopt;
-                }
-                if (progress_callback && (remaining % 10 == 0 || remaining <= 3)) {
-                    progress_callback(fmt::format("[REMOTE] Retrying {} in {}s...", entry.file_name, remaining));
-                }
-                std::this_thread::sleep_for(std::chrono::seconds(1));
-            }
-            if (retried_after_backoff) {
-                throw;
-            }
-            retried_after_backoff = true;
-        }
-    }
+    context.combined_context = build_combined_context(hint_block);
+    return context;
+}
 
+std::optional<CategorizedFile> CategorizationService::finalize_entry(
+    const FileEntry& entry,
+    const EntryContext& context,
+    const DatabaseManager::ResolvedCategory& resolved,
+    bool is_local_llm,
+    const std::string& suggested_name,
+    const RecategorizationCallback& recategorization_callback,
+    SessionHistoryMap& session_history,
+    std::vector<DatabaseManager::CategorizationRecord>* deferred_writes) const
+{
     if (auto retry = handle_empty_result(entry,
-                                         dir_path,
+                                         context.dir_path,
                                          resolved,
-                                         use_consistency_hints,
+                                         context.use_consistency_hints,
                                          is_local_llm,
                                          recategorization_callback)) {
         return retry;
     }
 
     update_storage_with_result(entry,
-                               dir_path,
+                               context.dir_path,
                                resolved,
-                               use_consistency_hints,
+                               context.use_consistency_hints,
                                suggested_name,
-                               session_history);
-
-    const auto display_resolved = db_manager.localize_category(resolved, settings.get_category_language());
-    CategorizedFile result{dir_path, entry.file_name, entry.type,
+                               context.content_fingerprint,
+                               session_history,
+                               deferred_writes);
+
+    const auto display_resolved = [&] {
+        std::lock_guard<std::mutex> lock(storage_mutex);
+        return db_manager.localize_category(resolved, settings.get_category_language());
+    }();
+    CategorizedFile result{context.dir_path, entry.file_name, entry.type,
                            display_resolved.category, display_resolved.subcategory, resolved.taxonomy_id};
-    result.used_consistency_hints = use_consistency_hints;
+    result.used_consistency_hints = context.use_consistency_hints;
     result.suggested_name = suggested_name;
     result.canonical_category = resolved.category;
     result.canonical_subcategory = resolved.subcategory;
     return result;
 }
 
+std::vector<std::optional<CategorizedFile>> CategorizationService::categorize_entry_batch(
+    ILLMClient& llm,
+    bool is_local_llm,
+    const std::vector<const FileEntry*>& entries,
+    const std::vector<std::optional<PromptOverride>>& prompt_overrides,
+    const std::vector<std::string>& suggested_names,
+    std::atomic<bool>& stop_flag,
+    const ProgressCallback& progress_callback,
+    const RecategorizationCallback& recategorization_callback,
+    SessionHistoryMap& session_history) const
+{
+    std::vector<std::optional<CategorizedFile>> results(entries.size());
+    std::vector<EntryContext> contexts;
+    std::vector<std::optional<DatabaseManager::ResolvedCategory>> resolved(entries.size());
+    std::vector<std::size_t> pending;
+    std::vector<CategorizationRequest> requests;
+    contexts.reserve(entries.size());
+
+    for (std::size_t i = 0; i < entries.size(); ++i) {
+        const FileEntry& entry = *entries[i];
+        contexts.push_back(build_entry_context(entry, prompt_overrides[i], session_history));
+        EntryContext& context = contexts.back();
+        if (auto cached = try_cached_categorization(entry.file_name,
+                                                    context.display_path,
+                                                    context.prompt_path_display,
+                                                    context.dir_path,
+                                                    entry.type,
+                                                    progress_callback,
+                                                    entry.full_path,
+                                                    &context.content_fingerprint)) {
+            const auto display_resolved = localize_resolved_category(llm, *cached);
+            emit_progress_message(progress_callback, "CACHE", entry.file_name, display_resolved,
+                                  context.display_path, context.prompt_path_display);
+            resolved[i] = *cached;
+            continue;
+        }
+        if (!is_local_llm && !ensure_remote_credentials_for_request(entry.file_name, progress_callback)) {
+            resolved[i] = DatabaseManager::ResolvedCategory{-1, "", ""};
+            continue;
+        }
+        pending.push_back(i);
+        requests.push_back(CategorizationRequest{context.prompt_name,
+                                                 context.prompt_path_display,
+                                                 entry.type,
+                                                 context.combined_context});
+    }
+
+    if (!requests.empty()) {
+        // A lone uncached entry goes straight to the single-item request.
+        std::optional<std::vector<std::optional<std::string>>> responses;
+        if (requests.size() > 1 && !stop_flag.load()) {
+            // The whole batch shares one deadline scaled by its size; a timeout aborts like a single request does.
+            const int timeout_seconds = resolve_llm_timeout(is_local_llm) * static_cast<int>(requests.size());
+            auto future = llm.categorize_files_async(requests);
+            if (future.wait_for(std::chrono::seconds(timeout_seconds)) == std::future_status::timeout) {
+                throw std::runtime_error("Timed out waiting for LLM response");
+            }
+
+            try {
+                responses = future.get();
+            } catch (const BackoffError&) {
+                // The client has already waited out any Retry-After it was given. Sending every item on
+                // its own would only hit the same limit harder.
+                throw;
+            } catch (const std::exception& ex) {
+                if (core_logger) {
+                    core_logger->warn("Batched categorization of {} item(s) failed ({}); retrying individually.",
+                                      requests.size(),
+                                      ex.what());
+                }
+            }
+        }
+
+        if (responses && responses->size() != requests.size()) {
+            if (core_logger) {
+                core_logger->warn("Batched categorization returned {} response(s) for {} request(s); retrying individually.",
+                                  responses->size(),
+                                  requests.size());
+            }
+            responses.reset();
+        }
+
+        for (std::size_t k = 0; k < pending.size(); ++k) {
+            const std::size_t i = pending[k];
+            if (responses && (*responses)[k]) {
+                resolved[i] = resolve_llm_response(llm,
+                                                   *(*responses)[k],
+                                                   entries[i]->file_name,
+                                                   contexts[i].display_path,
+                                                   contexts[i].prompt_path_display,
+                                                   progress_callback);
+                continue;
+            }
+            if (stop_flag.load()) {
+                continue;
+            }
+            results[i] = categorize_single_entry(llm,
+                                                 is_local_llm,
+                                                 *entries[i],
+                                                 prompt_overrides[i],
+                                                 suggested_names[i],
+                                                 progress_callback,
+                                                 recategorization_callback,
+                                                 session_history);
+        }
+    }
+
+    // Rows for the whole batch are committed together instead of one transaction per file.
+    std::vector<DatabaseManager::CategorizationRecord> deferred_writes;
+    deferred_writes.reserve(entries.size());
+    for (std::size_t i = 0; i < entries.size(); ++i) {
+        if (!resolved[i]) {
+            continue;
+        }
+        results[i] = finalize_entry(*entries[i],
+                                    contexts[i],
+                                    *resolved[i],
+                                    is_local_llm,
+                                    suggested_names[i],
+                                    recategorization_callback,
+                                    session_history,
+                                    &deferred_writes);
+    }
+    if (!deferred_writes.empty()) {
+        std::lock_guard<std::mutex> lock(storage_mutex);
+        if (!db_manager.insert_or_update_files_with_categorization(deferred_writes) && core_logger) {
+            core_logger->error("Failed to store {} categorization result(s).", deferred_writes.size());
+        }
+    }
+    return results;
+}
+
 std::string CategorizationService::build_combined_context(const std::string& hint_block) const
 {
     std::string combined_context;
@@ -1068,15 +1536,20 @@ DatabaseManager::ResolvedCategory CategorizationService::localize_resolved_categ
         return resolved;
     }
 
-    if (!db_manager.get_category_translation(resolved.taxonomy_id, language)) {
-        if (const auto translated = translate_resolved_category(llm, resolved)) {
-            db_manager.upsert_category_translation(resolved.taxonomy_id,
-                                                  language,
-                                                  translated->category,
-                                                  translated->subcategory);
-        }
-    }
+    const bool has_translation = [&] {
+        std::lock_guard<std::mutex> lock(storage_mutex);
+        return db_manager.get_category_translation(resolved.taxonomy_id, language).has_value();
+    }();
+    // The translation prompt runs unlocked so other workers are not blocked on it.
+    const auto translated = has_translation ? std::nullopt : translate_resolved_category(llm, resolved);
 
+    std::lock_guard<std::mutex> lock(storage_mutex);
+    if (translated) {
+        db_manager.upsert_category_translation(resolved.taxonomy_id,
+                                              language,
+                                              translated->category,
+                                              translated->subcategory);
+    }
     return db_manager.localize_category(resolved, language);
 }
 
@@ -1152,7 +1625,8 @@ DatabaseManager::ResolvedCategory CategorizationService::run_categorization_with
     const std::string& prompt_name,
     const std::string& prompt_path,
     const ProgressCallback& progress_callback,
-    const std::string& combined_context) const
+    const std::string& combined_context,
+    std::string* content_fingerprint) const
 {
     return categorize_with_cache(llm,
                                  is_local_llm,
@@ -1163,7 +1637,9 @@ DatabaseManager::ResolvedCategory CategorizationService::run_categorization_with
                                  prompt_path,
                                  entry.type,
                                  progress_callback,
-                                 combined_context);
+                                 combined_context,
+                                 entry.full_path,
+                                 content_fingerprint);
 }
 
 std::optional<CategorizedFile> CategorizationService::handle_empty_result(
@@ -1187,7 +1663,10 @@ std::optional<CategorizedFile> CategorizationService::handle_empty_result(
         core_logger->warn("{} for '{}'.", reason, entry.file_name);
     }
 
-    db_manager.remove_file_categorization(dir_path, entry.file_name, entry.type);
+    {
+        std::lock_guard<std::mutex> lock(storage_mutex);
+        db_manager.remove_file_categorization(dir_path, entry.file_name, entry.type);
+    }
 
     if (recategorization_callback) {
         CategorizedFile retry_entry{dir_path,
@@ -1207,7 +1686,9 @@ void CategorizationService::update_storage_with_result(const FileEntry& entry,
                                                        const DatabaseManager::ResolvedCategory& resolved,
                                                        bool used_consistency_hints,
                                                        const std::string& suggested_name,
-                                                       SessionHistoryMap& session_history) const
+                                                       const std::string& content_fingerprint,
+                                                       SessionHistoryMap& session_history,
+                                                       std::vector<DatabaseManager::CategorizationRecord>* deferred_writes) const
 {
     if (core_logger) {
         core_logger->info("Categorized '{}' as '{} / {}'.",
@@ -1216,13 +1697,28 @@ void CategorizationService::update_storage_with_result(const FileEntry& entry,
                           resolved.subcategory.empty() ? "<none>" : resolved.subcategory);
     }
 
-    db_manager.insert_or_update_file_with_categorization(
-        entry.file_name,
-        entry.type == FileType::File ? "F" : "D",
-        dir_path,
-        resolved,
-        used_consistency_hints,
-        suggested_name);
+    auto moved_from = collect_moved_rows(entry, dir_path, content_fingerprint);
+    std::lock_guard<std::mutex> lock(storage_mutex);
+    const std::string file_type = entry.type == FileType::File ? "F" : "D";
+    DatabaseManager::CategorizationRecord record{
+        entry.file_name, file_type, dir_path, resolved, used_consistency_hints, suggested_name,
+        false, false, content_fingerprint, std::move(moved_from)};
+    if (deferred_writes) {
+        deferred_writes->push_back(std::move(record));
+    } else if (!record.moved_from.empty()) {
+        db_manager.insert_or_update_files_with_categorization({record});
+    } else {
+        db_manager.insert_or_update_file_with_categorization(
+            entry.file_name,
+            file_type,
+            dir_path,
+            resolved,
+            used_consistency_hints,
+            suggested_name,
+            false,
+            false,
+            content_fingerprint);
+    }
 
     const std::string signature = make_file_signature(entry.type, extract_extension(entry.file_name));
     if (!signature.empty()) {
@@ -1230,6 +1726,35 @@ void CategorizationService::update_storage_with_result(const FileEntry& entry,
     }
 }
 
+std::vector<std::pair<std::string, std::string>> CategorizationService::collect_moved_rows(
+    const FileEntry& entry,
+    const std::string& dir_path,
+    const std::string& content_fingerprint) const
+{
+    std::vector<std::pair<std::string, std::string>> moved_from;
+    if (entry.type != FileType::File || content_fingerprint.empty()) {
+        return moved_from;
+    }
+
+    std::vector<CategorizedFile> matches;
+    {
+        std::lock_guard<std::mutex> lock(storage_mutex);
+        matches = db_manager.find_categorizations_by_fingerprint(content_fingerprint);
+    }
+    for (const auto& match : matches) {
+        if (match.file_path == dir_path && match.file_name == entry.file_name) {
+            continue;
+        }
+        std::error_code ec;
+        const std::filesystem::path previous_path =
+            Utils::utf8_to_path(match.file_path) / Utils::utf8_to_path(match.file_name);
+        if (!std::filesystem::exists(previous_path, ec) && !ec) {
+            moved_from.emplace_back(match.file_path, match.file_name);
+        }
+    }
+    return moved_from;
+}
+
 std::string CategorizationService::run_llm_with_timeout(
     ILLMClient& llm,
     const std::string& item_name,
@@ -1283,6 +1808,29 @@ int CategorizationService::resolve_llm_timeout(bool is_local_llm) const
     return timeout_seconds;
 }
 
+std::size_t CategorizationService::resolve_worker_count(bool is_local_llm, std::size_t item_count) const
+{
+    // Local clients each load their own model, so only remote backends fan out by default.
+    std::size_t workers = is_local_llm ? 1 : kDefaultRemoteWorkers;
+    const char* workers_env = std::getenv(is_local_llm ? kLocalWorkersEnv : kRemoteWorkersEnv);
+    if (workers_env && *workers_env != '\0') {
+        try {
+            const int parsed = std::stoi(workers_env);
+            if (parsed > 0) {
+                workers = static_cast<std::size_t>(parsed);
+            } else if (core_logger) {
+                core_logger->warn("Ignoring non-positive LLM worker count '{}'", workers_env);
+            }
+        } catch (const std::exception& ex) {
+            if (core_logger) {
+                core_logger->warn("Failed to parse LLM worker count '{}': {}", workers_env, ex.what());
+            }
+        }
+    }
+
+    return std::clamp<std::size_t>(workers, 1, std::max<std::size_t>(1, std::min(item_count, kMaxWorkers)));
+}
+
 std::future<std::string> CategorizationService::start_llm_future(
     ILLMClient& llm,
     const std::string& item_name,
@@ -1290,22 +1838,7 @@ std::future<std::string> CategorizationService::start_llm_future(
     FileType file_type,
     const std::string& consistency_context) const
 {
-    auto promise = std::make_shared<std::promise<std::string>>();
-    std::future<std::string> future = promise->get_future();
-
-    std::thread([&llm, promise, item_name, item_path, file_type, consistency_context]() mutable {
-        try {
-            promise->set_value(llm.categorize_file(item_name, item_path, file_type, consistency_context));
-        } catch (...) {
-            try {
-                promise->set_exception(std::current_exception());
-            } catch (...) {
-                // no-op
-            }
-        }
-    }).detach();
-
-    return future;
+    return llm.categorize_file_async(item_name, item_path, file_type, consistency_context);
 }
 
 std::vector<CategorizationService::CategoryPair> CategorizationService::collect_consistency_hints(
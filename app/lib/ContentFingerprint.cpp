@@ -0,0 +1,157 @@
+#include "ContentFingerprint.hpp"
+#include "Utils.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <fstream>
+#include <system_error>
+#include <vector>
+
+#include <fmt/format.h>
+
+namespace {
+
+constexpr std::uint64_t kPrime1 = 0x9E3779B185EBCA87ULL;
+constexpr std::uint64_t kPrime2 = 0xC2B2AE3D27D4EB4FULL;
+constexpr std::uint64_t kPrime3 = 0x165667B19E3779F9ULL;
+constexpr std::uint64_t kPrime4 = 0x85EBCA77C2B2AE63ULL;
+constexpr std::uint64_t kPrime5 = 0x27D4EB2F165667C5ULL;
+
+constexpr std::uint64_t rotl(std::uint64_t value, int bits)
+{
+    return (value << bits) | (value >> (64 - bits));
+}
+
+std::uint64_t read64(const unsigned char* p)
+{
+    std::uint64_t value = 0;
+    for (int i = 7; i >= 0; --i) {
+        value = (value << 8) | p[i];
+    }
+    return value;
+}
+
+std::uint32_t read32(const unsigned char* p)
+{
+    return static_cast<std::uint32_t>(p[0]) | (static_cast<std::uint32_t>(p[1]) << 8) |
+           (static_cast<std::uint32_t>(p[2]) << 16) | (static_cast<std::uint32_t>(p[3]) << 24);
+}
+
+std::uint64_t xxh_round(std::uint64_t acc, std::uint64_t input)
+{
+    acc += input * kPrime2;
+    acc = rotl(acc, 31);
+    return acc * kPrime1;
+}
+
+std::uint64_t merge_round(std::uint64_t acc, std::uint64_t value)
+{
+    acc ^= xxh_round(0, value);
+    return acc * kPrime1 + kPrime4;
+}
+
+bool read_exact(std::ifstream& in, unsigned char* out, std::size_t size)
+{
+    in.read(reinterpret_cast<char*>(out), static_cast<std::streamsize>(size));
+    return static_cast<std::size_t>(in.gcount()) == size;
+}
+
+} // namespace
+
+std::uint64_t ContentFingerprint::xxh64(const void* data, std::size_t size, std::uint64_t seed)
+{
+    const auto* p = static_cast<const unsigned char*>(data);
+    const unsigned char* const end = p + size;
+    std::uint64_t hash = 0;
+
+    if (size >= 32) {
+        std::uint64_t v1 = seed + kPrime1 + kPrime2;
+        std::uint64_t v2 = seed + kPrime2;
+        std::uint64_t v3 = seed;
+        std::uint64_t v4 = seed - kPrime1;
+        const unsigned char* const limit = end - 32;
+        do {
+            v1 = xxh_round(v1, read64(p));
+            v2 = xxh_round(v2, read64(p + 8));
+            v3 = xxh_round(v3, read64(p + 16));
+            v4 = xxh_round(v4, read64(p + 24));
+            p += 32;
+        } while (p <= limit);
+        hash = rotl(v1, 1) + rotl(v2, 7) + rotl(v3, 12) + rotl(v4, 18);
+        hash = merge_round(hash, v1);
+        hash = merge_round(hash, v2);
+        hash = merge_round(hash, v3);
+        hash = merge_round(hash, v4);
+    } else {
+        hash = seed + kPrime5;
+    }
+    hash += static_cast<std::uint64_t>(size);
+
+    for (; p + 8 <= end; p += 8) {
+        hash ^= xxh_round(0, read64(p));
+        hash = rotl(hash, 27) * kPrime1 + kPrime4;
+    }
+    if (p + 4 <= end) {
+        hash ^= static_cast<std::uint64_t>(read32(p)) * kPrime1;
+        hash = rotl(hash, 23) * kPrime2 + kPrime3;
+        p += 4;
+    }
+    for (; p < end; ++p) {
+        hash ^= static_cast<std::uint64_t>(*p) * kPrime5;
+        hash = rotl(hash, 11) * kPrime1;
+    }
+
+    hash ^= hash >> 33;
+    hash *= kPrime2;
+    hash ^= hash >> 29;
+    hash *= kPrime3;
+    hash ^= hash >> 32;
+    return hash;
+}
+
+std::optional<std::string> ContentFingerprint::compute(const std::string& path)
+{
+    const std::filesystem::path file_path = Utils::utf8_to_path(path);
+    std::error_code ec;
+    const std::uintmax_t size = std::filesystem::file_size(file_path, ec);
+    if (ec || size < kMinFileBytes) {
+        return std::nullopt;
+    }
+
+    std::ifstream in(file_path, std::ios::binary);
+    if (!in) {
+        return std::nullopt;
+    }
+
+    // Head and tail only; they overlap entirely for files up to twice the sample size.
+    const std::size_t head_bytes = static_cast<std::size_t>(std::min<std::uintmax_t>(size, kSampleBytes));
+    const std::uintmax_t tail_start = std::max<std::uintmax_t>(head_bytes, size > kSampleBytes ? size - kSampleBytes : 0);
+    const std::size_t tail_bytes = static_cast<std::size_t>(size - tail_start);
+
+    std::vector<unsigned char> buffer(head_bytes + tail_bytes);
+    if (!read_exact(in, buffer.data(), head_bytes)) {
+        return std::nullopt;
+    }
+    if (tail_bytes > 0) {
+        in.seekg(static_cast<std::streamoff>(tail_start));
+        if (!read_exact(in, buffer.data() + head_bytes, tail_bytes)) {
+            return std::nullopt;
+        }
+    }
+
+    return fmt::format("{:x}-{:016x}", size, xxh64(buffer.data(), buffer.size(), size));
+}
+
+bool ContentFingerprint::enabled()
+{
+    const char* value = std::getenv("AI_FILE_SORTER_CONTENT_FINGERPRINT");
+    if (!value || value[0] == '\0') {
+        return true;
+    }
+    std::string lowered(value);
+    std::transform(lowered.begin(), lowered.end(), lowered.begin(), [](unsigned char c) {
+        return static_cast<char>(std::tolower(c));
+    });
+    return lowered != "0" && lowered != "false" && lowered != "off" && lowered != "no";
+}
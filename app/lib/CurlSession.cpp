@@ -0,0 +1,200 @@
+#include "CurlSession.hpp"
+
+#include "Logger.hpp"
+#include "Utils.hpp"
+
+#include <spdlog/spdlog.h>
+
+#include <algorithm>
+#include <array>
+#include <cctype>
+#include <cstdlib>
+#include <stdexcept>
+#include <string_view>
+#include <utility>
+
+namespace {
+
+size_t WriteCallback(void* contents, size_t size, size_t nmemb, std::string* response)
+{
+    const size_t total_size = size * nmemb;
+    response->append(static_cast<const char*>(contents), total_size);
+    return total_size;
+}
+
+// Captures "Retry-After: <seconds>" headers; HTTP-date values are ignored.
+size_t HeaderCallback(char* buffer, size_t size, size_t nitems, CurlSession::Response* response)
+{
+    const size_t total_size = size * nitems;
+    static constexpr std::string_view kRetryAfter = "retry-after:";
+    if (total_size > kRetryAfter.size()) {
+        bool matches = true;
+        for (size_t i = 0; i < kRetryAfter.size(); ++i) {
+            if (std::tolower(static_cast<unsigned char>(buffer[i])) != kRetryAfter[i]) {
+                matches = false;
+                break;
+            }
+        }
+        if (matches) {
+            const std::string value(buffer + kRetryAfter.size(), total_size - kRetryAfter.size());
+            char* end = nullptr;
+            const long seconds = std::strtol(value.c_str(), &end, 10);
+            if (end != value.c_str() && seconds > 0) {
+                response->retry_after_seconds = static_cast<int>(std::min<long>(seconds, 3600));
+            }
+        }
+    }
+    return total_size;
+}
+
+std::array<std::mutex, CURL_LOCK_DATA_LAST>& share_locks()
+{
+    static std::array<std::mutex, CURL_LOCK_DATA_LAST> locks;
+    return locks;
+}
+
+void lock_share(CURL*, curl_lock_data data, curl_lock_access, void*)
+{
+    share_locks()[static_cast<std::size_t>(data)].lock();
+}
+
+void unlock_share(CURL*, curl_lock_data data, void*)
+{
+    share_locks()[static_cast<std::size_t>(data)].unlock();
+}
+
+// Process-wide DNS and TLS-session cache shared by every session. Connections are not
+// shared: curl does not support using one connection pool from several threads, so each
+// session's easy handle and the request engine's multi handle keep their own.
+CURLSH* shared_cache()
+{
+    static CURLSH* share = [] {
+        CURLSH* handle = curl_share_init();
+        if (!handle) {
+            return handle;
+        }
+        curl_share_setopt(handle, CURLSHOPT_LOCKFUNC, lock_share);
+        curl_share_setopt(handle, CURLSHOPT_UNLOCKFUNC, unlock_share);
+        curl_share_setopt(handle, CURLSHOPT_SHARE, CURL_LOCK_DATA_DNS);
+        curl_share_setopt(handle, CURLSHOPT_SHARE, CURL_LOCK_DATA_SSL_SESSION);
+        return handle;
+    }();
+    return share;
+}
+
+struct HeaderList {
+    curl_slist* list{nullptr};
+    ~HeaderList()
+    {
+        if (list) {
+            curl_slist_free_all(list);
+        }
+    }
+};
+
+} // namespace
+
+CurlSession::CurlSession(std::string log_label)
+    : log_label_(std::move(log_label))
+{
+}
+
+CurlSession::~CurlSession()
+{
+    if (handle_) {
+        curl_easy_cleanup(handle_);
+    }
+}
+
+CURL* CurlSession::acquire_handle()
+{
+    if (!handle_) {
+        handle_ = curl_easy_init();
+        if (!handle_) {
+            if (auto logger = Logger::get_logger("core_logger")) {
+                logger->critical("Failed to initialize cURL handle for {} request", log_label_);
+            }
+            throw std::runtime_error("Initialization Error: Failed to initialize cURL.");
+        }
+    } else {
+        // Drops per-request options but keeps the handle's live connections and caches.
+        curl_easy_reset(handle_);
+    }
+
+    apply_connection_defaults(handle_);
+    return handle_;
+}
+
+void CurlSession::apply_connection_defaults(CURL* handle)
+{
+#ifdef _WIN32
+    try {
+        const auto cert_path = Utils::ensure_ca_bundle();
+        curl_easy_setopt(handle, CURLOPT_CAINFO, cert_path.string().c_str());
+    } catch (const std::exception& ex) {
+        throw std::runtime_error(std::string("Failed to stage CA bundle: ") + ex.what());
+    }
+#endif
+
+    if (CURLSH* share = shared_cache()) {
+        curl_easy_setopt(handle, CURLOPT_SHARE, share);
+    }
+    curl_easy_setopt(handle, CURLOPT_HTTP_VERSION, static_cast<long>(CURL_HTTP_VERSION_2TLS));
+    curl_easy_setopt(handle, CURLOPT_PIPEWAIT, 1L);
+    curl_easy_setopt(handle, CURLOPT_TCP_KEEPALIVE, 1L);
+    curl_easy_setopt(handle, CURLOPT_NOSIGNAL, 1L);
+}
+
+void CurlSession::bind_response(CURL* handle, Response& response)
+{
+    curl_easy_setopt(handle, CURLOPT_WRITEFUNCTION, WriteCallback);
+    curl_easy_setopt(handle, CURLOPT_WRITEDATA, &response.body);
+    curl_easy_setopt(handle, CURLOPT_HEADERFUNCTION, HeaderCallback);
+    curl_easy_setopt(handle, CURLOPT_HEADERDATA, &response);
+}
+
+CurlSession::Response CurlSession::post_json(const std::string& url,
+                                             const std::string& payload,
+                                             const std::vector<std::string>& headers,
+                                             long timeout_seconds)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    CURL* handle = acquire_handle();
+
+    Response response;
+    HeaderList header_list;
+    header_list.list = curl_slist_append(header_list.list, "Content-Type: application/json");
+    for (const auto& header : headers) {
+        header_list.list = curl_slist_append(header_list.list, header.c_str());
+    }
+
+    curl_easy_setopt(handle, CURLOPT_URL, url.c_str());
+    curl_easy_setopt(handle, CURLOPT_POST, 1L);
+    curl_easy_setopt(handle, CURLOPT_TIMEOUT, timeout_seconds);
+    curl_easy_setopt(handle, CURLOPT_HTTPHEADER, header_list.list);
+    curl_easy_setopt(handle, CURLOPT_POSTFIELDS, payload.c_str());
+    curl_easy_setopt(handle, CURLOPT_POSTFIELDSIZE_LARGE, static_cast<curl_off_t>(payload.size()));
+    bind_response(handle, response);
+
+    const CURLcode res = curl_easy_perform(handle);
+    if (res != CURLE_OK) {
+        if (auto logger = Logger::get_logger("core_logger")) {
+            logger->error("cURL request failed: {}", curl_easy_strerror(res));
+        }
+        // The connection may be half-broken; start the next request from a fresh handle.
+        curl_easy_cleanup(handle_);
+        handle_ = nullptr;
+        throw std::runtime_error("Network Error: " + std::string(curl_easy_strerror(res)));
+    }
+
+    curl_easy_getinfo(handle, CURLINFO_RESPONSE_CODE, &response.http_code);
+    if (auto logger = Logger::get_logger("core_logger")) {
+        long new_connections = 0;
+        curl_easy_getinfo(handle, CURLINFO_NUM_CONNECTS, &new_connections);
+        logger->debug("{} request completed with HTTP {} ({})",
+                      log_label_,
+                      response.http_code,
+                      new_connections == 0 ? "reused connection" : "new connection");
+    }
+    return response;
+}
@@ -6,9 +6,11 @@
 #include <algorithm>
 #include <cctype>
 #include <cmath>
+#include <cstdint>
 #include <cstdio>
 #include <iostream>
 #include <memory>
+#include <mutex>
 #include <optional>
 #include <sstream>
 #include <unordered_set>
@@ -63,23 +65,10 @@ std::string extract_extension_lower(const std::string& file_name) {
     return to_lower_copy(ext);
 }
 
-struct StatementDeleter {
-    void operator()(sqlite3_stmt* stmt) const {
-        if (stmt) {
-            sqlite3_finalize(stmt);
-        }
-    }
-};
-
-using StatementPtr = std::unique_ptr<sqlite3_stmt, StatementDeleter>;
-
-StatementPtr prepare_statement(sqlite3* db, const char* sql) {
-    sqlite3_stmt* raw = nullptr;
-    if (sqlite3_prepare_v2(db, sql, -1, &raw, nullptr) != SQLITE_OK) {
-        return StatementPtr{};
-    }
-    return StatementPtr(raw);
-}
+// Page cache in KiB (negative value for PRAGMA cache_size) and memory-mapped I/O window.
+constexpr int kCacheSizeKiB = 16 * 1024;
+constexpr long long kMmapSizeBytes = 256LL * 1024 * 1024;
+constexpr int kBusyTimeoutMs = 5000;
 
 std::string trim_copy(std::string value) {
     auto not_space = [](unsigned char ch) { return !std::isspace(ch); };
@@ -92,34 +81,44 @@ bool has_label_content(const std::string& value) {
     return !trim_copy(value).empty();
 }
 
-std::string escape_like_pattern(const std::string& value) {
-    std::string escaped;
-    escaped.reserve(value.size() * 2);
-    for (char ch : value) {
-        if (ch == '\\' || ch == '%' || ch == '_') {
-            escaped.push_back('\\');
+// Bounds of a directory subtree under the BINARY collation of dir_path: every descendant
+// sorts in [lower, upper), so the query is an index range scan instead of a LIKE table scan.
+struct DirectorySubtreeRange {
+    std::string lower;
+    std::optional<std::string> upper;
+};
+
+DirectorySubtreeRange build_directory_subtree_range(const std::string& directory_path) {
+    DirectorySubtreeRange range;
+    range.lower = directory_path;
+    if (!directory_path.empty()) {
+        const char sep = directory_path.find('\\') != std::string::npos ? '\\' : '/';
+        if (directory_path.back() != sep) {
+            range.lower.push_back(sep);
         }
-        escaped.push_back(ch);
     }
-    return escaped;
-}
 
-std::string build_recursive_dir_pattern(const std::string& directory_path) {
-    std::string escaped = escape_like_pattern(directory_path);
-    if (directory_path.empty()) {
-        return escaped + "%";
+    std::string upper = range.lower;
+    while (!upper.empty() && static_cast<unsigned char>(upper.back()) == 0xFF) {
+        upper.pop_back();
     }
-    const char sep = directory_path.find('\\') != std::string::npos ? '\\' : '/';
-    if (directory_path.back() == sep) {
-        escaped.push_back('%');
-        return escaped;
+    if (!upper.empty()) {
+        upper.back() = static_cast<char>(static_cast<unsigned char>(upper.back()) + 1);
+        range.upper = std::move(upper);
     }
-    if (sep == '\\' || sep == '%' || sep == '_') {
-        escaped.push_back('\\');
+    return range;
+}
+
+// Binds the exact directory and its subtree range starting at @p first_index; returns the next free index.
+int bind_directory_subtree(sqlite3_stmt* stmt, int first_index, const std::string& directory_path,
+                           const DirectorySubtreeRange& range) {
+    sqlite3_bind_text(stmt, first_index, directory_path.c_str(), -1, SQLITE_TRANSIENT);
+    sqlite3_bind_text(stmt, first_index + 1, range.lower.c_str(), -1, SQLITE_TRANSIENT);
+    if (range.upper) {
+        sqlite3_bind_text(stmt, first_index + 2, range.upper->c_str(), -1, SQLITE_TRANSIENT);
+        return first_index + 3;
     }
-    escaped.push_back(sep);
-    escaped.push_back('%');
-    return escaped;
+    return first_index + 2;
 }
 
 std::optional<CategorizedFile> build_categorized_entry(sqlite3_stmt* stmt) {
@@ -177,6 +176,101 @@ std::optional<CategorizedFile> build_categorized_entry(sqlite3_stmt* stmt) {
 
 } // namespace
 
+class DatabaseManager::StatementCache {
+public:
+    struct Slot {
+        sqlite3_stmt* stmt{nullptr};
+        bool in_use{false};
+    };
+
+    explicit StatementCache(sqlite3* db) : db_(db) {}
+
+    ~StatementCache() {
+        for (auto& [sql, slot] : slots_) {
+            sqlite3_finalize(slot.stmt);
+        }
+    }
+
+    StatementCache(const StatementCache&) = delete;
+    StatementCache& operator=(const StatementCache&) = delete;
+
+    CachedStatement acquire(const char* sql);
+
+    void release(Slot* slot) {
+        sqlite3_reset(slot->stmt);
+        sqlite3_clear_bindings(slot->stmt);
+        std::lock_guard<std::mutex> lock(mutex_);
+        slot->in_use = false;
+    }
+
+private:
+    sqlite3* db_;
+    std::mutex mutex_;
+    std::unordered_map<std::string, Slot> slots_;
+};
+
+class DatabaseManager::CachedStatement {
+public:
+    CachedStatement() = default;
+    CachedStatement(StatementCache* cache, StatementCache::Slot* slot)
+        : cache_(cache), slot_(slot), stmt_(slot->stmt) {}
+    explicit CachedStatement(sqlite3_stmt* owned)
+        : stmt_(owned) {}
+
+    ~CachedStatement() {
+        if (slot_) {
+            cache_->release(slot_);
+        } else if (stmt_) {
+            sqlite3_finalize(stmt_);
+        }
+    }
+
+    CachedStatement(CachedStatement&& other) noexcept
+        : cache_(std::exchange(other.cache_, nullptr)),
+          slot_(std::exchange(other.slot_, nullptr)),
+          stmt_(std::exchange(other.stmt_, nullptr)) {}
+    CachedStatement(const CachedStatement&) = delete;
+    CachedStatement& operator=(const CachedStatement&) = delete;
+    CachedStatement& operator=(CachedStatement&&) = delete;
+
+    sqlite3_stmt* get() const { return stmt_; }
+    explicit operator bool() const { return stmt_ != nullptr; }
+
+private:
+    StatementCache* cache_{nullptr};
+    StatementCache::Slot* slot_{nullptr};
+    sqlite3_stmt* stmt_{nullptr};
+};
+
+DatabaseManager::CachedStatement DatabaseManager::StatementCache::acquire(const char* sql) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        Slot& slot = slots_[sql];
+        if (slot.stmt && !slot.in_use) {
+            slot.in_use = true;
+            return CachedStatement(this, &slot);
+        }
+        if (!slot.stmt) {
+            if (sqlite3_prepare_v3(db_, sql, -1, SQLITE_PREPARE_PERSISTENT, &slot.stmt, nullptr) != SQLITE_OK) {
+                sqlite3_finalize(slot.stmt);
+                slot.stmt = nullptr;
+                slots_.erase(sql);
+                return CachedStatement();
+            }
+            slot.in_use = true;
+            return CachedStatement(this, &slot);
+        }
+    }
+
+    // The cached copy is busy (e.g. a nested call issues the same query); use a one-off statement.
+    sqlite3_stmt* raw = nullptr;
+    if (sqlite3_prepare_v2(db_, sql, -1, &raw, nullptr) != SQLITE_OK) {
+        sqlite3_finalize(raw);
+        return CachedStatement();
+    }
+    return CachedStatement(raw);
+}
+
 DatabaseManager::DatabaseManager(std::string config_dir)
     : db(nullptr),
       config_dir(std::move(config_dir)),
@@ -196,20 +290,61 @@ DatabaseManager::DatabaseManager(std::string config_dir)
     }
 
     sqlite3_extended_result_codes(db, 1);
+    configure_connection();
+    statement_cache = std::make_unique<StatementCache>(db);
 
     initialize_schema();
     initialize_taxonomy_schema();
+    initialize_scan_snapshot_schema();
+    initialize_document_analysis_schema();
     load_taxonomy_cache();
     load_translation_cache();
+    open_snapshot_connection();
 }
 
 DatabaseManager::~DatabaseManager() {
+    if (snapshot_db) {
+        sqlite3_close(snapshot_db);
+        snapshot_db = nullptr;
+    }
+    statement_cache.reset();
     if (db) {
         sqlite3_close(db);
         db = nullptr;
     }
 }
 
+void DatabaseManager::configure_connection() {
+    if (!db) return;
+
+    sqlite3_busy_timeout(db, kBusyTimeoutMs);
+
+    // WAL lets readers proceed during writes and, with synchronous=NORMAL, only syncs at checkpoints.
+    const std::string pragmas = fmt::format(
+        "PRAGMA journal_mode=WAL;"
+        "PRAGMA synchronous=NORMAL;"
+        "PRAGMA temp_store=MEMORY;"
+        "PRAGMA cache_size=-{};"
+        "PRAGMA mmap_size={};",
+        kCacheSizeKiB,
+        kMmapSizeBytes);
+
+    char *error_msg = nullptr;
+    if (sqlite3_exec(db, pragmas.c_str(), nullptr, nullptr, &error_msg) != SQLITE_OK) {
+        db_log(spdlog::level::warn, "Failed to apply database tuning pragmas: {}", error_msg ? error_msg : "");
+        if (error_msg) {
+            sqlite3_free(error_msg);
+        }
+    }
+}
+
+DatabaseManager::CachedStatement DatabaseManager::prepare_cached(const char* sql) const {
+    if (!statement_cache) {
+        return CachedStatement();
+    }
+    return statement_cache->acquire(sql);
+}
+
 void DatabaseManager::initialize_schema() {
     if (!db) return;
 
@@ -291,12 +426,111 @@ void DatabaseManager::initialize_schema() {
         }
     }
 
+    const char *add_extension_column_sql =
+        "ALTER TABLE file_categorization ADD COLUMN extension TEXT;";
+    if (sqlite3_exec(db, add_extension_column_sql, nullptr, nullptr, &error_msg) != SQLITE_OK) {
+        if (!is_duplicate_column_error(error_msg)) {
+            db_log(spdlog::level::warn, "Failed to add extension column: {}", error_msg ? error_msg : "");
+        }
+        if (error_msg) {
+            sqlite3_free(error_msg);
+        }
+    }
+    backfill_file_extensions();
+
+    const char *create_extension_index_sql =
+        "CREATE INDEX IF NOT EXISTS idx_file_categorization_extension "
+        "ON file_categorization(file_type, extension, timestamp);";
+    if (sqlite3_exec(db, create_extension_index_sql, nullptr, nullptr, &error_msg) != SQLITE_OK) {
+        db_log(spdlog::level::err, "Failed to create extension index: {}", error_msg);
+        sqlite3_free(error_msg);
+    }
+
     const char *create_index_sql =
         "CREATE INDEX IF NOT EXISTS idx_file_categorization_taxonomy ON file_categorization(taxonomy_id);";
     if (sqlite3_exec(db, create_index_sql, nullptr, nullptr, &error_msg) != SQLITE_OK) {
         db_log(spdlog::level::err, "Failed to create taxonomy index: {}", error_msg);
         sqlite3_free(error_msg);
     }
+
+    // Lookups by directory and subtree range scans; the UNIQUE index leads with file_name.
+    const char *create_dir_index_sql =
+        "CREATE INDEX IF NOT EXISTS idx_file_categorization_dir ON file_categorization(dir_path);";
+    if (sqlite3_exec(db, create_dir_index_sql, nullptr, nullptr, &error_msg) != SQLITE_OK) {
+        db_log(spdlog::level::err, "Failed to create directory index: {}", error_msg);
+        sqlite3_free(error_msg);
+    }
+
+    const char *add_fingerprint_column_sql =
+        "ALTER TABLE file_categorization ADD COLUMN content_fingerprint TEXT;";
+    if (sqlite3_exec(db, add_fingerprint_column_sql, nullptr, nullptr, &error_msg) != SQLITE_OK) {
+        if (!is_duplicate_column_error(error_msg)) {
+            db_log(spdlog::level::warn, "Failed to add content_fingerprint column: {}", error_msg ? error_msg : "");
+        }
+        if (error_msg) {
+            sqlite3_free(error_msg);
+        }
+    }
+
+    // Partial: rows without a fingerprint (directories, small or older files) stay out of the index.
+    const char *create_fingerprint_index_sql =
+        "CREATE INDEX IF NOT EXISTS idx_file_categorization_fingerprint "
+        "ON file_categorization(content_fingerprint, timestamp) WHERE content_fingerprint IS NOT NULL;";
+    if (sqlite3_exec(db, create_fingerprint_index_sql, nullptr, nullptr, &error_msg) != SQLITE_OK) {
+        db_log(spdlog::level::err, "Failed to create content fingerprint index: {}", error_msg);
+        sqlite3_free(error_msg);
+    }
+}
+
+void DatabaseManager::backfill_file_extensions() {
+    if (!db) return;
+
+    std::vector<std::pair<sqlite3_int64, std::string>> pending;
+    sqlite3_stmt *stmt = nullptr;
+    const char *select_sql =
+        "SELECT id, file_name FROM file_categorization WHERE file_type IN ('F', 'D') AND extension IS NULL;";
+    if (sqlite3_prepare_v2(db, select_sql, -1, &stmt, nullptr) != SQLITE_OK) {
+        db_log(spdlog::level::warn, "Failed to query rows without an extension: {}", sqlite3_errmsg(db));
+        sqlite3_finalize(stmt);
+        return;
+    }
+    while (sqlite3_step(stmt) == SQLITE_ROW) {
+        const char *file_name = reinterpret_cast<const char *>(sqlite3_column_text(stmt, 1));
+        pending.emplace_back(sqlite3_column_int64(stmt, 0), file_name ? file_name : "");
+    }
+    sqlite3_finalize(stmt);
+    if (pending.empty()) {
+        return;
+    }
+
+    if (!execute_statement("BEGIN IMMEDIATE;", "begin extension backfill")) {
+        return;
+    }
+    const char *update_sql = "UPDATE file_categorization SET extension = ? WHERE id = ?;";
+    bool success = true;
+    {
+        CachedStatement statement = prepare_cached(update_sql);
+        sqlite3_stmt *update = statement.get();
+        success = update != nullptr;
+        for (const auto& [id, file_name] : pending) {
+            if (!success) {
+                break;
+            }
+            const std::string extension = extract_extension_lower(file_name);
+            sqlite3_bind_text(update, 1, extension.c_str(), -1, SQLITE_TRANSIENT);
+            sqlite3_bind_int64(update, 2, id);
+            success = sqlite3_step(update) == SQLITE_DONE;
+            sqlite3_reset(update);
+        }
+    }
+    if (!success) {
+        db_log(spdlog::level::warn, "Failed to backfill file extensions: {}", sqlite3_errmsg(db));
+        execute_statement("ROLLBACK;", "roll back extension backfill");
+        return;
+    }
+    if (execute_statement("COMMIT;", "commit extension backfill")) {
+        db_log(spdlog::level::info, "Backfilled extensions for {} cached categorization(s)", pending.size());
+    }
 }
 
 void DatabaseManager::initialize_taxonomy_schema() {
@@ -368,11 +602,103 @@ void DatabaseManager::initialize_taxonomy_schema() {
     }
 }
 
+void DatabaseManager::initialize_scan_snapshot_schema() {
+    if (!db) return;
+
+    // Directory paths are stored once per directory; children reference them by id.
+    const char *snapshot_sql = R"(
+        CREATE TABLE IF NOT EXISTS scan_snapshot (
+            id INTEGER PRIMARY KEY AUTOINCREMENT,
+            root_path TEXT NOT NULL,
+            scan_options INTEGER NOT NULL,
+            scanned_at INTEGER NOT NULL,
+            UNIQUE(root_path, scan_options)
+        );
+        CREATE TABLE IF NOT EXISTS scan_snapshot_directory (
+            id INTEGER PRIMARY KEY AUTOINCREMENT,
+            snapshot_id INTEGER NOT NULL,
+            dir_path TEXT NOT NULL,
+            mtime_ns INTEGER NOT NULL,
+            inode INTEGER NOT NULL,
+            child_count INTEGER NOT NULL,
+            UNIQUE(snapshot_id, dir_path),
+            FOREIGN KEY(snapshot_id) REFERENCES scan_snapshot(id)
+        );
+        CREATE TABLE IF NOT EXISTS scan_snapshot_entry (
+            directory_id INTEGER NOT NULL,
+            position INTEGER NOT NULL,
+            file_name TEXT NOT NULL,
+            file_type TEXT,
+            descend INTEGER NOT NULL DEFAULT 0,
+            inode INTEGER NOT NULL DEFAULT 0,
+            PRIMARY KEY(directory_id, position),
+            FOREIGN KEY(directory_id) REFERENCES scan_snapshot_directory(id)
+        ) WITHOUT ROWID;
+    )";
+
+    char *error_msg = nullptr;
+    if (sqlite3_exec(db, snapshot_sql, nullptr, nullptr, &error_msg) != SQLITE_OK) {
+        db_log(spdlog::level::err, "Failed to create scan snapshot tables: {}", error_msg ? error_msg : "");
+        if (error_msg) {
+            sqlite3_free(error_msg);
+        }
+    }
+}
+
+void DatabaseManager::initialize_document_analysis_schema() {
+    if (!db) return;
+
+    // Document summaries and rename suggestions, reused while the file stays unchanged.
+    const char *document_sql = R"(
+        CREATE TABLE IF NOT EXISTS document_analysis_cache (
+            file_path TEXT PRIMARY KEY,
+            file_size INTEGER NOT NULL,
+            mtime_ns INTEGER NOT NULL,
+            content_fingerprint TEXT,
+            excerpt_hash TEXT NOT NULL,
+            summary TEXT NOT NULL,
+            suggested_name TEXT NOT NULL,
+            updated_at DATETIME DEFAULT CURRENT_TIMESTAMP
+        );
+    )";
+
+    char *error_msg = nullptr;
+    if (sqlite3_exec(db, document_sql, nullptr, nullptr, &error_msg) != SQLITE_OK) {
+        db_log(spdlog::level::err, "Failed to create document_analysis_cache table: {}", error_msg ? error_msg : "");
+        if (error_msg) {
+            sqlite3_free(error_msg);
+        }
+    }
+}
+
+void DatabaseManager::open_snapshot_connection() {
+    if (!db) return;
+
+    if (sqlite3_open(db_file.c_str(), &snapshot_db) != SQLITE_OK) {
+        db_log(spdlog::level::warn, "Can't open scan snapshot connection: {}", sqlite3_errmsg(snapshot_db));
+        sqlite3_close(snapshot_db);
+        snapshot_db = nullptr;
+        return;
+    }
+    sqlite3_extended_result_codes(snapshot_db, 1);
+    sqlite3_busy_timeout(snapshot_db, kBusyTimeoutMs);
+
+    char *error_msg = nullptr;
+    if (sqlite3_exec(snapshot_db, "PRAGMA synchronous=NORMAL; PRAGMA temp_store=MEMORY;",
+                     nullptr, nullptr, &error_msg) != SQLITE_OK) {
+        db_log(spdlog::level::warn, "Failed to tune scan snapshot connection: {}", error_msg ? error_msg : "");
+        if (error_msg) {
+            sqlite3_free(error_msg);
+        }
+    }
+}
+
 void DatabaseManager::load_taxonomy_cache() {
     taxonomy_entries.clear();
     canonical_lookup.clear();
     alias_lookup.clear();
     taxonomy_index.clear();
+    taxonomy_match_index.clear();
 
     if (!db) return;
 
@@ -391,6 +717,9 @@ void DatabaseManager::load_taxonomy_cache() {
             entry.normalized_subcategory = reinterpret_cast<const char *>(sqlite3_column_text(stmt, 4));
 
             taxonomy_index[entry.id] = taxonomy_entries.size();
+            taxonomy_match_index.insert(taxonomy_entries.size(),
+                                        entry.normalized_category,
+                                        entry.normalized_subcategory);
             taxonomy_entries.push_back(entry);
             canonical_lookup[make_key(entry.normalized_category, entry.normalized_subcategory)] = entry.id;
         }
@@ -656,33 +985,7 @@ CanonicalCategoryLabel canonicalize_category_label(const std::string& normalized
 }
 
 double DatabaseManager::string_similarity(const std::string &a, const std::string &b) {
-    if (a == b) {
-        return 1.0;
-    }
-    if (a.empty() || b.empty()) {
-        return 0.0;
-    }
-
-    const size_t m = a.size();
-    const size_t n = b.size();
-    std::vector<size_t> prev(n + 1), curr(n + 1);
-
-    for (size_t j = 0; j <= n; ++j) {
-        prev[j] = j;
-    }
-
-    for (size_t i = 1; i <= m; ++i) {
-        curr[0] = i;
-        for (size_t j = 1; j <= n; ++j) {
-            size_t cost = (a[i - 1] == b[j - 1]) ? 0 : 1;
-            curr[j] = std::min({prev[j] + 1, curr[j - 1] + 1, prev[j - 1] + cost});
-        }
-        std::swap(prev, curr);
-    }
-
-    const double dist = static_cast<double>(prev[n]);
-    const double max_len = static_cast<double>(std::max(m, n));
-    return 1.0 - (dist / max_len);
+    return TaxonomyMatchIndex::similarity(a, b);
 }
 
 std::string DatabaseManager::make_key(const std::string &norm_category,
@@ -702,8 +1005,9 @@ int DatabaseManager::create_taxonomy_entry(const std::string &category,
         VALUES (?, ?, ?, ?, 0);
     )";
 
-    sqlite3_stmt *stmt = nullptr;
-    if (sqlite3_prepare_v2(db, sql, -1, &stmt, nullptr) != SQLITE_OK) {
+    CachedStatement statement = prepare_cached(sql);
+    sqlite3_stmt* stmt = statement.get();
+    if (!stmt) {
         db_log(spdlog::level::err, "Failed to prepare taxonomy insert: {}", sqlite3_errmsg(db));
         return -1;
     }
@@ -715,7 +1019,6 @@ int DatabaseManager::create_taxonomy_entry(const std::string &category,
 
     int step_rc = sqlite3_step(stmt);
     int extended_rc = sqlite3_extended_errcode(db);
-    sqlite3_finalize(stmt);
 
     if (step_rc != SQLITE_DONE) {
         if (extended_rc == SQLITE_CONSTRAINT_UNIQUE ||
@@ -731,6 +1034,7 @@ int DatabaseManager::create_taxonomy_entry(const std::string &category,
     int new_id = static_cast<int>(sqlite3_last_insert_rowid(db));
     TaxonomyEntry entry{new_id, category, subcategory, norm_category, norm_subcategory};
     taxonomy_index[new_id] = taxonomy_entries.size();
+    taxonomy_match_index.insert(taxonomy_entries.size(), norm_category, norm_subcategory);
     taxonomy_entries.push_back(entry);
     canonical_lookup[make_key(norm_category, norm_subcategory)] = new_id;
     return new_id;
@@ -742,20 +1046,16 @@ int DatabaseManager::find_existing_taxonomy_id(const std::string &norm_category,
 
     const char *select_sql =
         "SELECT id FROM category_taxonomy WHERE normalized_category = ? AND normalized_subcategory = ? LIMIT 1;";
-    sqlite3_stmt *stmt = nullptr;
     int existing_id = -1;
 
-    if (sqlite3_prepare_v2(db, select_sql, -1, &stmt, nullptr) == SQLITE_OK) {
+    CachedStatement statement = prepare_cached(select_sql);
+    if (sqlite3_stmt *stmt = statement.get()) {
         sqlite3_bind_text(stmt, 1, norm_category.c_str(), -1, SQLITE_TRANSIENT);
         sqlite3_bind_text(stmt, 2, norm_subcategory.c_str(), -1, SQLITE_TRANSIENT);
         if (sqlite3_step(stmt) == SQLITE_ROW) {
             existing_id = sqlite3_column_int(stmt, 0);
         }
     }
-
-    if (stmt) {
-        sqlite3_finalize(stmt);
-    }
     return existing_id;
 }
 
@@ -780,8 +1080,9 @@ void DatabaseManager::ensure_alias_mapping(int taxonomy_id,
         VALUES (?, ?, ?);
     )";
 
-    sqlite3_stmt *stmt = nullptr;
-    if (sqlite3_prepare_v2(db, sql, -1, &stmt, nullptr) != SQLITE_OK) {
+    CachedStatement statement = prepare_cached(sql);
+    sqlite3_stmt* stmt = statement.get();
+    if (!stmt) {
         db_log(spdlog::level::err, "Failed to prepare alias insert: {}", sqlite3_errmsg(db));
         return;
     }
@@ -792,11 +1093,9 @@ void DatabaseManager::ensure_alias_mapping(int taxonomy_id,
 
     if (sqlite3_step(stmt) != SQLITE_DONE) {
         db_log(spdlog::level::err, "Failed to insert alias: {}", sqlite3_errmsg(db));
-        sqlite3_finalize(stmt);
         return;
     }
 
-    sqlite3_finalize(stmt);
     alias_lookup[key] = taxonomy_id;
 }
 
@@ -815,27 +1114,12 @@ const DatabaseManager::TaxonomyEntry *DatabaseManager::find_taxonomy_entry(int t
 std::pair<int, double> DatabaseManager::find_fuzzy_match(
     const std::string& norm_category,
     const std::string& norm_subcategory) const {
-    if (taxonomy_entries.empty()) {
+    const auto match = taxonomy_match_index.find_best_match(norm_category, norm_subcategory,
+                                                            kSimilarityThreshold);
+    if (!match || match->position >= taxonomy_entries.size()) {
         return {-1, 0.0};
     }
-
-    double best_score = 0.0;
-    int best_id = -1;
-    for (const auto &entry : taxonomy_entries) {
-        double category_score = string_similarity(norm_category, entry.normalized_category);
-        double subcategory_score =
-            string_similarity(norm_subcategory, entry.normalized_subcategory);
-        double combined = (category_score + subcategory_score) / 2.0;
-        if (combined > best_score) {
-            best_score = combined;
-            best_id = entry.id;
-        }
-    }
-
-    if (best_id != -1 && best_score >= kSimilarityThreshold) {
-        return {best_id, best_score};
-    }
-    return {-1, best_score};
+    return {taxonomy_entries[match->position].id, match->score};
 }
 
 int DatabaseManager::resolve_existing_taxonomy(const std::string& key,
@@ -1063,8 +1347,9 @@ bool DatabaseManager::upsert_category_translation(int taxonomy_id,
             updated_at = CURRENT_TIMESTAMP;
     )";
 
-    sqlite3_stmt* stmt = nullptr;
-    if (sqlite3_prepare_v2(db, sql, -1, &stmt, nullptr) != SQLITE_OK) {
+    CachedStatement statement = prepare_cached(sql);
+    sqlite3_stmt* stmt = statement.get();
+    if (!stmt) {
         db_log(spdlog::level::err, "Failed to prepare translation upsert: {}", sqlite3_errmsg(db));
         return false;
     }
@@ -1080,7 +1365,6 @@ bool DatabaseManager::upsert_category_translation(int taxonomy_id,
     if (!success) {
         db_log(spdlog::level::err, "Failed to upsert category translation: {}", sqlite3_errmsg(db));
     }
-    sqlite3_finalize(stmt);
     if (!success) {
         return false;
     }
@@ -1101,63 +1385,138 @@ bool DatabaseManager::insert_or_update_file_with_categorization(
     bool used_consistency_hints,
     const std::string &suggested_name,
     bool rename_only,
-    bool rename_applied) {
+    bool rename_applied,
+    const std::string &content_fingerprint) {
     if (!db) return false;
 
+    const CategorizationRecord record{file_name, file_type, dir_path, resolved,
+                                      used_consistency_hints, suggested_name, rename_only, rename_applied,
+                                      content_fingerprint};
+    if (!upsert_file_categorization(record)) {
+        return false;
+    }
+
+    if (resolved.taxonomy_id > 0) {
+        increment_taxonomy_frequency(resolved.taxonomy_id);
+    }
+    return true;
+}
+
+bool DatabaseManager::insert_or_update_files_with_categorization(
+    const std::vector<CategorizationRecord>& records) {
+    if (!db) return false;
+    if (records.empty()) return true;
+
+    if (!execute_statement("BEGIN IMMEDIATE;", "begin categorization batch")) {
+        return false;
+    }
+
+    std::vector<int> touched_taxonomy_ids;
+    for (const auto& record : records) {
+        if (!upsert_file_categorization(record)) {
+            execute_statement("ROLLBACK;", "roll back categorization batch");
+            return false;
+        }
+        for (const auto& [moved_dir, moved_name] : record.moved_from) {
+            if (!remove_file_categorization(moved_dir, moved_name, FileType::File)) {
+                execute_statement("ROLLBACK;", "roll back categorization batch");
+                return false;
+            }
+        }
+        if (record.resolved.taxonomy_id > 0) {
+            touched_taxonomy_ids.push_back(record.resolved.taxonomy_id);
+        }
+    }
+
+    // Each refresh counts every row of its taxonomy, so run it once per id rather than once per row.
+    std::sort(touched_taxonomy_ids.begin(), touched_taxonomy_ids.end());
+    touched_taxonomy_ids.erase(std::unique(touched_taxonomy_ids.begin(), touched_taxonomy_ids.end()),
+                               touched_taxonomy_ids.end());
+    for (int taxonomy_id : touched_taxonomy_ids) {
+        increment_taxonomy_frequency(taxonomy_id);
+    }
+
+    if (!execute_statement("COMMIT;", "commit categorization batch")) {
+        execute_statement("ROLLBACK;", "roll back categorization batch");
+        return false;
+    }
+    db_log(spdlog::level::debug, "Stored {} categorization result(s) in one transaction", records.size());
+    return true;
+}
+
+bool DatabaseManager::execute_statement(const char* sql, const char* description) {
+    CachedStatement statement = prepare_cached(sql);
+    sqlite3_stmt* stmt = statement.get();
+    if (!stmt) {
+        db_log(spdlog::level::err, "Failed to prepare statement to {}: {}", description, sqlite3_errmsg(db));
+        return false;
+    }
+    if (sqlite3_step(stmt) != SQLITE_DONE) {
+        db_log(spdlog::level::err, "Failed to {}: {}", description, sqlite3_errmsg(db));
+        return false;
+    }
+    return true;
+}
+
+bool DatabaseManager::upsert_file_categorization(const CategorizationRecord& record) {
     const char *sql = R"(
         INSERT INTO file_categorization
             (file_name, file_type, dir_path, category, subcategory, suggested_name,
-             taxonomy_id, categorization_style, rename_only, rename_applied)
-        VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?, ?)
+             taxonomy_id, categorization_style, rename_only, rename_applied, extension,
+             content_fingerprint)
+        VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?)
         ON CONFLICT(file_name, file_type, dir_path)
         DO UPDATE SET
+            content_fingerprint = COALESCE(excluded.content_fingerprint, content_fingerprint),
             category = excluded.category,
             subcategory = excluded.subcategory,
             suggested_name = excluded.suggested_name,
             taxonomy_id = excluded.taxonomy_id,
             categorization_style = excluded.categorization_style,
             rename_only = excluded.rename_only,
+            extension = excluded.extension,
             rename_applied = CASE
                 WHEN excluded.rename_applied = 1 THEN 1
                 ELSE rename_applied
             END;
     )";
 
-    sqlite3_stmt *stmt = nullptr;
-    if (sqlite3_prepare_v2(db, sql, -1, &stmt, nullptr) != SQLITE_OK) {
+    CachedStatement statement = prepare_cached(sql);
+    sqlite3_stmt* stmt = statement.get();
+    if (!stmt) {
         db_log(spdlog::level::err, "SQL prepare error: {}", sqlite3_errmsg(db));
         return false;
     }
 
-    sqlite3_bind_text(stmt, 1, file_name.c_str(), -1, SQLITE_TRANSIENT);
-    sqlite3_bind_text(stmt, 2, file_type.c_str(), -1, SQLITE_TRANSIENT);
-    sqlite3_bind_text(stmt, 3, dir_path.c_str(), -1, SQLITE_TRANSIENT);
+    const ResolvedCategory& resolved = record.resolved;
+    sqlite3_bind_text(stmt, 1, record.file_name.c_str(), -1, SQLITE_TRANSIENT);
+    sqlite3_bind_text(stmt, 2, record.file_type.c_str(), -1, SQLITE_TRANSIENT);
+    sqlite3_bind_text(stmt, 3, record.dir_path.c_str(), -1, SQLITE_TRANSIENT);
     sqlite3_bind_text(stmt, 4, resolved.category.c_str(), -1, SQLITE_TRANSIENT);
     sqlite3_bind_text(stmt, 5, resolved.subcategory.c_str(), -1, SQLITE_TRANSIENT);
-    sqlite3_bind_text(stmt, 6, suggested_name.c_str(), -1, SQLITE_TRANSIENT);
+    sqlite3_bind_text(stmt, 6, record.suggested_name.c_str(), -1, SQLITE_TRANSIENT);
 
     if (resolved.taxonomy_id > 0) {
         sqlite3_bind_int(stmt, 7, resolved.taxonomy_id);
     } else {
         sqlite3_bind_null(stmt, 7);
     }
-    sqlite3_bind_int(stmt, 8, used_consistency_hints ? 1 : 0);
-    sqlite3_bind_int(stmt, 9, rename_only ? 1 : 0);
-    sqlite3_bind_int(stmt, 10, rename_applied ? 1 : 0);
+    sqlite3_bind_int(stmt, 8, record.used_consistency_hints ? 1 : 0);
+    sqlite3_bind_int(stmt, 9, record.rename_only ? 1 : 0);
+    sqlite3_bind_int(stmt, 10, record.rename_applied ? 1 : 0);
+    const std::string extension = extract_extension_lower(record.file_name);
+    sqlite3_bind_text(stmt, 11, extension.c_str(), -1, SQLITE_TRANSIENT);
+    if (record.content_fingerprint.empty()) {
+        sqlite3_bind_null(stmt, 12);
+    } else {
+        sqlite3_bind_text(stmt, 12, record.content_fingerprint.c_str(), -1, SQLITE_TRANSIENT);
+    }
 
-    bool success = true;
     if (sqlite3_step(stmt) != SQLITE_DONE) {
         db_log(spdlog::level::err, "SQL error during insert/update: {}", sqlite3_errmsg(db));
-        success = false;
-    }
-
-    sqlite3_finalize(stmt);
-
-    if (success && resolved.taxonomy_id > 0) {
-        increment_taxonomy_frequency(resolved.taxonomy_id);
+        return false;
     }
-
-    return success;
+    return true;
 }
 
 bool DatabaseManager::remove_file_categorization(const std::string& dir_path,
@@ -1170,8 +1529,9 @@ bool DatabaseManager::remove_file_categorization(const std::string& dir_path,
     const char* sql =
         "DELETE FROM file_categorization WHERE dir_path = ? AND file_name = ? AND file_type = ?;";
 
-    sqlite3_stmt* stmt = nullptr;
-    if (sqlite3_prepare_v2(db, sql, -1, &stmt, nullptr) != SQLITE_OK) {
+    CachedStatement statement = prepare_cached(sql);
+    sqlite3_stmt* stmt = statement.get();
+    if (!stmt) {
         db_log(spdlog::level::err, "Failed to prepare delete categorization statement: {}", sqlite3_errmsg(db));
         return false;
     }
@@ -1187,7 +1547,6 @@ bool DatabaseManager::remove_file_categorization(const std::string& dir_path,
         db_log(spdlog::level::err, "Failed to delete cached categorization for '{}': {}", file_name, sqlite3_errmsg(db));
     }
 
-    sqlite3_finalize(stmt);
     return success;
 }
 
@@ -1197,26 +1556,68 @@ bool DatabaseManager::clear_directory_categorizations(const std::string& dir_pat
         return false;
     }
 
-    const char* sql = recursive
-        ? "DELETE FROM file_categorization WHERE dir_path = ? OR dir_path LIKE ? ESCAPE '\\';"
-        : "DELETE FROM file_categorization WHERE dir_path = ?;";
-    sqlite3_stmt* stmt = nullptr;
-    if (sqlite3_prepare_v2(db, sql, -1, &stmt, nullptr) != SQLITE_OK) {
+    const auto range = build_directory_subtree_range(dir_path);
+    const char* sql = !recursive
+        ? "DELETE FROM file_categorization WHERE dir_path = ?;"
+        : range.upper
+            ? "DELETE FROM file_categorization WHERE dir_path = ? OR (dir_path >= ? AND dir_path < ?);"
+            : "DELETE FROM file_categorization WHERE dir_path = ? OR dir_path >= ?;";
+    CachedStatement statement = prepare_cached(sql);
+    sqlite3_stmt* stmt = statement.get();
+    if (!stmt) {
         db_log(spdlog::level::err, "Failed to prepare directory cache clear statement: {}", sqlite3_errmsg(db));
         return false;
     }
 
-    sqlite3_bind_text(stmt, 1, dir_path.c_str(), -1, SQLITE_TRANSIENT);
     if (recursive) {
-        const std::string pattern = build_recursive_dir_pattern(dir_path);
-        sqlite3_bind_text(stmt, 2, pattern.c_str(), -1, SQLITE_TRANSIENT);
+        bind_directory_subtree(stmt, 1, dir_path, range);
+    } else {
+        sqlite3_bind_text(stmt, 1, dir_path.c_str(), -1, SQLITE_TRANSIENT);
     }
     const bool success = sqlite3_step(stmt) == SQLITE_DONE;
     if (!success) {
         db_log(spdlog::level::err, "Failed to clear cached categorizations for '{}': {}", dir_path, sqlite3_errmsg(db));
     }
-    sqlite3_finalize(stmt);
     cached_results.clear();
+    return clear_directory_document_analyses(dir_path, recursive) && success;
+}
+
+bool DatabaseManager::clear_directory_document_analyses(const std::string& dir_path,
+                                                        bool recursive) {
+    // Rows are keyed by full file path, so the folder's files all sort inside its subtree
+    // range; a non-recursive clear also requires no separator after the folder prefix.
+    const auto range = build_directory_subtree_range(dir_path);
+    const char* sql = recursive
+        ? range.upper
+            ? "DELETE FROM document_analysis_cache WHERE file_path >= ? AND file_path < ?;"
+            : "DELETE FROM document_analysis_cache WHERE file_path >= ?;"
+        : range.upper
+            ? "DELETE FROM document_analysis_cache WHERE file_path >= ? AND file_path < ? "
+              "AND instr(substr(file_path, length(?) + 1), ?) = 0;"
+            : "DELETE FROM document_analysis_cache WHERE file_path >= ? "
+              "AND instr(substr(file_path, length(?) + 1), ?) = 0;";
+    CachedStatement statement = prepare_cached(sql);
+    sqlite3_stmt* stmt = statement.get();
+    if (!stmt) {
+        db_log(spdlog::level::err, "Failed to prepare document analysis clear statement: {}", sqlite3_errmsg(db));
+        return false;
+    }
+
+    int index = 1;
+    sqlite3_bind_text(stmt, index++, range.lower.c_str(), -1, SQLITE_TRANSIENT);
+    if (range.upper) {
+        sqlite3_bind_text(stmt, index++, range.upper->c_str(), -1, SQLITE_TRANSIENT);
+    }
+    if (!recursive) {
+        const std::string separator = range.lower.empty() ? "/" : range.lower.substr(range.lower.size() - 1);
+        sqlite3_bind_text(stmt, index++, range.lower.c_str(), -1, SQLITE_TRANSIENT);
+        sqlite3_bind_text(stmt, index++, separator.c_str(), -1, SQLITE_TRANSIENT);
+    }
+
+    const bool success = sqlite3_step(stmt) == SQLITE_DONE;
+    if (!success) {
+        db_log(spdlog::level::err, "Failed to clear document analyses for '{}': {}", dir_path, sqlite3_errmsg(db));
+    }
     return success;
 }
 
@@ -1227,30 +1628,36 @@ bool DatabaseManager::has_categorization_style_conflict(const std::string& dir_p
         return false;
     }
 
-    const char* sql = recursive
+    const auto range = build_directory_subtree_range(dir_path);
+    const char* sql = !recursive
         ? "SELECT 1 FROM file_categorization "
-          "WHERE (dir_path = ? OR dir_path LIKE ? ESCAPE '\\') "
-          "AND IFNULL(categorization_style, 0) != ? "
-          "LIMIT 1;"
-        : "SELECT 1 FROM file_categorization "
           "WHERE dir_path = ? AND IFNULL(categorization_style, 0) != ? "
-          "LIMIT 1;";
-    sqlite3_stmt* stmt = nullptr;
-    if (sqlite3_prepare_v2(db, sql, -1, &stmt, nullptr) != SQLITE_OK) {
+          "LIMIT 1;"
+        : range.upper
+            ? "SELECT 1 FROM file_categorization "
+              "WHERE (dir_path = ? OR (dir_path >= ? AND dir_path < ?)) "
+              "AND IFNULL(categorization_style, 0) != ? "
+              "LIMIT 1;"
+            : "SELECT 1 FROM file_categorization "
+              "WHERE (dir_path = ? OR dir_path >= ?) "
+              "AND IFNULL(categorization_style, 0) != ? "
+              "LIMIT 1;";
+    CachedStatement statement = prepare_cached(sql);
+    sqlite3_stmt* stmt = statement.get();
+    if (!stmt) {
         db_log(spdlog::level::warn, "Failed to prepare cached style conflict query: {}", sqlite3_errmsg(db));
         return false;
     }
 
-    sqlite3_bind_text(stmt, 1, dir_path.c_str(), -1, SQLITE_TRANSIENT);
     int bind_index = 2;
     if (recursive) {
-        const std::string pattern = build_recursive_dir_pattern(dir_path);
-        sqlite3_bind_text(stmt, bind_index++, pattern.c_str(), -1, SQLITE_TRANSIENT);
+        bind_index = bind_directory_subtree(stmt, 1, dir_path, range);
+    } else {
+        sqlite3_bind_text(stmt, 1, dir_path.c_str(), -1, SQLITE_TRANSIENT);
     }
     sqlite3_bind_int(stmt, bind_index, desired_style ? 1 : 0);
 
     const bool conflict = sqlite3_step(stmt) == SQLITE_ROW;
-    sqlite3_finalize(stmt);
     return conflict;
 }
 
@@ -1261,8 +1668,9 @@ std::optional<bool> DatabaseManager::get_directory_categorization_style(const st
 
     const char* sql =
         "SELECT categorization_style FROM file_categorization WHERE dir_path = ? LIMIT 1;";
-    sqlite3_stmt* stmt = nullptr;
-    if (sqlite3_prepare_v2(db, sql, -1, &stmt, nullptr) != SQLITE_OK) {
+    CachedStatement statement = prepare_cached(sql);
+    sqlite3_stmt* stmt = statement.get();
+    if (!stmt) {
         db_log(spdlog::level::warn, "Failed to prepare cached style query: {}", sqlite3_errmsg(db));
         return std::nullopt;
     }
@@ -1276,10 +1684,297 @@ std::optional<bool> DatabaseManager::get_directory_categorization_style(const st
                      ? (sqlite3_column_int(stmt, 0) != 0)
                      : false;
     }
-    sqlite3_finalize(stmt);
     return result;
 }
 
+DatabaseManager::CachedStatement DatabaseManager::prepare_snapshot_statement(const char* sql) const {
+    sqlite3_stmt* stmt = nullptr;
+    if (!snapshot_db || sqlite3_prepare_v2(snapshot_db, sql, -1, &stmt, nullptr) != SQLITE_OK) {
+        sqlite3_finalize(stmt);
+        return CachedStatement();
+    }
+    return CachedStatement(stmt);
+}
+
+bool DatabaseManager::execute_snapshot_statement(const char* sql, const char* description) {
+    if (sqlite3_exec(snapshot_db, sql, nullptr, nullptr, nullptr) != SQLITE_OK) {
+        db_log(spdlog::level::err, "Failed to {}: {}", description, sqlite3_errmsg(snapshot_db));
+        return false;
+    }
+    return true;
+}
+
+std::optional<std::int64_t> DatabaseManager::find_scan_snapshot_id(const std::string& root_path,
+                                                                   int scan_options) const {
+    CachedStatement statement = prepare_snapshot_statement(
+        "SELECT id FROM scan_snapshot WHERE root_path = ? AND scan_options = ?;");
+    sqlite3_stmt* stmt = statement.get();
+    if (!stmt) {
+        return std::nullopt;
+    }
+    sqlite3_bind_text(stmt, 1, root_path.c_str(), -1, SQLITE_TRANSIENT);
+    sqlite3_bind_int(stmt, 2, scan_options);
+    if (sqlite3_step(stmt) != SQLITE_ROW) {
+        return std::nullopt;
+    }
+    return sqlite3_column_int64(stmt, 0);
+}
+
+std::optional<DatabaseManager::ScanSnapshot>
+DatabaseManager::load_scan_snapshot(const std::string& root_path, int scan_options) {
+    std::lock_guard<std::mutex> lock(snapshot_mutex);
+    if (!snapshot_db) {
+        return std::nullopt;
+    }
+
+    // Read in one consistent view; a concurrent writer must not mix two scans.
+    if (!execute_snapshot_statement("BEGIN;", "begin scan snapshot read")) {
+        return std::nullopt;
+    }
+
+    ScanSnapshot snapshot;
+    sqlite3_int64 snapshot_id = 0;
+    {
+        CachedStatement statement = prepare_snapshot_statement(
+            "SELECT id, scanned_at FROM scan_snapshot WHERE root_path = ? AND scan_options = ?;");
+        sqlite3_stmt* stmt = statement.get();
+        if (!stmt) {
+            db_log(spdlog::level::warn, "Failed to prepare scan snapshot query: {}", sqlite3_errmsg(snapshot_db));
+        } else {
+            sqlite3_bind_text(stmt, 1, root_path.c_str(), -1, SQLITE_TRANSIENT);
+            sqlite3_bind_int(stmt, 2, scan_options);
+            if (sqlite3_step(stmt) == SQLITE_ROW) {
+                snapshot_id = sqlite3_column_int64(stmt, 0);
+                snapshot.scanned_at_ns = sqlite3_column_int64(stmt, 1);
+            }
+        }
+    }
+    if (snapshot_id == 0) {
+        execute_snapshot_statement("COMMIT;", "end scan snapshot read");
+        return std::nullopt;
+    }
+
+    struct DirectoryRow {
+        ScanSnapshotDirectory directory;
+        std::size_t child_count{0};
+    };
+    std::unordered_map<sqlite3_int64, DirectoryRow> rows;
+    {
+        CachedStatement statement = prepare_snapshot_statement(
+            "SELECT id, dir_path, mtime_ns, inode, child_count FROM scan_snapshot_directory "
+            "WHERE snapshot_id = ?;");
+        sqlite3_stmt* stmt = statement.get();
+        if (!stmt) {
+            db_log(spdlog::level::warn, "Failed to prepare scan snapshot directory query: {}",
+                   sqlite3_errmsg(snapshot_db));
+            execute_snapshot_statement("ROLLBACK;", "end scan snapshot read");
+            return std::nullopt;
+        }
+        sqlite3_bind_int64(stmt, 1, snapshot_id);
+        while (sqlite3_step(stmt) == SQLITE_ROW) {
+            const char* dir_path = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 1));
+            DirectoryRow row;
+            row.directory.dir_path = dir_path ? dir_path : "";
+            row.directory.mtime_ns = sqlite3_column_int64(stmt, 2);
+            row.directory.inode = static_cast<std::uint64_t>(sqlite3_column_int64(stmt, 3));
+            row.child_count = static_cast<std::size_t>(sqlite3_column_int64(stmt, 4));
+            row.directory.children.reserve(row.child_count);
+            rows.emplace(sqlite3_column_int64(stmt, 0), std::move(row));
+        }
+    }
+    {
+        CachedStatement statement = prepare_snapshot_statement(
+            "SELECT directory_id, file_name, file_type, descend, inode FROM scan_snapshot_entry "
+            "WHERE directory_id IN (SELECT id FROM scan_snapshot_directory WHERE snapshot_id = ?) "
+            "ORDER BY directory_id, position;");
+        sqlite3_stmt* stmt = statement.get();
+        if (!stmt) {
+            db_log(spdlog::level::warn, "Failed to prepare scan snapshot entry query: {}",
+                   sqlite3_errmsg(snapshot_db));
+            execute_snapshot_statement("ROLLBACK;", "end scan snapshot read");
+            return std::nullopt;
+        }
+        sqlite3_bind_int64(stmt, 1, snapshot_id);
+        DirectoryRow* current = nullptr;
+        sqlite3_int64 current_id = 0;
+        while (sqlite3_step(stmt) == SQLITE_ROW) {
+            const sqlite3_int64 directory_id = sqlite3_column_int64(stmt, 0);
+            if (!current || directory_id != current_id) {
+                auto it = rows.find(directory_id);
+                current = it != rows.end() ? &it->second : nullptr;
+                current_id = directory_id;
+                if (!current) {
+                    continue;
+                }
+            }
+            const char* file_name = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 1));
+            const char* file_type = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 2));
+            ScanSnapshotEntry entry;
+            entry.file_name = file_name ? file_name : "";
+            if (file_type) {
+                entry.file_type = file_type[0] == 'D' ? FileType::Directory : FileType::File;
+            }
+            entry.descend = sqlite3_column_int(stmt, 3) != 0;
+            entry.inode = static_cast<std::uint64_t>(sqlite3_column_int64(stmt, 4));
+            current->directory.children.push_back(std::move(entry));
+        }
+    }
+    execute_snapshot_statement("COMMIT;", "end scan snapshot read");
+
+    snapshot.directories.reserve(rows.size());
+    std::size_t incomplete = 0;
+    for (auto& [id, row] : rows) {
+        if (row.directory.children.size() != row.child_count) {
+            ++incomplete;
+            continue;
+        }
+        std::string key = row.directory.dir_path;
+        snapshot.directories.emplace(std::move(key), std::move(row.directory));
+    }
+    if (incomplete > 0) {
+        db_log(spdlog::level::warn, "Ignoring {} incomplete scan snapshot director(ies) for '{}'",
+               incomplete, root_path);
+    }
+    return snapshot;
+}
+
+bool DatabaseManager::update_scan_snapshot(const std::string& root_path,
+                                           int scan_options,
+                                           std::int64_t scanned_at_ns,
+                                           const std::vector<ScanSnapshotDirectory>& changed_directories,
+                                           const std::vector<std::string>& removed_directories) {
+    std::lock_guard<std::mutex> lock(snapshot_mutex);
+    if (!snapshot_db) {
+        return false;
+    }
+
+    if (!execute_snapshot_statement("BEGIN IMMEDIATE;", "begin scan snapshot update")) {
+        return false;
+    }
+
+    const auto rollback = [&](const char* what) {
+        db_log(spdlog::level::err, "Failed to {} for '{}': {}", what, root_path, sqlite3_errmsg(snapshot_db));
+        execute_snapshot_statement("ROLLBACK;", "roll back scan snapshot update");
+        return false;
+    };
+
+    {
+        CachedStatement statement = prepare_snapshot_statement(R"(
+            INSERT INTO scan_snapshot (root_path, scan_options, scanned_at) VALUES (?, ?, ?)
+            ON CONFLICT(root_path, scan_options) DO UPDATE SET scanned_at = excluded.scanned_at;
+        )");
+        sqlite3_stmt* stmt = statement.get();
+        if (!stmt) {
+            return rollback("prepare scan snapshot root");
+        }
+        sqlite3_bind_text(stmt, 1, root_path.c_str(), -1, SQLITE_TRANSIENT);
+        sqlite3_bind_int(stmt, 2, scan_options);
+        sqlite3_bind_int64(stmt, 3, scanned_at_ns);
+        if (sqlite3_step(stmt) != SQLITE_DONE) {
+            return rollback("store scan snapshot root");
+        }
+    }
+    const auto snapshot_id = find_scan_snapshot_id(root_path, scan_options);
+    if (!snapshot_id) {
+        return rollback("look up scan snapshot");
+    }
+
+    // Prepared once per update; a first scan of a large tree writes every directory.
+    CachedStatement delete_entries = prepare_snapshot_statement(
+        "DELETE FROM scan_snapshot_entry WHERE directory_id = "
+        "(SELECT id FROM scan_snapshot_directory WHERE snapshot_id = ? AND dir_path = ?);");
+    CachedStatement delete_directory = prepare_snapshot_statement(
+        "DELETE FROM scan_snapshot_directory WHERE snapshot_id = ? AND dir_path = ?;");
+    CachedStatement upsert_directory = prepare_snapshot_statement(R"(
+        INSERT INTO scan_snapshot_directory (snapshot_id, dir_path, mtime_ns, inode, child_count)
+        VALUES (?, ?, ?, ?, ?)
+        ON CONFLICT(snapshot_id, dir_path) DO UPDATE SET
+            mtime_ns = excluded.mtime_ns,
+            inode = excluded.inode,
+            child_count = excluded.child_count;
+    )");
+    CachedStatement select_directory = prepare_snapshot_statement(
+        "SELECT id FROM scan_snapshot_directory WHERE snapshot_id = ? AND dir_path = ?;");
+    CachedStatement insert_entry = prepare_snapshot_statement(
+        "INSERT INTO scan_snapshot_entry (directory_id, position, file_name, file_type, descend, inode) "
+        "VALUES (?, ?, ?, ?, ?, ?);");
+    if (!delete_entries || !delete_directory || !upsert_directory || !select_directory || !insert_entry) {
+        return rollback("prepare scan snapshot statements");
+    }
+
+    const auto step_for_directory = [&](sqlite3_stmt* stmt, const std::string& dir_path, int expected) {
+        sqlite3_bind_int64(stmt, 1, *snapshot_id);
+        sqlite3_bind_text(stmt, 2, dir_path.c_str(), -1, SQLITE_TRANSIENT);
+        return sqlite3_step(stmt) == expected;
+    };
+    const auto reset = [](sqlite3_stmt* stmt) {
+        sqlite3_reset(stmt);
+        sqlite3_clear_bindings(stmt);
+    };
+
+    for (const auto& dir_path : removed_directories) {
+        const bool cleared = step_for_directory(delete_entries.get(), dir_path, SQLITE_DONE);
+        reset(delete_entries.get());
+        const bool removed = cleared && step_for_directory(delete_directory.get(), dir_path, SQLITE_DONE);
+        reset(delete_directory.get());
+        if (!removed) {
+            return rollback("remove scan snapshot directory");
+        }
+    }
+
+    for (const auto& directory : changed_directories) {
+        sqlite3_stmt* upsert = upsert_directory.get();
+        sqlite3_bind_int64(upsert, 1, *snapshot_id);
+        sqlite3_bind_text(upsert, 2, directory.dir_path.c_str(), -1, SQLITE_TRANSIENT);
+        sqlite3_bind_int64(upsert, 3, directory.mtime_ns);
+        sqlite3_bind_int64(upsert, 4, static_cast<sqlite3_int64>(directory.inode));
+        sqlite3_bind_int64(upsert, 5, static_cast<sqlite3_int64>(directory.children.size()));
+        const bool upserted = sqlite3_step(upsert) == SQLITE_DONE;
+        reset(upsert);
+        if (!upserted) {
+            return rollback("store scan snapshot directory");
+        }
+
+        const bool cleared = step_for_directory(delete_entries.get(), directory.dir_path, SQLITE_DONE);
+        reset(delete_entries.get());
+        const bool found = cleared &&
+                           step_for_directory(select_directory.get(), directory.dir_path, SQLITE_ROW);
+        const sqlite3_int64 directory_id = found ? sqlite3_column_int64(select_directory.get(), 0) : 0;
+        reset(select_directory.get());
+        if (!found) {
+            return rollback("store scan snapshot directory");
+        }
+
+        sqlite3_stmt* insert = insert_entry.get();
+        for (std::size_t position = 0; position < directory.children.size(); ++position) {
+            const auto& child = directory.children[position];
+            sqlite3_bind_int64(insert, 1, directory_id);
+            sqlite3_bind_int64(insert, 2, static_cast<sqlite3_int64>(position));
+            sqlite3_bind_text(insert, 3, child.file_name.c_str(), -1, SQLITE_TRANSIENT);
+            if (child.file_type) {
+                sqlite3_bind_text(insert, 4, *child.file_type == FileType::File ? "F" : "D", -1, SQLITE_STATIC);
+            } else {
+                sqlite3_bind_null(insert, 4);
+            }
+            sqlite3_bind_int(insert, 5, child.descend ? 1 : 0);
+            sqlite3_bind_int64(insert, 6, static_cast<sqlite3_int64>(child.inode));
+            const bool inserted = sqlite3_step(insert) == SQLITE_DONE;
+            reset(insert);
+            if (!inserted) {
+                return rollback("store scan snapshot entry");
+            }
+        }
+    }
+
+    if (!execute_snapshot_statement("COMMIT;", "commit scan snapshot update")) {
+        execute_snapshot_statement("ROLLBACK;", "roll back scan snapshot update");
+        return false;
+    }
+    db_log(spdlog::level::debug, "Scan snapshot for '{}': {} director(ies) stored, {} removed",
+           root_path, changed_directories.size(), removed_directories.size());
+    return true;
+}
+
 std::vector<CategorizedFile>
 DatabaseManager::remove_empty_categorizations(const std::string& dir_path) {
     std::vector<CategorizedFile> removed;
@@ -1296,15 +1991,15 @@ DatabaseManager::remove_empty_categorizations(const std::string& dir_path) {
           AND IFNULL(rename_only, 0) = 0;
     )";
 
-    sqlite3_stmt* stmt = nullptr;
-    if (sqlite3_prepare_v2(db, sql, -1, &stmt, nullptr) != SQLITE_OK) {
+    CachedStatement statement = prepare_cached(sql);
+    sqlite3_stmt* stmt = statement.get();
+    if (!stmt) {
         db_log(spdlog::level::err, "Failed to prepare empty categorization query: {}", sqlite3_errmsg(db));
         return removed;
     }
 
     if (sqlite3_bind_text(stmt, 1, dir_path.c_str(), -1, SQLITE_TRANSIENT) != SQLITE_OK) {
         db_log(spdlog::level::err, "Failed to bind directory path for empty categorization query: {}", sqlite3_errmsg(db));
-        sqlite3_finalize(stmt);
         return removed;
     }
 
@@ -1331,7 +2026,6 @@ DatabaseManager::remove_empty_categorizations(const std::string& dir_path) {
                            taxonomy_id});
     }
 
-    sqlite3_finalize(stmt);
     for (const auto& entry : removed) {
         remove_file_categorization(entry.file_path, entry.file_name, entry.type);
     }
@@ -1345,8 +2039,9 @@ void DatabaseManager::increment_taxonomy_frequency(int taxonomy_id) {
         "UPDATE category_taxonomy "
         "SET frequency = (SELECT COUNT(*) FROM file_categorization WHERE taxonomy_id = ?) "
         "WHERE id = ?;";
-    sqlite3_stmt *stmt = nullptr;
-    if (sqlite3_prepare_v2(db, sql, -1, &stmt, nullptr) != SQLITE_OK) {
+    CachedStatement statement = prepare_cached(sql);
+    sqlite3_stmt* stmt = statement.get();
+    if (!stmt) {
         db_log(spdlog::level::err, "Failed to prepare frequency update: {}", sqlite3_errmsg(db));
         return;
     }
@@ -1356,7 +2051,6 @@ void DatabaseManager::increment_taxonomy_frequency(int taxonomy_id) {
     if (sqlite3_step(stmt) != SQLITE_DONE) {
         db_log(spdlog::level::err, "Failed to increment taxonomy frequency: {}", sqlite3_errmsg(db));
     }
-    sqlite3_finalize(stmt);
 }
 
 std::vector<CategorizedFile>
@@ -1368,7 +2062,7 @@ DatabaseManager::get_categorized_files(const std::string &directory_path) {
         "SELECT dir_path, file_name, file_type, category, subcategory, suggested_name, taxonomy_id, "
         "categorization_style, rename_only, rename_applied "
         "FROM file_categorization WHERE dir_path = ?;";
-    StatementPtr stmt = prepare_statement(db, sql);
+    CachedStatement stmt = prepare_cached(sql);
     if (!stmt) {
         return categorized_files;
     }
@@ -1394,26 +2088,22 @@ DatabaseManager::get_categorized_files_recursive(const std::string& directory_pa
         return categorized_files;
     }
 
-    const char* sql =
-        "SELECT dir_path, file_name, file_type, category, subcategory, suggested_name, taxonomy_id, "
-        "categorization_style, rename_only, rename_applied "
-        "FROM file_categorization "
-        "WHERE dir_path = ? OR dir_path LIKE ? ESCAPE '\\';";
-    StatementPtr stmt = prepare_statement(db, sql);
+    const auto range = build_directory_subtree_range(directory_path);
+    const char* sql = range.upper
+        ? "SELECT dir_path, file_name, file_type, category, subcategory, suggested_name, taxonomy_id, "
+          "categorization_style, rename_only, rename_applied "
+          "FROM file_categorization "
+          "WHERE dir_path = ? OR (dir_path >= ? AND dir_path < ?);"
+        : "SELECT dir_path, file_name, file_type, category, subcategory, suggested_name, taxonomy_id, "
+          "categorization_style, rename_only, rename_applied "
+          "FROM file_categorization "
+          "WHERE dir_path = ? OR dir_path >= ?;";
+    CachedStatement stmt = prepare_cached(sql);
     if (!stmt) {
         return categorized_files;
     }
 
-    if (sqlite3_bind_text(stmt.get(), 1, directory_path.c_str(), -1, SQLITE_TRANSIENT) != SQLITE_OK) {
-        db_log(spdlog::level::err, "Failed to bind directory_path: {}", sqlite3_errmsg(db));
-        return categorized_files;
-    }
-
-    const std::string pattern = build_recursive_dir_pattern(directory_path);
-    if (sqlite3_bind_text(stmt.get(), 2, pattern.c_str(), -1, SQLITE_TRANSIENT) != SQLITE_OK) {
-        db_log(spdlog::level::err, "Failed to bind recursive directory pattern: {}", sqlite3_errmsg(db));
-        return categorized_files;
-    }
+    bind_directory_subtree(stmt.get(), 1, directory_path, range);
 
     while (sqlite3_step(stmt.get()) == SQLITE_ROW) {
         if (auto entry = build_categorized_entry(stmt.get())) {
@@ -1438,7 +2128,7 @@ DatabaseManager::get_categorized_file(const std::string& dir_path,
         "FROM file_categorization "
         "WHERE dir_path = ? AND file_name = ? AND file_type = ? "
         "LIMIT 1;";
-    StatementPtr stmt = prepare_statement(db, sql);
+    CachedStatement stmt = prepare_cached(sql);
     if (!stmt) {
         return std::nullopt;
     }
@@ -1461,6 +2151,113 @@ DatabaseManager::get_categorized_file(const std::string& dir_path,
     return std::nullopt;
 }
 
+std::vector<CategorizedFile>
+DatabaseManager::find_categorizations_by_fingerprint(const std::string& content_fingerprint,
+                                                     std::size_t max_entries) {
+    std::vector<CategorizedFile> matches;
+    if (!db || content_fingerprint.empty() || max_entries == 0) {
+        return matches;
+    }
+
+    const char *sql =
+        "SELECT dir_path, file_name, file_type, category, subcategory, suggested_name, taxonomy_id, "
+        "categorization_style, rename_only, rename_applied "
+        "FROM file_categorization "
+        "WHERE content_fingerprint = ? AND file_type = 'F' AND category <> '' AND subcategory <> '' "
+        "ORDER BY timestamp DESC, id DESC "
+        "LIMIT ?;";
+    CachedStatement stmt = prepare_cached(sql);
+    if (!stmt) {
+        return matches;
+    }
+    if (sqlite3_bind_text(stmt.get(), 1, content_fingerprint.c_str(), -1, SQLITE_TRANSIENT) != SQLITE_OK ||
+        sqlite3_bind_int64(stmt.get(), 2, static_cast<sqlite3_int64>(max_entries)) != SQLITE_OK) {
+        return matches;
+    }
+
+    while (sqlite3_step(stmt.get()) == SQLITE_ROW) {
+        if (auto entry = build_categorized_entry(stmt.get())) {
+            matches.push_back(std::move(*entry));
+        }
+    }
+    return matches;
+}
+
+std::optional<DatabaseManager::DocumentAnalysisRecord>
+DatabaseManager::get_document_analysis(const std::string& file_path) {
+    if (!db || file_path.empty()) {
+        return std::nullopt;
+    }
+
+    const char *sql =
+        "SELECT file_size, mtime_ns, content_fingerprint, excerpt_hash, summary, suggested_name "
+        "FROM document_analysis_cache WHERE file_path = ?;";
+    CachedStatement stmt = prepare_cached(sql);
+    if (!stmt) {
+        return std::nullopt;
+    }
+    sqlite3_bind_text(stmt.get(), 1, file_path.c_str(), -1, SQLITE_TRANSIENT);
+    if (sqlite3_step(stmt.get()) != SQLITE_ROW) {
+        return std::nullopt;
+    }
+
+    const auto column_text = [&stmt](int index) {
+        const auto* text = reinterpret_cast<const char*>(sqlite3_column_text(stmt.get(), index));
+        return text ? std::string(text) : std::string();
+    };
+    DocumentAnalysisRecord record;
+    record.file_path = file_path;
+    record.file_size = sqlite3_column_int64(stmt.get(), 0);
+    record.mtime_ns = sqlite3_column_int64(stmt.get(), 1);
+    record.content_fingerprint = column_text(2);
+    record.excerpt_hash = column_text(3);
+    record.summary = column_text(4);
+    record.suggested_name = column_text(5);
+    return record;
+}
+
+bool DatabaseManager::upsert_document_analysis(const DocumentAnalysisRecord& record) {
+    if (!db || record.file_path.empty()) {
+        return false;
+    }
+
+    const char *sql = R"(
+        INSERT INTO document_analysis_cache
+            (file_path, file_size, mtime_ns, content_fingerprint, excerpt_hash, summary, suggested_name, updated_at)
+        VALUES (?, ?, ?, ?, ?, ?, ?, CURRENT_TIMESTAMP)
+        ON CONFLICT(file_path) DO UPDATE SET
+            file_size = excluded.file_size,
+            mtime_ns = excluded.mtime_ns,
+            content_fingerprint = excluded.content_fingerprint,
+            excerpt_hash = excluded.excerpt_hash,
+            summary = excluded.summary,
+            suggested_name = excluded.suggested_name,
+            updated_at = excluded.updated_at;
+    )";
+    CachedStatement stmt = prepare_cached(sql);
+    if (!stmt) {
+        db_log(spdlog::level::err, "Failed to prepare document analysis upsert: {}", sqlite3_errmsg(db));
+        return false;
+    }
+    sqlite3_bind_text(stmt.get(), 1, record.file_path.c_str(), -1, SQLITE_TRANSIENT);
+    sqlite3_bind_int64(stmt.get(), 2, record.file_size);
+    sqlite3_bind_int64(stmt.get(), 3, record.mtime_ns);
+    if (record.content_fingerprint.empty()) {
+        sqlite3_bind_null(stmt.get(), 4);
+    } else {
+        sqlite3_bind_text(stmt.get(), 4, record.content_fingerprint.c_str(), -1, SQLITE_TRANSIENT);
+    }
+    sqlite3_bind_text(stmt.get(), 5, record.excerpt_hash.c_str(), -1, SQLITE_TRANSIENT);
+    sqlite3_bind_text(stmt.get(), 6, record.summary.c_str(), -1, SQLITE_TRANSIENT);
+    sqlite3_bind_text(stmt.get(), 7, record.suggested_name.c_str(), -1, SQLITE_TRANSIENT);
+
+    const bool success = sqlite3_step(stmt.get()) == SQLITE_DONE;
+    if (!success) {
+        db_log(spdlog::level::err, "Failed to store document analysis for '{}': {}", record.file_path, sqlite3_errmsg(db));
+    }
+    return success;
+}
+
 std::vector<std::string>
 DatabaseManager::get_categorization_from_db(const std::string& dir_path,
                                             const std::string& file_name,
@@ -1471,24 +2268,21 @@ DatabaseManager::get_categorization_from_db(const std::string& dir_path,
     const char *sql =
         "SELECT category, subcategory FROM file_categorization "
         "WHERE dir_path = ? AND file_name = ? AND file_type = ?;";
-    sqlite3_stmt *stmtcat = nullptr;
-
-    if (sqlite3_prepare_v2(db, sql, -1, &stmtcat, nullptr) != SQLITE_OK) {
+    CachedStatement statement = prepare_cached(sql);
+    sqlite3_stmt *stmtcat = statement.get();
+    if (!stmtcat) {
         return categorization;
     }
 
     if (sqlite3_bind_text(stmtcat, 1, dir_path.c_str(), -1, SQLITE_TRANSIENT) != SQLITE_OK) {
-        sqlite3_finalize(stmtcat);
         return categorization;
     }
 
     std::string file_type_str = (file_type == FileType::File) ? "F" : "D";
     if (sqlite3_bind_text(stmtcat, 2, file_name.c_str(), -1, SQLITE_TRANSIENT) != SQLITE_OK) {
-        sqlite3_finalize(stmtcat);
         return categorization;
     }
     if (sqlite3_bind_text(stmtcat, 3, file_type_str.c_str(), -1, SQLITE_TRANSIENT) != SQLITE_OK) {
-        sqlite3_finalize(stmtcat);
         return categorization;
     }
 
@@ -1499,7 +2293,6 @@ DatabaseManager::get_categorization_from_db(const std::string& dir_path,
         categorization.emplace_back(subcategory ? subcategory : "");
     }
 
-    sqlite3_finalize(stmtcat);
     return categorization;
 }
 
@@ -1507,14 +2300,14 @@ bool DatabaseManager::is_file_already_categorized(const std::string &file_name)
     if (!db) return false;
 
     const char *sql = "SELECT 1 FROM file_categorization WHERE file_name = ? LIMIT 1;";
-    sqlite3_stmt *stmt = nullptr;
-    if (sqlite3_prepare_v2(db, sql, -1, &stmt, nullptr) != SQLITE_OK) {
+    CachedStatement statement = prepare_cached(sql);
+    sqlite3_stmt* stmt = statement.get();
+    if (!stmt) {
         return false;
     }
 
     sqlite3_bind_text(stmt, 1, file_name.c_str(), -1, SQLITE_TRANSIENT);
     bool exists = sqlite3_step(stmt) == SQLITE_ROW;
-    sqlite3_finalize(stmt);
     return exists;
 }
 
@@ -1523,8 +2316,9 @@ std::vector<std::string> DatabaseManager::get_dir_contents_from_db(const std::st
     if (!db) return results;
 
     const char *sql = "SELECT file_name FROM file_categorization WHERE dir_path = ?;";
-    sqlite3_stmt *stmt = nullptr;
-    if (sqlite3_prepare_v2(db, sql, -1, &stmt, nullptr) != SQLITE_OK) {
+    CachedStatement statement = prepare_cached(sql);
+    sqlite3_stmt* stmt = statement.get();
+    if (!stmt) {
         return results;
     }
 
@@ -1533,7 +2327,6 @@ std::vector<std::string> DatabaseManager::get_dir_contents_from_db(const std::st
         const char *name = reinterpret_cast<const char *>(sqlite3_column_text(stmt, 0));
         results.emplace_back(name ? name : "");
     }
-    sqlite3_finalize(stmt);
     return results;
 }
 
@@ -1567,26 +2360,9 @@ bool DatabaseManager::is_duplicate_category(
 }
 
 std::optional<std::pair<std::string, std::string>> DatabaseManager::build_recent_category_candidate(
-    const char* file_name_text,
     const char* category_text,
-    const char* subcategory_text,
-    const std::string& normalized_extension,
-    bool has_extension) const
+    const char* subcategory_text)
 {
-    std::string file_name = file_name_text ? file_name_text : "";
-    if (file_name.empty()) {
-        return std::nullopt;
-    }
-
-    const std::string candidate_extension = extract_extension_lower(file_name);
-    if (has_extension) {
-        if (candidate_extension != normalized_extension) {
-            return std::nullopt;
-        }
-    } else if (!candidate_extension.empty()) {
-        return std::nullopt;
-    }
-
     std::string category = category_text ? category_text : "";
     if (category.empty()) {
         return std::nullopt;
@@ -1606,12 +2382,14 @@ DatabaseManager::get_recent_categories_for_extension(const std::string& extensio
         return results;
     }
 
-    sqlite3_stmt* stmt = nullptr;
+    // Served by idx_file_categorization_extension, so only the newest rows of this extension are read.
     const char* sql =
-        "SELECT file_name, category, subcategory FROM file_categorization "
-        "WHERE file_type = ? ORDER BY timestamp DESC LIMIT ?";
+        "SELECT category, subcategory FROM file_categorization "
+        "WHERE file_type = ? AND extension = ? ORDER BY timestamp DESC, id DESC LIMIT ?";
 
-    if (sqlite3_prepare_v2(db, sql, -1, &stmt, nullptr) != SQLITE_OK) {
+    CachedStatement statement = prepare_cached(sql);
+    sqlite3_stmt* stmt = statement.get();
+    if (!stmt) {
         db_log(spdlog::level::warn,
                "Failed to prepare recent category lookup: {}",
                sqlite3_errmsg(db));
@@ -1619,23 +2397,17 @@ DatabaseManager::get_recent_categories_for_extension(const std::string& extensio
     }
 
     const std::string type_code(1, file_type == FileType::File ? 'F' : 'D');
+    const std::string normalized_extension = to_lower_copy(extension);
     sqlite3_bind_text(stmt, 1, type_code.c_str(), -1, SQLITE_TRANSIENT);
+    sqlite3_bind_text(stmt, 2, normalized_extension.c_str(), -1, SQLITE_TRANSIENT);
     const std::size_t fetch_limit = std::max<std::size_t>(limit * 5, limit);
-    sqlite3_bind_int(stmt, 2, static_cast<int>(fetch_limit));
-
-    const std::string normalized_extension = to_lower_copy(extension);
-    const bool has_extension = !normalized_extension.empty();
+    sqlite3_bind_int(stmt, 3, static_cast<int>(fetch_limit));
 
     while (sqlite3_step(stmt) == SQLITE_ROW) {
-        const char* file_name_text = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 0));
-        const char* category_text = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 1));
-        const char* subcategory_text = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 2));
-
-        const auto candidate = build_recent_category_candidate(file_name_text,
-                                                               category_text,
-                                                               subcategory_text,
-                                                               normalized_extension,
-                                                               has_extension);
+        const char* category_text = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 0));
+        const char* subcategory_text = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 1));
+
+        const auto candidate = build_recent_category_candidate(category_text, subcategory_text);
         if (!candidate.has_value()) {
             continue;
         }
@@ -1649,7 +2421,6 @@ DatabaseManager::get_recent_categories_for_extension(const std::string& extensio
         }
     }
 
-    sqlite3_finalize(stmt);
     return results;
 }
 
@@ -1670,14 +2441,14 @@ bool DatabaseManager::file_exists_in_db(const std::string &file_name, const std:
 
     const char *sql =
         "SELECT 1 FROM file_categorization WHERE file_name = ? AND dir_path = ? LIMIT 1;";
-    sqlite3_stmt *stmt = nullptr;
-    if (sqlite3_prepare_v2(db, sql, -1, &stmt, nullptr) != SQLITE_OK) {
+    CachedStatement statement = prepare_cached(sql);
+    sqlite3_stmt* stmt = statement.get();
+    if (!stmt) {
         return false;
     }
 
     sqlite3_bind_text(stmt, 1, file_name.c_str(), -1, SQLITE_TRANSIENT);
     sqlite3_bind_text(stmt, 2, file_path.c_str(), -1, SQLITE_TRANSIENT);
     bool exists = sqlite3_step(stmt) == SQLITE_ROW;
-    sqlite3_finalize(stmt);
     return exists;
 }
@@ -0,0 +1,126 @@
+#include "DocumentAnalysisCache.hpp"
+#include "ContentFingerprint.hpp"
+#include "DatabaseManager.hpp"
+#include "Utils.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <system_error>
+
+#include <fmt/format.h>
+
+namespace {
+
+struct FileStamp {
+    std::int64_t size{0};
+    std::int64_t mtime_ns{0};
+};
+
+std::optional<FileStamp> stat_file(const std::string& full_path)
+{
+    const std::filesystem::path path = Utils::utf8_to_path(full_path);
+    std::error_code ec;
+    const auto size = std::filesystem::file_size(path, ec);
+    if (ec) {
+        return std::nullopt;
+    }
+    const auto mtime = std::filesystem::last_write_time(path, ec);
+    if (ec) {
+        return std::nullopt;
+    }
+    return FileStamp{
+        static_cast<std::int64_t>(size),
+        static_cast<std::int64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(mtime.time_since_epoch()).count())};
+}
+
+std::string fingerprint_if_enabled(const std::string& full_path)
+{
+    if (!ContentFingerprint::enabled()) {
+        return std::string();
+    }
+    return ContentFingerprint::compute(full_path).value_or(std::string());
+}
+
+DocumentAnalysisResult to_result(const DatabaseManager::DocumentAnalysisRecord& record)
+{
+    DocumentAnalysisResult result;
+    result.summary = record.summary;
+    result.suggested_name = record.suggested_name;
+    return result;
+}
+
+} // namespace
+
+DocumentAnalysisCache::DocumentAnalysisCache(DatabaseManager& db)
+    : db_(db)
+{
+}
+
+std::optional<DocumentAnalysisResult> DocumentAnalysisCache::lookup(const std::string& full_path)
+{
+    auto record = db_.get_document_analysis(full_path);
+    if (!record) {
+        return std::nullopt;
+    }
+    const auto stamp = stat_file(full_path);
+    if (!stamp || stamp->size != record->file_size) {
+        return std::nullopt;
+    }
+    if (stamp->mtime_ns == record->mtime_ns) {
+        return to_result(*record);
+    }
+
+    // Touched but possibly not edited (copied back, restored, synced): compare the content.
+    if (record->content_fingerprint.empty() ||
+        fingerprint_if_enabled(full_path) != record->content_fingerprint) {
+        return std::nullopt;
+    }
+    record->mtime_ns = stamp->mtime_ns;
+    db_.upsert_document_analysis(*record);
+    return to_result(*record);
+}
+
+std::optional<DocumentAnalysisResult> DocumentAnalysisCache::lookup_excerpt(const std::string& full_path,
+                                                                            const std::string& excerpt)
+{
+    if (excerpt.empty()) {
+        return std::nullopt;
+    }
+    auto record = db_.get_document_analysis(full_path);
+    if (!record || record->excerpt_hash != hash_excerpt(excerpt)) {
+        return std::nullopt;
+    }
+    if (const auto stamp = stat_file(full_path)) {
+        record->file_size = stamp->size;
+        record->mtime_ns = stamp->mtime_ns;
+        record->content_fingerprint = fingerprint_if_enabled(full_path);
+        db_.upsert_document_analysis(*record);
+    }
+    return to_result(*record);
+}
+
+void DocumentAnalysisCache::store(const std::string& full_path,
+                                  const std::string& excerpt,
+                                  const DocumentAnalysisResult& result)
+{
+    const auto stamp = stat_file(full_path);
+    if (!stamp) {
+        return;
+    }
+    DatabaseManager::DocumentAnalysisRecord record;
+    record.file_path = full_path;
+    record.file_size = stamp->size;
+    record.mtime_ns = stamp->mtime_ns;
+    record.content_fingerprint = fingerprint_if_enabled(full_path);
+    record.excerpt_hash = hash_excerpt(excerpt);
+    record.summary = result.summary;
+    record.suggested_name = result.suggested_name;
+    db_.upsert_document_analysis(record);
+}
+
+std::string DocumentAnalysisCache::hash_excerpt(const std::string& excerpt)
+{
+    return fmt::format("{:016x}", ContentFingerprint::xxh64(excerpt.data(), excerpt.size(), 0));
+}
@@ -0,0 +1,121 @@
+#include "DocumentExcerptPipeline.hpp"
+#include "Logger.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <exception>
+#include <utility>
+
+namespace {
+
+constexpr const char* kDocumentThreadsEnv = "AI_FILE_SORTER_DOCUMENT_THREADS";
+constexpr std::size_t kMaxDefaultDocumentThreads = 4;
+constexpr std::size_t kMaxDocumentThreads = 32;
+
+} // namespace
+
+DocumentExcerptPipeline::DocumentExcerptPipeline(std::vector<std::filesystem::path> paths,
+                                                 Extractor extractor,
+                                                 std::size_t threads,
+                                                 std::size_t lookahead)
+    : paths_(std::move(paths)),
+      extractor_(std::move(extractor)),
+      lookahead_(std::max<std::size_t>(1, lookahead)),
+      results_(paths_.size())
+{
+    const std::size_t worker_count = std::min(std::max<std::size_t>(1, threads),
+                                              std::max<std::size_t>(1, paths_.size()));
+    workers_.reserve(worker_count);
+    for (std::size_t i = 0; i < worker_count; ++i) {
+        workers_.emplace_back(&DocumentExcerptPipeline::run_worker, this);
+    }
+}
+
+DocumentExcerptPipeline::~DocumentExcerptPipeline()
+{
+    cancel();
+    for (auto& worker : workers_) {
+        worker.join();
+    }
+}
+
+std::optional<DocumentExcerptPipeline::Excerpt> DocumentExcerptPipeline::next()
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (next_to_return_ >= results_.size()) {
+        return std::nullopt;
+    }
+    ready_cv_.wait(lock, [this]() { return cancelled_ || results_[next_to_return_].has_value(); });
+    if (cancelled_) {
+        return std::nullopt;
+    }
+    Excerpt excerpt = std::move(*results_[next_to_return_]);
+    results_[next_to_return_].reset();
+    ++next_to_return_;
+    // Taking a result frees a lookahead slot for the workers.
+    work_cv_.notify_one();
+    return excerpt;
+}
+
+void DocumentExcerptPipeline::cancel()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    cancelled_ = true;
+    work_cv_.notify_all();
+    ready_cv_.notify_all();
+}
+
+std::size_t DocumentExcerptPipeline::resolve_thread_count()
+{
+    const std::size_t hardware = std::max(1u, std::thread::hardware_concurrency());
+    std::size_t threads = std::min(hardware, kMaxDefaultDocumentThreads);
+    const char* env = std::getenv(kDocumentThreadsEnv);
+    if (env && *env != '\0') {
+        auto logger = Logger::get_logger("core_logger");
+        try {
+            const int parsed = std::stoi(env);
+            if (parsed > 0) {
+                threads = std::min(static_cast<std::size_t>(parsed), kMaxDocumentThreads);
+            } else if (logger) {
+                logger->warn("Ignoring non-positive document thread count '{}'", env);
+            }
+        } catch (const std::exception& ex) {
+            if (logger) {
+                logger->warn("Failed to parse document thread count '{}': {}", env, ex.what());
+            }
+        }
+    }
+    return threads;
+}
+
+void DocumentExcerptPipeline::run_worker()
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true) {
+        work_cv_.wait(lock, [this]() {
+            return cancelled_ || next_to_extract_ >= paths_.size() ||
+                   next_to_extract_ < next_to_return_ + lookahead_;
+        });
+        if (cancelled_ || next_to_extract_ >= paths_.size()) {
+            return;
+        }
+        const std::size_t index = next_to_extract_++;
+        lock.unlock();
+
+        Excerpt excerpt;
+        excerpt.path = paths_[index];
+        try {
+            excerpt.text = extractor_(excerpt.path);
+        } catch (const std::exception& ex) {
+            excerpt.error = ex.what();
+        } catch (...) {
+            excerpt.error = "Unknown extraction error";
+        }
+
+        lock.lock();
+        results_[index] = std::move(excerpt);
+        if (index == next_to_return_) {
+            ready_cv_.notify_one();
+        }
+    }
+}
@@ -1,22 +1,17 @@
 #include "DocumentTextAnalyzer.hpp"
 
 #include "ILLMClient.hpp"
+#include "PdfTextExtractor.hpp"
+#include "XmlTextStream.hpp"
 
+#include <QElapsedTimer>
 #include <QProcess>
 #include <QStandardPaths>
 #include <QStringList>
 
-#if defined(AI_FILE_SORTER_USE_PDFIUM)
-#include "fpdf_doc.h"
-#include "fpdf_text.h"
-#include "fpdfview.h"
-#endif
 #if defined(AI_FILE_SORTER_USE_LIBZIP)
 #include <zip.h>
 #endif
-#if defined(AI_FILE_SORTER_USE_PUGIXML)
-#include <pugixml.hpp>
-#endif
 
 #if __has_include(<jsoncpp/json/json.h>)
 #include <jsoncpp/json/json.h>
@@ -42,6 +37,7 @@ namespace {
 constexpr size_t kDefaultMaxChars = 8000;
 constexpr int kDefaultMaxTokens = 256;
 constexpr size_t kMaxProcessOutput = 200000;
+constexpr size_t kStreamChunkBytes = 4096;
 
 std::string to_lower_copy(std::string value) {
     std::transform(value.begin(), value.end(), value.begin(), [](unsigned char ch) {
@@ -99,72 +95,6 @@ std::vector<std::string> split_words(const QString& value) {
     return words;
 }
 
-std::string strip_xml_tags(const std::string& xml) {
-    std::string output;
-    output.reserve(xml.size());
-    bool in_tag = false;
-    for (char ch : xml) {
-        if (ch == '<') {
-            in_tag = true;
-            continue;
-        }
-        if (ch == '>') {
-            in_tag = false;
-            continue;
-        }
-        if (!in_tag) {
-            output.push_back(ch);
-        }
-    }
-    return output;
-}
-
-void replace_all(std::string& value, std::string_view from, std::string_view to) {
-    if (from.empty()) {
-        return;
-    }
-    size_t pos = 0;
-    while ((pos = value.find(from.data(), pos, from.size())) != std::string::npos) {
-        value.replace(pos, from.size(), to.data(), to.size());
-        pos += to.size();
-    }
-}
-
-std::string decode_basic_entities(std::string value) {
-    replace_all(value, "&amp;", "&");
-    replace_all(value, "&lt;", "<");
-    replace_all(value, "&gt;", ">");
-    replace_all(value, "&quot;", "\"");
-    replace_all(value, "&apos;", "'");
-    return value;
-}
-
-#if defined(AI_FILE_SORTER_USE_PUGIXML)
-void append_node_text(const pugi::xml_node& node, std::string& out) {
-    if (node.type() == pugi::node_pcdata || node.type() == pugi::node_cdata) {
-        out.append(node.value());
-        out.push_back(' ');
-    }
-    for (const auto& child : node.children()) {
-        append_node_text(child, out);
-    }
-}
-#endif
-
-std::string extract_xml_text(const std::string& xml) {
-#if defined(AI_FILE_SORTER_USE_PUGIXML)
-    pugi::xml_document doc;
-    pugi::xml_parse_result result = doc.load_string(xml.c_str(), pugi::parse_default | pugi::parse_ws_pcdata);
-    if (result) {
-        std::string out;
-        out.reserve(xml.size());
-        append_node_text(doc, out);
-        return out;
-    }
-#endif
-    return strip_xml_tags(xml);
-}
-
 std::optional<std::string> run_process(const QString& program,
                                        const QStringList& args,
                                        int timeout_ms) {
@@ -257,6 +187,108 @@ std::optional<std::string> extract_zip_member(const std::filesystem::path& path,
     return std::nullopt;
 }
 
+// Feeds the program's stdout into the stream as it arrives and kills the
+// program once the stream is full, so large parts are never fully inflated.
+bool stream_process_output(const QString& program,
+                           const QStringList& args,
+                           int timeout_ms,
+                           XmlTextStream& stream) {
+    QProcess process;
+    process.start(program, args);
+    if (!process.waitForStarted()) {
+        return false;
+    }
+    QElapsedTimer timer;
+    timer.start();
+    while (!stream.full()) {
+        const QByteArray chunk = process.read(static_cast<qint64>(kStreamChunkBytes));
+        if (!chunk.isEmpty()) {
+            stream.feed(std::string_view(chunk.constData(), static_cast<size_t>(chunk.size())));
+            continue;
+        }
+        if (process.state() == QProcess::NotRunning) {
+            break;
+        }
+        const qint64 remaining = timeout_ms - timer.elapsed();
+        if (remaining <= 0 ||
+            (!process.waitForReadyRead(static_cast<int>(remaining)) &&
+             process.state() != QProcess::NotRunning)) {
+            process.kill();
+            process.waitForFinished();
+            return false;
+        }
+    }
+    if (process.state() != QProcess::NotRunning) {
+        process.kill();
+        process.waitForFinished();
+        return true;
+    }
+    return stream.full() ||
+           (process.exitStatus() == QProcess::NormalExit && process.exitCode() == 0);
+}
+
+#if defined(AI_FILE_SORTER_USE_LIBZIP)
+std::string extract_zip_text_libzip(const std::filesystem::path& path,
+                                    std::initializer_list<QString> members,
+                                    size_t max_chars) {
+    int error_code = 0;
+    zip_t* archive = zip_open(path.string().c_str(), ZIP_RDONLY, &error_code);
+    if (!archive) {
+        return {};
+    }
+    XmlTextStream stream(max_chars);
+    std::array<char, kStreamChunkBytes> buffer{};
+    for (const auto& member : members) {
+        const QByteArray member_name = member.toUtf8();
+        zip_file_t* file = zip_fopen(archive, member_name.constData(), 0);
+        if (!file) {
+            continue;
+        }
+        // zip_fread inflates on demand, so stopping early skips the rest of the part.
+        zip_int64_t read = 0;
+        while ((read = zip_fread(file, buffer.data(), buffer.size())) > 0 &&
+               stream.feed(std::string_view(buffer.data(), static_cast<size_t>(read)))) {
+        }
+        zip_fclose(file);
+        std::string text = stream.take();
+        if (!text.empty()) {
+            zip_close(archive);
+            return text;
+        }
+    }
+    zip_close(archive);
+    return {};
+}
+#endif
+
+// Text of the first listed XML part that has any, capped at max_chars.
+std::string extract_zip_text(const std::filesystem::path& path,
+                             std::initializer_list<QString> members,
+                             int timeout_ms,
+                             size_t max_chars)
+{
+#if defined(AI_FILE_SORTER_USE_LIBZIP)
+    if (std::string text = extract_zip_text_libzip(path, members, max_chars); !text.empty()) {
+        return text;
+    }
+#endif
+    const auto unzip = find_executable(QStringLiteral("unzip"));
+    if (!unzip) {
+        return {};
+    }
+    const QString file_path = QString::fromStdString(path.string());
+    XmlTextStream stream(max_chars);
+    for (const auto& member : members) {
+        const bool ok = stream_process_output(
+            *unzip, {QStringLiteral("-p"), file_path, member}, timeout_ms, stream);
+        std::string text = stream.take();
+        if (ok && !text.empty()) {
+            return text;
+        }
+    }
+    return {};
+}
+
 std::string read_file_prefix(const std::filesystem::path& path, size_t max_chars) {
     std::ifstream file(path, std::ios::binary);
     if (!file) {
@@ -341,64 +373,6 @@ std::optional<std::string> extract_pdf_date(const std::filesystem::path& path) {
     return std::nullopt;
 }
 
-#if defined(AI_FILE_SORTER_USE_PDFIUM)
-class PdfiumLibraryGuard {
-public:
-    PdfiumLibraryGuard() { FPDF_InitLibrary(); }
-    ~PdfiumLibraryGuard() { FPDF_DestroyLibrary(); }
-};
-
-PdfiumLibraryGuard& pdfium_library() {
-    static PdfiumLibraryGuard guard;
-    return guard;
-}
-
-std::string extract_pdf_text_pdfium(const std::filesystem::path& path, size_t max_chars) {
-    pdfium_library();
-    const std::string pdf_path = path.string();
-    FPDF_DOCUMENT doc = FPDF_LoadDocument(pdf_path.c_str(), nullptr);
-    if (!doc) {
-        return {};
-    }
-    const int page_count = FPDF_GetPageCount(doc);
-    std::string result;
-    for (int i = 0; i < page_count && result.size() < max_chars; ++i) {
-        FPDF_PAGE page = FPDF_LoadPage(doc, i);
-        if (!page) {
-            continue;
-        }
-        FPDF_TEXTPAGE text_page = FPDFText_LoadPage(page);
-        if (!text_page) {
-            FPDF_ClosePage(page);
-            continue;
-        }
-        const int total_chars = FPDFText_CountChars(text_page);
-        const int chunk = 4096;
-        int offset = 0;
-        while (offset < total_chars && result.size() < max_chars) {
-            const int take = std::min(chunk, total_chars - offset);
-            std::vector<unsigned short> buffer(static_cast<size_t>(take + 1));
-            const int extracted = FPDFText_GetText(text_page, offset, take, buffer.data());
-            if (extracted <= 0) {
-                break;
-            }
-            const int count = std::max(0, extracted - 1);
-            QString text = QString::fromUtf16(reinterpret_cast<const char16_t*>(buffer.data()), count);
-            result.append(text.toStdString());
-            if (result.size() >= max_chars) {
-                result.resize(max_chars);
-                break;
-            }
-            offset += take;
-        }
-        FPDFText_ClosePage(text_page);
-        FPDF_ClosePage(page);
-    }
-    FPDF_CloseDocument(doc);
-    return result;
-}
-#endif
-
 const std::unordered_set<std::string> kDocumentExtensions = {
     ".txt", ".md", ".markdown", ".rtf", ".csv", ".tsv", ".log", ".json", ".xml", ".yml", ".yaml",
     ".ini", ".cfg", ".conf", ".html", ".htm", ".tex", ".rst", ".pdf", ".docx", ".xlsx", ".pptx",
@@ -509,13 +483,23 @@ DocumentTextAnalyzer::DocumentTextAnalyzer(Settings settings)
 DocumentAnalysisResult DocumentTextAnalyzer::analyze(const std::filesystem::path& document_path,
                                                      ILLMClient& llm) const
 {
-    DocumentAnalysisResult result;
-    const std::string raw_text = extract_text(document_path);
-    if (raw_text.empty()) {
+    return analyze_excerpt(extract_excerpt(document_path), document_path, llm);
+}
+
+std::string DocumentTextAnalyzer::extract_excerpt(const std::filesystem::path& document_path) const
+{
+    return truncate_excerpt(extract_text(document_path), settings_.max_characters);
+}
+
+DocumentAnalysisResult DocumentTextAnalyzer::analyze_excerpt(const std::string& excerpt,
+                                                             const std::filesystem::path& document_path,
+                                                             ILLMClient& llm) const
+{
+    if (excerpt.empty()) {
         throw std::runtime_error("No extractable text");
     }
 
-    const std::string excerpt = truncate_excerpt(raw_text, settings_.max_characters);
+    DocumentAnalysisResult result;
     const std::string prompt = build_prompt(excerpt, document_path.filename().string());
     const std::string response = llm.complete_prompt(prompt, settings_.max_tokens);
 
@@ -577,11 +561,13 @@ std::string DocumentTextAnalyzer::extract_text(const std::filesystem::path& path
     }
 
     if (ext == ".pdf") {
-#if defined(AI_FILE_SORTER_USE_PDFIUM)
-        if (auto output = extract_pdf_text_pdfium(path, settings_.max_characters); !output.empty()) {
-            return collapse_whitespace(output);
+        if (PdfTextExtractor::available()) {
+            PdfTextExtractor::Budget budget;
+            budget.max_characters = settings_.max_characters;
+            if (auto output = PdfTextExtractor::instance().extract(path, budget); !output.empty()) {
+                return collapse_whitespace(output);
+            }
         }
-#endif
         const auto pdftotext = find_executable(QStringLiteral("pdftotext"));
         if (!pdftotext) {
             return {};
@@ -599,65 +585,31 @@ std::string DocumentTextAnalyzer::extract_text(const std::filesystem::path& path
         return collapse_whitespace(*output);
     }
 
+    // Office parts are streamed through XmlTextStream, which stops inflating once the
+    // excerpt budget is met and already yields decoded, whitespace-collapsed text.
     if (ext == ".docx") {
-        auto xml = extract_zip_member(path, {QStringLiteral("word/document.xml")}, 7000);
-        if (!xml) {
-            return {};
-        }
-        std::string text = extract_xml_text(*xml);
-        text = decode_basic_entities(text);
-        if (text.size() > settings_.max_characters) {
-            text.resize(settings_.max_characters);
-        }
-        return collapse_whitespace(text);
+        return extract_zip_text(path, {QStringLiteral("word/document.xml")}, 7000, settings_.max_characters);
     }
 
     if (ext == ".xlsx") {
-        auto xml = extract_zip_member(
-            path,
-            {QStringLiteral("xl/sharedStrings.xml"),
-             QStringLiteral("xl/worksheets/sheet1.xml"),
-             QStringLiteral("xl/worksheets/sheet2.xml")},
-            7000);
-        if (!xml) {
-            return {};
-        }
-        std::string text = extract_xml_text(*xml);
-        text = decode_basic_entities(text);
-        if (text.size() > settings_.max_characters) {
-            text.resize(settings_.max_characters);
-        }
-        return collapse_whitespace(text);
+        return extract_zip_text(path,
+                                {QStringLiteral("xl/sharedStrings.xml"),
+                                 QStringLiteral("xl/worksheets/sheet1.xml"),
+                                 QStringLiteral("xl/worksheets/sheet2.xml")},
+                                7000,
+                                settings_.max_characters);
     }
 
     if (ext == ".pptx") {
-        auto xml = extract_zip_member(
-            path,
-            {QStringLiteral("ppt/slides/slide1.xml"),
-             QStringLiteral("ppt/slides/slide2.xml")},
-            7000);
-        if (!xml) {
-            return {};
-        }
-        std::string text = extract_xml_text(*xml);
-        text = decode_basic_entities(text);
-        if (text.size() > settings_.max_characters) {
-            text.resize(settings_.max_characters);
-        }
-        return collapse_whitespace(text);
+        return extract_zip_text(path,
+                                {QStringLiteral("ppt/slides/slide1.xml"),
+                                 QStringLiteral("ppt/slides/slide2.xml")},
+                                7000,
+                                settings_.max_characters);
     }
 
     if (ext == ".odt" || ext == ".ods" || ext == ".odp") {
-        auto xml = extract_zip_member(path, {QStringLiteral("content.xml")}, 7000);
-        if (!xml) {
-            return {};
-        }
-        std::string text = extract_xml_text(*xml);
-        text = decode_basic_entities(text);
-        if (text.size() > settings_.max_characters) {
-            text.resize(settings_.max_characters);
-        }
-        return collapse_whitespace(text);
+        return extract_zip_text(path, {QStringLiteral("content.xml")}, 7000, settings_.max_characters);
     }
 
     return {};
@@ -0,0 +1,50 @@
+#include "EntryBatchQueue.hpp"
+
+#include <algorithm>
+#include <utility>
+
+EntryBatchQueue::EntryBatchQueue(std::size_t capacity)
+    : capacity_(std::max<std::size_t>(1, capacity))
+{
+}
+
+bool EntryBatchQueue::push(std::vector<FileEntry>&& batch)
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    not_full_.wait(lock, [this]() { return cancelled_ || batches_.size() < capacity_; });
+    if (cancelled_) {
+        return false;
+    }
+    batches_.push_back(std::move(batch));
+    not_empty_.notify_one();
+    return true;
+}
+
+std::optional<std::vector<FileEntry>> EntryBatchQueue::pop()
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    not_empty_.wait(lock, [this]() { return cancelled_ || closed_ || !batches_.empty(); });
+    if (cancelled_ || batches_.empty()) {
+        return std::nullopt;
+    }
+    std::vector<FileEntry> batch = std::move(batches_.front());
+    batches_.pop_front();
+    not_full_.notify_one();
+    return batch;
+}
+
+void EntryBatchQueue::close()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    closed_ = true;
+    not_empty_.notify_all();
+}
+
+void EntryBatchQueue::cancel()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    cancelled_ = true;
+    batches_.clear();
+    not_full_.notify_all();
+    not_empty_.notify_all();
+}
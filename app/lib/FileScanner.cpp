@@ -2,21 +2,125 @@
 #include "Logger.hpp"
 #include "Utils.hpp"
 #include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdlib>
+#include <deque>
+#include <exception>
 #include <iostream>
 #include <filesystem>
+#include <iterator>
+#include <memory>
+#include <mutex>
 #include <optional>
+#include <thread>
+#include <unordered_map>
 #include <unordered_set>
 
 #ifdef _WIN32
 #include <windows.h>
 #endif
 
+#ifdef __linux__
+#include <cerrno>
+#include <cstring>
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
 namespace fs = std::filesystem;
 
 namespace {
 
 constexpr fs::directory_options kIteratorOptions =
     fs::directory_options::skip_permission_denied;
+constexpr const char* kScanThreadsEnv = "AI_FILE_SORTER_SCAN_THREADS";
+constexpr std::size_t kMaxDefaultScanThreads = 8;
+constexpr std::size_t kMaxScanThreads = 64;
+constexpr std::chrono::milliseconds kIdleWait{2};
+constexpr std::size_t kPrefetchedListingsPerThread = 4;
+
+// Recursive scans spend most of their time waiting on directory metadata, so a few threads pay off
+// even on a single disk or network share.
+std::size_t resolve_scan_thread_count(const std::shared_ptr<spdlog::logger>& logger)
+{
+    const std::size_t hardware = std::max(1u, std::thread::hardware_concurrency());
+    std::size_t threads = std::min(hardware, kMaxDefaultScanThreads);
+    const char* env = std::getenv(kScanThreadsEnv);
+    if (env && *env != '\0') {
+        try {
+            const int parsed = std::stoi(env);
+            if (parsed > 0) {
+                threads = std::min(static_cast<std::size_t>(parsed), kMaxScanThreads);
+            } else if (logger) {
+                logger->warn("Ignoring non-positive scan thread count '{}'", env);
+            }
+        } catch (const std::exception& ex) {
+            if (logger) {
+                logger->warn("Failed to parse scan thread count '{}': {}", env, ex.what());
+            }
+        }
+    }
+    return threads;
+}
+
+constexpr const char* kScanBackendEnv = "AI_FILE_SORTER_SCAN_BACKEND";
+
+bool use_native_listing()
+{
+#ifdef __linux__
+    const char* env = std::getenv(kScanBackendEnv);
+    if (!env) {
+        return true;
+    }
+    const std::string value(env);
+    return value != "std" && value != "filesystem";
+#else
+    return false;
+#endif
+}
+
+#ifdef __linux__
+// Mirrors the kernel's struct linux_dirent64, which glibc does not expose.
+struct LinuxDirent64 {
+    std::uint64_t d_ino;
+    std::int64_t d_off;
+    unsigned short d_reclen;
+    unsigned char d_type;
+    char d_name[1];
+};
+
+constexpr std::size_t kDirentBufferSize = 64 * 1024;
+
+class DirectoryFd {
+public:
+    explicit DirectoryFd(int fd) : fd_(fd) {}
+    ~DirectoryFd() { if (fd_ >= 0) ::close(fd_); }
+    DirectoryFd(const DirectoryFd&) = delete;
+    DirectoryFd& operator=(const DirectoryFd&) = delete;
+    int get() const { return fd_; }
+
+private:
+    int fd_;
+};
+
+// Joins like fs::path::operator/ does for a relative file name on POSIX.
+void join_path(std::string& out, const std::string& directory, const char* name, std::size_t name_length)
+{
+    out.clear();
+    out.reserve(directory.size() + 1 + name_length);
+    out.append(directory);
+    if (!directory.empty() && directory.back() != '/') {
+        out.push_back('/');
+    }
+    out.append(name, name_length);
+}
+#endif
 
 } // namespace
 
@@ -24,6 +128,7 @@ struct FileScanner::ScanContext {
     bool include_files{false};
     bool include_directories{false};
     bool include_hidden{false};
+    bool native_listing{false};
     std::shared_ptr<spdlog::logger> logger;
 };
 
@@ -38,11 +143,7 @@ FileScanner::get_directory_entries(const std::string &directory_path,
         logger->debug("Scanning directory '{}' with options mask {}", directory_path, static_cast<int>(options));
     }
 
-    ScanContext context;
-    context.include_files = has_flag(options, FileScanOptions::Files);
-    context.include_directories = has_flag(options, FileScanOptions::Directories);
-    context.include_hidden = has_flag(options, FileScanOptions::HiddenFiles);
-    context.logger = logger;
+    const ScanContext context = make_scan_context(options, logger);
     const bool recursive = has_flag(options, FileScanOptions::Recursive);
 
     try {
@@ -50,7 +151,12 @@ FileScanner::get_directory_entries(const std::string &directory_path,
         if (!recursive) {
             scan_non_recursive(scan_path, context, file_paths_and_names);
         } else {
-            scan_recursive(scan_path, context, file_paths_and_names);
+            const std::size_t thread_count = resolve_scan_thread_count(logger);
+            if (thread_count > 1) {
+                scan_recursive_parallel(scan_path, context, file_paths_and_names, thread_count);
+            } else {
+                scan_recursive(scan_path, context, file_paths_and_names);
+            }
         }
     } catch (const fs::filesystem_error& ex) {
         if (logger) {
@@ -67,10 +173,242 @@ FileScanner::get_directory_entries(const std::string &directory_path,
     return file_paths_and_names;
 }
 
+void FileScanner::scan_directory_entries(const std::string& directory_path,
+                                         FileScanOptions options,
+                                         std::size_t batch_size,
+                                         const EntryBatchSink& sink)
+{
+    auto logger = Logger::get_logger("core_logger");
+    if (logger) {
+        logger->debug("Streaming scan of '{}' with options mask {}", directory_path, static_cast<int>(options));
+    }
+
+    const ScanContext context = make_scan_context(options, logger);
+    batch_size = std::max<std::size_t>(1, batch_size);
+    std::size_t total = 0;
+    bool stopped = false;
+    std::vector<FileEntry> batch;
+
+    // Hands over full batches; a partial batch is kept until the next directory or the end of the scan.
+    const auto flush = [&](bool final) {
+        std::size_t offset = 0;
+        while (!stopped && (batch.size() - offset >= batch_size || (final && offset < batch.size()))) {
+            const std::size_t count = std::min(batch_size, batch.size() - offset);
+            const auto first = batch.begin() + static_cast<std::ptrdiff_t>(offset);
+            std::vector<FileEntry> chunk(std::make_move_iterator(first),
+                                         std::make_move_iterator(first + static_cast<std::ptrdiff_t>(count)));
+            offset += count;
+            total += chunk.size();
+            stopped = !sink(std::move(chunk));
+        }
+        batch.erase(batch.begin(), batch.begin() + static_cast<std::ptrdiff_t>(offset));
+    };
+
+    try {
+        const fs::path scan_path = Utils::utf8_to_path(directory_path);
+        if (!has_flag(options, FileScanOptions::Recursive)) {
+            scan_non_recursive(scan_path, context, batch);
+        } else {
+            // Walks in the same order as scan_recursive() so streamed and materialized scans agree;
+            // the prefetcher lists the directories ahead of the walk.
+            DirectoryPrefetcher prefetcher(*this, options, directory_path);
+            std::vector<std::string> pending_dirs{directory_path};
+            while (!pending_dirs.empty() && !stopped) {
+                const std::string current_dir = std::move(pending_dirs.back());
+                pending_dirs.pop_back();
+
+                DirectoryContents contents = prefetcher.take(current_dir);
+                batch.insert(batch.end(),
+                             std::make_move_iterator(contents.entries.begin()),
+                             std::make_move_iterator(contents.entries.end()));
+                for (auto& subdirectory : contents.subdirectories) {
+                    prefetcher.request(subdirectory);
+                    pending_dirs.push_back(std::move(subdirectory));
+                }
+                flush(false);
+            }
+        }
+        flush(true);
+    } catch (const fs::filesystem_error& ex) {
+        if (logger) {
+            logger->warn("Error while scanning '{}': {}", directory_path, ex.what());
+        }
+        throw;
+    }
+
+    if (logger) {
+        logger->info("Streaming scan {} for '{}': {} item(s) delivered",
+                     stopped ? "stopped" : "complete", directory_path, total);
+    }
+}
+
+FileScanner::DirectoryContents
+FileScanner::list_directory_contents(const std::string& directory_path,
+                                     FileScanOptions options,
+                                     bool is_scan_root)
+{
+    const ScanContext context = make_scan_context(options, Logger::get_logger("core_logger"));
+    const fs::path directory = Utils::utf8_to_path(directory_path);
+
+    DirectoryContents contents;
+    std::vector<fs::path> subdirectories;
+    contents.complete = list_directory(directory, is_scan_root, context, contents.entries,
+                                       subdirectories, &contents.entry_inodes);
+    if (has_flag(options, FileScanOptions::Recursive)) {
+        contents.subdirectories.reserve(subdirectories.size());
+        for (const auto& subdirectory : subdirectories) {
+            contents.subdirectories.push_back(Utils::path_to_utf8(subdirectory));
+        }
+    }
+    return contents;
+}
+
+struct FileScanner::DirectoryPrefetcher::State {
+    struct Slot {
+        bool started{false};
+        bool done{false};
+        DirectoryContents contents;
+        std::exception_ptr error;
+    };
+
+    std::mutex mutex;
+    std::condition_variable changed;
+    std::vector<std::string> queued;
+    std::unordered_map<std::string, Slot> slots;
+    std::size_t held{0};
+    std::size_t max_held{0};
+    bool stopping{false};
+};
+
+FileScanner::DirectoryPrefetcher::DirectoryPrefetcher(FileScanner& scanner,
+                                                      FileScanOptions options,
+                                                      std::string scan_root)
+    : scanner(scanner),
+      options(options),
+      scan_root(std::move(scan_root)),
+      state(std::make_unique<State>())
+{
+    // The walker lists whatever it reaches first itself, so it counts as one of the scan threads.
+    const std::size_t thread_count = resolve_scan_thread_count(Logger::get_logger("core_logger"));
+    if (thread_count < 2 || !has_flag(options, FileScanOptions::Recursive)) {
+        return;
+    }
+    state->max_held = (thread_count - 1) * kPrefetchedListingsPerThread;
+    threads.reserve(thread_count - 1);
+    for (std::size_t i = 1; i < thread_count; ++i) {
+        threads.emplace_back(&DirectoryPrefetcher::run, this);
+    }
+}
+
+FileScanner::DirectoryPrefetcher::~DirectoryPrefetcher()
+{
+    {
+        std::lock_guard<std::mutex> lock(state->mutex);
+        state->stopping = true;
+    }
+    state->changed.notify_all();
+    for (auto& thread : threads) {
+        thread.join();
+    }
+}
+
+void FileScanner::DirectoryPrefetcher::request(const std::string& directory)
+{
+    if (threads.empty()) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(state->mutex);
+        if (!state->slots.try_emplace(directory).second) {
+            return;
+        }
+        state->queued.push_back(directory);
+    }
+    state->changed.notify_one();
+}
+
+FileScanner::DirectoryContents FileScanner::DirectoryPrefetcher::take(const std::string& directory)
+{
+    {
+        std::unique_lock<std::mutex> lock(state->mutex);
+        const auto it = state->slots.find(directory);
+        if (it != state->slots.end() && it->second.started) {
+            state->changed.wait(lock, [&]() { return it->second.done; });
+            State::Slot slot = std::move(it->second);
+            state->slots.erase(it);
+            --state->held;
+            lock.unlock();
+            state->changed.notify_all();
+            if (slot.error) {
+                std::rethrow_exception(slot.error);
+            }
+            return std::move(slot.contents);
+        }
+        if (it != state->slots.end()) {
+            // Not picked up yet: listing it here is quicker than waiting for a free thread.
+            state->slots.erase(it);
+            state->queued.erase(std::find(state->queued.begin(), state->queued.end(), directory));
+        }
+    }
+    return scanner.list_directory_contents(directory, options, directory == scan_root);
+}
+
+void FileScanner::DirectoryPrefetcher::run()
+{
+    std::unique_lock<std::mutex> lock(state->mutex);
+    for (;;) {
+        state->changed.wait(lock, [&]() {
+            return state->stopping || (!state->queued.empty() && state->held < state->max_held);
+        });
+        if (state->stopping) {
+            return;
+        }
+        const std::string directory = std::move(state->queued.back());
+        state->queued.pop_back();
+        state->slots[directory].started = true;
+        ++state->held;
+        lock.unlock();
+
+        DirectoryContents contents;
+        std::exception_ptr error;
+        try {
+            contents = scanner.list_directory_contents(directory, options, directory == scan_root);
+        } catch (...) {
+            error = std::current_exception();
+        }
+
+        lock.lock();
+        State::Slot& slot = state->slots[directory];
+        slot.contents = std::move(contents);
+        slot.error = error;
+        slot.done = true;
+        state->changed.notify_all();
+    }
+}
+
+FileScanner::ScanContext FileScanner::make_scan_context(FileScanOptions options,
+                                                        std::shared_ptr<spdlog::logger> logger)
+{
+    ScanContext context;
+    context.include_files = has_flag(options, FileScanOptions::Files);
+    context.include_directories = has_flag(options, FileScanOptions::Directories);
+    context.include_hidden = has_flag(options, FileScanOptions::HiddenFiles);
+    context.native_listing = use_native_listing();
+    context.logger = std::move(logger);
+    return context;
+}
+
 void FileScanner::scan_non_recursive(const fs::path& scan_path,
                                      const ScanContext& context,
                                      std::vector<FileEntry>& results)
 {
+#ifdef __linux__
+    if (context.native_listing) {
+        list_directory_native(scan_path, true, context, results, nullptr);
+        return;
+    }
+#endif
+
     std::error_code ec;
     fs::directory_iterator it(scan_path, kIteratorOptions, ec);
     if (ec) {
@@ -102,55 +440,312 @@ void FileScanner::scan_recursive(const fs::path& scan_path,
 {
     std::vector<fs::path> pending_dirs;
     pending_dirs.push_back(scan_path);
+    std::vector<fs::path> subdirectories;
 
     while (!pending_dirs.empty()) {
         const fs::path current_dir = pending_dirs.back();
         pending_dirs.pop_back();
 
-        std::error_code open_ec;
-        fs::directory_iterator it(current_dir, kIteratorOptions, open_ec);
-        if (open_ec) {
-            if (current_dir == scan_path) {
-                throw fs::filesystem_error("directory_iterator", current_dir, open_ec);
+        subdirectories.clear();
+        list_directory(current_dir, current_dir == scan_path, context, results, subdirectories);
+        pending_dirs.insert(pending_dirs.end(),
+                            std::make_move_iterator(subdirectories.begin()),
+                            std::make_move_iterator(subdirectories.end()));
+    }
+}
+
+bool FileScanner::list_directory(const fs::path& directory,
+                                 bool is_scan_root,
+                                 const ScanContext& context,
+                                 std::vector<FileEntry>& entries,
+                                 std::vector<fs::path>& subdirectories,
+                                 std::vector<std::uint64_t>* entry_inodes)
+{
+#ifdef __linux__
+    if (context.native_listing) {
+        return list_directory_native(directory, is_scan_root, context, entries, &subdirectories,
+                                     entry_inodes);
+    }
+#endif
+
+    std::error_code open_ec;
+    fs::directory_iterator it(directory, kIteratorOptions, open_ec);
+    if (open_ec) {
+        if (is_scan_root) {
+            throw fs::filesystem_error("directory_iterator", directory, open_ec);
+        }
+        log_scan_warning(context, directory, open_ec,
+                         "Skipping directory after filesystem error");
+        return false;
+    }
+
+    const fs::directory_iterator end;
+    while (it != end) {
+        fs::directory_entry entry = *it;
+        const fs::path entry_path = entry.path();
+        const std::string full_path = Utils::path_to_utf8(entry_path);
+        const std::string file_name = Utils::path_to_utf8(entry_path.filename());
+
+        std::error_code dir_ec;
+        const bool is_directory = entry.is_directory(dir_ec);
+        if (dir_ec) {
+            log_scan_warning(context, entry_path, dir_ec,
+                             "Skipping entry after filesystem error");
+        } else {
+            const bool bundle = is_file_bundle(entry_path, is_directory);
+            const bool skip_entry = should_skip_entry(entry_path, file_name, context, full_path);
+            if (!skip_entry) {
+                if (auto type = classify_entry(entry, bundle, is_directory, context)) {
+                    entries.push_back(FileEntry{full_path, file_name, *type});
+                    if (entry_inodes) {
+                        entry_inodes->push_back(0);
+                    }
+                }
             }
-            log_scan_warning(context, current_dir, open_ec,
-                             "Skipping directory after filesystem error");
-            continue;
+            if (is_directory && !bundle && !skip_entry) {
+                subdirectories.push_back(entry_path);
+            }
+        }
+
+        std::error_code increment_ec;
+        it.increment(increment_ec);
+        if (increment_ec) {
+            log_scan_warning(context, directory, increment_ec,
+                             "Stopping scan of directory after filesystem error");
+            return false;
+        }
+    }
+    return true;
+}
+
+#ifdef __linux__
+bool FileScanner::list_directory_native(const fs::path& directory,
+                                        bool is_scan_root,
+                                        const ScanContext& context,
+                                        std::vector<FileEntry>& entries,
+                                        std::vector<fs::path>* subdirectories,
+                                        std::vector<std::uint64_t>* entry_inodes)
+{
+    const int fd = ::open(directory.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (fd < 0) {
+        const int open_errno = errno;
+        if (open_errno == EACCES) {
+            // Same as directory_options::skip_permission_denied.
+            return true;
+        }
+        const std::error_code open_ec(open_errno, std::system_category());
+        if (is_scan_root) {
+            throw fs::filesystem_error("directory_iterator", directory, open_ec);
+        }
+        log_scan_warning(context, directory, open_ec,
+                         "Skipping directory after filesystem error");
+        return false;
+    }
+    DirectoryFd directory_fd(fd);
+
+    const std::string directory_utf8 = Utils::path_to_utf8(directory);
+    std::vector<char> buffer(kDirentBufferSize);
+    std::string full_path;
+
+    for (;;) {
+        const long read = ::syscall(SYS_getdents64, fd, buffer.data(), buffer.size());
+        if (read == 0) {
+            break;
+        }
+        if (read < 0) {
+            log_scan_warning(context, directory, std::error_code(errno, std::system_category()),
+                             "Stopping scan of directory after filesystem error");
+            return false;
         }
 
-        const fs::directory_iterator end;
-        while (it != end) {
-            fs::directory_entry entry = *it;
-            const fs::path entry_path = entry.path();
-            const std::string full_path = Utils::path_to_utf8(entry_path);
-            const std::string file_name = Utils::path_to_utf8(entry_path.filename());
-
-            std::error_code dir_ec;
-            const bool is_directory = entry.is_directory(dir_ec);
-            if (dir_ec) {
-                log_scan_warning(context, entry_path, dir_ec,
-                                 "Skipping entry after filesystem error");
+        for (long offset = 0; offset < read;) {
+            const auto* dirent = reinterpret_cast<const LinuxDirent64*>(buffer.data() + offset);
+            offset += dirent->d_reclen;
+
+            const char* name = dirent->d_name;
+            const std::size_t name_length = std::strlen(name);
+            if ((name_length == 1 && name[0] == '.') ||
+                (name_length == 2 && name[0] == '.' && name[1] == '.')) {
+                continue;
+            }
+
+            std::string file_name(name, name_length);
+            join_path(full_path, directory_utf8, name, name_length);
+            if (is_junk_file(file_name)) {
+                continue;
+            }
+            if (name[0] == '.' && !context.include_hidden) {
+                if (context.logger) {
+                    context.logger->trace("Skipping hidden entry '{}'", full_path);
+                }
+                continue;
+            }
+
+            // d_type answers without a stat; symlinks are followed like directory_entry::is_directory().
+            bool is_directory = dirent->d_type == DT_DIR;
+            bool is_regular_file = dirent->d_type == DT_REG;
+            if (dirent->d_type == DT_UNKNOWN || dirent->d_type == DT_LNK) {
+                struct stat info {};
+                if (::fstatat(fd, name, &info, 0) != 0) {
+                    log_scan_warning(context, fs::path(full_path),
+                                     std::error_code(errno, std::system_category()),
+                                     "Skipping entry after filesystem error");
+                    continue;
+                }
+                is_directory = S_ISDIR(info.st_mode);
+                is_regular_file = S_ISREG(info.st_mode);
+            }
+
+            const bool bundle = is_directory && is_bundle_name(file_name);
+            const bool is_file = bundle || is_regular_file;
+            const bool descend = subdirectories && is_directory && !bundle;
+            if (descend) {
+                subdirectories->emplace_back(full_path);
+            }
+            if (context.include_files && is_file) {
+                entries.push_back(FileEntry{full_path, std::move(file_name), FileType::File});
+            } else if (context.include_directories && !bundle && is_directory) {
+                entries.push_back(FileEntry{full_path, std::move(file_name), FileType::Directory});
             } else {
-                const bool bundle = is_file_bundle(entry_path, is_directory);
-                const bool skip_entry = should_skip_entry(entry_path, file_name, context, full_path);
-                if (!skip_entry) {
-                    if (auto type = classify_entry(entry, bundle, is_directory, context)) {
-                        results.push_back(FileEntry{full_path, file_name, *type});
+                continue;
+            }
+            if (entry_inodes) {
+                entry_inodes->push_back(dirent->d_ino);
+            }
+        }
+    }
+    return true;
+}
+#endif
+
+struct FileScanner::DirectoryListing {
+    fs::path path;
+    std::vector<FileEntry> entries;
+    std::vector<std::unique_ptr<DirectoryListing>> children;
+};
+
+void FileScanner::scan_recursive_parallel(const fs::path& scan_path,
+                                          const ScanContext& context,
+                                          std::vector<FileEntry>& results,
+                                          std::size_t thread_count)
+{
+    // Each directory is listed into its own node; the tree is flattened afterwards in the order the
+    // sequential scan produces, so the result does not depend on which thread listed what.
+    DirectoryListing root{scan_path, {}, {}};
+    std::vector<fs::path> root_subdirectories;
+    list_directory(scan_path, true, context, root.entries, root_subdirectories);
+
+    const auto attach_children = [](DirectoryListing& parent, std::vector<fs::path>& paths) {
+        parent.children.reserve(paths.size());
+        for (auto& path : paths) {
+            parent.children.push_back(
+                std::make_unique<DirectoryListing>(DirectoryListing{std::move(path), {}, {}}));
+        }
+    };
+    attach_children(root, root_subdirectories);
+
+    struct WorkQueue {
+        std::mutex mutex;
+        std::deque<DirectoryListing*> items;
+    };
+    std::vector<WorkQueue> queues(thread_count);
+    for (std::size_t i = 0; i < root.children.size(); ++i) {
+        queues[i % thread_count].items.push_back(root.children[i].get());
+    }
+
+    std::atomic<std::size_t> outstanding{root.children.size()};
+    std::atomic<bool> failed{false};
+    std::exception_ptr first_error;
+    std::mutex idle_mutex;
+    std::condition_variable idle_cv;
+
+    // Owners take their newest work (depth-first locality); idle threads steal the oldest, largest subtrees.
+    const auto take_work = [&](std::size_t self) -> DirectoryListing* {
+        {
+            std::lock_guard<std::mutex> lock(queues[self].mutex);
+            if (!queues[self].items.empty()) {
+                DirectoryListing* work = queues[self].items.back();
+                queues[self].items.pop_back();
+                return work;
+            }
+        }
+        for (std::size_t offset = 1; offset < thread_count; ++offset) {
+            WorkQueue& victim = queues[(self + offset) % thread_count];
+            std::lock_guard<std::mutex> lock(victim.mutex);
+            if (!victim.items.empty()) {
+                DirectoryListing* work = victim.items.front();
+                victim.items.pop_front();
+                return work;
+            }
+        }
+        return nullptr;
+    };
+
+    const auto worker = [&](std::size_t self) {
+        std::vector<fs::path> subdirectories;
+        while (!failed.load()) {
+            DirectoryListing* work = take_work(self);
+            if (!work) {
+                std::unique_lock<std::mutex> lock(idle_mutex);
+                if (outstanding.load() == 0) {
+                    return;
+                }
+                idle_cv.wait_for(lock, kIdleWait);
+                continue;
+            }
+
+            try {
+                subdirectories.clear();
+                list_directory(work->path, false, context, work->entries, subdirectories);
+                if (!subdirectories.empty()) {
+                    attach_children(*work, subdirectories);
+                    outstanding.fetch_add(work->children.size());
+                    {
+                        std::lock_guard<std::mutex> lock(queues[self].mutex);
+                        for (const auto& child : work->children) {
+                            queues[self].items.push_back(child.get());
+                        }
                     }
+                    idle_cv.notify_all();
                 }
-                if (is_directory && !bundle && !skip_entry) {
-                    pending_dirs.push_back(entry_path);
+            } catch (...) {
+                std::lock_guard<std::mutex> lock(idle_mutex);
+                if (!first_error) {
+                    first_error = std::current_exception();
                 }
+                failed = true;
             }
 
-            std::error_code increment_ec;
-            it.increment(increment_ec);
-            if (increment_ec) {
-                log_scan_warning(context, current_dir, increment_ec,
-                                 "Stopping scan of directory after filesystem error");
-                break;
+            if (outstanding.fetch_sub(1) == 1) {
+                std::lock_guard<std::mutex> lock(idle_mutex);
+                idle_cv.notify_all();
             }
         }
+    };
+
+    std::vector<std::thread> threads;
+    threads.reserve(thread_count - 1);
+    for (std::size_t i = 1; i < thread_count; ++i) {
+        threads.emplace_back(worker, i);
+    }
+    worker(0);
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    if (first_error) {
+        std::rethrow_exception(first_error);
+    }
+
+    std::vector<DirectoryListing*> pending{&root};
+    while (!pending.empty()) {
+        DirectoryListing* node = pending.back();
+        pending.pop_back();
+        results.insert(results.end(),
+                       std::make_move_iterator(node->entries.begin()),
+                       std::make_move_iterator(node->entries.end()));
+        for (const auto& child : node->children) {
+            pending.push_back(child.get());
+        }
     }
 }
 
@@ -186,16 +781,26 @@ bool FileScanner::is_junk_file(const std::string& name) const {
 
 
 bool FileScanner::is_file_bundle(const fs::path& path, bool is_directory) const {
+    if (!is_directory) {
+        return false;
+    }
+
+    return is_bundle_name(Utils::path_to_utf8(path.filename()));
+}
+
+bool FileScanner::is_bundle_name(const std::string& file_name) const {
     static const std::unordered_set<std::string> bundle_extensions = {
         ".app", ".utm", ".vmwarevm", ".pvm", ".vbox", ".pkg", ".mpkg",
         ".prefPane", ".plugin", ".framework", ".kext", ".qlgenerator",
         ".mdimporter", ".wdgt", ".scptd", ".nib", ".xib"
     };
-    if (!is_directory) {
+    // Same rule as fs::path::extension(): a leading dot alone does not start an extension.
+    const auto dot = file_name.rfind('.');
+    if (dot == std::string::npos || dot == 0 || file_name == "..") {
         return false;
     }
 
-    std::string ext = Utils::path_to_utf8(path.extension());
+    std::string ext = file_name.substr(dot);
     std::transform(ext.begin(), ext.end(), ext.begin(), ::tolower);
 
     return bundle_extensions.contains(ext);
@@ -0,0 +1,576 @@
+#include "FolderWatcher.hpp"
+#include "Logger.hpp"
+#include "Utils.hpp"
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstdlib>
+#include <iterator>
+#include <map>
+#include <mutex>
+#include <system_error>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+
+#include <spdlog/spdlog.h>
+
+#ifdef __linux__
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+constexpr const char* kWatchBackendEnv = "AI_FILE_SORTER_WATCH_BACKEND";
+// Stands in for "until something happens" when nothing is pending.
+constexpr std::chrono::milliseconds kIdleWait{60 * 60 * 1000};
+
+bool polling_forced_by_env()
+{
+    const char* env = std::getenv(kWatchBackendEnv);
+    return env && (std::string(env) == "poll" || std::string(env) == "polling");
+}
+
+std::string parent_of(const std::string& path)
+{
+    return Utils::path_to_utf8(Utils::utf8_to_path(path).parent_path());
+}
+
+} // namespace
+
+class FolderWatcher::EventSource {
+public:
+    virtual ~EventSource() = default;
+    /**
+     * @brief Waits up to @p timeout for changes and returns the paths they touched.
+     * @param lost Set when events were dropped and the whole folder must be rechecked.
+     */
+    virtual std::vector<std::string> wait(std::chrono::milliseconds timeout, bool& lost) = 0;
+    /** Interrupts a wait() in progress; called from stop(). */
+    virtual void wake() = 0;
+    /** Starts reporting changes inside newly found directories. */
+    virtual void watch_directories(const std::vector<std::string>& directories) { (void)directories; }
+};
+
+namespace {
+
+// Rescans the folder on an interval and reports paths that were not there on the previous pass.
+class PollingSource : public FolderWatcher::EventSource {
+public:
+    PollingSource(FileScanner& scanner, std::string root, FileScanOptions options,
+                  std::chrono::milliseconds interval)
+        : scanner_(scanner),
+          root_(std::move(root)),
+          options_(options),
+          interval_(interval)
+    {
+        for (auto& entry : scanner_.get_directory_entries(root_, options_)) {
+            known_.insert(std::move(entry.full_path));
+        }
+        next_poll_ = std::chrono::steady_clock::now() + interval_;
+    }
+
+    std::vector<std::string> wait(std::chrono::milliseconds timeout, bool& lost) override
+    {
+        lost = false;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            const auto deadline = std::min(next_poll_, std::chrono::steady_clock::now() + timeout);
+            cv_.wait_until(lock, deadline, [this] { return woken_; });
+            if (woken_) {
+                woken_ = false;
+                return {};
+            }
+        }
+        if (std::chrono::steady_clock::now() < next_poll_) {
+            return {};
+        }
+        next_poll_ = std::chrono::steady_clock::now() + interval_;
+
+        std::vector<std::string> changed;
+        std::unordered_set<std::string> current;
+        try {
+            for (auto& entry : scanner_.get_directory_entries(root_, options_)) {
+                if (!known_.contains(entry.full_path)) {
+                    changed.push_back(entry.full_path);
+                }
+                current.insert(std::move(entry.full_path));
+            }
+        } catch (const std::filesystem::filesystem_error&) {
+            // The folder is gone for now; keep the last listing and try again next time.
+            return {};
+        }
+        known_ = std::move(current);
+        return changed;
+    }
+
+    void wake() override
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        woken_ = true;
+        cv_.notify_all();
+    }
+
+private:
+    FileScanner& scanner_;
+    const std::string root_;
+    const FileScanOptions options_;
+    const std::chrono::milliseconds interval_;
+    std::unordered_set<std::string> known_;
+    std::chrono::steady_clock::time_point next_poll_;
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    bool woken_{false};
+};
+
+#ifdef __linux__
+constexpr std::uint32_t kInotifyMask =
+    IN_CREATE | IN_CLOSE_WRITE | IN_MOVED_TO | IN_ONLYDIR | IN_EXCL_UNLINK;
+
+// One inotify watch per directory the scan would descend into.
+class InotifySource : public FolderWatcher::EventSource {
+public:
+    InotifySource(FileScanner& scanner, FileScanOptions options)
+        : scanner_(scanner),
+          options_(options)
+    {
+    }
+
+    ~InotifySource() override
+    {
+        for (int fd : {inotify_fd_, wake_pipe_[0], wake_pipe_[1]}) {
+            if (fd >= 0) {
+                ::close(fd);
+            }
+        }
+    }
+
+    InotifySource(const InotifySource&) = delete;
+    InotifySource& operator=(const InotifySource&) = delete;
+
+    /**
+     * @brief Creates the inotify instance and watches @p root and, for recursive options, its subtree.
+     * @return False when inotify is unusable or the watch limit was reached.
+     */
+    bool open(const std::string& root, const std::atomic<bool>& cancelled)
+    {
+        inotify_fd_ = ::inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+        if (inotify_fd_ < 0 || ::pipe2(wake_pipe_, O_NONBLOCK | O_CLOEXEC) != 0) {
+            log_errno("Failed to initialize inotify");
+            return false;
+        }
+        cancelled_ = &cancelled;
+        return watch_tree(root, true);
+    }
+
+    std::vector<std::string> wait(std::chrono::milliseconds timeout, bool& lost) override
+    {
+        lost = false;
+        pollfd fds[2] = {{inotify_fd_, POLLIN, 0}, {wake_pipe_[0], POLLIN, 0}};
+        const int ready = ::poll(fds, 2, static_cast<int>(std::min<long long>(timeout.count(), 60 * 60 * 1000)));
+        if (ready <= 0) {
+            return {};
+        }
+        if (fds[1].revents & POLLIN) {
+            char drain[64];
+            while (::read(wake_pipe_[0], drain, sizeof(drain)) > 0) {
+            }
+        }
+
+        std::vector<std::string> changed;
+        alignas(inotify_event) char buffer[64 * 1024];
+        for (;;) {
+            const ssize_t length = ::read(inotify_fd_, buffer, sizeof(buffer));
+            if (length <= 0) {
+                break;
+            }
+            for (ssize_t offset = 0; offset < length;) {
+                const auto* event = reinterpret_cast<const inotify_event*>(buffer + offset);
+                offset += static_cast<ssize_t>(sizeof(inotify_event) + event->len);
+
+                if (event->mask & IN_Q_OVERFLOW) {
+                    lost = true;
+                    continue;
+                }
+                if (event->mask & IN_IGNORED) {
+                    directories_.erase(event->wd);
+                    continue;
+                }
+                const auto it = directories_.find(event->wd);
+                if (it == directories_.end() || event->len == 0 || event->name[0] == '\0') {
+                    continue;
+                }
+                changed.push_back(join(it->second, event->name));
+            }
+        }
+        return changed;
+    }
+
+    void wake() override
+    {
+        const char byte = 1;
+        [[maybe_unused]] const ssize_t written = ::write(wake_pipe_[1], &byte, 1);
+    }
+
+    void watch_directories(const std::vector<std::string>& directories) override
+    {
+        for (const auto& directory : directories) {
+            watch_tree(directory, false);
+        }
+    }
+
+private:
+    bool watch_tree(const std::string& root, bool is_scan_root)
+    {
+        std::vector<std::string> pending{root};
+        while (!pending.empty() && !(cancelled_ && cancelled_->load())) {
+            const std::string directory = std::move(pending.back());
+            pending.pop_back();
+
+            const int wd = ::inotify_add_watch(inotify_fd_, directory.c_str(), kInotifyMask);
+            if (wd < 0) {
+                if (errno == ENOSPC || errno == ENOMEM) {
+                    log_errno("inotify watch limit reached");
+                    return false;
+                }
+                if (is_scan_root && directory == root) {
+                    log_errno("Failed to watch folder");
+                    return false;
+                }
+                continue;
+            }
+            // A directory moved inside the tree keeps its watch descriptor; point it at the new path.
+            directories_[wd] = directory;
+
+            if (!has_flag(options_, FileScanOptions::Recursive)) {
+                continue;
+            }
+            auto contents = scanner_.list_directory_contents(directory, options_, is_scan_root && directory == root);
+            pending.insert(pending.end(),
+                           std::make_move_iterator(contents.subdirectories.begin()),
+                           std::make_move_iterator(contents.subdirectories.end()));
+        }
+        return true;
+    }
+
+    static std::string join(const std::string& directory, const char* name)
+    {
+        std::string path = directory;
+        if (!path.empty() && path.back() != '/') {
+            path.push_back('/');
+        }
+        path.append(name);
+        return path;
+    }
+
+    static void log_errno(const char* message)
+    {
+        const int error = errno;
+        if (auto logger = Logger::get_logger("core_logger")) {
+            logger->warn("{}: {}", message, std::strerror(error));
+        }
+    }
+
+    FileScanner& scanner_;
+    const FileScanOptions options_;
+    const std::atomic<bool>* cancelled_{nullptr};
+    int inotify_fd_{-1};
+    int wake_pipe_[2]{-1, -1};
+    std::unordered_map<int, std::string> directories_;
+};
+#endif
+
+} // namespace
+
+FolderWatcher::FolderWatcher(FileScanner& scanner,
+                             std::string root_path,
+                             FileScanOptions scan_options,
+                             Options options)
+    : scanner(scanner),
+      root_path(std::move(root_path)),
+      scan_options(scan_options),
+      options(options)
+{
+}
+
+FolderWatcher::~FolderWatcher()
+{
+    stop();
+}
+
+void FolderWatcher::start(BatchCallback callback)
+{
+    stop();
+    std::error_code ec;
+    const auto root = Utils::utf8_to_path(root_path);
+    if (!std::filesystem::is_directory(root, ec)) {
+        throw std::filesystem::filesystem_error(
+            "Cannot watch folder", root, ec ? ec : std::make_error_code(std::errc::not_a_directory));
+    }
+
+    on_batch = std::move(callback);
+    {
+        std::lock_guard<std::mutex> lock(source_mutex);
+        source.reset();
+        watching = false;
+    }
+    stop_requested = false;
+    running = true;
+    // Setting up the watches walks the whole tree, so it happens on the watcher thread.
+    worker = std::thread([this] {
+        auto opened = open_source();
+        {
+            std::lock_guard<std::mutex> lock(source_mutex);
+            source = std::move(opened);
+            watching = source && !stop_requested;
+        }
+        watching_changed.notify_all();
+        if (watching) {
+            run();
+        }
+        running = false;
+        {
+            std::lock_guard<std::mutex> lock(source_mutex);
+            watching = false;
+        }
+        watching_changed.notify_all();
+    });
+}
+
+std::unique_ptr<FolderWatcher::EventSource> FolderWatcher::open_source()
+{
+    auto logger = Logger::get_logger("core_logger");
+#ifdef __linux__
+    if (!options.force_polling && !polling_forced_by_env()) {
+        auto inotify = std::make_unique<InotifySource>(scanner, scan_options);
+        if (inotify->open(root_path, stop_requested)) {
+            active_backend = Backend::Inotify;
+            if (logger) {
+                logger->info("Watching '{}' with the inotify backend", root_path);
+            }
+            return inotify;
+        }
+        if (stop_requested) {
+            return nullptr;
+        }
+        if (logger) {
+            logger->warn("Falling back to polling for '{}'", root_path);
+        }
+    }
+#endif
+    try {
+        auto polling = std::make_unique<PollingSource>(scanner, root_path, scan_options, options.poll_interval);
+        active_backend = Backend::Polling;
+        if (logger) {
+            logger->info("Watching '{}' with the polling backend", root_path);
+        }
+        return polling;
+    } catch (const std::filesystem::filesystem_error& ex) {
+        if (logger) {
+            logger->warn("Failed to watch '{}': {}", root_path, ex.what());
+        }
+        return nullptr;
+    }
+}
+
+bool FolderWatcher::wait_until_watching(std::chrono::milliseconds timeout) const
+{
+    std::unique_lock<std::mutex> lock(source_mutex);
+    watching_changed.wait_for(lock, timeout, [this] { return watching || !running; });
+    return watching;
+}
+
+void FolderWatcher::stop()
+{
+    stop_requested = true;
+    {
+        std::lock_guard<std::mutex> lock(source_mutex);
+        if (source) {
+            source->wake();
+        }
+    }
+    if (worker.joinable()) {
+        worker.join();
+    }
+    running = false;
+}
+
+void FolderWatcher::requeue(const std::vector<FileEntry>& entries)
+{
+    if (entries.empty()) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(requeue_mutex);
+        for (const auto& entry : entries) {
+            requeued_paths.push_back(entry.full_path);
+        }
+    }
+    std::lock_guard<std::mutex> lock(source_mutex);
+    if (source) {
+        source->wake();
+    }
+}
+
+bool FolderWatcher::is_running() const
+{
+    return running && !stop_requested;
+}
+
+FolderWatcher::Backend FolderWatcher::backend() const
+{
+    return active_backend;
+}
+
+const std::string& FolderWatcher::watched_path() const
+{
+    return root_path;
+}
+
+FileScanOptions FolderWatcher::watched_scan_options() const
+{
+    return scan_options;
+}
+
+void FolderWatcher::run()
+{
+    using Clock = std::chrono::steady_clock;
+    auto logger = Logger::get_logger("core_logger");
+
+    // Paths in arrival order; repeated events for one path collapse into its first slot.
+    std::vector<std::string> pending;
+    std::unordered_set<std::string> pending_set;
+    bool resync = false;
+    Clock::time_point first_event;
+    Clock::time_point last_event;
+
+    while (!stop_requested) {
+        auto timeout = kIdleWait;
+        const bool has_pending = !pending.empty() || resync;
+        if (has_pending) {
+            const auto now = Clock::now();
+            const auto quiet_left = options.debounce - (now - last_event);
+            const auto delay_left = options.max_delay - (now - first_event);
+            timeout = std::max(std::chrono::milliseconds(0),
+                               std::chrono::duration_cast<std::chrono::milliseconds>(
+                                   std::min(quiet_left, delay_left)));
+        }
+
+        bool lost = false;
+        std::vector<std::string> paths = source->wait(timeout, lost);
+        if (stop_requested) {
+            break;
+        }
+        {
+            std::lock_guard<std::mutex> lock(requeue_mutex);
+            paths.insert(paths.end(),
+                         std::make_move_iterator(requeued_paths.begin()),
+                         std::make_move_iterator(requeued_paths.end()));
+            requeued_paths.clear();
+        }
+
+        const auto now = Clock::now();
+        if (!paths.empty() || lost) {
+            if (pending.empty() && !resync) {
+                first_event = now;
+            }
+            last_event = now;
+            resync = resync || lost;
+            for (auto& path : paths) {
+                if (pending_set.insert(path).second) {
+                    pending.push_back(std::move(path));
+                }
+            }
+        }
+
+        if ((pending.empty() && !resync) ||
+            (now - last_event < options.debounce && now - first_event < options.max_delay)) {
+            continue;
+        }
+
+        std::vector<FileEntry> entries;
+        try {
+            if (resync) {
+                if (logger) {
+                    logger->warn("Watch events were lost for '{}'; rechecking the whole folder", root_path);
+                }
+                entries = scanner.get_directory_entries(root_path, scan_options);
+            } else {
+                entries = resolve_entries(pending);
+            }
+        } catch (const std::exception& ex) {
+            if (logger) {
+                logger->warn("Failed to resolve watch events for '{}': {}", root_path, ex.what());
+            }
+        }
+        pending.clear();
+        pending_set.clear();
+        resync = false;
+        dispatch(std::move(entries));
+    }
+}
+
+std::vector<FileEntry> FolderWatcher::resolve_entries(const std::vector<std::string>& paths)
+{
+    // Each parent is listed once so the scanner's filters (hidden, junk, bundles, types) decide what
+    // is reported; paths that vanished before the flush simply do not show up.
+    std::map<std::string, std::unordered_set<std::string>> by_parent;
+    std::vector<std::string> parent_order;
+    for (const auto& path : paths) {
+        std::string parent = parent_of(path);
+        auto [it, inserted] = by_parent.try_emplace(parent);
+        if (inserted) {
+            parent_order.push_back(std::move(parent));
+        }
+        it->second.insert(path);
+    }
+
+    std::vector<FileEntry> entries;
+    std::vector<std::string> new_directories;
+    for (const auto& parent : parent_order) {
+        const auto& wanted = by_parent[parent];
+        auto contents = scanner.list_directory_contents(parent, scan_options, false);
+        for (auto& entry : contents.entries) {
+            if (wanted.contains(entry.full_path)) {
+                entries.push_back(std::move(entry));
+            }
+        }
+        for (auto& subdirectory : contents.subdirectories) {
+            if (wanted.contains(subdirectory)) {
+                new_directories.push_back(std::move(subdirectory));
+            }
+        }
+    }
+
+    if (!new_directories.empty()) {
+        source->watch_directories(new_directories);
+        // Files can land in a new directory before its watch exists; list it to catch them.
+        std::unordered_set<std::string> seen;
+        for (const auto& entry : entries) {
+            seen.insert(entry.full_path);
+        }
+        for (const auto& directory : new_directories) {
+            for (auto& entry : scanner.get_directory_entries(directory, scan_options)) {
+                if (seen.insert(entry.full_path).second) {
+                    entries.push_back(std::move(entry));
+                }
+            }
+        }
+    }
+    return entries;
+}
+
+void FolderWatcher::dispatch(std::vector<FileEntry>&& entries)
+{
+    const std::size_t batch_size = std::max<std::size_t>(1, options.batch_size);
+    for (std::size_t offset = 0; offset < entries.size() && !stop_requested; offset += batch_size) {
+        const auto first = entries.begin() + static_cast<std::ptrdiff_t>(offset);
+        const auto last = entries.begin() + static_cast<std::ptrdiff_t>(std::min(entries.size(), offset + batch_size));
+        on_batch(std::vector<FileEntry>(std::make_move_iterator(first), std::make_move_iterator(last)));
+    }
+}
@@ -3,8 +3,9 @@
 #include "Logger.hpp"
 #include "LLMErrors.hpp"
 #include "Utils.hpp"
-
-#include <curl/curl.h>
+#include "CurlSession.hpp"
+#include "RemoteBatchPrompt.hpp"
+#include "RemoteRequestEngine.hpp"
 
 #if __has_include(<jsoncpp/json/json.h>)
     #include <jsoncpp/json/json.h>
@@ -16,8 +17,14 @@
 
 #include <spdlog/spdlog.h>
 
+#include <algorithm>
+#include <atomic>
 #include <cmath>
+#include <functional>
+#include <future>
+#include <memory>
 #include <iostream>
+#include <optional>
 #include <sstream>
 #include <regex>
 #include <stdexcept>
@@ -26,13 +33,6 @@
 
 namespace {
 
-size_t WriteCallback(void* contents, size_t size, size_t nmemb, std::string* response)
-{
-    const size_t total_size = size * nmemb;
-    response->append(static_cast<const char*>(contents), total_size);
-    return total_size;
-}
-
 std::string escape_json(const std::string& input) {
     std::string out;
     out.reserve(input.size() * 2);
@@ -50,116 +50,19 @@ std::string escape_json(const std::string& input) {
     return out;
 }
 
-struct CurlRequest {
-    CURL* handle{nullptr};
-    curl_slist* headers{nullptr};
-
-    CurlRequest() = default;
-    CurlRequest(const CurlRequest&) = delete;
-    CurlRequest& operator=(const CurlRequest&) = delete;
-
-    CurlRequest(CurlRequest&& other) noexcept
-        : handle(other.handle),
-          headers(other.headers)
-    {
-        other.handle = nullptr;
-        other.headers = nullptr;
-    }
-
-    CurlRequest& operator=(CurlRequest&& other) noexcept
-    {
-        if (this != &other) {
-            cleanup();
-            handle = other.handle;
-            headers = other.headers;
-            other.handle = nullptr;
-            other.headers = nullptr;
-        }
-        return *this;
-    }
-
-    ~CurlRequest() {
-        cleanup();
-    }
-
-private:
-    void cleanup()
-    {
-        if (handle) {
-            curl_easy_cleanup(handle);
-            handle = nullptr;
-        }
-        if (headers) {
-            curl_slist_free_all(headers);
-            headers = nullptr;
-        }
-    }
-};
-
-CurlRequest create_curl_request(const std::shared_ptr<spdlog::logger>& logger)
-{
-    CurlRequest request;
-    request.handle = curl_easy_init();
-    if (!request.handle) {
-        if (logger) {
-            logger->critical("Failed to initialize cURL handle for Gemini request");
-        }
-        throw std::runtime_error("Initialization Error: Failed to initialize cURL.");
-    }
-
-#ifdef _WIN32
-    try {
-        const auto cert_path = Utils::ensure_ca_bundle();
-        curl_easy_setopt(request.handle, CURLOPT_CAINFO, cert_path.string().c_str());
-    } catch (const std::exception& ex) {
-        throw std::runtime_error(std::string("Failed to stage CA bundle: ") + ex.what());
-    }
-#endif
-    return request;
-}
-
-void configure_request_payload(CurlRequest& request,
-                               const std::string& api_url,
-                               const std::string& payload,
-                               std::string& response_buffer)
-{
-    curl_easy_setopt(request.handle, CURLOPT_URL, api_url.c_str());
-    curl_easy_setopt(request.handle, CURLOPT_POST, 1L);
-    curl_easy_setopt(request.handle, CURLOPT_TIMEOUT, 5L);
-
-    request.headers = curl_slist_append(request.headers, "Content-Type: application/json");
-    curl_easy_setopt(request.handle, CURLOPT_HTTPHEADER, request.headers);
-
-    curl_easy_setopt(request.handle, CURLOPT_POSTFIELDS, payload.c_str());
-    curl_easy_setopt(request.handle, CURLOPT_WRITEFUNCTION, WriteCallback);
-    curl_easy_setopt(request.handle, CURLOPT_WRITEDATA, &response_buffer);
-}
-
-long perform_request(CurlRequest& request, const std::shared_ptr<spdlog::logger>& logger)
-{
-    const CURLcode res = curl_easy_perform(request.handle);
-    if (res != CURLE_OK) {
-        if (logger) {
-            logger->error("cURL request failed: {}", curl_easy_strerror(res));
-        }
-        throw std::runtime_error("Network Error: " + std::string(curl_easy_strerror(res)));
-    }
-
-    long http_code = 0;
-    curl_easy_getinfo(request.handle, CURLINFO_RESPONSE_CODE, &http_code);
-    return http_code;
-}
-
-std::string parse_text_response(const std::string& payload,
-                                long http_code,
+std::string parse_text_response(const CurlSession::Response& response,
                                 const std::shared_ptr<spdlog::logger>& logger)
 {
+    const long http_code = response.http_code;
     Json::CharReaderBuilder reader_builder;
     Json::Value root;
-    std::istringstream response_stream(payload);
+    std::istringstream response_stream(response.body);
     std::string errors;
 
     if (!Json::parseFromStream(reader_builder, response_stream, &root, &errors)) {
+        if (http_code == 429) {
+            throw BackoffError("Gemini quota reached", response.retry_after_seconds);
+        }
         if (logger) {
             logger->error("Failed to parse JSON response: {}", errors);
         }
@@ -191,6 +94,9 @@ std::string parse_text_response(const std::string& payload,
                     }
                 }
             }
+            if (retry_secs <= 0) {
+                retry_secs = response.retry_after_seconds;
+            }
             throw BackoffError(message.empty()
                 ? "Gemini quota reached"
                 : "Gemini quota reached: " + message, retry_secs);
@@ -221,15 +127,117 @@ std::string parse_text_response(const std::string& payload,
     return parts[0]["text"].asString();
 }
 
+const std::vector<std::string>& gemini_api_versions()
+{
+    static const std::vector<std::string> versions = {"v1", "v1beta"};
+    return versions;
+}
+
+std::string gemini_endpoint(const std::string& api_version, const std::string& model_path)
+{
+    return "https://generativelanguage.googleapis.com/" + api_version + "/" + model_path + ":generateContent";
+}
+
+using ReplyHandler = std::function<void(std::string, std::exception_ptr)>;
+
+// Sends one API-version attempt; 404s and errors fall through to the next version like send_api_request().
+void submit_gemini_attempt(RemoteRequestEngine* engine,
+                           std::shared_ptr<const std::string> payload,
+                           std::string model_path,
+                           std::string api_key,
+                           std::size_t version_index,
+                           long timeout_seconds,
+                           ReplyHandler on_reply)
+{
+    const auto& versions = gemini_api_versions();
+    RemoteRequestEngine::Request request{gemini_endpoint(versions[version_index], model_path) + "?key=" + api_key,
+                                         *payload,
+                                         {},
+                                         timeout_seconds};
+    engine->submit(std::move(request),
+                   [engine, payload, model_path, api_key, version_index, timeout_seconds, on_reply](
+                       CurlSession::Response response, std::exception_ptr error) {
+        const bool has_next = version_index + 1 < gemini_api_versions().size();
+        if (!error && response.http_code == 404 && has_next) {
+            submit_gemini_attempt(engine, payload, model_path, api_key, version_index + 1, timeout_seconds, on_reply);
+            return;
+        }
+        try {
+            if (error) {
+                std::rethrow_exception(error);
+            }
+            std::string text = parse_text_response(response, Logger::get_logger("core_logger"));
+            on_reply(std::move(text), nullptr);
+        } catch (...) {
+            if (has_next) {
+                submit_gemini_attempt(engine, payload, model_path, api_key, version_index + 1, timeout_seconds, on_reply);
+                return;
+            }
+            on_reply(std::string(), std::current_exception());
+        }
+    });
+}
+
+using BatchPromise = std::promise<std::vector<std::optional<std::string>>>;
+
+// Sends a batch on the engine. If Gemini rejects the response schema, the batch is re-sent once as
+// @p plain_payload (starting at v1 again) and structured batches stay off for this client.
+void submit_gemini_batch(RemoteRequestEngine* engine,
+                         std::shared_ptr<const std::string> payload,
+                         std::shared_ptr<const std::string> plain_payload,
+                         std::string model_path,
+                         std::string api_key,
+                         long timeout_seconds,
+                         std::size_t item_count,
+                         std::shared_ptr<std::atomic<bool>> structured_batches,
+                         std::shared_ptr<BatchPromise> promise,
+                         bool log_response)
+{
+    // responseSchema is only accepted by v1beta, so structured batches skip the v1 attempt.
+    const std::size_t first_version = plain_payload ? 1 : 0;
+    auto on_reply = [engine, plain_payload, model_path, api_key, timeout_seconds, item_count,
+                     structured_batches, promise, log_response](std::string reply, std::exception_ptr error) {
+        auto logger = Logger::get_logger("core_logger");
+        try {
+            if (error) {
+                std::rethrow_exception(error);
+            }
+            if (log_response) {
+                std::cout << "[DEV][RESPONSE] Batch categorization reply\n" << reply << "\n";
+            }
+            promise->set_value(RemoteBatchPrompt::parse_response(reply, item_count, logger));
+        } catch (const BackoffError&) {
+            promise->set_exception(std::current_exception());
+        } catch (const std::exception& ex) {
+            if (!plain_payload || !RemoteBatchPrompt::is_schema_rejection(ex.what())) {
+                promise->set_exception(std::current_exception());
+                return;
+            }
+            if (logger) {
+                logger->info("Gemini rejected the response schema ({}); retrying without it", ex.what());
+            }
+            structured_batches->store(false);
+            submit_gemini_batch(engine, plain_payload, nullptr, model_path, api_key, timeout_seconds,
+                                item_count, structured_batches, promise, log_response);
+        }
+    };
+    submit_gemini_attempt(engine, payload, model_path, api_key, first_version, timeout_seconds, on_reply);
+}
+
 } // namespace
 
 
 GeminiClient::GeminiClient(std::string api_key, std::string model)
     : api_key_(std::move(api_key)),
-      model_(std::move(model))
+      model_(std::move(model)),
+      http_session_(std::make_unique<CurlSession>("Gemini")),
+      batch_size_(RemoteBatchPrompt::resolve_batch_size()),
+      structured_batches_(std::make_shared<std::atomic<bool>>(true))
 {
 }
 
+GeminiClient::~GeminiClient() = default;
+
 void GeminiClient::set_prompt_logging_enabled(bool enabled)
 {
     prompt_logging_enabled_ = enabled;
@@ -243,16 +251,11 @@ std::string GeminiClient::send_api_request(const std::string& json_payload)
 
     const std::string model_path = effective_model().starts_with("models/") ? effective_model()
                                                                             : "models/" + effective_model();
-    const std::vector<std::string> api_versions = {"v1", "v1beta"};
+    const auto& api_versions = gemini_api_versions();
     std::string last_error;
 
     for (size_t i = 0; i < api_versions.size(); ++i) {
-        std::string response_string;
-        const std::string base_url = "https://generativelanguage.googleapis.com/"
-            + api_versions[i]
-            + "/"
-            + model_path
-            + ":generateContent";
+        const std::string base_url = gemini_endpoint(api_versions[i], model_path);
         const std::string api_url = base_url + "?key=" + api_key_;
         auto logger = Logger::get_logger("core_logger");
 
@@ -261,15 +264,13 @@ std::string GeminiClient::send_api_request(const std::string& json_payload)
         }
 
         try {
-            CurlRequest request = create_curl_request(logger);
-            configure_request_payload(request, api_url, json_payload, response_string);
-            const long http_code = perform_request(request, logger);
-            if (http_code == 404 && i + 1 < api_versions.size()) {
+            const auto response = http_session_->post_json(api_url, json_payload, {}, 5L);
+            if (response.http_code == 404 && i + 1 < api_versions.size()) {
                 // Fallback to next version (e.g., v1beta) on 404.
                 last_error = "HTTP 404 on " + api_versions[i];
                 continue;
             }
-            return parse_text_response(response_string, http_code, logger);
+            return parse_text_response(response, logger);
         } catch (const std::exception& ex) {
             last_error = ex.what();
             if (i + 1 < api_versions.size()) {
@@ -316,6 +317,120 @@ std::string GeminiClient::categorize_file(const std::string& file_name,
     return category;
 }
 
+std::size_t GeminiClient::preferred_batch_size() const
+{
+    return batch_size_;
+}
+
+std::vector<std::string> GeminiClient::categorize_files(const std::vector<CategorizationRequest>& requests)
+{
+    if (requests.size() <= 1) {
+        return ILLMClient::categorize_files(requests);
+    }
+
+    auto parsed = categorize_files_async(requests).get();
+    std::vector<std::string> responses;
+    responses.reserve(requests.size());
+    for (std::size_t i = 0; i < requests.size(); ++i) {
+        if (parsed[i]) {
+            responses.push_back(std::move(*parsed[i]));
+            continue;
+        }
+        const auto& request = requests[i];
+        responses.push_back(categorize_file(request.file_name,
+                                            request.file_path,
+                                            request.file_type,
+                                            request.consistency_context));
+    }
+    return responses;
+}
+
+std::future<std::vector<std::optional<std::string>>> GeminiClient::categorize_files_async(
+    const std::vector<CategorizationRequest>& requests)
+{
+    if (api_key_.empty()) {
+        BatchPromise failed;
+        failed.set_exception(std::make_exception_ptr(std::runtime_error("Missing Gemini API key.")));
+        return failed.get_future();
+    }
+    if (auto logger = Logger::get_logger("core_logger")) {
+        logger->debug("Queueing Gemini categorization for {} item(s) in one batch", requests.size());
+    }
+
+    const bool structured = structured_batches_->load();
+    auto payload = std::make_shared<const std::string>(make_batch_payload(requests, structured));
+    if (prompt_logging_enabled_ && !last_prompt_.empty()) {
+        std::cout << "\n[DEV][PROMPT] Batch categorization request\n" << last_prompt_ << "\n";
+    }
+    std::shared_ptr<const std::string> plain_payload;
+    if (structured) {
+        plain_payload = std::make_shared<const std::string>(make_batch_payload(requests, false));
+    }
+
+    if (!request_engine_) {
+        request_engine_ = RemoteRequestEngine::acquire();
+    }
+
+    auto promise = std::make_shared<BatchPromise>();
+    auto future = promise->get_future();
+    const std::string model_path = effective_model().starts_with("models/") ? effective_model()
+                                                                            : "models/" + effective_model();
+    submit_gemini_batch(request_engine_.get(),
+                        std::move(payload),
+                        std::move(plain_payload),
+                        model_path,
+                        api_key_,
+                        RemoteBatchPrompt::batch_timeout_seconds(5L, requests.size()),
+                        requests.size(),
+                        structured_batches_,
+                        promise,
+                        prompt_logging_enabled_);
+    return future;
+}
+
+std::future<std::string> GeminiClient::categorize_file_async(const std::string& file_name,
+                                                             const std::string& file_path,
+                                                             FileType file_type,
+                                                             const std::string& consistency_context)
+{
+    if (api_key_.empty()) {
+        std::promise<std::string> failed;
+        failed.set_exception(std::make_exception_ptr(std::runtime_error("Missing Gemini API key.")));
+        return failed.get_future();
+    }
+    if (auto logger = Logger::get_logger("core_logger")) {
+        logger->debug("Queueing Gemini categorization for '{}' ({})", file_name, to_string(file_type));
+    }
+
+    auto payload = std::make_shared<const std::string>(
+        make_categorization_payload(file_name, file_path, file_type, consistency_context));
+    if (prompt_logging_enabled_ && !last_prompt_.empty()) {
+        std::cout << "\n[DEV][PROMPT] Categorization request\n" << last_prompt_ << "\n";
+    }
+
+    if (!request_engine_) {
+        request_engine_ = RemoteRequestEngine::acquire();
+    }
+
+    auto promise = std::make_shared<std::promise<std::string>>();
+    std::future<std::string> future = promise->get_future();
+    const std::string model_path = effective_model().starts_with("models/") ? effective_model()
+                                                                            : "models/" + effective_model();
+    const bool log_response = prompt_logging_enabled_;
+    submit_gemini_attempt(request_engine_.get(), payload, model_path, api_key_, 0, 5L,
+                          [promise, log_response](std::string category, std::exception_ptr error) {
+        if (error) {
+            promise->set_exception(error);
+            return;
+        }
+        if (log_response) {
+            std::cout << "[DEV][RESPONSE] Categorization reply\n" << category << "\n";
+        }
+        promise->set_value(std::move(category));
+    });
+    return future;
+}
+
 std::string GeminiClient::make_categorization_payload(const std::string& file_name,
                                                       const std::string& file_path,
                                                       FileType file_type,
@@ -362,6 +477,24 @@ std::string GeminiClient::make_categorization_payload(const std::string& file_na
     return payload.str();
 }
 
+std::string GeminiClient::make_batch_payload(const std::vector<CategorizationRequest>& requests, bool structured)
+{
+    last_prompt_ = RemoteBatchPrompt::build_user_prompt(requests);
+    const std::string merged_prompt = RemoteBatchPrompt::system_prompt() + "\n\n" + last_prompt_;
+
+    std::ostringstream payload;
+    payload << "{";
+    payload << "\"contents\":[";
+    payload << "{\"role\":\"user\",\"parts\":[{\"text\":\"" << escape_json(merged_prompt) << "\"}]}";
+    payload << "]";
+    if (structured) {
+        payload << ",\"generationConfig\":{\"responseMimeType\":\"application/json\","
+                << "\"responseSchema\":" << RemoteBatchPrompt::gemini_response_schema() << "}";
+    }
+    payload << "}";
+    return payload.str();
+}
+
 std::string GeminiClient::make_generic_payload(const std::string& system_prompt,
                                                const std::string& user_prompt,
                                                int max_tokens) const
@@ -0,0 +1,434 @@
+#include "IncrementalScanner.hpp"
+#include "Logger.hpp"
+#include "Utils.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <iterator>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+
+#include <spdlog/spdlog.h>
+
+#ifndef _WIN32
+#include <sys/stat.h>
+#endif
+
+namespace fs = std::filesystem;
+
+namespace {
+
+// Directories modified this close to the previous scan may have changed again within the same
+// mtime tick, so they are listed again rather than trusted.
+constexpr std::int64_t kRacyWindowNs = 2'000'000'000;
+
+// Builds an entry path the way the scanner does (directory_iterator / getdents64).
+std::string child_path(const std::string& directory, const std::string& name)
+{
+#ifdef _WIN32
+    return Utils::path_to_utf8(Utils::utf8_to_path(directory) / Utils::utf8_to_path(name));
+#else
+    std::string path;
+    path.reserve(directory.size() + 1 + name.size());
+    path.append(directory);
+    if (!directory.empty() && directory.back() != '/') {
+        path.push_back('/');
+    }
+    path.append(name);
+    return path;
+#endif
+}
+
+std::string child_key(const std::string& name, FileType type)
+{
+    std::string key = name;
+    key.push_back('\0');
+    key.push_back(type == FileType::File ? 'F' : 'D');
+    return key;
+}
+
+std::uint64_t read_entry_inode(const std::string& path)
+{
+#ifdef _WIN32
+    (void)path;
+    return 0;
+#else
+    struct stat info {};
+    if (::lstat(path.c_str(), &info) != 0) {
+        return 0;
+    }
+    return static_cast<std::uint64_t>(info.st_ino);
+#endif
+}
+
+} // namespace
+
+IncrementalScanner::IncrementalScanner(FileScanner& scanner, DatabaseManager& db_manager)
+    : scanner(scanner),
+      db_manager(db_manager)
+{
+}
+
+IncrementalScanner::ScanDelta IncrementalScanner::scan(const std::string& directory_path,
+                                                       FileScanOptions options,
+                                                       bool track_changes)
+{
+    return run_scan(directory_path, options, 0, nullptr, track_changes);
+}
+
+IncrementalScanner::ScanDelta IncrementalScanner::scan(const std::string& directory_path,
+                                                       FileScanOptions options,
+                                                       std::size_t batch_size,
+                                                       const FileScanner::EntryBatchSink& sink,
+                                                       bool track_changes)
+{
+    return run_scan(directory_path, options, std::max<std::size_t>(1, batch_size), &sink, track_changes);
+}
+
+IncrementalScanner::ScanDelta IncrementalScanner::run_scan(const std::string& directory_path,
+                                                           FileScanOptions options,
+                                                           std::size_t batch_size,
+                                                           const FileScanner::EntryBatchSink* sink,
+                                                           bool track_changes)
+{
+    using SnapshotDirectory = DatabaseManager::ScanSnapshotDirectory;
+    using SnapshotEntry = DatabaseManager::ScanSnapshotEntry;
+
+    auto logger = Logger::get_logger("core_logger");
+    const int options_mask = static_cast<int>(options);
+    const std::int64_t scan_started_ns = current_time_ns();
+    const auto snapshot = db_manager.load_scan_snapshot(directory_path, options_mask);
+
+    ScanDelta delta;
+    delta.had_snapshot = snapshot.has_value();
+    std::vector<std::uint64_t> added_inodes;
+    std::vector<std::uint64_t> removed_inodes;
+    std::vector<SnapshotDirectory> changed_directories;
+    std::vector<std::string> dropped_directories;
+    std::unordered_set<std::string> visited;
+
+    const auto find_previous = [&](const std::string& dir) -> const SnapshotDirectory* {
+        if (!snapshot) {
+            return nullptr;
+        }
+        const auto it = snapshot->directories.find(dir);
+        return it != snapshot->directories.end() ? &it->second : nullptr;
+    };
+
+    // Everything below a directory that disappeared is gone as well.
+    const auto collect_removed_subtree = [&](const std::string& root) {
+        std::vector<std::string> pending{root};
+        while (!pending.empty()) {
+            const std::string dir = std::move(pending.back());
+            pending.pop_back();
+            const SnapshotDirectory* previous = find_previous(dir);
+            if (!previous) {
+                continue;
+            }
+            for (const auto& child : previous->children) {
+                std::string path = child_path(dir, child.file_name);
+                if (child.file_type) {
+                    delta.removed.push_back(FileEntry{path, child.file_name, *child.file_type});
+                    removed_inodes.push_back(child.inode);
+                }
+                if (child.descend) {
+                    pending.push_back(std::move(path));
+                }
+            }
+        }
+    };
+
+    bool stopped = false;
+    std::size_t delivered = 0;
+    std::vector<FileEntry> batch;
+    const auto flush = [&](bool final) {
+        std::size_t offset = 0;
+        while (!stopped && (batch.size() - offset >= batch_size || (final && offset < batch.size()))) {
+            const std::size_t count = std::min(batch_size, batch.size() - offset);
+            const auto first = batch.begin() + static_cast<std::ptrdiff_t>(offset);
+            std::vector<FileEntry> chunk(std::make_move_iterator(first),
+                                         std::make_move_iterator(first + static_cast<std::ptrdiff_t>(count)));
+            offset += count;
+            delivered += chunk.size();
+            stopped = !(*sink)(std::move(chunk));
+        }
+        batch.erase(batch.begin(), batch.begin() + static_cast<std::ptrdiff_t>(offset));
+    };
+    const auto emit = [&](std::vector<FileEntry>&& entries) {
+        std::vector<FileEntry>& target = sink ? batch : delta.entries;
+        target.insert(target.end(),
+                      std::make_move_iterator(entries.begin()),
+                      std::make_move_iterator(entries.end()));
+        if (sink) {
+            flush(false);
+        }
+    };
+
+    // Changed directories are listed ahead of the walk on the scanner's thread pool.
+    FileScanner::DirectoryPrefetcher prefetcher(scanner, options, directory_path);
+    struct PendingDirectory {
+        std::string path;
+        std::optional<DirectoryStamp> stamp;
+        bool reuse{false};
+    };
+    // Stat before listing: a change racing with the listing leaves a newer mtime behind.
+    const auto make_pending = [&](std::string dir) {
+        PendingDirectory pending{std::move(dir), std::nullopt, false};
+        pending.stamp = stat_directory(pending.path);
+        const SnapshotDirectory* previous = find_previous(pending.path);
+        pending.reuse = previous && pending.stamp &&
+                        previous->mtime_ns == pending.stamp->mtime_ns &&
+                        previous->inode == pending.stamp->inode &&
+                        previous->mtime_ns < snapshot->scanned_at_ns - kRacyWindowNs;
+        if (!pending.reuse) {
+            prefetcher.request(pending.path);
+        }
+        return pending;
+    };
+
+    // Same traversal order as FileScanner::scan_recursive(), so the entries come out identical.
+    std::vector<PendingDirectory> pending_dirs;
+    pending_dirs.push_back(make_pending(directory_path));
+    while (!pending_dirs.empty() && !stopped) {
+        const PendingDirectory current = std::move(pending_dirs.back());
+        pending_dirs.pop_back();
+        const std::string& dir = current.path;
+        const auto& stamp = current.stamp;
+        visited.insert(dir);
+
+        const SnapshotDirectory* previous = find_previous(dir);
+        std::vector<FileEntry> entries;
+        std::vector<std::string> subdirectories;
+
+        if (current.reuse) {
+            ++delta.directories_reused;
+            entries.reserve(previous->children.size());
+            for (const auto& child : previous->children) {
+                std::string path = child_path(dir, child.file_name);
+                if (child.file_type) {
+                    entries.push_back(FileEntry{path, child.file_name, *child.file_type});
+                }
+                if (child.descend) {
+                    subdirectories.push_back(std::move(path));
+                }
+            }
+        } else {
+            ++delta.directories_listed;
+            FileScanner::DirectoryContents contents = prefetcher.take(dir);
+
+            std::unordered_map<std::string, std::uint64_t> previous_reported;
+            std::unordered_set<std::string> previous_descend;
+            if (previous) {
+                for (const auto& child : previous->children) {
+                    if (child.file_type) {
+                        previous_reported.emplace(child_key(child.file_name, *child.file_type), child.inode);
+                    }
+                    if (child.descend) {
+                        previous_descend.insert(child.file_name);
+                    }
+                }
+            }
+
+            SnapshotDirectory record;
+            record.dir_path = dir;
+            record.mtime_ns = stamp ? stamp->mtime_ns : 0;
+            record.inode = stamp ? stamp->inode : 0;
+            record.children.reserve(contents.entries.size());
+            std::unordered_map<std::string, std::size_t> child_by_path;
+            std::unordered_set<std::string> current_reported;
+            for (std::size_t i = 0; i < contents.entries.size(); ++i) {
+                const FileEntry& entry = contents.entries[i];
+                std::uint64_t inode = i < contents.entry_inodes.size() ? contents.entry_inodes[i] : 0;
+                std::string key = child_key(entry.file_name, entry.type);
+                const auto known = previous_reported.find(key);
+                if (inode == 0 && known != previous_reported.end()) {
+                    inode = known->second;
+                }
+                if (inode == 0) {
+                    // Only the getdents64 backend reports inodes; rename detection needs them.
+                    inode = read_entry_inode(entry.full_path);
+                }
+                if (track_changes && known == previous_reported.end() && delta.had_snapshot) {
+                    delta.added.push_back(entry);
+                    added_inodes.push_back(inode);
+                }
+                current_reported.insert(std::move(key));
+                child_by_path.emplace(entry.full_path, record.children.size());
+                record.children.push_back(SnapshotEntry{entry.file_name, entry.type, false, inode});
+            }
+            std::unordered_set<std::string> current_descend;
+            for (const auto& subdirectory : contents.subdirectories) {
+                std::string name = Utils::path_to_utf8(Utils::utf8_to_path(subdirectory).filename());
+                const auto reported = child_by_path.find(subdirectory);
+                if (reported != child_by_path.end()) {
+                    record.children[reported->second].descend = true;
+                } else {
+                    record.children.push_back(SnapshotEntry{name, std::nullopt, true, 0});
+                }
+                current_descend.insert(std::move(name));
+            }
+
+            if (previous && track_changes) {
+                for (const auto& child : previous->children) {
+                    if (child.file_type &&
+                        !current_reported.contains(child_key(child.file_name, *child.file_type))) {
+                        delta.removed.push_back(
+                            FileEntry{child_path(dir, child.file_name), child.file_name, *child.file_type});
+                        removed_inodes.push_back(child.inode);
+                    }
+                    if (child.descend && !current_descend.contains(child.file_name)) {
+                        collect_removed_subtree(child_path(dir, child.file_name));
+                    }
+                }
+            }
+
+            // A failed listing is not recorded, so the next scan reads the directory again.
+            if (stamp && contents.complete) {
+                changed_directories.push_back(std::move(record));
+            } else if (previous) {
+                dropped_directories.push_back(dir);
+            }
+            entries = std::move(contents.entries);
+            subdirectories = std::move(contents.subdirectories);
+        }
+
+        emit(std::move(entries));
+        for (auto& subdirectory : subdirectories) {
+            pending_dirs.push_back(make_pending(std::move(subdirectory)));
+        }
+    }
+    if (sink) {
+        flush(true);
+    }
+
+    if (track_changes) {
+        match_renames(delta, added_inodes, removed_inodes);
+    }
+
+    if (stopped) {
+        if (logger) {
+            logger->info("Incremental scan stopped for '{}' after {} item(s); snapshot left unchanged",
+                         directory_path, delivered);
+        }
+        return delta;
+    }
+
+    if (snapshot) {
+        for (const auto& [dir, previous] : snapshot->directories) {
+            if (!visited.contains(dir)) {
+                dropped_directories.push_back(dir);
+            }
+        }
+    }
+    if (!db_manager.update_scan_snapshot(directory_path, options_mask, scan_started_ns,
+                                         changed_directories, dropped_directories) &&
+        logger) {
+        logger->warn("Failed to store scan snapshot for '{}'; the next scan lists every directory",
+                     directory_path);
+    }
+
+    if (logger && track_changes) {
+        logger->info("Incremental scan complete for '{}': {} director(ies) listed, {} reused; "
+                     "{} added, {} removed, {} renamed",
+                     directory_path, delta.directories_listed, delta.directories_reused,
+                     delta.added.size(), delta.removed.size(), delta.renamed.size());
+    } else if (logger) {
+        logger->info("Incremental scan complete for '{}': {} director(ies) listed, {} reused",
+                     directory_path, delta.directories_listed, delta.directories_reused);
+    }
+    return delta;
+}
+
+void IncrementalScanner::match_renames(ScanDelta& delta,
+                                       std::vector<std::uint64_t>& added_inodes,
+                                       std::vector<std::uint64_t>& removed_inodes)
+{
+    if (delta.added.empty() || delta.removed.empty()) {
+        return;
+    }
+
+    // Same inode and type on both sides means the entry moved; hard links pair up first come, first served.
+    std::unordered_multimap<std::uint64_t, std::size_t> removed_by_inode;
+    for (std::size_t i = 0; i < delta.removed.size(); ++i) {
+        if (removed_inodes[i] != 0) {
+            removed_by_inode.emplace(removed_inodes[i], i);
+        }
+    }
+    if (removed_by_inode.empty()) {
+        return;
+    }
+
+    std::vector<bool> added_matched(delta.added.size(), false);
+    std::vector<bool> removed_matched(delta.removed.size(), false);
+    for (std::size_t i = 0; i < delta.added.size(); ++i) {
+        if (added_inodes[i] == 0) {
+            continue;
+        }
+        auto [first, last] = removed_by_inode.equal_range(added_inodes[i]);
+        for (auto it = first; it != last; ++it) {
+            const std::size_t removed_index = it->second;
+            if (delta.removed[removed_index].type == delta.added[i].type) {
+                delta.renamed.push_back(RenamedEntry{delta.removed[removed_index], delta.added[i]});
+                added_matched[i] = true;
+                removed_matched[removed_index] = true;
+                removed_by_inode.erase(it);
+                break;
+            }
+        }
+    }
+
+    const auto drop_matched = [](std::vector<FileEntry>& entries, const std::vector<bool>& matched) {
+        std::size_t kept = 0;
+        for (std::size_t i = 0; i < entries.size(); ++i) {
+            if (matched[i]) {
+                continue;
+            }
+            if (kept != i) {
+                entries[kept] = std::move(entries[i]);
+            }
+            ++kept;
+        }
+        entries.resize(kept);
+    };
+    drop_matched(delta.added, added_matched);
+    drop_matched(delta.removed, removed_matched);
+}
+
+std::optional<IncrementalScanner::DirectoryStamp>
+IncrementalScanner::stat_directory(const std::string& directory_path)
+{
+#ifdef _WIN32
+    std::error_code ec;
+    const auto mtime = fs::last_write_time(Utils::utf8_to_path(directory_path), ec);
+    if (ec) {
+        return std::nullopt;
+    }
+    return DirectoryStamp{
+        std::chrono::duration_cast<std::chrono::nanoseconds>(mtime.time_since_epoch()).count(), 0};
+#else
+    struct stat info {};
+    if (::stat(directory_path.c_str(), &info) != 0) {
+        return std::nullopt;
+    }
+#if defined(__APPLE__)
+    const auto& mtime = info.st_mtimespec;
+#else
+    const auto& mtime = info.st_mtim;
+#endif
+    return DirectoryStamp{static_cast<std::int64_t>(mtime.tv_sec) * 1'000'000'000 + mtime.tv_nsec,
+                          static_cast<std::uint64_t>(info.st_ino)};
+#endif
+}
+
+std::int64_t IncrementalScanner::current_time_ns()
+{
+    // Same clock as the stamps above, so the racy-window comparison is meaningful.
+#ifdef _WIN32
+    const auto now = fs::file_time_type::clock::now().time_since_epoch();
+#else
+    const auto now = std::chrono::system_clock::now().time_since_epoch();
+#endif
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(now).count();
+}
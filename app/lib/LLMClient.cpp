@@ -2,7 +2,10 @@
 #include "Types.hpp"
 #include "Utils.hpp"
 #include "Logger.hpp"
-#include <curl/curl.h>
+#include "CurlSession.hpp"
+#include "LLMErrors.hpp"
+#include "RemoteBatchPrompt.hpp"
+#include "RemoteRequestEngine.hpp"
 #include <cstdlib>
 #include <filesystem>
 #if __has_include(<jsoncpp/json/json.h>)
@@ -16,17 +19,11 @@
 #include <iostream>
 #include <sstream>
 #include <algorithm>
+#include <atomic>
+#include <optional>
 #include <string>
 #include <utility>
 
-// Helper function to write the response from curl into a string
-static size_t WriteCallback(void *contents, size_t size, size_t nmemb, std::string *response)
-{
-    size_t totalSize = size * nmemb;
-    response->append(static_cast<const char*>(contents), totalSize);
-    return totalSize;
-}
-
 namespace {
 std::string trim_ws(const std::string& value);
 
@@ -95,122 +92,23 @@ bool ends_with(const std::string& value, const std::string& suffix) {
     return std::equal(suffix.rbegin(), suffix.rend(), value.rbegin());
 }
 
-struct CurlRequest {
-    CURL* handle{nullptr};
-    curl_slist* headers{nullptr};
-
-    CurlRequest() = default;
-    CurlRequest(const CurlRequest&) = delete;
-    CurlRequest& operator=(const CurlRequest&) = delete;
-
-    CurlRequest(CurlRequest&& other) noexcept
-        : handle(other.handle),
-          headers(other.headers)
-    {
-        other.handle = nullptr;
-        other.headers = nullptr;
-    }
-
-    CurlRequest& operator=(CurlRequest&& other) noexcept
-    {
-        if (this != &other) {
-            cleanup();
-            handle = other.handle;
-            headers = other.headers;
-            other.handle = nullptr;
-            other.headers = nullptr;
-        }
-        return *this;
-    }
-
-    ~CurlRequest() {
-        cleanup();
-    }
-
-private:
-    void cleanup()
-    {
-        if (handle) {
-            curl_easy_cleanup(handle);
-            handle = nullptr;
-        }
-        if (headers) {
-            curl_slist_free_all(headers);
-            headers = nullptr;
-        }
-    }
-};
-
-CurlRequest create_curl_request(const std::shared_ptr<spdlog::logger>& logger)
-{
-    CurlRequest request;
-    request.handle = curl_easy_init();
-    if (!request.handle) {
-        if (logger) {
-            logger->critical("Failed to initialize cURL handle for remote request");
-        }
-        throw std::runtime_error("Initialization Error: Failed to initialize cURL.");
-    }
-
-#ifdef _WIN32
-    try {
-        const auto cert_path = Utils::ensure_ca_bundle();
-        curl_easy_setopt(request.handle, CURLOPT_CAINFO, cert_path.string().c_str());
-    } catch (const std::exception& ex) {
-        throw std::runtime_error(std::string("Failed to stage CA bundle: ") + ex.what());
-    }
-#endif
-    return request;
-}
-
-void configure_request_payload(CurlRequest& request,
-                               const std::string& api_url,
-                               const std::string& payload,
-                               const std::string& api_key,
-                               long timeout_seconds,
-                               std::string& response_buffer)
-{
-    curl_easy_setopt(request.handle, CURLOPT_URL, api_url.c_str());
-    curl_easy_setopt(request.handle, CURLOPT_POST, 1L);
-    curl_easy_setopt(request.handle, CURLOPT_TIMEOUT, timeout_seconds);
-
-    request.headers = curl_slist_append(request.headers, "Content-Type: application/json");
-    if (!api_key.empty()) {
-        const std::string auth = "Authorization: Bearer " + api_key;
-        request.headers = curl_slist_append(request.headers, auth.c_str());
-    }
-    curl_easy_setopt(request.handle, CURLOPT_HTTPHEADER, request.headers);
-
-    curl_easy_setopt(request.handle, CURLOPT_POSTFIELDS, payload.c_str());
-    curl_easy_setopt(request.handle, CURLOPT_WRITEFUNCTION, WriteCallback);
-    curl_easy_setopt(request.handle, CURLOPT_WRITEDATA, &response_buffer);
-}
-
-long perform_request(CurlRequest& request, const std::shared_ptr<spdlog::logger>& logger)
-{
-    const CURLcode res = curl_easy_perform(request.handle);
-    if (res != CURLE_OK) {
-        if (logger) {
-            logger->error("cURL request failed: {}", curl_easy_strerror(res));
-        }
-        throw std::runtime_error("Network Error: " + std::string(curl_easy_strerror(res)));
-    }
-
-    long http_code = 0;
-    curl_easy_getinfo(request.handle, CURLINFO_RESPONSE_CODE, &http_code);
-    return http_code;
-}
-
-std::string parse_category_response(const std::string& payload,
-                                    long http_code,
+std::string parse_category_response(const CurlSession::Response& response,
                                     const std::shared_ptr<spdlog::logger>& logger)
 {
+    const long http_code = response.http_code;
     Json::CharReaderBuilder reader_builder;
     Json::Value root;
-    std::istringstream response_stream(payload);
+    std::istringstream response_stream(response.body);
     std::string errors;
 
-    if (!Json::parseFromStream(reader_builder, response_stream, &root, &errors)) {
+    const bool parsed = Json::parseFromStream(reader_builder, response_stream, &root, &errors);
+    if (http_code == 429) {
+        const std::string message = parsed && root["error"].isObject() ? root["error"]["message"].asString()
+                                                                      : std::string();
+        throw BackoffError(message.empty() ? "Rate limit reached" : "Rate limit reached: " + message,
+                           response.retry_after_seconds);
+    }
+    if (!parsed) {
         if (logger) {
             logger->error("Failed to parse JSON response: {}", errors);
         }
@@ -233,11 +131,59 @@ std::string parse_category_response(const std::string& payload,
 
     return root["choices"][0]["message"]["content"].asString();
 }
+
+using BatchPromise = std::promise<std::vector<std::optional<std::string>>>;
+
+// Sends a batch on the engine. If the endpoint rejects the response schema, the batch is re-sent
+// once as @p plain_request and structured batches stay off for this client.
+void submit_batch_request(RemoteRequestEngine* engine,
+                          RemoteRequestEngine::Request request,
+                          std::optional<RemoteRequestEngine::Request> plain_request,
+                          std::size_t item_count,
+                          std::shared_ptr<std::atomic<bool>> structured_batches,
+                          std::shared_ptr<BatchPromise> promise,
+                          bool log_response)
+{
+    engine->submit(std::move(request),
+                   [engine, plain_request, item_count, structured_batches, promise, log_response](
+                       CurlSession::Response response, std::exception_ptr error) mutable {
+        auto logger = Logger::get_logger("core_logger");
+        try {
+            if (error) {
+                std::rethrow_exception(error);
+            }
+            const std::string reply = parse_category_response(response, logger);
+            if (log_response) {
+                std::cout << "[DEV][RESPONSE] Batch categorization reply\n" << reply << "\n";
+            }
+            promise->set_value(RemoteBatchPrompt::parse_response(reply, item_count, logger));
+        } catch (const BackoffError&) {
+            promise->set_exception(std::current_exception());
+        } catch (const std::exception& ex) {
+            // Older models and some compatible servers reject json_schema; fall back to prompt-only JSON.
+            if (!plain_request || !RemoteBatchPrompt::is_schema_rejection(ex.what())) {
+                promise->set_exception(std::current_exception());
+                return;
+            }
+            if (logger) {
+                logger->info("Remote endpoint rejected structured output ({}); retrying without a schema", ex.what());
+            }
+            structured_batches->store(false);
+            submit_batch_request(engine, std::move(*plain_request), std::nullopt, item_count,
+                                 structured_batches, promise, log_response);
+        }
+    });
+}
 }
 
 
 LLMClient::LLMClient(std::string api_key, std::string model, std::string base_url)
-    : api_key(std::move(api_key)), model(std::move(model)), base_url(std::move(base_url))
+    : api_key(std::move(api_key)),
+      model(std::move(model)),
+      base_url(std::move(base_url)),
+      batch_size(RemoteBatchPrompt::resolve_batch_size()),
+      structured_batches(std::make_shared<std::atomic<bool>>(true)),
+      http_session(std::make_unique<CurlSession>("remote"))
 {}
 
 
@@ -251,7 +197,6 @@ void LLMClient::set_prompt_logging_enabled(bool enabled)
 
 
 std::string LLMClient::send_api_request(std::string json_payload) {
-    std::string response_string;
     const std::string api_url = resolve_api_url();
     auto logger = Logger::get_logger("core_logger");
 
@@ -259,11 +204,17 @@ std::string LLMClient::send_api_request(std::string json_payload) {
         logger->debug("Dispatching remote LLM request to {}", api_url);
     }
 
-    CurlRequest request = create_curl_request(logger);
-    configure_request_payload(request, api_url, json_payload, api_key, resolve_timeout_seconds(base_url), response_string);
+    const auto response = http_session->post_json(api_url, json_payload, auth_headers(), resolve_timeout_seconds(base_url));
+    return parse_category_response(response, logger);
+}
 
-    const long http_code = perform_request(request, logger);
-    return parse_category_response(response_string, http_code, logger);
+std::vector<std::string> LLMClient::auth_headers() const
+{
+    std::vector<std::string> headers;
+    if (!api_key.empty()) {
+        headers.push_back("Authorization: Bearer " + api_key);
+    }
+    return headers;
 }
 
 std::string LLMClient::effective_model() const
@@ -323,6 +274,121 @@ std::string LLMClient::categorize_file(const std::string& file_name,
 }
 
 
+std::size_t LLMClient::preferred_batch_size() const
+{
+    return batch_size;
+}
+
+
+std::vector<std::string> LLMClient::categorize_files(const std::vector<CategorizationRequest>& requests)
+{
+    if (requests.size() <= 1) {
+        return ILLMClient::categorize_files(requests);
+    }
+
+    auto parsed = categorize_files_async(requests).get();
+    std::vector<std::string> responses;
+    responses.reserve(requests.size());
+    for (std::size_t i = 0; i < requests.size(); ++i) {
+        if (parsed[i]) {
+            responses.push_back(std::move(*parsed[i]));
+            continue;
+        }
+        const auto& request = requests[i];
+        responses.push_back(categorize_file(request.file_name,
+                                            request.file_path,
+                                            request.file_type,
+                                            request.consistency_context));
+    }
+    return responses;
+}
+
+
+std::future<std::vector<std::optional<std::string>>> LLMClient::categorize_files_async(
+    const std::vector<CategorizationRequest>& requests)
+{
+    if (auto logger = Logger::get_logger("core_logger")) {
+        logger->debug("Queueing remote categorization for {} item(s) in one batch", requests.size());
+    }
+
+    const bool structured = structured_batches->load();
+    std::string json_payload = make_batch_payload(requests, structured);
+    if (prompt_logging_enabled && !last_prompt.empty()) {
+        std::cout << "\n[DEV][PROMPT] Batch categorization request\n" << last_prompt << "\n";
+    }
+
+    if (!request_engine) {
+        request_engine = RemoteRequestEngine::acquire();
+    }
+
+    auto promise = std::make_shared<BatchPromise>();
+    auto future = promise->get_future();
+    const long timeout_seconds = RemoteBatchPrompt::batch_timeout_seconds(resolve_timeout_seconds(base_url),
+                                                                          requests.size());
+    RemoteRequestEngine::Request request{resolve_api_url(), std::move(json_payload), auth_headers(), timeout_seconds};
+    std::optional<RemoteRequestEngine::Request> plain_request;
+    if (structured) {
+        plain_request = RemoteRequestEngine::Request{resolve_api_url(),
+                                                     make_batch_payload(requests, false),
+                                                     auth_headers(),
+                                                     timeout_seconds};
+    }
+    submit_batch_request(request_engine.get(),
+                         std::move(request),
+                         std::move(plain_request),
+                         requests.size(),
+                         structured_batches,
+                         promise,
+                         prompt_logging_enabled);
+    return future;
+}
+
+
+std::future<std::string> LLMClient::categorize_file_async(const std::string& file_name,
+                                                          const std::string& file_path,
+                                                          FileType file_type,
+                                                          const std::string& consistency_context)
+{
+    if (auto logger = Logger::get_logger("core_logger")) {
+        logger->debug("Queueing remote categorization for '{}' ({})", file_name, to_string(file_type));
+    }
+    std::string json_payload = make_payload(file_name, file_path, file_type, consistency_context);
+
+    if (prompt_logging_enabled && !last_prompt.empty()) {
+        std::cout << "\n[DEV][PROMPT] Categorization request\n" << last_prompt << "\n";
+    }
+
+    if (!request_engine) {
+        request_engine = RemoteRequestEngine::acquire();
+    }
+
+    auto promise = std::make_shared<std::promise<std::string>>();
+    std::future<std::string> future = promise->get_future();
+    RemoteRequestEngine::Request request{resolve_api_url(),
+                                         std::move(json_payload),
+                                         auth_headers(),
+                                         resolve_timeout_seconds(base_url)};
+    const bool log_response = prompt_logging_enabled;
+    request_engine->submit(std::move(request),
+                           [promise, log_response](CurlSession::Response response, std::exception_ptr error) {
+        if (error) {
+            promise->set_exception(error);
+            return;
+        }
+        try {
+            std::string category = parse_category_response(response, Logger::get_logger("core_logger"));
+            if (log_response) {
+                std::cout << "[DEV][RESPONSE] Categorization reply\n" << category << "\n";
+            }
+            promise->set_value(std::move(category));
+        } catch (...) {
+            promise->set_exception(std::current_exception());
+        }
+    });
+    return future;
+}
+
+
 std::string LLMClient::make_payload(const std::string& file_name,
                                     const std::string& file_path,
                                     const FileType file_type,
@@ -373,6 +439,24 @@ std::string LLMClient::make_payload(const std::string& file_name,
     return payload.str();
 }
 
+std::string LLMClient::make_batch_payload(const std::vector<CategorizationRequest>& requests, bool structured)
+{
+    last_prompt = RemoteBatchPrompt::build_user_prompt(requests);
+
+    std::ostringstream payload;
+    payload << "{\"model\": \"" << escape_json(effective_model()) << "\",";
+    payload << "\"messages\": [";
+    payload << "{\"role\": \"system\", \"content\": \""
+            << escape_json(RemoteBatchPrompt::system_prompt()) << "\"},";
+    payload << "{\"role\": \"user\", \"content\": \""
+            << escape_json(last_prompt) << "\"}]";
+    if (structured) {
+        payload << ",\"response_format\": " << RemoteBatchPrompt::openai_response_format();
+    }
+    payload << "}";
+    return payload.str();
+}
+
 std::string LLMClient::make_generic_payload(const std::string& system_prompt,
                                             const std::string& user_prompt,
                                             int max_tokens) const
@@ -19,6 +19,7 @@
 #include <string_view>
 #include <thread>
 #include <unordered_set>
+#include <vector>
 
 #ifdef AI_FILE_SORTER_HAS_MTMD
 #include "ggml-backend.h"
@@ -145,6 +146,10 @@ std::optional<int> resolve_visual_gpu_layer_override() {
     return read_env_int("LLAVA_N_GPU_LAYERS");
 }
 
+bool resolve_single_pass(bool configured) {
+    return read_env_bool("AI_FILE_SORTER_VISUAL_SINGLE_PASS").value_or(configured);
+}
+
 std::string read_env_lower(const char* key) {
     const char* value = std::getenv(key);
     if (!value || value[0] == '\0') {
@@ -412,6 +417,10 @@ int32_t default_visual_batch_size(bool gpu_enabled, std::string_view backend_nam
 int32_t visual_model_n_gpu_layers_for_model(const std::string& model_path) {
     return build_visual_model_params_for_path(model_path, nullptr).n_gpu_layers;
 }
+
+bool resolve_single_pass(bool configured) {
+    return ::resolve_single_pass(configured);
+}
 }
 #endif
 
@@ -433,6 +442,7 @@ LlavaImageAnalyzer::LlavaImageAnalyzer(const std::filesystem::path& model_path,
     if (settings_.n_threads <= 0) {
         settings_.n_threads = static_cast<int32_t>(std::max(1u, std::thread::hardware_concurrency()));
     }
+    settings_.single_pass = resolve_single_pass(settings_.single_pass);
 
 #ifndef AI_FILE_SORTER_HAS_MTMD
     (void)model_path;
@@ -644,9 +654,16 @@ LlavaImageAnalysisResult LlavaImageAnalyzer::analyze(const std::filesystem::path
                                                build_description_prompt(),
                                                settings_.n_predict);
 
-    const std::string raw_filename = infer_text(nullptr,
-                                                build_filename_prompt(description),
-                                                settings_.n_predict);
+    // Single pass: ask for the filename right after the description, reusing the image and
+    // description already in the KV cache. Re-prompt from scratch only if that does not fit.
+    std::optional<std::string> followup;
+    if (settings_.single_pass) {
+        followup = continue_text(build_filename_followup_prompt(), settings_.n_predict);
+    }
+    const std::string raw_filename = followup ? *followup
+                                              : infer_text(nullptr,
+                                                           build_filename_prompt(description),
+                                                           settings_.n_predict);
     if (logger) {
         logger->info("LLaVA raw filename: {}", raw_filename);
     }
@@ -694,6 +711,21 @@ std::string LlavaImageAnalyzer::build_filename_prompt(const std::string& descrip
     return oss.str();
 }
 
+std::string LlavaImageAnalyzer::build_filename_followup_prompt() const {
+    std::ostringstream oss;
+    oss << "\n\nBased on the description above, generate a specific and descriptive filename for the image.\n"
+        << "Limit the filename to a maximum of 3 words. Use nouns and avoid starting with verbs like "
+        << "'depicts', 'shows', 'presents', etc.\n"
+        << "Do not include any data type words like 'image', 'jpg', 'png', etc. Use only letters and "
+        << "connect words with underscores.\n\n"
+        << "Example:\n"
+        << "Description: A photo of a sunset over the mountains.\n"
+        << "Filename: sunset_over_mountains\n\n"
+        << "Output only the filename, without any additional text.\n\n"
+        << "Filename:";
+    return oss.str();
+}
+
 #ifdef AI_FILE_SORTER_HAS_MTMD
 void LlavaImageAnalyzer::mtmd_progress_callback(const char* name,
                                                 int32_t current_batch,
@@ -834,6 +866,49 @@ std::string LlavaImageAnalyzer::infer_text(mtmd_bitmap* bitmap,
         throw std::runtime_error("mtmd_helper_eval_chunks failed");
     }
 
+    return generate_response(max_tokens);
+}
+
+std::optional<std::string> LlavaImageAnalyzer::continue_text(const std::string& prompt,
+                                                             int32_t max_tokens) {
+    if (!context_) {
+        return std::nullopt;
+    }
+
+    std::vector<llama_token> tokens(prompt.size() + 1);
+    const int32_t n_tokens = llama_tokenize(vocab_,
+                                            prompt.c_str(),
+                                            static_cast<int32_t>(prompt.size()),
+                                            tokens.data(),
+                                            static_cast<int32_t>(tokens.size()),
+                                            false /* add_special */,
+                                            true /* parse_special */);
+    if (n_tokens <= 0) {
+        return std::nullopt;
+    }
+    tokens.resize(static_cast<size_t>(n_tokens));
+
+    const llama_pos n_past = llama_memory_seq_pos_max(llama_get_memory(context_), 0) + 1;
+    if (n_past <= 0 || n_past + n_tokens + max_tokens > context_tokens_) {
+        return std::nullopt;
+    }
+
+    const int32_t n_batch = batch_size_ > 0 ? batch_size_ : 512;
+    for (int32_t offset = 0; offset < n_tokens; offset += n_batch) {
+        const int32_t count = std::min(n_batch, n_tokens - offset);
+        llama_batch batch = llama_batch_get_one(tokens.data() + offset, count);
+        if (llama_decode(context_, batch) != 0) {
+            if (auto logger = Logger::get_logger("core_logger")) {
+                logger->warn("LLaVA follow-up prompt failed to decode; re-prompting without context.");
+            }
+            return std::nullopt;
+        }
+    }
+
+    return generate_response(max_tokens);
+}
+
+std::string LlavaImageAnalyzer::generate_response(int32_t max_tokens) {
     std::string response;
     response.reserve(256);
 
@@ -27,6 +27,7 @@
 #include <string_view>
 #include <string>
 #include <array>
+#include <chrono>
 #include <utility>
 
 #if defined(__APPLE__)
@@ -676,6 +677,13 @@ std::string shrink_user_prompt_for_context(const std::string& prompt, int attemp
         static_cast<std::size_t>(attempt),
         kPromptBudgets.size() - 1)];
     if (trimmed.size() > budget) {
+        // Leading context is expendable; the per-item request at the end is not.
+        const std::size_t request_start = trimmed.find("\n\nCategorize this ");
+        if (request_start != std::string::npos && trimmed.size() - request_start < budget) {
+            const std::size_t context_budget = budget - (trimmed.size() - request_start);
+            return truncate_with_ellipsis(trimmed.substr(0, request_start), context_budget) +
+                   trimmed.substr(request_start);
+        }
         return truncate_with_ellipsis(trimmed, budget);
     }
 
@@ -1104,13 +1112,141 @@ bool tokenize_prompt(const llama_vocab* vocab,
     return true;
 }
 
+double elapsed_ms(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+int resolve_local_batch_size() {
+    int parsed = 0;
+    if (try_parse_env_int("AI_FILE_SORTER_LOCAL_BATCH_SIZE", parsed) && parsed > 0) {
+        return std::clamp(parsed, 1, 16);
+    }
+    // Opt-in: a batch is prompted before any of its items is finalized, so it sees fewer
+    // consistency hints, and the batched context is allocated next to the regular one.
+    return 1;
+}
+
+bool grammar_decoding_enabled_from_env()
+{
+    const char* env = std::getenv("AI_FILE_SORTER_LOCAL_GRAMMAR");
+    if (!env || env[0] == '\0') {
+        return true;
+    }
+
+    std::string value{env};
+    std::transform(value.begin(), value.end(), value.begin(), [](unsigned char c) {
+        return static_cast<char>(std::tolower(c));
+    });
+    return value != "0" && value != "false" && value != "off" && value != "no";
+}
+
+std::string escape_gbnf_literal(const std::string& value)
+{
+    std::string escaped;
+    escaped.reserve(value.size() + 2);
+    escaped.push_back('"');
+    for (const char ch : value) {
+        switch (ch) {
+            case '"': escaped += "\\\""; break;
+            case '\\': escaped += "\\\\"; break;
+            case '\n': escaped += "\\n"; break;
+            case '\r': escaped += "\\r"; break;
+            case '\t': escaped += "\\t"; break;
+            default: escaped.push_back(ch); break;
+        }
+    }
+    escaped.push_back('"');
+    return escaped;
+}
+
+// Alternation of whitelisted labels, or a free-form label without ':' or line breaks.
+std::string build_label_rule(const std::vector<std::string>& labels)
+{
+    std::string rule;
+    for (const auto& label : labels) {
+        const std::string trimmed = trim_copy(label);
+        if (trimmed.empty() || trimmed.find_first_of(":\r\n") != std::string::npos) {
+            continue;
+        }
+        if (!rule.empty()) {
+            rule += " | ";
+        }
+        rule += escape_gbnf_literal(trimmed);
+    }
+    return rule.empty() ? std::string("label") : rule;
+}
+
+// Shared context goes first so consecutive requests share a long prompt prefix in the KV cache;
+// only the lines naming the item differ between requests.
+std::string build_categorization_prompt(const std::string& file_name,
+                                        const std::string& file_path,
+                                        FileType file_type,
+                                        const std::string& consistency_context)
+{
+    std::ostringstream prompt;
+    if (!consistency_context.empty()) {
+        prompt << consistency_context << "\n\n";
+    }
+
+    prompt << (file_type == FileType::File ? "Categorize this file.\n" : "Categorize this directory.\n");
+    if (!file_path.empty()) {
+        prompt << "Full path: " << file_path << "\n";
+    }
+    prompt << (file_type == FileType::File ? "File name: " : "Directory name: ")
+           << file_name << "\n";
+
+    return prompt.str();
+}
+
+// GBNF grammar that admits exactly one "<Category> : <Subcategory>" line followed by a newline.
+std::string build_category_grammar(const std::vector<std::string>& categories,
+                                   const std::vector<std::string>& subcategories)
+{
+    std::string grammar;
+    grammar += "root ::= category \" : \" subcategory \"\\n\"\n";
+    grammar += "category ::= " + build_label_rule(categories) + "\n";
+    grammar += "subcategory ::= " + build_label_rule(subcategories) + "\n";
+    grammar += "label ::= [^ :\\r\\n] [^:\\r\\n]{0,47}\n";
+    return grammar;
+}
+
+llama_sampler* create_sampler_chain(const llama_vocab* vocab = nullptr, const std::string& grammar = {})
+{
+    llama_sampler* chain = llama_sampler_chain_init(llama_sampler_chain_default_params());
+    if (vocab && !grammar.empty()) {
+        if (llama_sampler* constraint = llama_sampler_init_grammar(vocab, grammar.c_str(), "root")) {
+            llama_sampler_chain_add(chain, constraint);
+        } else if (auto logger = Logger::get_logger("core_logger")) {
+            logger->warn("Failed to parse category grammar; sampling without constraints");
+        }
+    }
+    llama_sampler_chain_add(chain, llama_sampler_init_min_p(0.05f, 1));
+    llama_sampler_chain_add(chain, llama_sampler_init_temp(0.8f));
+    llama_sampler_chain_add(chain, llama_sampler_init_dist(LLAMA_DEFAULT_SEED));
+    return chain;
+}
+
+void add_batch_token(llama_batch& batch, llama_token token, llama_pos pos, llama_seq_id seq_id, bool logits)
+{
+    const int32_t index = batch.n_tokens;
+    batch.token[index] = token;
+    batch.pos[index] = pos;
+    batch.n_seq_id[index] = 1;
+    batch.seq_id[index][0] = seq_id;
+    batch.logits[index] = logits ? 1 : 0;
+    ++batch.n_tokens;
+}
+
 std::string run_generation_loop(llama_context* ctx,
                                 llama_sampler* smpl,
                                 std::vector<llama_token>& prompt_tokens,
                                 int n_prompt,
                                 int max_tokens,
                                 const std::shared_ptr<spdlog::logger>& logger,
-                                const llama_vocab* vocab)
+                                const llama_vocab* vocab,
+                                LocalLLMClient::RequestTimings* timings = nullptr,
+                                std::vector<llama_token>* kv_tokens = nullptr)
 {
     const int ctx_n_ctx = static_cast<int>(llama_n_ctx(ctx));
     int ctx_n_batch = static_cast<int>(llama_n_batch(ctx));
@@ -1132,7 +1268,28 @@ std::string run_generation_loop(llama_context* ctx,
         }
     }
 
+    const auto prompt_eval_start = std::chrono::steady_clock::now();
     int n_pos = 0;
+    if (kv_tokens) {
+        // Keep the longest prefix already resident in the KV cache (system prompt, chat template,
+        // shared context) and drop the rest. At least one token is re-decoded to get fresh logits.
+        const std::size_t limit = std::min(kv_tokens->size(), static_cast<std::size_t>(n_prompt - 1));
+        std::size_t common = 0;
+        while (common < limit && (*kv_tokens)[common] == prompt_tokens[common]) {
+            ++common;
+        }
+        llama_memory_t memory = llama_get_memory(ctx);
+        if (!llama_memory_seq_rm(memory, 0, static_cast<llama_pos>(common), -1)) {
+            llama_memory_clear(memory, true);
+            common = 0;
+        }
+        kv_tokens->assign(prompt_tokens.begin(), prompt_tokens.begin() + static_cast<std::ptrdiff_t>(common));
+        n_pos = static_cast<int>(common);
+    }
+    if (timings) {
+        timings->reused_prompt_tokens = n_pos;
+    }
+
     while (n_pos < n_prompt) {
         const int chunk = std::min(ctx_n_batch, n_prompt - n_pos);
         llama_batch batch = llama_batch_get_one(prompt_tokens.data() + n_pos, chunk);
@@ -1140,11 +1297,23 @@ std::string run_generation_loop(llama_context* ctx,
             if (logger) {
                 logger->warn("llama_decode returned non-zero status during prompt eval; aborting generation");
             }
+            if (kv_tokens) {
+                llama_memory_clear(llama_get_memory(ctx), true);
+                kv_tokens->clear();
+            }
             return std::string();
         }
+        if (kv_tokens) {
+            kv_tokens->insert(kv_tokens->end(), prompt_tokens.begin() + n_pos, prompt_tokens.begin() + n_pos + chunk);
+        }
         n_pos += chunk;
     }
+    if (timings) {
+        timings->prompt_eval_ms = elapsed_ms(prompt_eval_start);
+        timings->prompt_tokens = n_prompt;
+    }
 
+    const auto generation_start = std::chrono::steady_clock::now();
     std::string output;
     int generated_tokens = 0;
     while (generated_tokens < max_tokens) {
@@ -1167,8 +1336,20 @@ std::string run_generation_loop(llama_context* ctx,
             if (logger) {
                 logger->warn("llama_decode returned non-zero status; aborting generation");
             }
+            if (kv_tokens) {
+                llama_memory_clear(llama_get_memory(ctx), true);
+                kv_tokens->clear();
+            }
             break;
         }
+        if (kv_tokens) {
+            kv_tokens->push_back(new_token_id);
+        }
+    }
+
+    if (timings) {
+        timings->generation_ms = elapsed_ms(generation_start);
+        timings->generated_tokens = generated_tokens;
     }
 
     while (!output.empty() && std::isspace(static_cast<unsigned char>(output.front()))) {
@@ -1893,6 +2074,9 @@ LocalLLMClient::LocalLLMClient(const std::string& model_path,
 
     model_params = load_model_or_throw(model_params, logger);
     configure_context(context_length, model_params);
+    batch_size = static_cast<std::size_t>(resolve_local_batch_size());
+    grammar_enabled_ = grammar_decoding_enabled_from_env();
+    category_grammar_ = build_category_grammar({}, {});
 }
 
 
@@ -2055,6 +2239,18 @@ std::string sanitize_output_for_testing(const std::string& output) {
     return sanitize_categorization_output(output);
 }
 
+std::string build_category_grammar_for_testing(const std::vector<std::string>& categories,
+                                               const std::vector<std::string>& subcategories) {
+    return build_category_grammar(categories, subcategories);
+}
+
+std::string make_prompt_for_testing(const std::string& file_name,
+                                    const std::string& file_path,
+                                    FileType file_type,
+                                    const std::string& consistency_context) {
+    return build_categorization_prompt(file_name, file_path, file_type, consistency_context);
+}
+
 } // namespace LocalLLMTestAccess
 #endif
 
@@ -2124,26 +2320,15 @@ std::string LocalLLMClient::make_prompt(const std::string& file_name,
                                         FileType file_type,
                                         const std::string& consistency_context)
 {
-    std::ostringstream prompt;
-    prompt << (file_type == FileType::File ? "Categorize this file.\n" : "Categorize this directory.\n");
-    if (!file_path.empty()) {
-        prompt << "Full path: " << file_path << "\n";
-    }
-    prompt << (file_type == FileType::File ? "File name: " : "Directory name: ")
-           << file_name << "\n";
-
-    if (!consistency_context.empty()) {
-        prompt << "\n" << consistency_context << "\n";
-    }
-
-    return prompt.str();
+    return build_categorization_prompt(file_name, file_path, file_type, consistency_context);
 }
 
 
 std::string LocalLLMClient::generate_response(const std::string& prompt,
                                               int n_predict,
                                               bool apply_sanitizer,
-                                              const std::string& system_prompt)
+                                              const std::string& system_prompt,
+                                              const std::string& grammar)
 {
     auto logger = Logger::get_logger("core_logger");
     if (logger) {
@@ -2224,83 +2409,84 @@ std::string LocalLLMClient::generate_response(const std::string& prompt,
 
     bool allow_fallback = true;
     for (;;) {
-        llama_context* ctx = nullptr;
-        llama_sampler* smpl = nullptr;
         try {
-            llama_context_params resolved_params = ctx_params;
-            llama_context_params base_params = ctx_params;
-            ctx = init_context_with_retries(base_params, false, resolved_params);
-
-            if (!ctx && !is_cpu_backend_requested()) {
-                if (!allow_gpu_fallback(fallback_decision_callback_, logger, "context initialization failure")) {
-                    allow_fallback = false;
-                    throw std::runtime_error("GPU backend failed during context initialization and CPU fallback was declined.");
-                }
-                if (logger) {
-                    logger->warn("Context init failed on GPU; reloading model on CPU and retrying.");
-                }
-                notify_status(Status::GpuFallbackToCpu);
-                llama_model_params cpu_params = llama_model_default_params();
-                cpu_params.n_gpu_layers = 0;
-                set_env_var("AI_FILE_SORTER_GPU_BACKEND", "cpu");
-                set_env_var("LLAMA_ARG_DEVICE", "cpu");
-                set_env_var("GGML_DISABLE_CUDA", "1");
-
-                llama_model* old_model = model;
-                llama_model* cpu_model = llama_model_load_from_file(model_path.c_str(), cpu_params);
-                if (!cpu_model) {
-                    if (logger) {
-                        logger->error("Failed to reload model on CPU after context init failure");
+            last_timings_ = RequestTimings{};
+            const auto setup_start = std::chrono::steady_clock::now();
+            if (ctx) {
+                // Reuse the context created by an earlier request. The KV cache is trimmed to the
+                // prompt prefix it shares with this request once the prompt is tokenized.
+                last_timings_.reused_context = true;
+            } else {
+                llama_context_params resolved_params = ctx_params;
+                llama_context_params base_params = ctx_params;
+                ctx = init_context_with_retries(base_params, false, resolved_params);
+
+                if (!ctx && !is_cpu_backend_requested()) {
+                    if (!allow_gpu_fallback(fallback_decision_callback_, logger, "context initialization failure")) {
+                        allow_fallback = false;
+                        throw std::runtime_error("GPU backend failed during context initialization and CPU fallback was declined.");
                     }
-                } else {
-                    if (old_model) {
-                        llama_model_free(old_model);
+                    if (logger) {
+                        logger->warn("Context init failed on GPU; reloading model on CPU and retrying.");
                     }
-                    model = cpu_model;
-                    vocab = llama_model_get_vocab(model);
+                    notify_status(Status::GpuFallbackToCpu);
+                    llama_model_params cpu_params = llama_model_default_params();
+                    cpu_params.n_gpu_layers = 0;
+                    set_env_var("AI_FILE_SORTER_GPU_BACKEND", "cpu");
+                    set_env_var("LLAMA_ARG_DEVICE", "cpu");
+                    set_env_var("GGML_DISABLE_CUDA", "1");
+
+                    llama_model* old_model = model;
+                    llama_model* cpu_model = llama_model_load_from_file(model_path.c_str(), cpu_params);
+                    if (!cpu_model) {
+                        if (logger) {
+                            logger->error("Failed to reload model on CPU after context init failure");
+                        }
+                    } else {
+                        release_context();
+                        if (old_model) {
+                            llama_model_free(old_model);
+                        }
+                        model = cpu_model;
+                        vocab = llama_model_get_vocab(model);
 #ifdef GGML_USE_METAL
-                    base_params = ctx_params;
-                    base_params.offload_kqv = false;
+                        base_params = ctx_params;
+                        base_params.offload_kqv = false;
 #else
-                    base_params = ctx_params;
+                        base_params = ctx_params;
 #endif
-                    resolved_params = base_params;
-                    ctx = init_context_with_retries(base_params, true, resolved_params);
+                        resolved_params = base_params;
+                        ctx = init_context_with_retries(base_params, true, resolved_params);
+                    }
                 }
-            }
 
-            if (!ctx) {
-                if (logger) {
-                    logger->error("Failed to initialize llama context");
+                if (!ctx) {
+                    if (logger) {
+                        logger->error("Failed to initialize llama context");
+                    }
+                    return "";
                 }
-                return "";
-            }
 
-            ctx_params = resolved_params;
+                ctx_params = resolved_params;
+                kv_tokens_.clear();
+            }
 
-            smpl = llama_sampler_chain_init(llama_sampler_chain_default_params());
-            llama_sampler_chain_add(smpl, llama_sampler_init_min_p(0.05f, 1));
-            llama_sampler_chain_add(smpl, llama_sampler_init_temp(0.8f));
-            llama_sampler_chain_add(smpl, llama_sampler_init_dist(LLAMA_DEFAULT_SEED));
+            prepare_sampler(grammar);
 
             std::vector<llama_token> prompt_tokens;
             int n_prompt = 0;
             std::string working_prompt = prompt;
             std::string final_prompt;
-            const int context_budget = prompt_token_budget(static_cast<int>(resolved_params.n_ctx), n_predict);
+            const int context_budget = prompt_token_budget(static_cast<int>(ctx_params.n_ctx), n_predict);
             for (int shrink_attempt = 0;; ++shrink_attempt) {
                 if (!format_prompt(model, system_prompt, working_prompt, final_prompt)) {
                     if (logger) {
                         logger->error("Failed to apply chat template to prompt");
                     }
-                    llama_free(ctx);
-                    llama_sampler_free(smpl);
                     return "";
                 }
 
                 if (!tokenize_prompt(vocab, final_prompt, prompt_tokens, n_prompt, logger)) {
-                    llama_free(ctx);
-                    llama_sampler_free(smpl);
                     return "";
                 }
 
@@ -2325,6 +2511,7 @@ std::string LocalLLMClient::generate_response(const std::string& prompt,
                 }
                 working_prompt = trimmed_prompt;
             }
+            last_timings_.setup_ms = elapsed_ms(setup_start);
 
             std::string output = run_generation_loop(ctx,
                                                      smpl,
@@ -2332,14 +2519,21 @@ std::string LocalLLMClient::generate_response(const std::string& prompt,
                                                      n_prompt,
                                                      n_predict,
                                                      logger,
-                                                     vocab);
-
-            llama_sampler_reset(smpl);
-            llama_free(ctx);
-            llama_sampler_free(smpl);
+                                                     vocab,
+                                                     &last_timings_,
+                                                     &kv_tokens_);
 
             if (logger) {
                 logger->debug("Generation complete, produced {} character(s)", output.size());
+                logger->debug("Local LLM timings: setup {:.1f} ms ({}), prompt eval {:.1f} ms ({} tok, {} cached), "
+                              "generation {:.1f} ms ({} tok)",
+                              last_timings_.setup_ms,
+                              last_timings_.reused_context ? "reused context" : "new context",
+                              last_timings_.prompt_eval_ms,
+                              last_timings_.prompt_tokens,
+                              last_timings_.reused_prompt_tokens,
+                              last_timings_.generation_ms,
+                              last_timings_.generated_tokens);
             }
 
             if (apply_sanitizer) {
@@ -2347,12 +2541,7 @@ std::string LocalLLMClient::generate_response(const std::string& prompt,
             }
             return output;
         } catch (const std::exception& ex) {
-            if (ctx) {
-                llama_free(ctx);
-            }
-            if (smpl) {
-                llama_sampler_free(smpl);
-            }
+            release_context();
 
             if (allow_fallback && !is_cpu_backend_requested()) {
                 if (!allow_gpu_fallback(fallback_decision_callback_, logger, "generation failure")) {
@@ -2399,6 +2588,282 @@ std::string LocalLLMClient::generate_response(const std::string& prompt,
 }
 
 
+void LocalLLMClient::prepare_sampler(const std::string& grammar)
+{
+    if (smpl && sampler_grammar_ == grammar) {
+        llama_sampler_reset(smpl);
+        return;
+    }
+    if (smpl) {
+        llama_sampler_free(smpl);
+    }
+    smpl = create_sampler_chain(vocab, grammar);
+    sampler_grammar_ = grammar;
+}
+
+
+void LocalLLMClient::release_context()
+{
+    if (smpl) {
+        llama_sampler_free(smpl);
+        smpl = nullptr;
+    }
+    if (ctx) {
+        llama_free(ctx);
+        ctx = nullptr;
+    }
+    if (batch_ctx) {
+        llama_free(batch_ctx);
+        batch_ctx = nullptr;
+        batch_ctx_seqs = 0;
+    }
+    kv_tokens_.clear();
+}
+
+
+bool LocalLLMClient::ensure_batch_context(std::size_t n_seq)
+{
+    if (batch_ctx && batch_ctx_seqs >= n_seq) {
+        return true;
+    }
+    if (batch_ctx) {
+        llama_free(batch_ctx);
+        batch_ctx = nullptr;
+        batch_ctx_seqs = 0;
+    }
+    if (!model) {
+        return false;
+    }
+
+    const std::size_t seqs = std::max(n_seq, batch_size);
+    llama_context_params params = ctx_params;
+    params.n_seq_max = static_cast<uint32_t>(seqs);
+    params.n_ctx = ctx_params.n_ctx * static_cast<uint32_t>(seqs);
+    params.n_batch = std::max<uint32_t>(ctx_params.n_batch, static_cast<uint32_t>(seqs));
+    batch_ctx = llama_init_from_model(model, params);
+    if (!batch_ctx) {
+        if (auto logger = Logger::get_logger("core_logger")) {
+            logger->warn("Failed to initialize batched llama context for {} sequence(s); using sequential decoding",
+                         seqs);
+        }
+        batch_size = 1;
+        return false;
+    }
+    batch_ctx_seqs = seqs;
+    return true;
+}
+
+
+std::optional<std::vector<std::string>> LocalLLMClient::generate_batch_responses(
+    const std::vector<std::string>& prompts,
+    int n_predict,
+    const std::string& system_prompt,
+    const std::string& grammar)
+{
+    auto logger = Logger::get_logger("core_logger");
+    const std::size_t n_seq = prompts.size();
+    if (n_seq == 0) {
+        return std::vector<std::string>{};
+    }
+
+    last_timings_ = RequestTimings{};
+    last_timings_.reused_context = batch_ctx != nullptr;
+    const auto setup_start = std::chrono::steady_clock::now();
+    if (!ensure_batch_context(n_seq)) {
+        return std::nullopt;
+    }
+
+    const int n_ctx_seq = static_cast<int>(llama_n_ctx(batch_ctx) / batch_ctx_seqs);
+    const int context_budget = prompt_token_budget(n_ctx_seq, n_predict);
+    std::vector<std::vector<llama_token>> tokens(n_seq);
+    for (std::size_t s = 0; s < n_seq; ++s) {
+        std::string final_prompt;
+        int n_prompt = 0;
+        if (!format_prompt(model, system_prompt, prompts[s], final_prompt) ||
+            !tokenize_prompt(vocab, final_prompt, tokens[s], n_prompt, logger) ||
+            tokens[s].empty()) {
+            return std::nullopt;
+        }
+        if (context_budget > 0 && n_prompt > context_budget) {
+            // Oversized prompts go through the sequential path, which knows how to shrink them.
+            return std::nullopt;
+        }
+        last_timings_.prompt_tokens += n_prompt;
+    }
+
+    // Tokens shared by every prompt (chat template, system prompt, shared context) are decoded once.
+    std::size_t prefix = tokens.front().size() - 1;
+    for (std::size_t s = 1; s < n_seq; ++s) {
+        const auto& current = tokens[s];
+        std::size_t common = 0;
+        const std::size_t limit = std::min(prefix, current.size() - 1);
+        while (common < limit && current[common] == tokens.front()[common]) {
+            ++common;
+        }
+        prefix = common;
+    }
+    last_timings_.reused_prompt_tokens = static_cast<int>(prefix * (n_seq - 1));
+
+    llama_memory_t memory = llama_get_memory(batch_ctx);
+    llama_memory_clear(memory, true);
+
+    const int32_t n_batch = static_cast<int32_t>(llama_n_batch(batch_ctx));
+    llama_batch batch = llama_batch_init(n_batch, 0, 1);
+    std::vector<llama_sampler*> samplers;
+    samplers.reserve(n_seq);
+    auto cleanup = [&]() {
+        for (auto* sampler : samplers) {
+            llama_sampler_free(sampler);
+        }
+        samplers.clear();
+        llama_batch_free(batch);
+    };
+    auto fail = [&](const char* stage) -> std::optional<std::vector<std::string>> {
+        if (logger) {
+            logger->warn("llama_decode returned non-zero status during batched {}; using sequential decoding",
+                         stage);
+        }
+        cleanup();
+        llama_memory_clear(memory, true);
+        return std::nullopt;
+    };
+    for (std::size_t s = 0; s < n_seq; ++s) {
+        samplers.push_back(create_sampler_chain(vocab, grammar));
+    }
+    last_timings_.setup_ms = elapsed_ms(setup_start);
+
+    const auto prompt_eval_start = std::chrono::steady_clock::now();
+    for (std::size_t pos = 0; pos < prefix; ++pos) {
+        add_batch_token(batch, tokens.front()[pos], static_cast<llama_pos>(pos), 0, false);
+        if (batch.n_tokens == n_batch) {
+            const bool ok = llama_decode(batch_ctx, batch) == 0;
+            batch.n_tokens = 0;
+            if (!ok) {
+                return fail("prompt eval");
+            }
+        }
+    }
+    if (batch.n_tokens > 0) {
+        const bool ok = llama_decode(batch_ctx, batch) == 0;
+        batch.n_tokens = 0;
+        if (!ok) {
+            return fail("prompt eval");
+        }
+    }
+    for (std::size_t s = 1; s < n_seq; ++s) {
+        llama_memory_seq_cp(memory, 0, static_cast<llama_seq_id>(s), -1, -1);
+    }
+
+    std::vector<std::string> outputs(n_seq);
+    std::vector<llama_token> pending(n_seq, 0);
+    std::vector<llama_pos> n_past(n_seq, 0);
+    std::vector<int32_t> logit_index(n_seq, -1);
+    std::vector<int> generated(n_seq, 0);
+    std::vector<bool> active(n_seq, true);
+
+    auto accept_token = [&](std::size_t s, llama_token token) {
+        if (llama_vocab_is_eog(vocab, token)) {
+            active[s] = false;
+            return;
+        }
+        char buf[128];
+        const int n = llama_token_to_piece(vocab, token, buf, sizeof(buf), 0, true);
+        if (n < 0) {
+            active[s] = false;
+            return;
+        }
+        outputs[s].append(buf, n);
+        pending[s] = token;
+        if (++generated[s] >= n_predict) {
+            active[s] = false;
+        }
+    };
+
+    // Each sequence samples its first token right after the decode that holds its last prompt token.
+    std::vector<std::size_t> awaiting_first_token;
+    auto flush_prompt_batch = [&]() {
+        const bool ok = llama_decode(batch_ctx, batch) == 0;
+        batch.n_tokens = 0;
+        if (!ok) {
+            return false;
+        }
+        for (const std::size_t s : awaiting_first_token) {
+            accept_token(s, llama_sampler_sample(samplers[s], batch_ctx, logit_index[s]));
+        }
+        awaiting_first_token.clear();
+        return true;
+    };
+    for (std::size_t s = 0; s < n_seq; ++s) {
+        const auto& seq_tokens = tokens[s];
+        for (std::size_t pos = prefix; pos < seq_tokens.size(); ++pos) {
+            const bool last = pos + 1 == seq_tokens.size();
+            add_batch_token(batch, seq_tokens[pos], static_cast<llama_pos>(pos), static_cast<llama_seq_id>(s), last);
+            if (last) {
+                logit_index[s] = batch.n_tokens - 1;
+                awaiting_first_token.push_back(s);
+            }
+            if (batch.n_tokens == n_batch && !flush_prompt_batch()) {
+                return fail("prompt eval");
+            }
+        }
+        n_past[s] = static_cast<llama_pos>(seq_tokens.size());
+    }
+    if (batch.n_tokens > 0 && !flush_prompt_batch()) {
+        return fail("prompt eval");
+    }
+    last_timings_.prompt_eval_ms = elapsed_ms(prompt_eval_start);
+
+    const auto generation_start = std::chrono::steady_clock::now();
+    std::vector<std::size_t> stepping;
+    for (;;) {
+        stepping.clear();
+        for (std::size_t s = 0; s < n_seq; ++s) {
+            if (!active[s]) {
+                continue;
+            }
+            logit_index[s] = batch.n_tokens;
+            add_batch_token(batch, pending[s], n_past[s]++, static_cast<llama_seq_id>(s), true);
+            stepping.push_back(s);
+        }
+        if (stepping.empty()) {
+            break;
+        }
+        const bool ok = llama_decode(batch_ctx, batch) == 0;
+        batch.n_tokens = 0;
+        if (!ok) {
+            return fail("generation");
+        }
+        for (const std::size_t s : stepping) {
+            accept_token(s, llama_sampler_sample(samplers[s], batch_ctx, logit_index[s]));
+        }
+    }
+    last_timings_.generation_ms = elapsed_ms(generation_start);
+    for (const int count : generated) {
+        last_timings_.generated_tokens += count;
+    }
+    cleanup();
+
+    if (logger) {
+        logger->debug("Local LLM batch of {} timings: setup {:.1f} ms, prompt eval {:.1f} ms ({} tok, {} shared), "
+                      "generation {:.1f} ms ({} tok)",
+                      n_seq,
+                      last_timings_.setup_ms,
+                      last_timings_.prompt_eval_ms,
+                      last_timings_.prompt_tokens,
+                      last_timings_.reused_prompt_tokens,
+                      last_timings_.generation_ms,
+                      last_timings_.generated_tokens);
+    }
+
+    for (auto& output : outputs) {
+        while (!output.empty() && std::isspace(static_cast<unsigned char>(output.front()))) {
+            output.erase(output.begin());
+        }
+    }
+    return outputs;
+}
+
+
 std::string LocalLLMClient::categorize_file(const std::string& file_name,
                                             const std::string& file_path,
                                             FileType file_type,
@@ -2419,7 +2884,7 @@ std::string LocalLLMClient::categorize_file(const std::string& file_name,
                   << "[system]\n" << system_prompt << "\n"
                   << "[user]\n" << prompt << "\n";
     }
-    std::string response = generate_response(prompt, 64, true, system_prompt);
+    std::string response = generate_response(prompt, 64, true, system_prompt, category_grammar());
     if (prompt_logging_enabled) {
         std::cout << "[DEV][RESPONSE] Categorization reply\n" << response << "\n";
     }
@@ -2427,6 +2892,91 @@ std::string LocalLLMClient::categorize_file(const std::string& file_name,
 }
 
 
+std::vector<std::string> LocalLLMClient::categorize_files(const std::vector<CategorizationRequest>& requests)
+{
+    if (requests.size() <= 1 || batch_size <= 1) {
+        return ILLMClient::categorize_files(requests);
+    }
+
+    auto logger = Logger::get_logger("core_logger");
+    const std::string system_prompt = categorization_system_prompt();
+    std::vector<std::string> responses;
+    responses.reserve(requests.size());
+    for (std::size_t start = 0; start < requests.size(); start += batch_size) {
+        const std::size_t end = std::min(requests.size(), start + batch_size);
+        std::vector<std::string> prompts;
+        prompts.reserve(end - start);
+        for (std::size_t i = start; i < end; ++i) {
+            const auto& request = requests[i];
+            prompts.push_back(make_prompt(request.file_name,
+                                          request.file_path,
+                                          request.file_type,
+                                          request.consistency_context));
+            if (prompt_logging_enabled) {
+                std::cout << "\n[DEV][PROMPT] Categorization request (batched)\n"
+                          << "[system]\n" << system_prompt << "\n"
+                          << "[user]\n" << prompts.back() << "\n";
+            }
+        }
+
+        std::optional<std::vector<std::string>> outputs;
+        if (batch_size > 1) {
+            try {
+                outputs = generate_batch_responses(prompts, 64, system_prompt, category_grammar());
+            } catch (const std::exception& ex) {
+                if (logger) {
+                    logger->warn("Batched local generation failed ({}); using sequential decoding", ex.what());
+                }
+                if (batch_ctx) {
+                    llama_free(batch_ctx);
+                    batch_ctx = nullptr;
+                    batch_ctx_seqs = 0;
+                }
+            }
+        }
+
+        if (!outputs) {
+            for (std::size_t i = start; i < end; ++i) {
+                const auto& request = requests[i];
+                responses.push_back(categorize_file(request.file_name,
+                                                    request.file_path,
+                                                    request.file_type,
+                                                    request.consistency_context));
+            }
+            continue;
+        }
+
+        for (const auto& output : *outputs) {
+            responses.push_back(sanitize_output(output));
+            if (prompt_logging_enabled) {
+                std::cout << "[DEV][RESPONSE] Categorization reply (batched)\n" << responses.back() << "\n";
+            }
+        }
+    }
+    return responses;
+}
+
+
+void LocalLLMClient::set_category_whitelist(const std::vector<std::string>& categories,
+                                            const std::vector<std::string>& subcategories)
+{
+    category_grammar_ = build_category_grammar(categories, subcategories);
+}
+
+
+const std::string& LocalLLMClient::category_grammar() const
+{
+    static const std::string kNoGrammar;
+    return grammar_enabled_ ? category_grammar_ : kNoGrammar;
+}
+
+
+std::size_t LocalLLMClient::preferred_batch_size() const
+{
+    return batch_size;
+}
+
+
 std::string LocalLLMClient::complete_prompt(const std::string& prompt,
                                             int max_tokens)
 {
@@ -2445,6 +2995,7 @@ LocalLLMClient::~LocalLLMClient() {
     if (auto logger = Logger::get_logger("core_logger")) {
         logger->debug("Destroying LocalLLMClient for model '{}'", model_path);
     }
+    release_context();
     if (model) llama_model_free(model);
 }
 
@@ -2463,6 +3014,11 @@ void LocalLLMClient::set_fallback_decision_callback(FallbackDecisionCallback cal
     fallback_decision_callback_ = std::move(callback);
 }
 
+const LocalLLMClient::RequestTimings& LocalLLMClient::last_request_timings() const
+{
+    return last_timings_;
+}
+
 void LocalLLMClient::notify_status(Status status) const
 {
     if (status_callback_) {
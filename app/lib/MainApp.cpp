@@ -21,6 +21,9 @@
 #include "UpdaterBuildConfig.hpp"
 #include "LlavaImageAnalyzer.hpp"
 #include "DocumentTextAnalyzer.hpp"
+#include "DocumentAnalysisCache.hpp"
+#include "DocumentExcerptPipeline.hpp"
+#include "EntryBatchQueue.hpp"
 #include "ImageRenameMetadataService.hpp"
 #include "MediaRenameMetadataService.hpp"
 #include "SupportCodeManager.hpp"
@@ -83,6 +86,7 @@
 #include <cstdlib>
 #include <exception>
 #include <optional>
+#include <future>
 #include <functional>
 #include <memory>
 #include <sstream>
@@ -99,6 +103,13 @@ using namespace std::chrono_literals;
 
 namespace {
 
+// Streaming analysis hands scanned entries to categorization in batches of this size, and lets the
+// scan run at most this many batches ahead of the LLM workers.
+constexpr std::size_t kStreamScanBatchSize = 256;
+constexpr std::size_t kStreamScanQueuedBatches = 8;
+// Document extraction may run this many documents per extraction thread ahead of the LLM.
+constexpr std::size_t kDocumentExtractionLookaheadPerThread = 2;
+
 std::string trim_ws_copy(const std::string& value) {
     const char* whitespace = " \t\n\r\f\v";
     const auto start = value.find_first_not_of(whitespace);
@@ -352,6 +363,9 @@ bool should_use_visual_gpu() {
     return value != "cpu";
 }
 
+// Set on the folder watcher thread, whose batches must never wait on the UI thread.
+thread_local bool on_watch_thread = false;
+
 std::optional<bool> read_env_bool(const char* key) {
     const char* value = std::getenv(key);
     if (!value || value[0] == '\0') {
@@ -501,18 +515,81 @@ void sync_disclosure_button(QToolButton* button, bool expanded)
     button->update();
 }
 
+// Lends a long-lived client to one categorization run without handing over ownership.
+class BorrowedLLMClient : public ILLMClient {
+public:
+    explicit BorrowedLLMClient(ILLMClient& client)
+        : client_(client)
+    {
+    }
+
+    std::string categorize_file(const std::string& file_name,
+                                const std::string& file_path,
+                                FileType file_type,
+                                const std::string& consistency_context) override
+    {
+        return client_.categorize_file(file_name, file_path, file_type, consistency_context);
+    }
+
+    std::string complete_prompt(const std::string& prompt, int max_tokens) override
+    {
+        return client_.complete_prompt(prompt, max_tokens);
+    }
+
+    void set_prompt_logging_enabled(bool enabled) override
+    {
+        client_.set_prompt_logging_enabled(enabled);
+    }
+
+    void set_category_whitelist(const std::vector<std::string>& categories,
+                                const std::vector<std::string>& subcategories) override
+    {
+        client_.set_category_whitelist(categories, subcategories);
+    }
+
+    std::future<std::string> categorize_file_async(const std::string& file_name,
+                                                   const std::string& file_path,
+                                                   FileType file_type,
+                                                   const std::string& consistency_context) override
+    {
+        return client_.categorize_file_async(file_name, file_path, file_type, consistency_context);
+    }
+
+    std::size_t preferred_batch_size() const override
+    {
+        return client_.preferred_batch_size();
+    }
+
+    std::vector<std::string> categorize_files(const std::vector<CategorizationRequest>& requests) override
+    {
+        return client_.categorize_files(requests);
+    }
+
+    std::future<std::vector<std::optional<std::string>>> categorize_files_async(
+        const std::vector<CategorizationRequest>& requests) override
+    {
+        return client_.categorize_files_async(requests);
+    }
+
+private:
+    ILLMClient& client_;
+};
+
 } // namespace
 
 MainApp::MainApp(Settings& settings, bool development_mode, QWidget* parent)
     : QMainWindow(parent),
       settings(settings),
       db_manager(settings.get_config_dir()),
+      incremental_scanner(dirscanner, db_manager),
       core_logger(Logger::get_logger("core_logger")),
       ui_logger(Logger::get_logger("ui_logger")),
       whitelist_store(settings.get_config_dir()),
       categorization_service(settings, db_manager, core_logger),
       consistency_pass_service(db_manager, core_logger),
-      results_coordinator(dirscanner),
+      results_coordinator(dirscanner,
+                          read_env_bool("AI_FILE_SORTER_SCAN_SNAPSHOT").value_or(true) ? &incremental_scanner
+                                                                                      : nullptr),
       undo_manager_(settings.get_config_dir() + "/undo"),
       development_mode_(development_mode),
       development_prompt_logging_enabled_(development_mode ? settings.get_development_prompt_logging() : false)
@@ -551,6 +628,7 @@ void MainApp::run()
 
 void MainApp::shutdown()
 {
+    retire_folder_watcher();
     stop_running_analysis();
     save_settings();
 }
@@ -754,12 +832,14 @@ void MainApp::connect_checkbox_signals()
         ensure_one_checkbox_active(categorize_files_checkbox);
         update_file_scan_option(FileScanOptions::Files, checked);
         settings.set_categorize_files(checked);
+        refresh_folder_watch();
     });
 
     connect(categorize_directories_checkbox, &QCheckBox::toggled, this, [this](bool checked) {
         ensure_one_checkbox_active(categorize_directories_checkbox);
         update_file_scan_option(FileScanOptions::Directories, checked);
         settings.set_categorize_directories(checked);
+        refresh_folder_watch();
     });
 
     if (include_subdirectories_checkbox) {
@@ -772,6 +852,7 @@ void MainApp::connect_checkbox_signals()
                 settings.set_categorize_directories(false);
             }
             update_image_only_controls();
+            refresh_folder_watch();
         });
     }
 
@@ -1407,48 +1488,234 @@ void MainApp::on_analyze_clicked()
     }
 
     const std::string folder_path = get_folder_path();
+    if (!ensure_llm_available(folder_path)) {
+        return;
+    }
+
+    if (!ensure_folder_categorization_style(folder_path)) {
+        return;
+    }
+
+    stop_analysis = false;
+    text_cpu_fallback_choice_.reset();
+    update_analyze_button_state(true);
+
+    const bool show_subcategory = use_subcategories_checkbox->isChecked();
+    progress_dialog = std::make_unique<CategorizationProgressDialog>(this, this, show_subcategory);
+    progress_dialog->show();
+
+    // A watched-folder batch in flight gives way and is picked up again once the analysis finishes.
+    const auto watch_session = watch_session_;
+    if (watch_session) {
+        watch_session->stop_batch = true;
+    }
+    analyze_thread = std::thread([this, watch_session]() {
+        {
+            std::lock_guard<std::mutex> run_lock(categorization_run_mutex_);
+            if (watch_session) {
+                watch_session->stop_batch = false;
+            }
+            try {
+                perform_analysis();
+            } catch (const std::exception& ex) {
+                core_logger->error("Exception during analysis: {}", ex.what());
+                run_on_ui([this, message = std::string("Analysis error: ") + ex.what()]() {
+                    handle_analysis_failure(message);
+                });
+            }
+        }
+        run_on_ui([this]() { requeue_deferred_watch_entries(); });
+    });
+}
+
+
+bool MainApp::ensure_llm_available(const std::string& folder_path)
+{
     if (!Utils::is_valid_directory(folder_path.c_str())) {
         show_error_dialog(ERR_INVALID_PATH);
         core_logger->warn("User supplied invalid directory '{}'", folder_path);
-        return;
+        return false;
     }
 
     if (!using_local_llm) {
         if (!Utils::is_network_available()) {
             show_error_dialog(ERR_NO_INTERNET_CONNECTION);
             core_logger->warn("Network unavailable when attempting to analyze '{}'", folder_path);
-            return;
+            return false;
         }
         std::string credential_error;
         if (!categorization_service.ensure_remote_credentials(&credential_error)) {
             show_error_dialog(credential_error.empty()
                                   ? "Remote model credentials are missing or invalid. Please configure your API key and try again."
                                   : credential_error);
-            return;
+            return false;
         }
     }
+    return true;
+}
 
-    if (!ensure_folder_categorization_style(folder_path)) {
+
+void MainApp::retire_folder_watcher()
+{
+    if (!folder_watcher_) {
         return;
     }
+    watch_session_->stop_batch = true;
+    {
+        std::lock_guard<std::mutex> lock(deferred_watch_mutex_);
+        watch_session_->retired = true;
+        deferred_watch_entries_.clear();
+    }
+    watch_session_.reset();
 
-    stop_analysis = false;
-    text_cpu_fallback_choice_.reset();
-    update_analyze_button_state(true);
+    retiring_watchers_.erase(std::remove_if(retiring_watchers_.begin(),
+                                            retiring_watchers_.end(),
+                                            [](const std::future<void>& retiring) {
+                                                return retiring.wait_for(std::chrono::seconds(0)) ==
+                                                       std::future_status::ready;
+                                            }),
+                             retiring_watchers_.end());
+    // The session and its client go away with the watcher's callback once the thread is joined.
+    retiring_watchers_.push_back(std::async(std::launch::async, [watcher = std::move(folder_watcher_)]() mutable {
+        watcher->stop();
+        watcher.reset();
+    }));
+}
 
-    const bool show_subcategory = use_subcategories_checkbox->isChecked();
-    progress_dialog = std::make_unique<CategorizationProgressDialog>(this, this, show_subcategory);
-    progress_dialog->show();
 
-    analyze_thread = std::thread([this]() {
-        try {
-            perform_analysis();
-        } catch (const std::exception& ex) {
-            core_logger->error("Exception during analysis: {}", ex.what());
-            run_on_ui([this, message = std::string("Analysis error: ") + ex.what()]() {
-                handle_analysis_failure(message);
-            });
+void MainApp::set_folder_watch_enabled(bool enabled)
+{
+    if (folder_watcher_) {
+        retire_folder_watcher();
+        statusBar()->showMessage(tr("Stopped watching folder"), 3000);
+        status_is_ready_ = false;
+    }
+    if (!enabled) {
+        return;
+    }
+
+    const auto uncheck = [this]() {
+        QSignalBlocker blocker(watch_folder_action);
+        watch_folder_action->setChecked(false);
+    };
+
+    const std::string folder_path = get_folder_path();
+    if (!ensure_llm_available(folder_path)) {
+        uncheck();
+        return;
+    }
+
+    auto watcher = std::make_unique<FolderWatcher>(
+        dirscanner, folder_path, effective_scan_options(), FolderWatcher::Options{});
+    auto session = std::make_shared<WatchSession>();
+    try {
+        // Returns right away; the watches are set up on the watcher thread.
+        watcher->start([this, session](std::vector<FileEntry>&& entries) {
+            categorize_watched_entries(std::move(entries), *session);
+        });
+    } catch (const std::filesystem::filesystem_error& ex) {
+        core_logger->warn("Failed to watch '{}': {}", folder_path, ex.what());
+        show_error_dialog(ERR_INVALID_PATH);
+        uncheck();
+        return;
+    }
+    folder_watcher_ = std::move(watcher);
+    watch_session_ = std::move(session);
+    statusBar()->showMessage(tr("Watching %1 for new files").arg(QString::fromStdString(folder_path)), 4000);
+    status_is_ready_ = false;
+}
+
+
+void MainApp::refresh_folder_watch(bool force)
+{
+    if (!folder_watcher_) {
+        return;
+    }
+    const std::string folder_path = get_folder_path();
+    if (!force &&
+        folder_watcher_->watched_path() == folder_path &&
+        folder_watcher_->watched_scan_options() == effective_scan_options()) {
+        return;
+    }
+    if (!Utils::is_valid_directory(folder_path.c_str())) {
+        set_folder_watch_enabled(false);
+        QSignalBlocker blocker(watch_folder_action);
+        watch_folder_action->setChecked(false);
+        return;
+    }
+    set_folder_watch_enabled(true);
+}
+
+
+void MainApp::requeue_deferred_watch_entries()
+{
+    std::vector<FileEntry> entries;
+    {
+        std::lock_guard<std::mutex> lock(deferred_watch_mutex_);
+        entries.swap(deferred_watch_entries_);
+    }
+    if (folder_watcher_ && !entries.empty()) {
+        folder_watcher_->requeue(entries);
+    }
+}
+
+
+void MainApp::categorize_watched_entries(std::vector<FileEntry>&& entries, WatchSession& session)
+{
+    on_watch_thread = true;
+    const auto defer_entries = [this, &entries, &session]() {
+        std::lock_guard<std::mutex> lock(deferred_watch_mutex_);
+        if (session.retired) {
+            return;
+        }
+        core_logger->info("Deferring {} watched entries until the running analysis finishes", entries.size());
+        deferred_watch_entries_.insert(deferred_watch_entries_.end(), entries.begin(), entries.end());
+    };
+    std::unique_lock<std::mutex> run_lock(categorization_run_mutex_, std::try_to_lock);
+    if (!run_lock.owns_lock()) {
+        defer_entries();
+        return;
+    }
+
+    std::vector<CategorizedFile> results;
+    try {
+        if (!session.llm) {
+            session.llm = make_llm_client();
         }
+        bool session_client_lent = false;
+        results = categorization_service.categorize_entries(
+            entries,
+            using_local_llm,
+            session.stop_batch,
+            [this](const std::string& message) { core_logger->info("{}", message); },
+            [](const FileEntry&) {},
+            [](const FileEntry&) {},
+            [this](const CategorizedFile& entry, const std::string& reason) {
+                core_logger->warn("Watched entry '{}' needs recategorization: {}", entry.file_name, reason);
+            },
+            [this, &session_client_lent]() -> std::unique_ptr<ILLMClient> {
+                if (session_client_lent) {
+                    return make_llm_client();
+                }
+                session_client_lent = true;
+                return std::make_unique<BorrowedLLMClient>(*session.llm);
+            });
+    } catch (const std::exception& ex) {
+        core_logger->error("Failed to categorize watched entries: {}", ex.what());
+        return;
+    }
+    if (session.stop_batch && results.size() < entries.size()) {
+        // Cut short for an analysis; entries finished already come back from the cache next time.
+        defer_entries();
+    }
+
+    if (results.empty()) {
+        return;
+    }
+    core_logger->info("Categorized {} new entries in the watched folder", results.size());
+    run_on_ui([this, count = static_cast<int>(results.size())]() {
+        statusBar()->showMessage(tr("Categorized %n new file(s) in the watched folder", nullptr, count), 4000);
+        status_is_ready_ = false;
     });
 }
 
@@ -1464,6 +1731,7 @@ void MainApp::on_directory_selected(const QString& path, bool user_initiated)
     }
 
     update_folder_contents(path);
+    refresh_folder_watch();
 }
 
 void MainApp::set_categorization_style(bool use_consistency)
@@ -2344,13 +2612,137 @@ void MainApp::log_pending_queue()
     }
 
     append_progress(to_utf8(tr("[QUEUE] Items waiting for categorization:")));
-    for (const auto& file_entry : files_to_categorize) {
+    log_queued_entries(files_to_categorize);
+}
+
+void MainApp::log_queued_entries(const std::vector<FileEntry>& entries)
+{
+    if (!progress_dialog) {
+        return;
+    }
+    for (const auto& file_entry : entries) {
         const QString type_label = file_entry.type == FileType::Directory ? tr("Directory") : tr("File");
         append_progress(to_utf8(QStringLiteral("  - [%1] %2")
                                     .arg(type_label, QString::fromStdString(file_entry.file_name))));
     }
 }
 
+std::vector<CategorizedFile> MainApp::stream_scan_and_categorize(
+    const std::string& directory_path,
+    FileScanOptions scan_options,
+    const std::unordered_set<std::string>& cached_file_names,
+    bool use_full_path_keys,
+    bool categorize_files,
+    const CategorizationService::SuggestedNameProvider& suggested_name_provider,
+    std::optional<std::vector<FileEntry>>& scanned_entries)
+{
+    using ProgressStageId = CategorizationProgressDialog::StageId;
+
+    // The scan runs on its own thread and feeds a bounded queue that the categorization workers drain.
+    EntryBatchQueue queue(kStreamScanQueuedBatches);
+    std::exception_ptr scan_error;
+    std::vector<FileEntry> listing;
+    bool scan_complete = false;
+    std::thread producer([&]() {
+        try {
+            scan_complete = results_coordinator.stream_files_to_categorize(
+                directory_path,
+                scan_options,
+                cached_file_names,
+                use_full_path_keys,
+                kStreamScanBatchSize,
+                [this, &queue, categorize_files](std::vector<FileEntry>&& batch) {
+                    if (should_abort_analysis()) {
+                        // Wakes a consumer waiting in pop() so Stop does not wait for the scan to finish.
+                        queue.cancel();
+                        return false;
+                    }
+                    if (!categorize_files) {
+                        batch.erase(std::remove_if(batch.begin(),
+                                                   batch.end(),
+                                                   [](const FileEntry& entry) {
+                                                       return entry.type != FileType::Directory;
+                                                   }),
+                                    batch.end());
+                    }
+                    if (batch.empty()) {
+                        return true;
+                    }
+                    return queue.push(std::move(batch));
+                },
+                &listing);
+        } catch (...) {
+            scan_error = std::current_exception();
+        }
+        queue.close();
+    });
+
+    std::size_t queued = 0;
+    auto next_batch = [&]() -> std::optional<std::vector<FileEntry>> {
+        auto batch = queue.pop();
+        if (!batch) {
+            if (queued == 0 && !scan_error && !should_abort_analysis()) {
+                append_progress(to_utf8(tr("[DONE] No files to categorize.")));
+            }
+            return batch;
+        }
+        if (queued == 0) {
+            append_progress(to_utf8(tr("[QUEUE] Items waiting for categorization:")));
+        }
+        queued += batch->size();
+        log_queued_entries(*batch);
+        run_on_ui_blocking([this, entries = *batch]() {
+            if (!progress_dialog) {
+                return;
+            }
+            for (const auto& entry : entries) {
+                progress_dialog->mark_stage_item_pending(ProgressStageId::Categorization, entry);
+            }
+            progress_dialog->set_active_stage(ProgressStageId::Categorization);
+        });
+        return batch;
+    };
+
+    std::vector<CategorizedFile> results;
+    try {
+        results = categorization_service.categorize_entry_stream(
+            next_batch,
+            using_local_llm,
+            stop_analysis,
+            [this](const std::string& message) { append_progress(message); },
+            [this](const FileEntry& entry) {
+                mark_progress_stage_item_in_progress(ProgressStageId::Categorization, entry);
+                const QString type_label = entry.type == FileType::Directory ? tr("Directory") : tr("File");
+                append_progress(to_utf8(tr("[SORT] %1 (%2)")
+                                            .arg(QString::fromStdString(entry.file_name), type_label)));
+            },
+            [this](const FileEntry& entry) {
+                mark_progress_stage_item_completed(ProgressStageId::Categorization, entry);
+            },
+            [this](const CategorizedFile& entry, const std::string& reason) {
+                notify_recategorization_reset(entry, reason);
+            },
+            [this]() { return make_llm_client(); },
+            {},
+            suggested_name_provider);
+    } catch (...) {
+        queue.cancel();
+        producer.join();
+        throw;
+    }
+    queue.cancel();
+    producer.join();
+    if (scan_error) {
+        std::rethrow_exception(scan_error);
+    }
+    if (scan_complete) {
+        scanned_entries = std::move(listing);
+    }
+
+    core_logger->debug("Streamed {} item(s) pending categorization in '{}'.", queued, directory_path);
+    return results;
+}
+
 void MainApp::perform_analysis()
 {
     const std::string directory_path = get_folder_path();
@@ -2752,10 +3144,22 @@ void MainApp::perform_analysis()
             }
         }
         const auto scan_options = effective_scan_options();
-        files_to_categorize = results_coordinator.find_files_to_categorize(directory_path,
-                                                                           scan_options,
-                                                                           cached_file_names,
-                                                                           use_full_path_keys);
+        // Plain categorization needs no up-front view of the whole tree, so it can start on the first
+        // scanned batch. Content analysis still plans its stages from the complete scan.
+        const bool stream_categorization =
+            !analyze_images && !analyze_documents &&
+            read_env_bool("AI_FILE_SORTER_STREAM_SCAN").value_or(true);
+        files_to_categorize.clear();
+        // The listing of this scan is reused for the review at the end, so an analysis scans once.
+        std::optional<std::vector<FileEntry>> scanned_entries;
+        if (!stream_categorization) {
+            scanned_entries.emplace();
+            files_to_categorize = results_coordinator.find_files_to_categorize(directory_path,
+                                                                               scan_options,
+                                                                               cached_file_names,
+                                                                               use_full_path_keys,
+                                                                               &*scanned_entries);
+        }
         if (process_images_only || process_documents_only) {
             const bool allow_images = process_images_only;
             const bool allow_documents = process_documents_only;
@@ -2778,10 +3182,11 @@ void MainApp::perform_analysis()
                                }),
                 files_to_categorize.end());
         }
-        core_logger->debug("Found {} item(s) pending categorization in '{}'.",
-                           files_to_categorize.size(), directory_path);
-
-        log_pending_queue();
+        if (!stream_categorization) {
+            core_logger->debug("Found {} item(s) pending categorization in '{}'.",
+                               files_to_categorize.size(), directory_path);
+            log_pending_queue();
+        }
         update_stop();
 
         append_progress(to_utf8(tr("[PROCESS] Letting the AI do its magic...")));
@@ -3366,12 +3771,43 @@ void MainApp::perform_analysis()
             const size_t char_budget = resolve_document_char_budget(using_local_llm, doc_settings.max_tokens);
             doc_settings.max_characters = std::min(doc_settings.max_characters, char_budget);
             DocumentTextAnalyzer doc_analyzer(doc_settings);
+            DocumentAnalysisCache document_cache(db_manager);
 
-            auto llm = make_llm_client();
-            if (!llm) {
-                throw std::runtime_error("Failed to create LLM client.");
+            // Unchanged documents reuse their stored analysis. The rest are extracted on a small
+            // pool ahead of the loop below, so PDF loading and zip inflation overlap with inference.
+            // The list must match the entries the loop analyzes.
+            std::unordered_map<std::string, DocumentAnalysisResult> stored_document_analyses;
+            std::vector<std::filesystem::path> extraction_paths;
+            for (const auto& entry : document_entries) {
+                const std::string key = entry_key(entry);
+                if ((rename_documents_only && renamed_files.contains(key)) ||
+                    cached_document_suggestions.contains(key)) {
+                    continue;
+                }
+                if (auto stored = document_cache.lookup(entry.full_path)) {
+                    stored_document_analyses.emplace(key, std::move(*stored));
+                    continue;
+                }
+                extraction_paths.push_back(Utils::utf8_to_path(entry.full_path));
+            }
+            const bool needs_document_llm = !extraction_paths.empty();
+            const std::size_t extraction_threads = DocumentExcerptPipeline::resolve_thread_count();
+            DocumentExcerptPipeline excerpts(
+                std::move(extraction_paths),
+                [&doc_analyzer](const std::filesystem::path& path) {
+                    return doc_analyzer.extract_excerpt(path);
+                },
+                extraction_threads,
+                extraction_threads * kDocumentExtractionLookaheadPerThread);
+
+            std::unique_ptr<ILLMClient> llm;
+            if (needs_document_llm) {
+                llm = make_llm_client();
+                if (!llm) {
+                    throw std::runtime_error("Failed to create LLM client.");
+                }
+                llm->set_prompt_logging_enabled(should_log_prompts());
             }
-            llm->set_prompt_logging_enabled(should_log_prompts());
 
             for (const auto& entry : document_entries) {
                 if (update_stop()) {
@@ -3420,9 +3856,29 @@ void MainApp::perform_analysis()
                         continue;
                     }
 
-                    append_progress(to_utf8(tr("[DOC] Analyzing %1")
-                                                .arg(QString::fromStdString(entry.file_name))));
-                    const auto analysis = doc_analyzer.analyze(Utils::utf8_to_path(entry.full_path), *llm);
+                    DocumentAnalysisResult analysis;
+                    if (const auto stored_it = stored_document_analyses.find(entry_key(entry));
+                        stored_it != stored_document_analyses.end()) {
+                        append_progress(to_utf8(tr("[DOC] Using cached suggestion for %1")
+                                                    .arg(QString::fromStdString(entry.file_name))));
+                        analysis = stored_it->second;
+                    } else {
+                        append_progress(to_utf8(tr("[DOC] Analyzing %1")
+                                                    .arg(QString::fromStdString(entry.file_name))));
+                        auto excerpt = excerpts.next();
+                        if (!excerpt) {
+                            throw std::runtime_error("Document extraction was cancelled");
+                        }
+                        if (excerpt->error) {
+                            throw std::runtime_error(*excerpt->error);
+                        }
+                        if (auto reused = document_cache.lookup_excerpt(entry.full_path, excerpt->text)) {
+                            analysis = std::move(*reused);
+                        } else {
+                            analysis = doc_analyzer.analyze_excerpt(excerpt->text, excerpt->path, *llm);
+                            document_cache.store(entry.full_path, excerpt->text, analysis);
+                        }
+                    }
                     const std::string suggested_name = already_renamed ? std::string() : analysis.suggested_name;
                     const std::string ui_suggested_name =
                         (allow_document_renames || rename_documents_only) ? suggested_name : std::string();
@@ -3631,7 +4087,15 @@ void MainApp::perform_analysis()
         };
 
         std::vector<CategorizedFile> other_results;
-        if (!stop_requested && !other_entries.empty()) {
+        if (!stop_requested && stream_categorization) {
+            other_results = stream_scan_and_categorize(directory_path,
+                                                       scan_options,
+                                                       cached_file_names,
+                                                       use_full_path_keys,
+                                                       settings.get_categorize_files(),
+                                                       suggested_name_provider,
+                                                       scanned_entries);
+        } else if (!stop_requested && !other_entries.empty()) {
             other_results = categorization_service.categorize_entries(
                 other_entries,
                 using_local_llm,
@@ -3809,8 +4273,11 @@ void MainApp::perform_analysis()
                                   pending_renames.end());
         }
 
-        const auto actual_files = results_coordinator.list_directory(get_folder_path(), scan_options);
-        new_files_to_sort = results_coordinator.compute_files_to_sort(get_folder_path(),
+        // A stream stopped early saw only part of the tree, so that case lists it again.
+        const auto actual_files = scanned_entries
+            ? std::move(*scanned_entries)
+            : results_coordinator.list_directory(directory_path, scan_options);
+        new_files_to_sort = results_coordinator.compute_files_to_sort(directory_path,
                                                                       scan_options,
                                                                       actual_files,
                                                                       review_entries,
@@ -3893,6 +4360,13 @@ void MainApp::request_stop_analysis()
 
 bool MainApp::prompt_text_cpu_fallback(const std::string& reason)
 {
+    if (on_watch_thread) {
+        // Nobody is looking at a background batch, and a blocking prompt could stall stopping the watcher.
+        if (core_logger && !reason.empty()) {
+            core_logger->warn("GPU fallback applied for watched folder: {}", reason);
+        }
+        return true;
+    }
     if (text_cpu_fallback_choice_.has_value()) {
         return text_cpu_fallback_choice_.value();
     }
@@ -3973,6 +4447,8 @@ void MainApp::show_llm_selection_dialog()
             }
             using_local_llm = !is_remote_choice(settings.get_llm_choice());
             settings.save();
+            // The watch session keeps its client; start over so it picks up the new model.
+            refresh_folder_watch(true);
         }
     } catch (const std::exception& ex) {
         show_error_dialog(fmt::format("LLM selection error: {}", ex.what()));
@@ -4246,6 +4722,9 @@ void MainApp::changeEvent(QEvent* event)
 
 void MainApp::closeEvent(QCloseEvent* event)
 {
+    if (watch_folder_action) {
+        watch_folder_action->setChecked(false);
+    }
     stop_running_analysis();
     save_settings();
     QMainWindow::closeEvent(event);
@@ -564,6 +564,7 @@ UiTranslator::Dependencies MainAppUiBuilder::build_translator_dependencies(MainA
         .actions = UiTranslator::ActionControls{
             app.file_quit_action,
             app.run_benchmark_action,
+            app.watch_folder_action,
             app.copy_action,
             app.cut_action,
             app.undo_last_run_action,
@@ -640,6 +641,11 @@ void MainAppUiBuilder::build_file_menu(MainApp& app) {
     QObject::connect(app.run_benchmark_action, &QAction::triggered, &app, [&app]() {
         app.show_suitability_benchmark_dialog(false);
     });
+    app.watch_folder_action = app.file_menu->addAction(icon_for(app, "view-refresh", QStyle::SP_BrowserReload), QString());
+    app.watch_folder_action->setCheckable(true);
+    QObject::connect(app.watch_folder_action, &QAction::toggled, &app, [&app](bool checked) {
+        app.set_folder_watch_enabled(checked);
+    });
     app.file_menu->addSeparator();
     app.file_quit_action = app.file_menu->addAction(icon_for(app, "application-exit", QStyle::SP_DialogCloseButton), QString());
     app.file_quit_action->setShortcut(QKeySequence::Quit);
@@ -0,0 +1,251 @@
+#include "PdfTextExtractor.hpp"
+#include "Logger.hpp"
+
+#if defined(AI_FILE_SORTER_USE_PDFIUM)
+#include "fpdf_text.h"
+#include "fpdfview.h"
+#endif
+
+#include <algorithm>
+#include <exception>
+#include <utility>
+
+namespace {
+
+void append_code_point(std::string& out, std::uint32_t code_point)
+{
+    if (code_point < 0x80) {
+        out.push_back(static_cast<char>(code_point));
+    } else if (code_point < 0x800) {
+        out.push_back(static_cast<char>(0xC0 | (code_point >> 6)));
+        out.push_back(static_cast<char>(0x80 | (code_point & 0x3F)));
+    } else if (code_point < 0x10000) {
+        out.push_back(static_cast<char>(0xE0 | (code_point >> 12)));
+        out.push_back(static_cast<char>(0x80 | ((code_point >> 6) & 0x3F)));
+        out.push_back(static_cast<char>(0x80 | (code_point & 0x3F)));
+    } else {
+        out.push_back(static_cast<char>(0xF0 | (code_point >> 18)));
+        out.push_back(static_cast<char>(0x80 | ((code_point >> 12) & 0x3F)));
+        out.push_back(static_cast<char>(0x80 | ((code_point >> 6) & 0x3F)));
+        out.push_back(static_cast<char>(0x80 | (code_point & 0x3F)));
+    }
+}
+
+#if defined(AI_FILE_SORTER_USE_PDFIUM)
+constexpr int kTextChunkChars = 4096;
+
+// Shortens @p text to at most @p max_bytes without splitting a UTF-8 sequence.
+void truncate_utf8(std::string& text, std::size_t max_bytes)
+{
+    if (text.size() <= max_bytes) {
+        return;
+    }
+    std::size_t end = max_bytes;
+    while (end > 0 && (static_cast<unsigned char>(text[end]) & 0xC0) == 0x80) {
+        --end;
+    }
+    text.resize(end);
+}
+#endif
+
+} // namespace
+
+double PdfTextExtractor::Metrics::pages_per_second() const
+{
+    const double seconds = std::chrono::duration<double>(busy).count();
+    return seconds > 0.0 ? static_cast<double>(pages) / seconds : 0.0;
+}
+
+PdfTextExtractor& PdfTextExtractor::instance()
+{
+    static PdfTextExtractor extractor;
+    return extractor;
+}
+
+bool PdfTextExtractor::available()
+{
+#if defined(AI_FILE_SORTER_USE_PDFIUM)
+    return true;
+#else
+    return false;
+#endif
+}
+
+PdfTextExtractor::PdfTextExtractor()
+{
+    if (available()) {
+        worker_ = std::thread(&PdfTextExtractor::run, this);
+    }
+}
+
+PdfTextExtractor::~PdfTextExtractor()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    jobs_cv_.notify_all();
+    if (worker_.joinable()) {
+        worker_.join();
+    }
+}
+
+std::string PdfTextExtractor::extract(const std::filesystem::path& path, const Budget& budget)
+{
+    if (!available() || budget.max_characters == 0 || budget.max_pages <= 0) {
+        return {};
+    }
+    std::future<std::string> result;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (stopping_) {
+            return {};
+        }
+        Job job{path, budget, {}};
+        result = job.result.get_future();
+        jobs_.push_back(std::move(job));
+    }
+    jobs_cv_.notify_one();
+    return result.get();
+}
+
+PdfTextExtractor::Metrics PdfTextExtractor::metrics() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return metrics_;
+}
+
+void PdfTextExtractor::append_utf16(const std::uint16_t* data, std::size_t count, std::string& out)
+{
+    for (std::size_t i = 0; i < count; ++i) {
+        const std::uint32_t unit = data[i];
+        if (unit >= 0xD800 && unit <= 0xDBFF && i + 1 < count &&
+            data[i + 1] >= 0xDC00 && data[i + 1] <= 0xDFFF) {
+            append_code_point(out, 0x10000 + ((unit - 0xD800) << 10) + (data[i + 1] - 0xDC00));
+            ++i;
+        } else if (unit >= 0xD800 && unit <= 0xDFFF) {
+            append_code_point(out, 0xFFFD);
+        } else {
+            append_code_point(out, unit);
+        }
+    }
+}
+
+void PdfTextExtractor::run()
+{
+#if defined(AI_FILE_SORTER_USE_PDFIUM)
+    FPDF_InitLibrary();
+#endif
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true) {
+        jobs_cv_.wait(lock, [this]() { return stopping_ || !jobs_.empty(); });
+        if (jobs_.empty()) {
+            break;
+        }
+        Job job = std::move(jobs_.front());
+        jobs_.pop_front();
+        lock.unlock();
+        try {
+            job.result.set_value(extract_on_worker(job.path, job.budget));
+        } catch (...) {
+            job.result.set_exception(std::current_exception());
+        }
+        lock.lock();
+    }
+#if defined(AI_FILE_SORTER_USE_PDFIUM)
+    FPDF_DestroyLibrary();
+#endif
+}
+
+std::string PdfTextExtractor::extract_on_worker(const std::filesystem::path& path, const Budget& budget)
+{
+    std::string text;
+#if defined(AI_FILE_SORTER_USE_PDFIUM)
+    const auto started = std::chrono::steady_clock::now();
+    const auto deadline = started + budget.max_duration;
+    const std::string pdf_path = path.string();
+    FPDF_DOCUMENT doc = FPDF_LoadDocument(pdf_path.c_str(), nullptr);
+    if (!doc) {
+        return text;
+    }
+
+    const int page_count = FPDF_GetPageCount(doc);
+    const int page_limit = std::min(page_count, budget.max_pages);
+    int pages_read = 0;
+    bool budget_stop = false;
+    for (int i = 0; i < page_limit && text.size() < budget.max_characters; ++i) {
+        if (i > 0 && std::chrono::steady_clock::now() >= deadline) {
+            budget_stop = true;
+            break;
+        }
+        FPDF_PAGE page = FPDF_LoadPage(doc, i);
+        if (!page) {
+            continue;
+        }
+        ++pages_read;
+        FPDF_TEXTPAGE text_page = FPDFText_LoadPage(page);
+        if (!text_page) {
+            FPDF_ClosePage(page);
+            continue;
+        }
+        if (!text.empty()) {
+            text.push_back('\n');
+        }
+        const int total_chars = FPDFText_CountChars(text_page);
+        int offset = 0;
+        while (offset < total_chars && text.size() < budget.max_characters) {
+            // Every code unit yields at least one byte, so never fetch more than still fits.
+            const std::size_t remaining = budget.max_characters - text.size();
+            const int take = static_cast<int>(std::min<std::size_t>(
+                std::min(kTextChunkChars, total_chars - offset), remaining));
+            utf16_buffer_.resize(static_cast<std::size_t>(take) + 1);
+            const int extracted = FPDFText_GetText(text_page, offset, take,
+                                                   reinterpret_cast<unsigned short*>(utf16_buffer_.data()));
+            if (extracted <= 0) {
+                break;
+            }
+            std::size_t units = static_cast<std::size_t>(std::max(0, extracted - 1));
+            int consumed = take;
+            // Leave a surrogate pair split by the chunk boundary for the next chunk.
+            if (units > 1 && offset + take < total_chars &&
+                utf16_buffer_[units - 1] >= 0xD800 && utf16_buffer_[units - 1] <= 0xDBFF) {
+                --units;
+                --consumed;
+            }
+            append_utf16(utf16_buffer_.data(), units, text);
+            offset += consumed;
+        }
+        FPDFText_ClosePage(text_page);
+        FPDF_ClosePage(page);
+    }
+    if (!budget_stop && page_limit < page_count && text.size() < budget.max_characters) {
+        budget_stop = true;
+    }
+    FPDF_CloseDocument(doc);
+    truncate_utf8(text, budget.max_characters);
+
+    const auto elapsed = std::chrono::steady_clock::now() - started;
+    Metrics totals;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        ++metrics_.documents;
+        metrics_.pages += static_cast<std::uint64_t>(pages_read);
+        metrics_.budget_stops += budget_stop ? 1 : 0;
+        metrics_.busy += std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed);
+        totals = metrics_;
+    }
+    if (auto logger = Logger::get_logger("core_logger")) {
+        logger->debug("PDF text from '{}': {} of {} pages in {} ms{} ({:.1f} pages/s overall)",
+                      pdf_path,
+                      pages_read,
+                      page_count,
+                      std::chrono::duration_cast<std::chrono::milliseconds>(elapsed).count(),
+                      budget_stop ? ", stopped by budget" : "",
+                      totals.pages_per_second());
+    }
+#else
+    (void)path;
+    (void)budget;
+#endif
+    return text;
+}
@@ -0,0 +1,410 @@
+#include "RemoteBatchPrompt.hpp"
+
+#include "Logger.hpp"
+
+#if __has_include(<jsoncpp/json/json.h>)
+    #include <jsoncpp/json/json.h>
+#elif __has_include(<json/json.h>)
+    #include <json/json.h>
+#else
+    #error "jsoncpp headers not found. Install jsoncpp development files."
+#endif
+
+#include <spdlog/spdlog.h>
+
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <sstream>
+
+namespace {
+
+constexpr const char* kBatchSizeEnv = "AI_FILE_SORTER_REMOTE_BATCH_SIZE";
+constexpr std::size_t kDefaultBatchSize = 20;
+constexpr std::size_t kMaxBatchSize = 50;
+
+std::string trim_whitespace(const std::string& value)
+{
+    const char* whitespace = " \t\n\r\f\v";
+    const auto start = value.find_first_not_of(whitespace);
+    const auto end = value.find_last_not_of(whitespace);
+    if (start == std::string::npos || end == std::string::npos) {
+        return std::string();
+    }
+    return value.substr(start, end - start + 1);
+}
+
+std::string write_compact(const Json::Value& value)
+{
+    Json::StreamWriterBuilder builder;
+    builder["indentation"] = "";
+    builder["emitUTF8"] = true;
+    return Json::writeString(builder, value);
+}
+
+// Converts an id value ("3" or 3) into a zero-based slot, or nullopt when out of range.
+std::optional<std::size_t> slot_for_id(const Json::Value& id, std::size_t item_count)
+{
+    long long parsed = 0;
+    if (id.isIntegral()) {
+        parsed = id.asLargestInt();
+    } else if (id.isString()) {
+        const std::string text = trim_whitespace(id.asString());
+        char* end = nullptr;
+        parsed = std::strtoll(text.c_str(), &end, 10);
+        if (text.empty() || end == text.c_str() || *end != '\0') {
+            return std::nullopt;
+        }
+    } else {
+        return std::nullopt;
+    }
+    if (parsed < 1 || static_cast<unsigned long long>(parsed) > item_count) {
+        return std::nullopt;
+    }
+    return static_cast<std::size_t>(parsed - 1);
+}
+
+// Fills one slot of a batch reply. seen marks ids already answered: an id answered twice is left
+// empty, since the two answers cannot be told apart, and the item is retried on its own.
+bool store_entry(std::vector<std::optional<std::string>>& slots,
+                 std::vector<bool>& seen,
+                 const Json::Value& id,
+                 std::string category,
+                 std::string subcategory,
+                 const std::shared_ptr<spdlog::logger>& logger)
+{
+    const auto slot = slot_for_id(id, slots.size());
+    if (slot && seen[*slot]) {
+        if (logger) {
+            logger->warn("Remote batch reply repeated id {}; retrying that item individually", *slot + 1);
+        }
+        slots[*slot].reset();
+        return false;
+    }
+    if (slot) {
+        seen[*slot] = true;
+    }
+    category = trim_whitespace(category);
+    subcategory = trim_whitespace(subcategory);
+    // Entries without a subcategory are left empty so the item falls back to a single request.
+    if (!slot || category.empty() || subcategory.empty()) {
+        if (logger) {
+            logger->warn("Remote batch reply skipped malformed entry for id {}", write_compact(id));
+        }
+        return false;
+    }
+    slots[*slot] = category + " : " + subcategory;
+    return true;
+}
+
+const Json::Value* extract_items(const Json::Value& root)
+{
+    if (root.isArray()) {
+        return &root;
+    }
+    if (root.isObject() && root.isMember("items") && root["items"].isArray()) {
+        return &root["items"];
+    }
+    return nullptr;
+}
+
+// Cuts the JSON document out of replies that wrap it in a code fence or prose.
+std::string extract_json_text(const std::string& response)
+{
+    const auto first = response.find_first_of("{[");
+    const auto last = response.find_last_of("}]");
+    if (first == std::string::npos || last == std::string::npos || last < first) {
+        return std::string();
+    }
+    return response.substr(first, last - first + 1);
+}
+
+bool parse_json_entries(const std::string& response,
+                        std::vector<std::optional<std::string>>& slots,
+                        std::vector<bool>& seen,
+                        const std::shared_ptr<spdlog::logger>& logger)
+{
+    const std::string json_text = extract_json_text(response);
+    if (json_text.empty()) {
+        return false;
+    }
+
+    Json::CharReaderBuilder reader;
+    Json::Value root;
+    std::string errors;
+    std::istringstream stream(json_text);
+    if (!Json::parseFromStream(reader, stream, &root, &errors)) {
+        if (logger) {
+            logger->warn("Remote batch JSON parse failed: {}", errors);
+        }
+        return false;
+    }
+
+    const Json::Value* items = extract_items(root);
+    if (!items) {
+        return false;
+    }
+    for (const auto& entry : *items) {
+        if (!entry.isObject()) {
+            continue;
+        }
+        store_entry(slots,
+                    seen,
+                    entry["id"],
+                    entry["category"].isString() ? entry["category"].asString() : std::string(),
+                    entry["subcategory"].isString() ? entry["subcategory"].asString() : std::string(),
+                    logger);
+    }
+    return true;
+}
+
+// Fallback for models that ignore the JSON instruction: "<id> => <Category> : <Subcategory>".
+void parse_line_entries(const std::string& response,
+                        std::vector<std::optional<std::string>>& slots,
+                        std::vector<bool>& seen,
+                        const std::shared_ptr<spdlog::logger>& logger)
+{
+    std::istringstream stream(response);
+    std::string line;
+    while (std::getline(stream, line)) {
+        const auto arrow_pos = line.find("=>");
+        if (arrow_pos == std::string::npos) {
+            continue;
+        }
+        const std::string remainder = line.substr(arrow_pos + 2);
+        const auto colon_pos = remainder.find(':');
+        if (colon_pos == std::string::npos) {
+            continue;
+        }
+        store_entry(slots,
+                    seen,
+                    Json::Value(trim_whitespace(line.substr(0, arrow_pos))),
+                    remainder.substr(0, colon_pos),
+                    remainder.substr(colon_pos + 1),
+                    logger);
+    }
+}
+
+// Splits a consistency context into its blank-line separated blocks (language, whitelist, hints).
+std::vector<std::string> split_context_blocks(const std::string& context)
+{
+    std::vector<std::string> blocks;
+    std::size_t start = 0;
+    while (start < context.size()) {
+        auto end = context.find("\n\n", start);
+        if (end == std::string::npos) {
+            end = context.size();
+        }
+        std::string block = trim_whitespace(context.substr(start, end - start));
+        if (!block.empty()) {
+            blocks.push_back(std::move(block));
+        }
+        start = end + 2;
+    }
+    return blocks;
+}
+
+// Joins @p blocks back together, leaving out those listed in @p skipped.
+std::string join_context_blocks(const std::vector<std::string>& blocks, const std::vector<std::string>& skipped)
+{
+    std::string joined;
+    for (const auto& block : blocks) {
+        if (std::find(skipped.begin(), skipped.end(), block) != skipped.end()) {
+            continue;
+        }
+        if (!joined.empty()) {
+            joined += "\n\n";
+        }
+        joined += block;
+    }
+    return joined;
+}
+
+} // namespace
+
+namespace RemoteBatchPrompt {
+
+std::size_t resolve_batch_size()
+{
+    const char* env = std::getenv(kBatchSizeEnv);
+    if (!env || *env == '\0') {
+        return kDefaultBatchSize;
+    }
+
+    auto logger = Logger::get_logger("core_logger");
+    try {
+        const int parsed = std::stoi(env);
+        if (parsed > 0) {
+            return std::min<std::size_t>(static_cast<std::size_t>(parsed), kMaxBatchSize);
+        }
+        if (logger) {
+            logger->warn("Ignoring non-positive remote batch size '{}'", env);
+        }
+    } catch (const std::exception& ex) {
+        if (logger) {
+            logger->warn("Failed to parse remote batch size '{}': {}", env, ex.what());
+        }
+    }
+    return kDefaultBatchSize;
+}
+
+const std::string& system_prompt()
+{
+    static const std::string prompt =
+        "You are a file categorization assistant. You categorize several items at once. If an item is an installer, "
+        "describe the type of software it installs. Consider each filename, extension, and any directory context "
+        "provided. For every item choose a main category and a subcategory. Main category must be broad (one or two "
+        "words, plural). Subcategory must be specific, relevant, and must not repeat the main category. Reply with "
+        "JSON only.";
+    return prompt;
+}
+
+std::string build_user_prompt(const std::vector<CategorizationRequest>& requests)
+{
+    // Context blocks every item shares (language rules, whitelist) are sent once; only the blocks
+    // that differ, such as per-extension consistency hints, stay with their item.
+    std::vector<std::vector<std::string>> item_blocks;
+    item_blocks.reserve(requests.size());
+    for (const auto& request : requests) {
+        item_blocks.push_back(split_context_blocks(request.consistency_context));
+    }
+    std::vector<std::string> shared_blocks;
+    if (!item_blocks.empty()) {
+        for (const auto& block : item_blocks.front()) {
+            const bool everywhere = std::all_of(item_blocks.begin() + 1, item_blocks.end(), [&](const auto& blocks) {
+                return std::find(blocks.begin(), blocks.end(), block) != blocks.end();
+            });
+            if (everywhere && std::find(shared_blocks.begin(), shared_blocks.end(), block) == shared_blocks.end()) {
+                shared_blocks.push_back(block);
+            }
+        }
+    }
+
+    std::ostringstream prompt;
+    prompt << "Categorize each of the following " << requests.size() << " items.\n";
+    prompt << "Respond with a JSON object of the form "
+              "{\"items\":[{\"id\":<id>,\"category\":\"<Main category>\",\"subcategory\":\"<Subcategory>\"}]} "
+              "containing exactly one entry for every id below. No other text.\n";
+    if (!shared_blocks.empty()) {
+        prompt << "\nApplies to every item:\n" << join_context_blocks(shared_blocks, {}) << "\n";
+    }
+
+    prompt << "\nItems (JSON, one per line):\n";
+    for (std::size_t i = 0; i < requests.size(); ++i) {
+        const auto& request = requests[i];
+        Json::Value item(Json::objectValue);
+        item["id"] = static_cast<Json::UInt64>(i + 1);
+        item["type"] = request.file_type == FileType::Directory ? "directory" : "file";
+        item["name"] = request.file_name;
+        if (!request.file_path.empty()) {
+            item["path"] = request.file_path;
+        }
+        const std::string own_context = join_context_blocks(item_blocks[i], shared_blocks);
+        if (!own_context.empty()) {
+            item["context"] = own_context;
+        }
+        prompt << write_compact(item) << "\n";
+    }
+    return prompt.str();
+}
+
+const std::string& openai_response_format()
+{
+    static const std::string format = [] {
+        Json::Value entry(Json::objectValue);
+        entry["type"] = "object";
+        entry["properties"]["id"]["type"] = "integer";
+        entry["properties"]["category"]["type"] = "string";
+        entry["properties"]["subcategory"]["type"] = "string";
+        entry["required"].append("id");
+        entry["required"].append("category");
+        entry["required"].append("subcategory");
+        entry["additionalProperties"] = false;
+
+        Json::Value schema(Json::objectValue);
+        schema["type"] = "object";
+        schema["properties"]["items"]["type"] = "array";
+        schema["properties"]["items"]["items"] = entry;
+        schema["required"].append("items");
+        schema["additionalProperties"] = false;
+
+        Json::Value format_json(Json::objectValue);
+        format_json["type"] = "json_schema";
+        format_json["json_schema"]["name"] = "file_categories";
+        format_json["json_schema"]["strict"] = true;
+        format_json["json_schema"]["schema"] = schema;
+        return write_compact(format_json);
+    }();
+    return format;
+}
+
+const std::string& gemini_response_schema()
+{
+    static const std::string schema_text = [] {
+        Json::Value entry(Json::objectValue);
+        entry["type"] = "OBJECT";
+        entry["properties"]["id"]["type"] = "INTEGER";
+        entry["properties"]["category"]["type"] = "STRING";
+        entry["properties"]["subcategory"]["type"] = "STRING";
+        entry["required"].append("id");
+        entry["required"].append("category");
+        entry["required"].append("subcategory");
+
+        Json::Value schema(Json::objectValue);
+        schema["type"] = "OBJECT";
+        schema["properties"]["items"]["type"] = "ARRAY";
+        schema["properties"]["items"]["items"] = entry;
+        schema["required"].append("items");
+        return write_compact(schema);
+    }();
+    return schema_text;
+}
+
+long batch_timeout_seconds(long base_timeout_seconds, std::size_t item_count)
+{
+    // Output grows with the batch; allow roughly one extra second of generation per item.
+    return std::max(1L, base_timeout_seconds) + static_cast<long>(item_count);
+}
+
+bool is_schema_rejection(const std::string& error_message)
+{
+    std::string lowered = error_message;
+    std::transform(lowered.begin(), lowered.end(), lowered.begin(), [](unsigned char ch) {
+        return static_cast<char>(std::tolower(ch));
+    });
+    // OpenAI-compatible servers answer with a 400 ("Client Error: ..."), Gemini with INVALID_ARGUMENT.
+    const bool bad_request = lowered.rfind("client error", 0) == 0 ||
+                             lowered.find("invalid_argument") != std::string::npos;
+    if (!bad_request) {
+        return false;
+    }
+    for (const char* marker : {"response_format", "json_schema", "schema", "responsemimetype",
+                               "response_mime_type", "structured output"}) {
+        if (lowered.find(marker) != std::string::npos) {
+            return true;
+        }
+    }
+    return false;
+}
+
+std::vector<std::optional<std::string>> parse_response(const std::string& response,
+                                                       std::size_t item_count,
+                                                       const std::shared_ptr<spdlog::logger>& logger)
+{
+    std::vector<std::optional<std::string>> slots(item_count);
+    std::vector<bool> seen(item_count, false);
+    if (!parse_json_entries(response, slots, seen, logger)) {
+        parse_line_entries(response, slots, seen, logger);
+    }
+
+    if (logger) {
+        const auto parsed = static_cast<std::size_t>(
+            std::count_if(slots.begin(), slots.end(), [](const auto& slot) { return slot.has_value(); }));
+        if (parsed < item_count) {
+            logger->debug("Remote batch reply covered {} of {} item(s)", parsed, item_count);
+        }
+    }
+    return slots;
+}
+
+} // namespace RemoteBatchPrompt
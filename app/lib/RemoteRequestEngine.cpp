@@ -0,0 +1,312 @@
+#include "RemoteRequestEngine.hpp"
+
+#include "Logger.hpp"
+
+#include <spdlog/spdlog.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <stdexcept>
+#include <utility>
+
+namespace {
+
+constexpr const char* kMaxInFlightEnv = "AI_FILE_SORTER_REMOTE_MAX_IN_FLIGHT";
+constexpr std::size_t kDefaultMaxInFlight = 16;
+constexpr std::size_t kMaxInFlightLimit = 256;
+constexpr int kMaxAttempts = 3;
+constexpr int kIdlePollMs = 1000;
+
+std::size_t resolve_max_in_flight()
+{
+    const char* env = std::getenv(kMaxInFlightEnv);
+    if (!env || *env == '\0') {
+        return kDefaultMaxInFlight;
+    }
+
+    auto logger = Logger::get_logger("core_logger");
+    try {
+        const int parsed = std::stoi(env);
+        if (parsed > 0) {
+            return std::min<std::size_t>(static_cast<std::size_t>(parsed), kMaxInFlightLimit);
+        }
+        if (logger) {
+            logger->warn("Ignoring non-positive remote in-flight limit '{}'", env);
+        }
+    } catch (const std::exception& ex) {
+        if (logger) {
+            logger->warn("Failed to parse remote in-flight limit '{}': {}", env, ex.what());
+        }
+    }
+    return kDefaultMaxInFlight;
+}
+
+} // namespace
+
+struct RemoteRequestEngine::Transfer {
+    Request request;
+    Completion on_complete;
+    CurlSession::Response response;
+    curl_slist* headers{nullptr};
+    std::chrono::steady_clock::time_point deadline;
+    std::chrono::steady_clock::time_point not_before;
+    int attempts{0};
+
+    ~Transfer()
+    {
+        if (headers) {
+            curl_slist_free_all(headers);
+        }
+    }
+
+    void complete(std::exception_ptr error)
+    {
+        try {
+            on_complete(std::move(response), error);
+        } catch (...) {
+            // Completions must not take down the event loop.
+        }
+    }
+};
+
+std::shared_ptr<RemoteRequestEngine> RemoteRequestEngine::acquire()
+{
+    static std::mutex instance_mutex;
+    static std::weak_ptr<RemoteRequestEngine> instance;
+
+    std::lock_guard<std::mutex> lock(instance_mutex);
+    if (auto existing = instance.lock()) {
+        return existing;
+    }
+    std::shared_ptr<RemoteRequestEngine> engine(new RemoteRequestEngine(resolve_max_in_flight()));
+    instance = engine;
+    return engine;
+}
+
+RemoteRequestEngine::RemoteRequestEngine(std::size_t max_in_flight)
+    : max_in_flight_(max_in_flight)
+{
+    multi_ = curl_multi_init();
+    if (!multi_) {
+        throw std::runtime_error("Initialization Error: Failed to initialize cURL multi handle.");
+    }
+    curl_multi_setopt(multi_, CURLMOPT_PIPELINING, CURLPIPE_MULTIPLEX);
+    loop_thread_ = std::thread(&RemoteRequestEngine::run, this);
+}
+
+RemoteRequestEngine::~RemoteRequestEngine()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    curl_multi_wakeup(multi_);
+    if (loop_thread_.joinable()) {
+        loop_thread_.join();
+    }
+    for (CURL* handle : idle_handles_) {
+        curl_easy_cleanup(handle);
+    }
+    curl_multi_cleanup(multi_);
+}
+
+void RemoteRequestEngine::submit(Request request, Completion on_complete)
+{
+    auto transfer = std::make_unique<Transfer>();
+    const long timeout_seconds = std::max(1L, request.timeout_seconds);
+    transfer->deadline = std::chrono::steady_clock::now() + std::chrono::seconds(timeout_seconds);
+    transfer->request = std::move(request);
+    transfer->on_complete = std::move(on_complete);
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!stopping_) {
+            queued_.push_back(std::move(transfer));
+        }
+    }
+    if (transfer) {
+        transfer->complete(std::make_exception_ptr(std::runtime_error("Remote request engine is shutting down.")));
+        return;
+    }
+    curl_multi_wakeup(multi_);
+}
+
+void RemoteRequestEngine::run()
+{
+    std::vector<std::unique_ptr<Transfer>> starting;
+    while (true) {
+        const auto now = std::chrono::steady_clock::now();
+
+        // Rate-limited retries whose Retry-After has elapsed go back on the wire first.
+        for (auto it = delayed_.begin(); it != delayed_.end();) {
+            if ((*it)->not_before <= now) {
+                starting.push_back(std::move(*it));
+                it = delayed_.erase(it);
+            } else {
+                ++it;
+            }
+        }
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (stopping_) {
+                break;
+            }
+            while (!queued_.empty() && active_.size() + starting.size() < max_in_flight_) {
+                starting.push_back(std::move(queued_.front()));
+                queued_.pop_front();
+            }
+        }
+        for (auto& transfer : starting) {
+            start_transfer(std::move(transfer));
+        }
+        starting.clear();
+
+        int running = 0;
+        curl_multi_perform(multi_, &running);
+        int pending_messages = 0;
+        while (CURLMsg* message = curl_multi_info_read(multi_, &pending_messages)) {
+            if (message->msg == CURLMSG_DONE) {
+                finish_transfer(message->easy_handle, message->data.result);
+            }
+        }
+
+        int wait_ms = kIdlePollMs;
+        const auto after = std::chrono::steady_clock::now();
+        for (const auto& transfer : delayed_) {
+            const auto until = std::chrono::duration_cast<std::chrono::milliseconds>(transfer->not_before - after);
+            wait_ms = std::clamp(static_cast<int>(until.count()), 0, wait_ms);
+        }
+        curl_multi_poll(multi_, nullptr, 0, wait_ms, nullptr);
+    }
+
+    fail_all("Remote request engine stopped before the request completed.");
+}
+
+void RemoteRequestEngine::start_transfer(std::unique_ptr<Transfer> transfer)
+{
+    const auto now = std::chrono::steady_clock::now();
+    if (now >= transfer->deadline) {
+        transfer->complete(std::make_exception_ptr(std::runtime_error("Network Error: Timeout was reached")));
+        return;
+    }
+
+    CURL* easy = nullptr;
+    if (!idle_handles_.empty()) {
+        easy = idle_handles_.back();
+        idle_handles_.pop_back();
+        curl_easy_reset(easy);
+    } else {
+        easy = curl_easy_init();
+    }
+    if (!easy) {
+        transfer->complete(std::make_exception_ptr(
+            std::runtime_error("Initialization Error: Failed to initialize cURL.")));
+        return;
+    }
+
+    try {
+        CurlSession::apply_connection_defaults(easy);
+    } catch (...) {
+        curl_easy_cleanup(easy);
+        transfer->complete(std::current_exception());
+        return;
+    }
+
+    transfer->response = CurlSession::Response{};
+    if (transfer->headers) {
+        curl_slist_free_all(transfer->headers);
+        transfer->headers = nullptr;
+    }
+    transfer->headers = curl_slist_append(transfer->headers, "Content-Type: application/json");
+    for (const auto& header : transfer->request.headers) {
+        transfer->headers = curl_slist_append(transfer->headers, header.c_str());
+    }
+
+    const auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(transfer->deadline - now);
+    curl_easy_setopt(easy, CURLOPT_URL, transfer->request.url.c_str());
+    curl_easy_setopt(easy, CURLOPT_POST, 1L);
+    curl_easy_setopt(easy, CURLOPT_HTTPHEADER, transfer->headers);
+    curl_easy_setopt(easy, CURLOPT_POSTFIELDS, transfer->request.payload.c_str());
+    curl_easy_setopt(easy, CURLOPT_POSTFIELDSIZE_LARGE, static_cast<curl_off_t>(transfer->request.payload.size()));
+    curl_easy_setopt(easy, CURLOPT_TIMEOUT_MS, static_cast<long>(std::max<long long>(1, remaining.count())));
+    CurlSession::bind_response(easy, transfer->response);
+    ++transfer->attempts;
+
+    if (curl_multi_add_handle(multi_, easy) != CURLM_OK) {
+        curl_easy_cleanup(easy);
+        transfer->complete(std::make_exception_ptr(
+            std::runtime_error("Initialization Error: Failed to queue cURL transfer.")));
+        return;
+    }
+    active_.emplace(easy, std::move(transfer));
+}
+
+void RemoteRequestEngine::finish_transfer(CURL* easy, CURLcode result)
+{
+    curl_multi_remove_handle(multi_, easy);
+    auto it = active_.find(easy);
+    if (it == active_.end()) {
+        curl_easy_cleanup(easy);
+        return;
+    }
+    std::unique_ptr<Transfer> transfer = std::move(it->second);
+    active_.erase(it);
+
+    if (result != CURLE_OK) {
+        if (auto logger = Logger::get_logger("core_logger")) {
+            logger->error("cURL request failed: {}", curl_easy_strerror(result));
+        }
+        // The connection may be half-broken; do not recycle this handle.
+        curl_easy_cleanup(easy);
+        transfer->complete(std::make_exception_ptr(
+            std::runtime_error("Network Error: " + std::string(curl_easy_strerror(result)))));
+        return;
+    }
+
+    curl_easy_getinfo(easy, CURLINFO_RESPONSE_CODE, &transfer->response.http_code);
+    if (idle_handles_.size() < max_in_flight_) {
+        idle_handles_.push_back(easy);
+    } else {
+        curl_easy_cleanup(easy);
+    }
+
+    const long http_code = transfer->response.http_code;
+    const int retry_after = transfer->response.retry_after_seconds;
+    if ((http_code == 429 || http_code == 503) && retry_after > 0 && transfer->attempts < kMaxAttempts) {
+        const auto retry_at = std::chrono::steady_clock::now() + std::chrono::seconds(retry_after);
+        if (retry_at < transfer->deadline) {
+            if (auto logger = Logger::get_logger("core_logger")) {
+                logger->debug("Remote request hit HTTP {}; retrying in {}s", http_code, retry_after);
+            }
+            transfer->not_before = retry_at;
+            delayed_.push_back(std::move(transfer));
+            return;
+        }
+    }
+
+    transfer->complete(nullptr);
+}
+
+void RemoteRequestEngine::fail_all(const std::string& reason)
+{
+    const auto error = std::make_exception_ptr(std::runtime_error(reason));
+    for (auto& [easy, transfer] : active_) {
+        curl_multi_remove_handle(multi_, easy);
+        curl_easy_cleanup(easy);
+        transfer->complete(error);
+    }
+    active_.clear();
+    for (auto& transfer : delayed_) {
+        transfer->complete(error);
+    }
+    delayed_.clear();
+
+    std::deque<std::unique_ptr<Transfer>> queued;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        queued.swap(queued_);
+    }
+    for (auto& transfer : queued) {
+        transfer->complete(error);
+    }
+}
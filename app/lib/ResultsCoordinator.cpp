@@ -2,15 +2,49 @@
 
 #include <algorithm>
 #include <filesystem>
+#include <unordered_map>
 
-ResultsCoordinator::ResultsCoordinator(FileScanner& scanner)
-    : scanner(scanner)
+namespace {
+
+// Two paths get the same key exactly when fs::path::operator== holds for them: the root name,
+// whether there is a root directory, and each relative element, separated by a NUL that no
+// element can contain.
+fs::path::string_type make_path_join_key(FileType type, const fs::path& path)
+{
+    fs::path::string_type key;
+    key.push_back(static_cast<fs::path::value_type>('0' + static_cast<int>(type)));
+    key += path.root_name().native();
+    key.push_back(static_cast<fs::path::value_type>(path.has_root_directory() ? '/' : '.'));
+    for (const auto& element : path.relative_path()) {
+        key.push_back(fs::path::value_type{});
+        key += element.native();
+    }
+    return key;
+}
+
+fs::path::string_type make_name_join_key(FileType type, const std::string& file_name)
+{
+    fs::path::string_type key;
+    key.push_back(static_cast<fs::path::value_type>('0' + static_cast<int>(type)));
+    key.append(file_name.begin(), file_name.end());
+    return key;
+}
+
+} // namespace
+
+ResultsCoordinator::ResultsCoordinator(FileScanner& scanner,
+                                       IncrementalScanner* incremental_scanner)
+    : scanner(scanner),
+      incremental_scanner(incremental_scanner)
 {
 }
 
 std::vector<FileEntry> ResultsCoordinator::list_directory(const std::string& directory,
                                                           FileScanOptions options) const
 {
+    if (incremental_scanner) {
+        return std::move(incremental_scanner->scan(directory, options, false).entries);
+    }
     return scanner.get_directory_entries(directory, options);
 }
 
@@ -18,7 +52,8 @@ std::vector<FileEntry> ResultsCoordinator::find_files_to_categorize(
     const std::string& directory_path,
     FileScanOptions options,
     const std::unordered_set<std::string>& cached_files,
-    bool use_full_path_keys) const
+    bool use_full_path_keys,
+    std::vector<FileEntry>* scanned_entries) const
 {
     std::vector<FileEntry> actual_files = list_directory(directory_path, options);
 
@@ -32,9 +67,45 @@ std::vector<FileEntry> ResultsCoordinator::find_files_to_categorize(
         }
     }
 
+    if (scanned_entries) {
+        *scanned_entries = std::move(actual_files);
+    }
     return found_files;
 }
 
+bool ResultsCoordinator::stream_files_to_categorize(
+    const std::string& directory_path,
+    FileScanOptions options,
+    const std::unordered_set<std::string>& cached_files,
+    bool use_full_path_keys,
+    std::size_t batch_size,
+    const FileScanner::EntryBatchSink& sink,
+    std::vector<FileEntry>* scanned_entries) const
+{
+    bool stopped = false;
+    const FileScanner::EntryBatchSink filter = [&](std::vector<FileEntry>&& batch) {
+        if (scanned_entries) {
+            scanned_entries->insert(scanned_entries->end(), batch.begin(), batch.end());
+        }
+        batch.erase(std::remove_if(batch.begin(),
+                                   batch.end(),
+                                   [&](const FileEntry& entry) {
+                                       return cached_files.contains(use_full_path_keys ? entry.full_path
+                                                                                       : entry.file_name);
+                                   }),
+                    batch.end());
+        // Fully cached batches still reach the sink so the caller can stop the scan between them.
+        stopped = !sink(std::move(batch));
+        return !stopped;
+    };
+    if (incremental_scanner) {
+        incremental_scanner->scan(directory_path, options, batch_size, filter, false);
+    } else {
+        scanner.scan_directory_entries(directory_path, options, batch_size, filter);
+    }
+    return !stopped;
+}
+
 std::vector<CategorizedFile> ResultsCoordinator::compute_files_to_sort(
     const std::string& directory_path,
     FileScanOptions options,
@@ -47,24 +118,26 @@ std::vector<CategorizedFile> ResultsCoordinator::compute_files_to_sort(
     std::vector<CategorizedFile> files_to_sort;
     files_to_sort.reserve(actual_files.size());
 
+    // Hash join: index the categorized entries once, then probe with each scanned entry.
+    // The first categorized entry wins for duplicate keys, as with a linear search.
+    std::unordered_map<fs::path::string_type, std::size_t> index;
+    index.reserve(categorized_files.size());
+    for (std::size_t i = 0; i < categorized_files.size(); ++i) {
+        const auto& categorized_file = categorized_files[i];
+        index.emplace(use_full_path_keys
+                          ? make_path_join_key(categorized_file.type,
+                                               fs::path(categorized_file.file_path) /
+                                                   fs::path(categorized_file.file_name))
+                          : make_name_join_key(categorized_file.type, categorized_file.file_name),
+                      i);
+    }
+
     for (const auto& entry : actual_files) {
-        const auto it = std::find_if(
-            categorized_files.begin(),
-            categorized_files.end(),
-            [&entry, use_full_path_keys](const CategorizedFile& categorized_file) {
-                if (categorized_file.type != entry.type) {
-                    return false;
-                }
-                if (use_full_path_keys) {
-                    const auto full_path = std::filesystem::path(categorized_file.file_path) /
-                                           std::filesystem::path(categorized_file.file_name);
-                    return full_path == std::filesystem::path(entry.full_path);
-                }
-                return categorized_file.file_name == entry.file_name;
-            });
-
-        if (it != categorized_files.end()) {
-            files_to_sort.push_back(*it);
+        const auto key = use_full_path_keys ? make_path_join_key(entry.type, fs::path(entry.full_path))
+                                            : make_name_join_key(entry.type, entry.file_name);
+        const auto it = index.find(key);
+        if (it != index.end()) {
+            files_to_sort.push_back(categorized_files[it->second]);
         }
     }
 
@@ -0,0 +1,267 @@
+#include "TaxonomyMatchIndex.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <limits>
+
+namespace {
+
+constexpr std::size_t kWordBits = 64;
+// Guards the radius bounds against rounding so no candidate at exactly the threshold is pruned.
+constexpr double kBoundSlack = 1e-9;
+
+std::size_t dp_edit_distance(std::string_view a, std::string_view b)
+{
+    const std::size_t n = b.size();
+    std::vector<std::size_t> prev(n + 1), curr(n + 1);
+    for (std::size_t j = 0; j <= n; ++j) {
+        prev[j] = j;
+    }
+    for (std::size_t i = 1; i <= a.size(); ++i) {
+        curr[0] = i;
+        for (std::size_t j = 1; j <= n; ++j) {
+            const std::size_t cost = (a[i - 1] == b[j - 1]) ? 0 : 1;
+            curr[j] = std::min({prev[j] + 1, curr[j - 1] + 1, prev[j - 1] + cost});
+        }
+        std::swap(prev, curr);
+    }
+    return prev[n];
+}
+
+// Myers/Hyyrö bit-vector edit distance for a pattern of at most 64 bytes.
+class BitParallelPattern {
+public:
+    explicit BitParallelPattern(std::string_view pattern)
+        : length_(pattern.size())
+    {
+        for (std::size_t i = 0; i < pattern.size(); ++i) {
+            peq_[static_cast<unsigned char>(pattern[i])] |= std::uint64_t{1} << i;
+        }
+    }
+
+    std::size_t distance(std::string_view text) const
+    {
+        if (length_ == 0) {
+            return text.size();
+        }
+        const std::uint64_t last = std::uint64_t{1} << (length_ - 1);
+        std::uint64_t pv = ~std::uint64_t{0};
+        std::uint64_t mv = 0;
+        std::size_t score = length_;
+        for (const char ch : text) {
+            const std::uint64_t eq = peq_[static_cast<unsigned char>(ch)];
+            const std::uint64_t xv = eq | mv;
+            const std::uint64_t xh = (((eq & pv) + pv) ^ pv) | eq;
+            std::uint64_t ph = mv | ~(xh | pv);
+            std::uint64_t mh = pv & xh;
+            if (ph & last) {
+                ++score;
+            } else if (mh & last) {
+                --score;
+            }
+            // Row 0 grows by one per text byte, hence the carried-in 1.
+            ph = (ph << 1) | 1;
+            mh <<= 1;
+            pv = mh | ~(xv | ph);
+            mv = ph & xv;
+        }
+        return score;
+    }
+
+private:
+    std::array<std::uint64_t, 256> peq_{};
+    std::size_t length_;
+};
+
+// Distance from a fixed query to many labels; reuses the bit masks when the query fits one word.
+class QueryDistance {
+public:
+    explicit QueryDistance(std::string_view query)
+        : query_(query)
+    {
+        if (query.size() <= kWordBits) {
+            pattern_.emplace(query);
+        }
+    }
+
+    std::size_t operator()(std::string_view label) const
+    {
+        if (pattern_) {
+            return pattern_->distance(label);
+        }
+        return TaxonomyMatchIndex::edit_distance(query_, label);
+    }
+
+private:
+    std::string_view query_;
+    std::optional<BitParallelPattern> pattern_;
+};
+
+double similarity_from_distance(std::size_t distance, std::size_t a_length, std::size_t b_length)
+{
+    if (distance == 0 && a_length == b_length) {
+        return 1.0;
+    }
+    if (a_length == 0 || b_length == 0) {
+        return 0.0;
+    }
+    const double dist = static_cast<double>(distance);
+    const double max_len = static_cast<double>(std::max(a_length, b_length));
+    return 1.0 - (dist / max_len);
+}
+
+// Largest distance any label can have from a query of @p query_length and still reach @p min_similarity.
+std::size_t radius_for(std::size_t query_length, double min_similarity)
+{
+    const double allowed = 1.0 - min_similarity + kBoundSlack;
+    if (allowed >= 1.0) {
+        return std::numeric_limits<std::size_t>::max();
+    }
+    if (allowed <= 0.0) {
+        return 0;
+    }
+    // d <= allowed * max(q, L) and L - q <= d imply L <= q / (1 - allowed).
+    return static_cast<std::size_t>(allowed * static_cast<double>(query_length) / (1.0 - allowed));
+}
+
+} // namespace
+
+std::size_t TaxonomyMatchIndex::LabelTree::insert(const std::string& label)
+{
+    if (nodes_.empty()) {
+        nodes_.push_back(Node{label, {}, {}});
+        return 0;
+    }
+
+    const QueryDistance distance_to(label);
+    std::size_t current = 0;
+    while (true) {
+        const std::size_t distance = distance_to(nodes_[current].label);
+        if (distance == 0) {
+            return current;
+        }
+        auto& children = nodes_[current].children;
+        const auto child = std::find_if(children.begin(), children.end(),
+                                        [distance](const auto& edge) { return edge.first == distance; });
+        if (child == children.end()) {
+            const std::size_t created = nodes_.size();
+            children.emplace_back(distance, created);
+            nodes_.push_back(Node{label, {}, {}});
+            return created;
+        }
+        current = child->second;
+    }
+}
+
+std::vector<std::pair<std::size_t, std::size_t>>
+TaxonomyMatchIndex::LabelTree::find_within(std::string_view query, std::size_t radius) const
+{
+    std::vector<std::pair<std::size_t, std::size_t>> matches;
+    if (nodes_.empty()) {
+        return matches;
+    }
+
+    const QueryDistance distance_to(query);
+    std::vector<std::size_t> pending{0};
+    while (!pending.empty()) {
+        const std::size_t current = pending.back();
+        pending.pop_back();
+        const Node& node = nodes_[current];
+        const std::size_t distance = distance_to(node.label);
+        if (distance <= radius) {
+            matches.emplace_back(current, distance);
+        }
+        // Triangle inequality: only subtrees whose edge lies within [d - r, d + r] can hold matches.
+        const std::size_t low = distance > radius ? distance - radius : 0;
+        const std::size_t high = radius > std::numeric_limits<std::size_t>::max() - distance
+                                     ? std::numeric_limits<std::size_t>::max()
+                                     : distance + radius;
+        for (const auto& [edge, child] : node.children) {
+            if (edge >= low && edge <= high) {
+                pending.push_back(child);
+            }
+        }
+    }
+    return matches;
+}
+
+void TaxonomyMatchIndex::clear()
+{
+    categories_.clear();
+    subcategories_.clear();
+    entry_count_ = 0;
+}
+
+void TaxonomyMatchIndex::insert(std::size_t position,
+                                const std::string& normalized_category,
+                                const std::string& normalized_subcategory)
+{
+    const std::size_t category_node = categories_.insert(normalized_category);
+    if (category_node >= subcategories_.size()) {
+        subcategories_.resize(category_node + 1);
+    }
+    LabelTree& subcategories = subcategories_[category_node];
+    subcategories.payload(subcategories.insert(normalized_subcategory)).push_back(position);
+    ++entry_count_;
+}
+
+std::optional<TaxonomyMatchIndex::Match> TaxonomyMatchIndex::find_best_match(
+    const std::string& normalized_category,
+    const std::string& normalized_subcategory,
+    double threshold) const
+{
+    std::optional<Match> best;
+    if (entry_count_ == 0) {
+        return best;
+    }
+
+    // The mean reaches the threshold only if the category alone scores at least 2t - 1.
+    const std::size_t category_radius = radius_for(normalized_category.size(), 2.0 * threshold - 1.0);
+    for (const auto& [category_node, category_distance] :
+         categories_.find_within(normalized_category, category_radius)) {
+        const double category_score = similarity_from_distance(category_distance,
+                                                               normalized_category.size(),
+                                                               categories_.label(category_node).size());
+        const LabelTree& subcategories = subcategories_[category_node];
+        const std::size_t subcategory_radius =
+            radius_for(normalized_subcategory.size(), 2.0 * threshold - category_score);
+        for (const auto& [subcategory_node, subcategory_distance] :
+             subcategories.find_within(normalized_subcategory, subcategory_radius)) {
+            const double subcategory_score =
+                similarity_from_distance(subcategory_distance,
+                                         normalized_subcategory.size(),
+                                         subcategories.label(subcategory_node).size());
+            const double combined = (category_score + subcategory_score) / 2.0;
+            if (combined < threshold) {
+                continue;
+            }
+            for (const std::size_t position : subcategories.payload(subcategory_node)) {
+                if (!best || combined > best->score ||
+                    (combined == best->score && position < best->position)) {
+                    best = Match{position, combined};
+                }
+            }
+        }
+    }
+    return best;
+}
+
+std::size_t TaxonomyMatchIndex::edit_distance(std::string_view a, std::string_view b)
+{
+    if (a.size() > b.size()) {
+        std::swap(a, b);
+    }
+    if (a.size() <= kWordBits) {
+        return BitParallelPattern(a).distance(b);
+    }
+    return dp_edit_distance(a, b);
+}
+
+double TaxonomyMatchIndex::similarity(std::string_view a, std::string_view b)
+{
+    if (a == b) {
+        return 1.0;
+    }
+    return similarity_from_distance(edit_distance(a, b), a.size(), b.size());
+}
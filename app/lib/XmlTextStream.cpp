@@ -0,0 +1,299 @@
+#include "XmlTextStream.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+
+namespace {
+
+constexpr std::string_view kCommentOpen = "!--";
+constexpr std::string_view kCDataOpen = "![CDATA[";
+constexpr std::size_t kMaxEntityLength = 10;
+
+bool is_xml_space(char ch)
+{
+    return ch == ' ' || ch == '\t' || ch == '\n' || ch == '\r';
+}
+
+// Length of the longest suffix of terminator[0, matched) + ch that is a prefix of terminator.
+std::size_t advance_match(std::string_view terminator, std::size_t matched, char ch)
+{
+    if (ch == terminator[matched]) {
+        return matched + 1;
+    }
+    std::string candidate(terminator.substr(0, matched));
+    candidate.push_back(ch);
+    const std::string_view view(candidate);
+    for (std::size_t k = std::min(view.size(), terminator.size() - 1); k > 0; --k) {
+        if (view.substr(view.size() - k) == terminator.substr(0, k)) {
+            return k;
+        }
+    }
+    return 0;
+}
+
+void append_utf8(std::string& out, std::uint32_t code_point)
+{
+    if (code_point < 0x80) {
+        out.push_back(static_cast<char>(code_point));
+    } else if (code_point < 0x800) {
+        out.push_back(static_cast<char>(0xC0 | (code_point >> 6)));
+        out.push_back(static_cast<char>(0x80 | (code_point & 0x3F)));
+    } else if (code_point < 0x10000) {
+        out.push_back(static_cast<char>(0xE0 | (code_point >> 12)));
+        out.push_back(static_cast<char>(0x80 | ((code_point >> 6) & 0x3F)));
+        out.push_back(static_cast<char>(0x80 | (code_point & 0x3F)));
+    } else {
+        out.push_back(static_cast<char>(0xF0 | (code_point >> 18)));
+        out.push_back(static_cast<char>(0x80 | ((code_point >> 12) & 0x3F)));
+        out.push_back(static_cast<char>(0x80 | ((code_point >> 6) & 0x3F)));
+        out.push_back(static_cast<char>(0x80 | (code_point & 0x3F)));
+    }
+}
+
+bool decode_entity(const std::string& name, std::string& out)
+{
+    if (name == "amp") { out = "&"; return true; }
+    if (name == "lt") { out = "<"; return true; }
+    if (name == "gt") { out = ">"; return true; }
+    if (name == "quot") { out = "\""; return true; }
+    if (name == "apos") { out = "'"; return true; }
+    if (name.size() < 2 || name[0] != '#') {
+        return false;
+    }
+
+    const bool hex = name[1] == 'x' || name[1] == 'X';
+    const std::string digits = name.substr(hex ? 2 : 1);
+    if (digits.empty()) {
+        return false;
+    }
+    char* end = nullptr;
+    const unsigned long value = std::strtoul(digits.c_str(), &end, hex ? 16 : 10);
+    if (*end != '\0' || value == 0 || value > 0x10FFFF || (value >= 0xD800 && value <= 0xDFFF)) {
+        return false;
+    }
+    out.clear();
+    append_utf8(out, static_cast<std::uint32_t>(value));
+    return true;
+}
+
+} // namespace
+
+XmlTextStream::XmlTextStream(std::size_t max_bytes)
+    : max_bytes_(max_bytes)
+{
+    full_ = max_bytes_ == 0;
+}
+
+bool XmlTextStream::feed(std::string_view chunk)
+{
+    std::size_t i = 0;
+    while (i < chunk.size() && !full_) {
+        const char ch = chunk[i];
+        bool consumed = true;
+        switch (state_) {
+        case State::Text:
+            if (ch == '<') {
+                state_ = State::MarkupStart;
+                pending_.clear();
+            } else if (ch == '&') {
+                state_ = State::Entity;
+                pending_.clear();
+            } else {
+                put(ch);
+            }
+            break;
+
+        case State::Entity:
+            if (ch == ';') {
+                finish_entity();
+                state_ = State::Text;
+            } else if (ch == '<' || ch == '&' || is_xml_space(ch) || pending_.size() >= kMaxEntityLength) {
+                // Not an entity after all; keep the ampersand literally.
+                put('&');
+                put_decoded(pending_);
+                state_ = State::Text;
+                consumed = false;
+            } else {
+                pending_.push_back(ch);
+            }
+            break;
+
+        case State::MarkupStart:
+            if (pending_.empty() && ch == '?') {
+                begin_skip("?>");
+            } else if (pending_.empty() && ch != '!') {
+                state_ = State::Tag;
+                quote_ = '\0';
+                consumed = false;
+            } else {
+                pending_.push_back(ch);
+                classify_markup();
+            }
+            break;
+
+        case State::Tag:
+            if (quote_ != '\0') {
+                if (ch == quote_) {
+                    quote_ = '\0';
+                }
+            } else if (ch == '"' || ch == '\'') {
+                quote_ = ch;
+            } else if (ch == '>') {
+                // Every element boundary separates text runs, as the DOM walk used to.
+                state_ = State::Text;
+                pending_space_ = true;
+            }
+            break;
+
+        case State::Skip:
+            terminator_match_ = advance_match(terminator_, terminator_match_, ch);
+            if (terminator_match_ == terminator_.size()) {
+                state_ = State::Text;
+                pending_space_ = true;
+            }
+            break;
+
+        case State::CData: {
+            const std::size_t before = terminator_match_;
+            terminator_match_ = advance_match(terminator_, before, ch);
+            if (terminator_match_ == terminator_.size()) {
+                state_ = State::Text;
+                pending_space_ = true;
+                break;
+            }
+            // Whatever fell out of the partial "]]>" match was content after all.
+            const std::size_t released = before + 1 - terminator_match_;
+            for (std::size_t j = 0; j < released; ++j) {
+                put(j < before ? terminator_[j] : ch);
+            }
+            break;
+        }
+        }
+        if (consumed) {
+            ++i;
+        }
+    }
+    return !full_;
+}
+
+std::string XmlTextStream::take()
+{
+    std::string out = std::move(text_);
+    text_.clear();
+    state_ = State::Text;
+    pending_.clear();
+    quote_ = '\0';
+    terminator_ = {};
+    terminator_match_ = 0;
+    pending_space_ = false;
+    full_ = max_bytes_ == 0;
+    return out;
+}
+
+void XmlTextStream::put(char ch)
+{
+    if (full_) {
+        return;
+    }
+    if (is_xml_space(ch)) {
+        pending_space_ = true;
+        return;
+    }
+    if (pending_space_) {
+        pending_space_ = false;
+        if (!text_.empty()) {
+            text_.push_back(' ');
+            if (text_.size() >= max_bytes_) {
+                mark_full();
+                return;
+            }
+        }
+    }
+    text_.push_back(ch);
+    if (text_.size() >= max_bytes_) {
+        mark_full();
+    }
+}
+
+void XmlTextStream::put_decoded(std::string_view value)
+{
+    for (const char ch : value) {
+        put(ch);
+    }
+}
+
+void XmlTextStream::finish_entity()
+{
+    std::string decoded;
+    if (decode_entity(pending_, decoded)) {
+        put_decoded(decoded);
+        return;
+    }
+    put('&');
+    put_decoded(pending_);
+    put(';');
+}
+
+void XmlTextStream::classify_markup()
+{
+    if (pending_ == kCommentOpen) {
+        begin_skip("-->");
+        return;
+    }
+    if (pending_ == kCDataOpen) {
+        state_ = State::CData;
+        terminator_ = "]]>";
+        terminator_match_ = 0;
+        pending_space_ = true;
+        return;
+    }
+    if (kCommentOpen.substr(0, pending_.size()) == pending_ ||
+        kCDataOpen.substr(0, pending_.size()) == pending_) {
+        return;
+    }
+    // Some other declaration such as <!DOCTYPE ...>.
+    if (pending_.back() == '>') {
+        state_ = State::Text;
+        pending_space_ = true;
+    } else {
+        begin_skip(">");
+    }
+}
+
+void XmlTextStream::begin_skip(std::string_view terminator)
+{
+    state_ = State::Skip;
+    terminator_ = terminator;
+    terminator_match_ = 0;
+}
+
+void XmlTextStream::mark_full()
+{
+    full_ = true;
+    // Drop a multi-byte sequence cut by the budget.
+    std::size_t lead = text_.size();
+    std::size_t continuation = 0;
+    while (lead > 0 && continuation < 3 &&
+           (static_cast<unsigned char>(text_[lead - 1]) & 0xC0) == 0x80) {
+        --lead;
+        ++continuation;
+    }
+    if (lead > 0) {
+        const auto first = static_cast<unsigned char>(text_[lead - 1]);
+        std::size_t expected = 1;
+        if ((first & 0xE0) == 0xC0) {
+            expected = 2;
+        } else if ((first & 0xF0) == 0xE0) {
+            expected = 3;
+        } else if ((first & 0xF8) == 0xF0) {
+            expected = 4;
+        }
+        if (expected > continuation + 1) {
+            text_.resize(lead - 1);
+        }
+    }
+    while (!text_.empty() && text_.back() == ' ') {
+        text_.pop_back();
+    }
+}
@@ -2,18 +2,23 @@
 
 #include "CategorizationService.hpp"
 #include "DatabaseManager.hpp"
+#include "EntryBatchQueue.hpp"
 #include "FileScanner.hpp"
 #include "ILLMClient.hpp"
+#include "LLMErrors.hpp"
 #include "ResultsCoordinator.hpp"
 #include "Settings.hpp"
 #include "TestHelpers.hpp"
 
 #include <atomic>
+#include <chrono>
+#include <future>
 #include <algorithm>
 #include <fstream>
 #include <filesystem>
 #include <memory>
 #include <string>
+#include <thread>
 #include <unordered_set>
 
 namespace {
@@ -47,6 +52,226 @@ private:
     std::shared_ptr<int> calls_;
     std::string response_;
 };
+
+// Records the category list size of every whitelist the service applies.
+class WhitelistRecordingLLM : public CountingLLM {
+public:
+    WhitelistRecordingLLM(std::shared_ptr<int> calls, std::shared_ptr<std::vector<std::size_t>> whitelists)
+        : CountingLLM(std::move(calls), "Documents : Reports"), whitelists_(std::move(whitelists)) {}
+
+    void set_category_whitelist(const std::vector<std::string>& categories,
+                                const std::vector<std::string>&) override {
+        whitelists_->push_back(categories.size());
+    }
+
+private:
+    std::shared_ptr<std::vector<std::size_t>> whitelists_;
+};
+
+class AtomicCountingLLM : public ILLMClient {
+public:
+    explicit AtomicCountingLLM(std::shared_ptr<std::atomic<int>> calls)
+        : calls_(std::move(calls)) {}
+
+    std::string categorize_file(const std::string&,
+                                const std::string&,
+                                FileType,
+                                const std::string&) override {
+        ++(*calls_);
+        return "Documents : Reports";
+    }
+
+    std::string complete_prompt(const std::string&, int) override {
+        return std::string();
+    }
+
+    void set_prompt_logging_enabled(bool) override {
+    }
+
+private:
+    std::shared_ptr<std::atomic<int>> calls_;
+};
+
+// Calls are recorded outside the client, which the worker destroys when it finishes.
+struct AsyncCalls {
+    int sync_calls = 0;
+    int async_calls = 0;
+};
+
+class AsyncOnlyLLM : public ILLMClient {
+public:
+    explicit AsyncOnlyLLM(std::shared_ptr<AsyncCalls> calls)
+        : calls_(std::move(calls)) {}
+
+    std::string categorize_file(const std::string&,
+                                const std::string&,
+                                FileType,
+                                const std::string&) override {
+        ++calls_->sync_calls;
+        return "Misc : Other";
+    }
+
+    std::future<std::string> categorize_file_async(const std::string&,
+                                                   const std::string&,
+                                                   FileType,
+                                                   const std::string&) override {
+        ++calls_->async_calls;
+        std::promise<std::string> ready;
+        ready.set_value("Documents : Reports");
+        return ready.get_future();
+    }
+
+    std::string complete_prompt(const std::string&, int) override {
+        return std::string();
+    }
+
+    void set_prompt_logging_enabled(bool) override {
+    }
+
+private:
+    std::shared_ptr<AsyncCalls> calls_;
+};
+
+struct BatchCalls {
+    int single_calls = 0;
+    std::vector<std::size_t> batch_sizes;
+};
+
+class BatchingLLM : public ILLMClient {
+public:
+    explicit BatchingLLM(std::shared_ptr<BatchCalls> calls)
+        : calls_(std::move(calls)) {}
+
+    std::string categorize_file(const std::string&,
+                                const std::string&,
+                                FileType,
+                                const std::string&) override {
+        ++calls_->single_calls;
+        return "Documents : Reports";
+    }
+
+    std::string complete_prompt(const std::string&, int) override {
+        return std::string();
+    }
+
+    void set_prompt_logging_enabled(bool) override {
+    }
+
+    std::size_t preferred_batch_size() const override {
+        return 3;
+    }
+
+    std::vector<std::string> categorize_files(const std::vector<CategorizationRequest>& requests) override {
+        calls_->batch_sizes.push_back(requests.size());
+        return std::vector<std::string>(requests.size(), "Documents : Reports");
+    }
+
+private:
+    std::shared_ptr<BatchCalls> calls_;
+};
+
+struct RemoteBatchCalls {
+    std::atomic<int> batch_calls{0};
+    std::atomic<int> single_calls{0};
+    bool rate_limited{false};
+};
+
+// Fails every batch with a rate limit when asked to, otherwise answers every item but the second one.
+class RateLimitedBatchLLM : public ILLMClient {
+public:
+    explicit RateLimitedBatchLLM(std::shared_ptr<RemoteBatchCalls> calls)
+        : calls_(std::move(calls)) {}
+
+    std::string categorize_file(const std::string&,
+                                const std::string&,
+                                FileType,
+                                const std::string&) override {
+        ++calls_->single_calls;
+        return "Media : Audio";
+    }
+
+    std::string complete_prompt(const std::string&, int) override {
+        return std::string();
+    }
+
+    void set_prompt_logging_enabled(bool) override {
+    }
+
+    std::size_t preferred_batch_size() const override {
+        return 3;
+    }
+
+    std::future<std::vector<std::optional<std::string>>> categorize_files_async(
+        const std::vector<CategorizationRequest>& requests) override {
+        std::promise<std::vector<std::optional<std::string>>> ready;
+        ++calls_->batch_calls;
+        if (calls_->rate_limited) {
+            ready.set_exception(std::make_exception_ptr(BackoffError("Rate limit reached", 1)));
+        } else {
+            std::vector<std::optional<std::string>> slots(requests.size(), std::string("Documents : Reports"));
+            slots[1].reset();
+            ready.set_value(std::move(slots));
+        }
+        return ready.get_future();
+    }
+
+private:
+    std::shared_ptr<RemoteBatchCalls> calls_;
+};
+
+// The linear matching compute_files_to_sort used before it indexed the categorized entries.
+std::vector<CategorizedFile> reference_files_to_sort(const std::vector<FileEntry>& actual_files,
+                                                     const std::vector<CategorizedFile>& categorized_files,
+                                                     bool use_full_path_keys) {
+    std::vector<CategorizedFile> files_to_sort;
+    for (const auto& entry : actual_files) {
+        const auto it = std::find_if(
+            categorized_files.begin(),
+            categorized_files.end(),
+            [&entry, use_full_path_keys](const CategorizedFile& categorized_file) {
+                if (categorized_file.type != entry.type) {
+                    return false;
+                }
+                if (use_full_path_keys) {
+                    return std::filesystem::path(categorized_file.file_path) /
+                               std::filesystem::path(categorized_file.file_name) ==
+                           std::filesystem::path(entry.full_path);
+                }
+                return categorized_file.file_name == entry.file_name;
+            });
+        if (it != categorized_files.end()) {
+            files_to_sort.push_back(*it);
+        }
+    }
+    return files_to_sort;
+}
+
+// Builds scanned entries and categorized rows where every other scanned entry has a match.
+void build_sort_inputs(std::size_t count,
+                       std::vector<FileEntry>& actual_files,
+                       std::vector<CategorizedFile>& categorized_files) {
+    actual_files.clear();
+    categorized_files.clear();
+    actual_files.reserve(count);
+    categorized_files.reserve(count);
+    for (std::size_t i = 0; i < count; ++i) {
+        const std::string dir = "/data/folder" + std::to_string(i % 97);
+        const std::string name = "file" + std::to_string(i) + ".txt";
+        actual_files.push_back(FileEntry{dir + "/" + name, name, FileType::File});
+        const std::size_t categorized_index = i % 2 == 0 ? i : i + count;
+        const std::string categorized_name = "file" + std::to_string(categorized_index) + ".txt";
+        categorized_files.push_back(CategorizedFile{dir, categorized_name, FileType::File, "Docs", "Text", 0});
+    }
+}
+
+std::vector<std::string> describe_sorted(const std::vector<CategorizedFile>& files) {
+    std::vector<std::string> described;
+    for (const auto& file : files) {
+        described.push_back(file.file_path + "|" + file.file_name + "|" + to_string(file.type) + "|" +
+                            file.category);
+    }
+    return described;
+}
 } // namespace
 
 TEST_CASE("CategorizationService uses cached categorization without calling LLM") {
@@ -133,6 +358,65 @@ TEST_CASE("CategorizationService falls back to LLM when cache is empty") {
     CHECK(cached[1] == "Photos");
 }
 
+TEST_CASE("CategorizationService reuses cached categories for moved and copied files") {
+    TempDir config_dir;
+    EnvVarGuard config_guard("AI_FILE_SORTER_CONFIG_DIR", config_dir.path().string());
+    EnvVarGuard fingerprint_guard("AI_FILE_SORTER_CONTENT_FINGERPRINT", std::nullopt);
+    Settings settings;
+    DatabaseManager db(settings.get_config_dir());
+    CategorizationService service(settings, db, nullptr);
+
+    TempDir data_dir;
+    const auto original = data_dir.path() / "inbox" / "report.pdf";
+    std::filesystem::create_directories(original.parent_path());
+    {
+        std::ofstream out(original, std::ios::binary);
+        out << std::string(4096, 'r');
+    }
+
+    std::atomic<bool> stop_flag{false};
+    auto calls = std::make_shared<int>(0);
+    auto factory = [calls]() {
+        return std::make_unique<CountingLLM>(calls, "Documents : Reports");
+    };
+    const auto categorize = [&](const std::filesystem::path& path) {
+        const std::vector<FileEntry> files = {
+            FileEntry{path.string(), path.filename().string(), FileType::File}};
+        return service.categorize_entries(files, true, stop_flag, {}, {}, {}, {}, factory);
+    };
+
+    REQUIRE(categorize(original).size() == 1);
+    REQUIRE(*calls == 1);
+
+    const auto copy = data_dir.path() / "archive" / "report (1).pdf";
+    std::filesystem::create_directories(copy.parent_path());
+    std::filesystem::copy_file(original, copy);
+    auto categorized = categorize(copy);
+    REQUIRE(categorized.size() == 1);
+    CHECK(categorized.front().category == "Documents");
+    CHECK(*calls == 1);
+    CHECK(db.get_categorized_file(original.parent_path().string(), "report.pdf", FileType::File).has_value());
+
+    const auto moved = data_dir.path() / "sorted" / "quarterly.pdf";
+    std::filesystem::create_directories(moved.parent_path());
+    std::filesystem::rename(original, moved);
+    categorized = categorize(moved);
+    REQUIRE(categorized.size() == 1);
+    CHECK(categorized.front().subcategory == "Reports");
+    CHECK(*calls == 1);
+    CHECK_FALSE(db.get_categorized_file(original.parent_path().string(), "report.pdf", FileType::File).has_value());
+    CHECK(db.get_categorized_file(moved.parent_path().string(), "quarterly.pdf", FileType::File).has_value());
+
+    SECTION("fingerprint lookups can be disabled") {
+        EnvVarGuard disabled("AI_FILE_SORTER_CONTENT_FINGERPRINT", std::string("0"));
+        const auto other = data_dir.path() / "other" / "again.pdf";
+        std::filesystem::create_directories(other.parent_path());
+        std::filesystem::copy_file(moved, other);
+        REQUIRE(categorize(other).size() == 1);
+        CHECK(*calls == 2);
+    }
+}
+
 TEST_CASE("CategorizationService invokes completion callback per entry") {
     TempDir config_dir;
     EnvVarGuard config_guard("AI_FILE_SORTER_CONFIG_DIR", config_dir.path().string());
@@ -172,6 +456,334 @@ TEST_CASE("CategorizationService invokes completion callback per entry") {
     CHECK(*calls == static_cast<int>(files.size()));
 }
 
+TEST_CASE("CategorizationService worker pool keeps input order") {
+    TempDir config_dir;
+    EnvVarGuard config_guard("AI_FILE_SORTER_CONFIG_DIR", config_dir.path().string());
+    EnvVarGuard workers_guard("AI_FILE_SORTER_REMOTE_LLM_WORKERS", std::string("4"));
+    Settings settings;
+    DatabaseManager db(settings.get_config_dir());
+    CategorizationService service(settings, db, nullptr);
+
+    TempDir data_dir;
+    std::vector<FileEntry> files;
+    for (int i = 0; i < 24; ++i) {
+        const std::string name = "file" + std::to_string(i) + ".txt";
+        files.push_back(FileEntry{(data_dir.path() / name).string(), name, FileType::File});
+    }
+
+    std::atomic<bool> stop_flag{false};
+    auto calls = std::make_shared<std::atomic<int>>(0);
+    std::atomic<int> clients_created{0};
+    auto factory = [calls, &clients_created]() {
+        ++clients_created;
+        return std::make_unique<AtomicCountingLLM>(calls);
+    };
+
+    std::size_t completed_count = 0;
+    const auto categorized = service.categorize_entries(
+        files,
+        false,
+        stop_flag,
+        {},
+        {},
+        [&completed_count](const FileEntry&) { ++completed_count; },
+        {},
+        factory);
+
+    CHECK(clients_created.load() == 4);
+    CHECK(calls->load() == static_cast<int>(files.size()));
+    CHECK(completed_count == files.size());
+    REQUIRE(categorized.size() == files.size());
+    for (std::size_t i = 0; i < files.size(); ++i) {
+        CHECK(categorized[i].file_name == files[i].file_name);
+        CHECK(categorized[i].category == "Documents");
+    }
+}
+
+TEST_CASE("CategorizationService starts on streamed batches before the stream ends") {
+    TempDir config_dir;
+    EnvVarGuard config_guard("AI_FILE_SORTER_CONFIG_DIR", config_dir.path().string());
+    EnvVarGuard workers_guard("AI_FILE_SORTER_REMOTE_LLM_WORKERS", std::string("1"));
+    Settings settings;
+    DatabaseManager db(settings.get_config_dir());
+    CategorizationService service(settings, db, nullptr);
+
+    TempDir data_dir;
+    std::vector<std::vector<FileEntry>> batches(3);
+    for (int i = 0; i < 9; ++i) {
+        const std::string name = "file" + std::to_string(i) + ".txt";
+        batches[i / 3].push_back(FileEntry{(data_dir.path() / name).string(), name, FileType::File});
+    }
+
+    std::vector<std::string> events;
+    std::size_t next = 0;
+    auto source = [&]() -> std::optional<std::vector<FileEntry>> {
+        if (next == batches.size()) {
+            events.push_back("end");
+            return std::nullopt;
+        }
+        events.push_back("batch" + std::to_string(next));
+        return batches[next++];
+    };
+
+    std::atomic<bool> stop_flag{false};
+    auto calls = std::make_shared<std::atomic<int>>(0);
+    const auto categorized = service.categorize_entry_stream(
+        source,
+        false,
+        stop_flag,
+        {},
+        [&events](const FileEntry& entry) { events.push_back(entry.file_name); },
+        {},
+        {},
+        [calls]() { return std::make_unique<AtomicCountingLLM>(calls); });
+
+    REQUIRE(categorized.size() == 9);
+    for (std::size_t i = 0; i < categorized.size(); ++i) {
+        CHECK(categorized[i].file_name == "file" + std::to_string(i) + ".txt");
+    }
+    const auto position = [&events](const std::string& event) {
+        return std::find(events.begin(), events.end(), event) - events.begin();
+    };
+    CHECK(position("file0.txt") < position("batch1"));
+    CHECK(position("file3.txt") < position("batch2"));
+    CHECK(events.back() == "end");
+}
+
+TEST_CASE("CategorizationService sizes the worker pool for the stream, not its first batch") {
+    TempDir config_dir;
+    EnvVarGuard config_guard("AI_FILE_SORTER_CONFIG_DIR", config_dir.path().string());
+    EnvVarGuard workers_guard("AI_FILE_SORTER_REMOTE_LLM_WORKERS", std::string("3"));
+    Settings settings;
+    DatabaseManager db(settings.get_config_dir());
+    CategorizationService service(settings, db, nullptr);
+
+    // A mostly cached rerun: the first scanned batch has a single uncached entry.
+    TempDir data_dir;
+    std::vector<std::vector<FileEntry>> batches(3);
+    for (int i = 0; i < 9; ++i) {
+        const std::string name = "file" + std::to_string(i) + ".txt";
+        batches[i == 0 ? 0 : 1 + (i % 2)].push_back(
+            FileEntry{(data_dir.path() / name).string(), name, FileType::File});
+    }
+    std::size_t next = 0;
+    auto source = [&]() -> std::optional<std::vector<FileEntry>> {
+        if (next == batches.size()) {
+            return std::nullopt;
+        }
+        return batches[next++];
+    };
+
+    std::atomic<bool> stop_flag{false};
+    auto calls = std::make_shared<std::atomic<int>>(0);
+    std::atomic<int> clients_created{0};
+    const auto categorized = service.categorize_entry_stream(
+        source,
+        false,
+        stop_flag,
+        {},
+        {},
+        {},
+        {},
+        [calls, &clients_created]() {
+            ++clients_created;
+            return std::make_unique<AtomicCountingLLM>(calls);
+        });
+
+    CHECK(clients_created.load() == 3);
+    CHECK(categorized.size() == 9);
+
+    // A stream that ends with its first batch still gets no more workers than items.
+    std::vector<FileEntry> single = {FileEntry{(data_dir.path() / "only.txt").string(), "only.txt", FileType::File}};
+    clients_created = 0;
+    service.categorize_entries(single, false, stop_flag, {}, {}, {}, {}, [calls, &clients_created]() {
+        ++clients_created;
+        return std::make_unique<AtomicCountingLLM>(calls);
+    });
+    CHECK(clients_created.load() == 1);
+}
+
+TEST_CASE("ResultsCoordinator streams uncached entries through a bounded queue") {
+    TempDir data_dir;
+    for (int i = 0; i < 20; ++i) {
+        write_file(data_dir.path() / ("dir" + std::to_string(i % 4)) / ("file" + std::to_string(i) + ".txt"));
+    }
+    const auto cached_file = data_dir.path() / "dir0" / "file0.txt";
+
+    FileScanner scanner;
+    ResultsCoordinator coordinator(scanner);
+    const auto options = FileScanOptions::Files | FileScanOptions::Recursive;
+    const std::unordered_set<std::string> cached{cached_file.string()};
+    std::vector<FileEntry> found_listing;
+    const auto expected = coordinator.find_files_to_categorize(data_dir.path().string(), options, cached, true,
+                                                               &found_listing);
+    REQUIRE(expected.size() == 19);
+    CHECK(found_listing.size() == 20);
+
+    EntryBatchQueue queue(1);
+    std::vector<FileEntry> streamed_listing;
+    bool scan_complete = false;
+    std::thread producer([&]() {
+        scan_complete = coordinator.stream_files_to_categorize(data_dir.path().string(), options, cached, true, 4,
+                                                               [&queue](std::vector<FileEntry>&& batch) {
+                                                                   return queue.push(std::move(batch));
+                                                               },
+                                                               &streamed_listing);
+        queue.close();
+    });
+
+    std::vector<std::string> streamed;
+    while (auto batch = queue.pop()) {
+        CHECK(batch->size() <= 4);
+        for (const auto& entry : *batch) {
+            streamed.push_back(entry.full_path);
+        }
+    }
+    producer.join();
+
+    std::vector<std::string> expected_paths;
+    for (const auto& entry : expected) {
+        expected_paths.push_back(entry.full_path);
+    }
+    CHECK(streamed == expected_paths);
+    // Both variants hand back the whole listing, cached entry included, for reuse after categorization.
+    CHECK(scan_complete);
+    REQUIRE(streamed_listing.size() == found_listing.size());
+    for (std::size_t i = 0; i < found_listing.size(); ++i) {
+        CHECK(streamed_listing[i].full_path == found_listing[i].full_path);
+    }
+    CHECK_FALSE(coordinator.stream_files_to_categorize(data_dir.path().string(), options, cached, true, 4,
+                                                       [](std::vector<FileEntry>&&) { return false; }));
+
+    EntryBatchQueue cancelled(1);
+    REQUIRE(cancelled.push({FileEntry{"a", "a", FileType::File}}));
+    cancelled.cancel();
+    CHECK_FALSE(cancelled.push({FileEntry{"b", "b", FileType::File}}));
+    CHECK_FALSE(cancelled.pop().has_value());
+}
+
+TEST_CASE("CategorizationService dispatches single requests through the async client API") {
+    TempDir config_dir;
+    EnvVarGuard config_guard("AI_FILE_SORTER_CONFIG_DIR", config_dir.path().string());
+    Settings settings;
+    DatabaseManager db(settings.get_config_dir());
+    CategorizationService service(settings, db, nullptr);
+
+    TempDir data_dir;
+    const std::vector<FileEntry> files = {
+        FileEntry{(data_dir.path() / "a.txt").string(), "a.txt", FileType::File},
+        FileEntry{(data_dir.path() / "b.txt").string(), "b.txt", FileType::File}};
+
+    std::atomic<bool> stop_flag{false};
+    auto calls = std::make_shared<AsyncCalls>();
+    auto factory = [calls]() {
+        return std::make_unique<AsyncOnlyLLM>(calls);
+    };
+
+    const auto categorized = service.categorize_entries(files, true, stop_flag, {}, {}, {}, {}, factory);
+
+    CHECK(calls->async_calls == 2);
+    CHECK(calls->sync_calls == 0);
+    REQUIRE(categorized.size() == 2);
+    CHECK(categorized[0].category == "Documents");
+    CHECK(categorized[1].category == "Documents");
+}
+
+TEST_CASE("CategorizationService sends uncached entries to the client in batches") {
+    TempDir config_dir;
+    EnvVarGuard config_guard("AI_FILE_SORTER_CONFIG_DIR", config_dir.path().string());
+    Settings settings;
+    DatabaseManager db(settings.get_config_dir());
+    CategorizationService service(settings, db, nullptr);
+
+    TempDir data_dir;
+    const std::string dir_path = data_dir.path().string();
+    const auto cached = db.resolve_category("Images", "Photos");
+    REQUIRE(cached.taxonomy_id > 0);
+    REQUIRE(db.insert_or_update_file_with_categorization(
+        "file1.txt", "F", dir_path, cached, false, std::string(), false));
+
+    std::vector<FileEntry> files;
+    for (int i = 0; i < 7; ++i) {
+        const std::string name = "file" + std::to_string(i) + ".txt";
+        files.push_back(FileEntry{(data_dir.path() / name).string(), name, FileType::File});
+    }
+
+    std::atomic<bool> stop_flag{false};
+    auto calls = std::make_shared<BatchCalls>();
+    auto factory = [calls]() {
+        return std::make_unique<BatchingLLM>(calls);
+    };
+
+    std::size_t completed_count = 0;
+    const auto categorized = service.categorize_entries(
+        files,
+        true,
+        stop_flag,
+        {},
+        {},
+        [&completed_count](const FileEntry&) { ++completed_count; },
+        {},
+        factory);
+
+    // Claims of 3, 3 and 1 entries; the cached entry in the first claim never reaches the LLM.
+    CHECK(calls->batch_sizes == std::vector<std::size_t>{2, 3});
+    CHECK(calls->single_calls == 1);
+    CHECK(completed_count == files.size());
+    REQUIRE(categorized.size() == files.size());
+    for (std::size_t i = 0; i < files.size(); ++i) {
+        CHECK(categorized[i].file_name == files[i].file_name);
+        CHECK(categorized[i].category == (i == 1 ? "Images" : "Documents"));
+    }
+}
+
+TEST_CASE("CategorizationService surfaces a rate-limited batch and sends only its gaps individually") {
+    TempDir config_dir;
+    EnvVarGuard config_guard("AI_FILE_SORTER_CONFIG_DIR", config_dir.path().string());
+    EnvVarGuard workers_guard("AI_FILE_SORTER_REMOTE_LLM_WORKERS", std::string("1"));
+    Settings settings;
+    DatabaseManager db(settings.get_config_dir());
+    CategorizationService service(settings, db, nullptr);
+
+    TempDir data_dir;
+    std::vector<FileEntry> files;
+    for (int i = 0; i < 3; ++i) {
+        const std::string name = "file" + std::to_string(i) + ".txt";
+        files.push_back(FileEntry{(data_dir.path() / name).string(), name, FileType::File});
+    }
+
+    std::atomic<bool> stop_flag{false};
+    auto calls = std::make_shared<RemoteBatchCalls>();
+    auto categorize = [&]() {
+        return service.categorize_entries(
+            files,
+            false,
+            stop_flag,
+            {},
+            {},
+            {},
+            {},
+            [calls]() { return std::make_unique<RateLimitedBatchLLM>(calls); });
+    };
+
+    SECTION("A rate limit the client gave up on is not waited out and resent") {
+        calls->rate_limited = true;
+        CHECK_THROWS_AS(categorize(), BackoffError);
+        CHECK(calls->batch_calls.load() == 1);
+        CHECK(calls->single_calls.load() == 0);
+    }
+
+    SECTION("Only the items the batch reply leaves empty are sent one by one") {
+        const auto categorized = categorize();
+        CHECK(calls->batch_calls.load() == 1);
+        CHECK(calls->single_calls.load() == 1);
+        REQUIRE(categorized.size() == 3);
+        CHECK(categorized[0].category == "Documents");
+        CHECK(categorized[1].category == "Media");
+        CHECK(categorized[2].category == "Documents");
+    }
+}
+
 TEST_CASE("CategorizationService loads cached entries recursively for analysis") {
     TempDir config_dir;
     EnvVarGuard config_guard("AI_FILE_SORTER_CONFIG_DIR", config_dir.path().string());
@@ -266,3 +878,115 @@ TEST_CASE("ResultsCoordinator respects full-path cache keys for recursive scans"
     REQUIRE(uncached_by_path.size() == 1);
     CHECK(uncached_by_path.front().full_path == nested_file.string());
 }
+
+TEST_CASE("ResultsCoordinator compute_files_to_sort matches the linear search") {
+    FileScanner scanner;
+    ResultsCoordinator coordinator(scanner);
+
+    const std::vector<FileEntry> actual_files{
+        {"/data/a/report.txt", "report.txt", FileType::File},
+        {"/data/b/report.txt", "report.txt", FileType::File},
+        {"/data/a/photos", "photos", FileType::Directory},
+        {"/data/a/photos", "photos", FileType::File},
+        {"/data//c/notes.txt", "notes.txt", FileType::File},
+        {"/data/d/missing.txt", "missing.txt", FileType::File},
+        {"data/e/relative.txt", "relative.txt", FileType::File},
+    };
+    const std::vector<CategorizedFile> categorized_files{
+        {"/data/b", "report.txt", FileType::File, "Work", "Reports", 0},
+        {"/data/a", "report.txt", FileType::File, "Home", "Reports", 0},
+        {"/data/a", "photos", FileType::Directory, "Media", "Photos", 0},
+        {"/data/c", "notes.txt", FileType::File, "Work", "Notes", 0},
+        {"/data/c", "notes.txt", FileType::File, "Duplicate", "Notes", 0},
+        {"/data/e", "relative.txt", FileType::File, "Rooted", "Text", 0},
+        {"data/e", "relative.txt", FileType::File, "Relative", "Text", 0},
+    };
+
+    for (const bool use_full_path_keys : {false, true}) {
+        const auto indexed = coordinator.compute_files_to_sort(
+            "/data", FileScanOptions::Files, actual_files, categorized_files, use_full_path_keys);
+        CHECK(describe_sorted(indexed) ==
+              describe_sorted(reference_files_to_sort(actual_files, categorized_files, use_full_path_keys)));
+    }
+
+    const auto by_path = coordinator.compute_files_to_sort(
+        "/data", FileScanOptions::Files, actual_files, categorized_files, true);
+    REQUIRE(by_path.size() == 5);
+    CHECK(by_path[0].category == "Home");
+    CHECK(by_path[1].category == "Work");
+    CHECK(by_path[2].category == "Media");
+    CHECK(by_path[3].category == "Work");
+    CHECK(by_path[4].category == "Relative");
+
+    std::vector<FileEntry> generated_actual;
+    std::vector<CategorizedFile> generated_categorized;
+    build_sort_inputs(500, generated_actual, generated_categorized);
+    CHECK(describe_sorted(coordinator.compute_files_to_sort(
+              "/data", FileScanOptions::Files, generated_actual, generated_categorized, true)) ==
+          describe_sorted(reference_files_to_sort(generated_actual, generated_categorized, true)));
+}
+
+TEST_CASE("ResultsCoordinator compute_files_to_sort benchmark", "[.][benchmark]") {
+    FileScanner scanner;
+    ResultsCoordinator coordinator(scanner);
+    const auto millis = [](auto elapsed) {
+        return std::chrono::duration_cast<std::chrono::milliseconds>(elapsed).count();
+    };
+
+    for (const std::size_t count : {std::size_t{10000}, std::size_t{100000}, std::size_t{1000000}}) {
+        std::vector<FileEntry> actual_files;
+        std::vector<CategorizedFile> categorized_files;
+        build_sort_inputs(count, actual_files, categorized_files);
+
+        for (const bool use_full_path_keys : {false, true}) {
+            const auto start = std::chrono::steady_clock::now();
+            const auto matched = coordinator.compute_files_to_sort(
+                "/data", FileScanOptions::Files, actual_files, categorized_files, use_full_path_keys);
+            const auto elapsed = std::chrono::steady_clock::now() - start;
+            CHECK(matched.size() == count / 2);
+
+            // The linear search needs about a minute for 10k full-path keys, so it only runs with name keys.
+            if (count == 10000 && !use_full_path_keys) {
+                const auto reference_start = std::chrono::steady_clock::now();
+                const auto reference = reference_files_to_sort(actual_files, categorized_files, use_full_path_keys);
+                const auto reference_elapsed = std::chrono::steady_clock::now() - reference_start;
+                CHECK(reference.size() == matched.size());
+                WARN(count << " entries (name keys): linear " << millis(reference_elapsed) << " ms; indexed "
+                     << millis(elapsed) << " ms");
+            } else {
+                WARN(count << " entries (" << (use_full_path_keys ? "full path" : "name") << " keys): indexed "
+                     << millis(elapsed) << " ms");
+            }
+        }
+    }
+}
+
+TEST_CASE("CategorizationService clears the whitelist of a reused client when it is disabled") {
+    TempDir config_dir;
+    EnvVarGuard config_guard("AI_FILE_SORTER_CONFIG_DIR", config_dir.path().string());
+    Settings settings;
+    settings.set_allowed_categories({"Documents", "Images"});
+    settings.set_allowed_subcategories({"Reports"});
+    DatabaseManager db(settings.get_config_dir());
+    CategorizationService service(settings, db, nullptr);
+
+    TempDir data_dir;
+    std::atomic<bool> stop_flag{false};
+    auto calls = std::make_shared<int>(0);
+    auto whitelists = std::make_shared<std::vector<std::size_t>>();
+    auto factory = [calls, whitelists]() {
+        return std::make_unique<WhitelistRecordingLLM>(calls, whitelists);
+    };
+    const auto categorize = [&](const std::string& name) {
+        const auto path = data_dir.path() / name;
+        const std::vector<FileEntry> files = {FileEntry{path.string(), name, FileType::File}};
+        return service.categorize_entries(files, true, stop_flag, {}, {}, {}, {}, factory);
+    };
+
+    settings.set_use_whitelist(true);
+    REQUIRE(categorize("first.txt").size() == 1);
+    settings.set_use_whitelist(false);
+    REQUIRE(categorize("second.txt").size() == 1);
+
+    CHECK(*whitelists == std::vector<std::size_t>{2, 0});
+}
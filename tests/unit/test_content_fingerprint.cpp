@@ -0,0 +1,111 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include "ContentFingerprint.hpp"
+#include "DatabaseManager.hpp"
+#include "TestHelpers.hpp"
+
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+namespace {
+
+void write_bytes(const std::filesystem::path& path, const std::string& data)
+{
+    std::filesystem::create_directories(path.parent_path());
+    std::ofstream out(path, std::ios::binary);
+    out << data;
+}
+
+std::string patterned(std::size_t size)
+{
+    std::string data(size, '\0');
+    for (std::size_t i = 0; i < size; ++i) {
+        data[i] = static_cast<char>('a' + (i * 7) % 26);
+    }
+    return data;
+}
+
+} // namespace
+
+TEST_CASE("ContentFingerprint hashes with XXH64") {
+    const auto hash = [](const char* text, std::uint64_t seed = 0) {
+        return ContentFingerprint::xxh64(text, std::strlen(text), seed);
+    };
+    CHECK(hash("") == 0xEF46DB3751D8E999ULL);
+    CHECK(hash("a") == 0xD24EC4F1A98C6E5BULL);
+    CHECK(hash("abc") == 0x44BC2CF5AD770999ULL);
+    CHECK(hash("Nobody inspects the spammish repetition") == 0xFBCEA83C8A378BF1ULL);
+}
+
+TEST_CASE("ContentFingerprint samples the head, the tail and the size") {
+    TempDir dir;
+    const std::size_t size = 3 * ContentFingerprint::kSampleBytes;
+    const std::string data = patterned(size);
+    write_bytes(dir.path() / "original.bin", data);
+    write_bytes(dir.path() / "copy.bin", data);
+
+    const auto original = ContentFingerprint::compute((dir.path() / "original.bin").string());
+    REQUIRE(original.has_value());
+    CHECK(ContentFingerprint::compute((dir.path() / "copy.bin").string()) == original);
+
+    std::string middle_changed = data;
+    middle_changed[size / 2] = '#';
+    write_bytes(dir.path() / "middle.bin", middle_changed);
+    CHECK(ContentFingerprint::compute((dir.path() / "middle.bin").string()) == original);
+
+    std::string tail_changed = data;
+    tail_changed[size - 1] = '#';
+    write_bytes(dir.path() / "tail.bin", tail_changed);
+    CHECK(ContentFingerprint::compute((dir.path() / "tail.bin").string()) != original);
+
+    write_bytes(dir.path() / "longer.bin", data + "x");
+    CHECK(ContentFingerprint::compute((dir.path() / "longer.bin").string()) != original);
+
+    write_bytes(dir.path() / "small.txt", "TODO");
+    CHECK_FALSE(ContentFingerprint::compute((dir.path() / "small.txt").string()).has_value());
+    CHECK_FALSE(ContentFingerprint::compute((dir.path() / "missing.bin").string()).has_value());
+}
+
+TEST_CASE("DatabaseManager finds categorizations by content fingerprint") {
+    TempDir base_dir;
+    EnvVarGuard config_guard("AI_FILE_SORTER_CONFIG_DIR", base_dir.path().string());
+    DatabaseManager db(base_dir.path().string());
+
+    const auto resolved = db.resolve_category("Documents", "Invoices");
+    REQUIRE(db.insert_or_update_file_with_categorization(
+        "invoice.pdf", "F", "/old", resolved, false, std::string(), false, false, "400-abc"));
+    CHECK(db.find_categorizations_by_fingerprint("400-def").empty());
+
+    auto matches = db.find_categorizations_by_fingerprint("400-abc");
+    REQUIRE(matches.size() == 1);
+    CHECK(matches.front().file_path == "/old");
+    CHECK(matches.front().file_name == "invoice.pdf");
+    CHECK(matches.front().category == "Documents");
+    CHECK(matches.front().subcategory == "Invoices");
+
+    SECTION("updates without a fingerprint keep the stored one") {
+        const auto edited = db.resolve_category("Documents", "Receipts");
+        REQUIRE(db.insert_or_update_file_with_categorization("invoice.pdf", "F", "/old", edited, false));
+        matches = db.find_categorizations_by_fingerprint("400-abc");
+        REQUIRE(matches.size() == 1);
+        CHECK(matches.front().subcategory == "Receipts");
+    }
+
+    SECTION("copies are listed newest first") {
+        REQUIRE(db.insert_or_update_file_with_categorization(
+            "invoice copy.pdf", "F", "/new", resolved, false, std::string(), false, false, "400-abc"));
+        matches = db.find_categorizations_by_fingerprint("400-abc");
+        REQUIRE(matches.size() == 2);
+        CHECK(matches.front().file_path == "/new");
+        CHECK(db.find_categorizations_by_fingerprint("400-abc", 1).size() == 1);
+    }
+
+    SECTION("rows with empty labels are not reused") {
+        DatabaseManager::ResolvedCategory empty{0, "", ""};
+        REQUIRE(db.insert_or_update_file_with_categorization(
+            "blank.pdf", "F", "/old", empty, false, std::string(), false, false, "500-abc"));
+        CHECK(db.find_categorizations_by_fingerprint("500-abc").empty());
+    }
+}
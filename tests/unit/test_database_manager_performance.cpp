@@ -0,0 +1,408 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include "DatabaseManager.hpp"
+#include "TestHelpers.hpp"
+
+#include <sqlite3.h>
+
+#include <chrono>
+#include <filesystem>
+#include <set>
+#include <string>
+#include <vector>
+
+namespace {
+
+std::string query_journal_mode(const std::filesystem::path& db_path)
+{
+    sqlite3* raw = nullptr;
+    REQUIRE(sqlite3_open(db_path.string().c_str(), &raw) == SQLITE_OK);
+    sqlite3_stmt* stmt = nullptr;
+    std::string mode;
+    if (sqlite3_prepare_v2(raw, "PRAGMA journal_mode;", -1, &stmt, nullptr) == SQLITE_OK &&
+        sqlite3_step(stmt) == SQLITE_ROW) {
+        mode = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 0));
+    }
+    sqlite3_finalize(stmt);
+    sqlite3_close(raw);
+    return mode;
+}
+
+int query_taxonomy_frequency(const std::filesystem::path& db_path, int taxonomy_id)
+{
+    sqlite3* raw = nullptr;
+    REQUIRE(sqlite3_open(db_path.string().c_str(), &raw) == SQLITE_OK);
+    sqlite3_stmt* stmt = nullptr;
+    int frequency = -1;
+    if (sqlite3_prepare_v2(raw, "SELECT frequency FROM category_taxonomy WHERE id = ?;", -1, &stmt, nullptr) ==
+        SQLITE_OK) {
+        sqlite3_bind_int(stmt, 1, taxonomy_id);
+        if (sqlite3_step(stmt) == SQLITE_ROW) {
+            frequency = sqlite3_column_int(stmt, 0);
+        }
+    }
+    sqlite3_finalize(stmt);
+    sqlite3_close(raw);
+    return frequency;
+}
+
+std::string query_plan(const std::filesystem::path& db_path, const std::string& sql)
+{
+    sqlite3* raw = nullptr;
+    REQUIRE(sqlite3_open(db_path.string().c_str(), &raw) == SQLITE_OK);
+    sqlite3_stmt* stmt = nullptr;
+    std::string plan;
+    const std::string explain = "EXPLAIN QUERY PLAN " + sql;
+    if (sqlite3_prepare_v2(raw, explain.c_str(), -1, &stmt, nullptr) == SQLITE_OK) {
+        while (sqlite3_step(stmt) == SQLITE_ROW) {
+            plan += reinterpret_cast<const char*>(sqlite3_column_text(stmt, 3));
+            plan += "\n";
+        }
+    }
+    sqlite3_finalize(stmt);
+    sqlite3_close(raw);
+    return plan;
+}
+
+std::set<std::string> entry_keys(const std::vector<CategorizedFile>& entries)
+{
+    std::set<std::string> keys;
+    for (const auto& entry : entries) {
+        keys.insert(entry.file_path + "|" + entry.file_name);
+    }
+    return keys;
+}
+
+std::string bench_file_name(int index)
+{
+    return "file_" + std::to_string(index) + ".pdf";
+}
+
+std::string bench_dir(int index)
+{
+    return "/bench/dir_" + std::to_string(index % 50);
+}
+
+double per_second(int operations, std::chrono::steady_clock::duration elapsed)
+{
+    const double seconds = std::chrono::duration<double>(elapsed).count();
+    return seconds > 0.0 ? operations / seconds : 0.0;
+}
+
+// Mirrors the previous access pattern: default rollback journal and one prepare/finalize per call.
+struct BaselineRates {
+    double inserts_per_second{0.0};
+    double lookups_per_second{0.0};
+    int hits{0};
+};
+
+BaselineRates run_uncached_baseline(const std::filesystem::path& db_path, int rows)
+{
+    sqlite3* raw = nullptr;
+    REQUIRE(sqlite3_open(db_path.string().c_str(), &raw) == SQLITE_OK);
+    REQUIRE(sqlite3_exec(raw,
+                         "CREATE TABLE file_categorization (id INTEGER PRIMARY KEY AUTOINCREMENT, "
+                         "file_name TEXT NOT NULL, file_type TEXT NOT NULL, dir_path TEXT NOT NULL, "
+                         "category TEXT NOT NULL, subcategory TEXT, "
+                         "UNIQUE(file_name, file_type, dir_path));",
+                         nullptr, nullptr, nullptr) == SQLITE_OK);
+
+    BaselineRates rates;
+    const auto insert_start = std::chrono::steady_clock::now();
+    for (int i = 0; i < rows; ++i) {
+        sqlite3_stmt* stmt = nullptr;
+        sqlite3_prepare_v2(raw,
+                           "INSERT INTO file_categorization (file_name, file_type, dir_path, category, subcategory) "
+                           "VALUES (?, 'F', ?, 'Documents', 'Reports') "
+                           "ON CONFLICT(file_name, file_type, dir_path) DO UPDATE SET category = excluded.category;",
+                           -1, &stmt, nullptr);
+        const std::string name = bench_file_name(i);
+        const std::string dir = bench_dir(i);
+        sqlite3_bind_text(stmt, 1, name.c_str(), -1, SQLITE_TRANSIENT);
+        sqlite3_bind_text(stmt, 2, dir.c_str(), -1, SQLITE_TRANSIENT);
+        sqlite3_step(stmt);
+        sqlite3_finalize(stmt);
+    }
+    rates.inserts_per_second = per_second(rows, std::chrono::steady_clock::now() - insert_start);
+
+    const auto lookup_start = std::chrono::steady_clock::now();
+    for (int i = 0; i < rows; ++i) {
+        sqlite3_stmt* stmt = nullptr;
+        sqlite3_prepare_v2(raw,
+                           "SELECT category, subcategory FROM file_categorization "
+                           "WHERE dir_path = ? AND file_name = ? AND file_type = ?;",
+                           -1, &stmt, nullptr);
+        const std::string name = bench_file_name(i);
+        const std::string dir = bench_dir(i);
+        sqlite3_bind_text(stmt, 1, dir.c_str(), -1, SQLITE_TRANSIENT);
+        sqlite3_bind_text(stmt, 2, name.c_str(), -1, SQLITE_TRANSIENT);
+        sqlite3_bind_text(stmt, 3, "F", -1, SQLITE_TRANSIENT);
+        if (sqlite3_step(stmt) == SQLITE_ROW) {
+            ++rates.hits;
+        }
+        sqlite3_finalize(stmt);
+    }
+    rates.lookups_per_second = per_second(rows, std::chrono::steady_clock::now() - lookup_start);
+
+    sqlite3_close(raw);
+    return rates;
+}
+
+} // namespace
+
+TEST_CASE("DatabaseManager enables WAL journaling on its cache database") {
+    TempDir base_dir;
+    EnvVarGuard config_guard("AI_FILE_SORTER_CONFIG_DIR", base_dir.path().string());
+    EnvVarGuard cache_guard("CATEGORIZATION_CACHE_FILE", std::nullopt);
+    {
+        DatabaseManager db(base_dir.path().string());
+        const auto resolved = db.resolve_category("Documents", "Reports");
+        REQUIRE(db.insert_or_update_file_with_categorization("a.pdf", "F", "/docs", resolved, false));
+    }
+
+    CHECK(query_journal_mode(base_dir.path() / "categorization_results.db") == "wal");
+}
+
+TEST_CASE("DatabaseManager reuses cached statements across repeated calls") {
+    TempDir base_dir;
+    EnvVarGuard config_guard("AI_FILE_SORTER_CONFIG_DIR", base_dir.path().string());
+    DatabaseManager db(base_dir.path().string());
+
+    const auto docs = db.resolve_category("Documents", "Reports");
+    const auto images = db.resolve_category("Images", "Photos");
+    REQUIRE(db.insert_or_update_file_with_categorization("a.pdf", "F", "/docs", docs, false));
+    REQUIRE(db.insert_or_update_file_with_categorization("b.jpg", "F", "/docs", images, false));
+
+    for (int round = 0; round < 3; ++round) {
+        const auto first = db.get_categorization_from_db("/docs", "a.pdf", FileType::File);
+        REQUIRE(first.size() == 2);
+        CHECK(first[0] == "Documents");
+
+        const auto second = db.get_categorization_from_db("/docs", "b.jpg", FileType::File);
+        REQUIRE(second.size() == 2);
+        CHECK(second[0] == "Images");
+
+        CHECK(db.get_categorization_from_db("/docs", "missing.txt", FileType::File).empty());
+    }
+
+    REQUIRE(db.insert_or_update_file_with_categorization("a.pdf", "F", "/docs", images, false));
+    const auto updated = db.get_categorization_from_db("/docs", "a.pdf", FileType::File);
+    REQUIRE(updated.size() == 2);
+    CHECK(updated[0] == "Images");
+
+    // remove_empty_categorizations deletes rows while its own query statement is still checked out.
+    const DatabaseManager::ResolvedCategory empty{0, "", ""};
+    REQUIRE(db.insert_or_update_file_with_categorization("empty1.txt", "F", "/docs", empty, false));
+    REQUIRE(db.insert_or_update_file_with_categorization("empty2.txt", "F", "/docs", empty, false));
+    CHECK(db.remove_empty_categorizations("/docs").size() == 2);
+    CHECK(db.remove_empty_categorizations("/docs").empty());
+    CHECK(db.get_categorized_files("/docs").size() == 2);
+}
+
+TEST_CASE("DatabaseManager stores categorization batches in one transaction") {
+    TempDir base_dir;
+    EnvVarGuard config_guard("AI_FILE_SORTER_CONFIG_DIR", base_dir.path().string());
+    EnvVarGuard cache_guard("CATEGORIZATION_CACHE_FILE", std::nullopt);
+    DatabaseManager db(base_dir.path().string());
+
+    const auto docs = db.resolve_category("Documents", "Reports");
+    const auto images = db.resolve_category("Images", "Photos");
+    REQUIRE(db.insert_or_update_file_with_categorization("keep.pdf", "F", "/docs", docs, false, "old.pdf"));
+
+    std::vector<DatabaseManager::CategorizationRecord> records;
+    for (int i = 0; i < 300; ++i) {
+        records.push_back({bench_file_name(i), "F", "/docs", i % 3 == 0 ? images : docs, i % 2 == 0, ""});
+    }
+    records.push_back({"keep.pdf", "F", "/docs", images, true, "new.pdf"});
+    records.push_back({"renamed.txt", "F", "/docs", DatabaseManager::ResolvedCategory{0, "", ""},
+                       false, "better.txt", true, true});
+
+    REQUIRE(db.insert_or_update_files_with_categorization(records));
+    CHECK(db.insert_or_update_files_with_categorization({}));
+
+    CHECK(db.get_categorized_files("/docs").size() == 302);
+
+    const auto updated = db.get_categorized_file("/docs", "keep.pdf", FileType::File);
+    REQUIRE(updated.has_value());
+    CHECK(updated->category == "Images");
+    CHECK(updated->suggested_name == "new.pdf");
+    CHECK(updated->used_consistency_hints);
+
+    const auto rename_only = db.get_categorized_file("/docs", "renamed.txt", FileType::File);
+    REQUIRE(rename_only.has_value());
+    CHECK(rename_only->rename_only);
+    CHECK(rename_only->rename_applied);
+    CHECK(rename_only->category.empty());
+
+    const auto db_path = base_dir.path() / "categorization_results.db";
+    CHECK(query_taxonomy_frequency(db_path, images.taxonomy_id) == 101);
+    CHECK(query_taxonomy_frequency(db_path, docs.taxonomy_id) == 200);
+}
+
+TEST_CASE("DatabaseManager subtree queries match only descendants") {
+    TempDir base_dir;
+    EnvVarGuard config_guard("AI_FILE_SORTER_CONFIG_DIR", base_dir.path().string());
+    EnvVarGuard cache_guard("CATEGORIZATION_CACHE_FILE", std::nullopt);
+    DatabaseManager db(base_dir.path().string());
+    const auto docs = db.resolve_category("Documents", "Reports");
+
+    const std::vector<std::string> dirs = {
+        "/data/a", "/data/a/b", "/data/a/b/c", "/data/ab", "/data/a_b", "/data/a%", "/data", "/other",
+        "C:\\Users\\me", "C:\\Users\\me\\docs", "C:\\Users\\meg"};
+    for (const auto& dir : dirs) {
+        REQUIRE(db.insert_or_update_file_with_categorization("f.txt", "F", dir, docs, dir == "/data/a/b/c"));
+    }
+
+    CHECK(entry_keys(db.get_categorized_files_recursive("/data/a")) ==
+          std::set<std::string>{"/data/a|f.txt", "/data/a/b|f.txt", "/data/a/b/c|f.txt"});
+    CHECK(entry_keys(db.get_categorized_files_recursive("/data/a/")) ==
+          std::set<std::string>{"/data/a/b|f.txt", "/data/a/b/c|f.txt"});
+    CHECK(entry_keys(db.get_categorized_files_recursive("C:\\Users\\me")) ==
+          std::set<std::string>{"C:\\Users\\me|f.txt", "C:\\Users\\me\\docs|f.txt"});
+    CHECK(db.get_categorized_files_recursive("").size() == dirs.size());
+
+    CHECK(db.has_categorization_style_conflict("/data/a", false, true));
+    CHECK(db.has_categorization_style_conflict("/data/ab", true, true));
+    CHECK_FALSE(db.has_categorization_style_conflict("/data/a/b/c", true, true));
+
+    REQUIRE(db.clear_directory_categorizations("/data/a", true));
+    CHECK(db.get_categorized_files_recursive("/data/a").empty());
+    CHECK(db.get_categorized_files_recursive("").size() == dirs.size() - 3);
+    CHECK(db.get_categorized_files("/data/ab").size() == 1);
+    CHECK(db.get_categorized_files("/data/a_b").size() == 1);
+    CHECK(db.get_categorized_files("/data/a%").size() == 1);
+}
+
+TEST_CASE("DatabaseManager subtree queries use the directory index") {
+    TempDir base_dir;
+    EnvVarGuard config_guard("AI_FILE_SORTER_CONFIG_DIR", base_dir.path().string());
+    EnvVarGuard cache_guard("CATEGORIZATION_CACHE_FILE", std::nullopt);
+    {
+        DatabaseManager db(base_dir.path().string());
+        const auto docs = db.resolve_category("Documents", "Reports");
+        REQUIRE(db.insert_or_update_file_with_categorization("f.txt", "F", "/data/a", docs, false));
+    }
+
+    const auto db_path = base_dir.path() / "categorization_results.db";
+    const std::string plan = query_plan(
+        db_path,
+        "SELECT file_name FROM file_categorization "
+        "WHERE dir_path = '/data/a' OR (dir_path >= '/data/a/' AND dir_path < '/data/a0');");
+    CHECK(plan.find("idx_file_categorization_dir") != std::string::npos);
+    CHECK(plan.find("SCAN file_categorization\n") == std::string::npos);
+}
+
+TEST_CASE("DatabaseManager recent categories come from the matching extension") {
+    TempDir base_dir;
+    EnvVarGuard config_guard("AI_FILE_SORTER_CONFIG_DIR", base_dir.path().string());
+    EnvVarGuard cache_guard("CATEGORIZATION_CACHE_FILE", std::nullopt);
+    DatabaseManager db(base_dir.path().string());
+
+    const auto invoices = db.resolve_category("Documents", "Invoices");
+    const auto reports = db.resolve_category("Documents", "Reports");
+    const auto photos = db.resolve_category("Images", "Photos");
+    // Many newer rows of another extension must not crowd out the PDF history.
+    REQUIRE(db.insert_or_update_file_with_categorization("old.PDF", "F", "/docs", invoices, false));
+    REQUIRE(db.insert_or_update_file_with_categorization("report.pdf", "F", "/docs", reports, false));
+    REQUIRE(db.insert_or_update_file_with_categorization("again.pdf", "F", "/docs", reports, false));
+    for (int i = 0; i < 50; ++i) {
+        REQUIRE(db.insert_or_update_file_with_categorization(
+            "img_" + std::to_string(i) + ".jpg", "F", "/docs", photos, false));
+    }
+    REQUIRE(db.insert_or_update_file_with_categorization("Makefile", "F", "/docs", reports, false));
+    REQUIRE(db.insert_or_update_file_with_categorization("pdf", "D", "/docs", photos, false));
+
+    const auto pdf_hints = db.get_recent_categories_for_extension(".PDF", FileType::File, 5);
+    REQUIRE(pdf_hints.size() == 2);
+    CHECK(pdf_hints[0] == std::make_pair(std::string("Documents"), std::string("Reports")));
+    CHECK(pdf_hints[1] == std::make_pair(std::string("Documents"), std::string("Invoices")));
+
+    CHECK(db.get_recent_categories_for_extension(".pdf", FileType::File, 1).size() == 1);
+    const auto bare = db.get_recent_categories_for_extension("", FileType::File, 5);
+    REQUIRE(bare.size() == 1);
+    CHECK(bare[0].second == "Reports");
+    const auto dirs = db.get_recent_categories_for_extension("", FileType::Directory, 5);
+    REQUIRE(dirs.size() == 1);
+    CHECK(dirs[0].first == "Images");
+
+    const std::string plan = query_plan(
+        base_dir.path() / "categorization_results.db",
+        "SELECT category, subcategory FROM file_categorization "
+        "WHERE file_type = 'F' AND extension = '.pdf' ORDER BY timestamp DESC, id DESC LIMIT 5;");
+    CHECK(plan.find("idx_file_categorization_extension") != std::string::npos);
+    CHECK(plan.find("TEMP B-TREE") == std::string::npos);
+}
+
+TEST_CASE("DatabaseManager backfills extensions for caches created before the column existed") {
+    TempDir base_dir;
+    EnvVarGuard config_guard("AI_FILE_SORTER_CONFIG_DIR", base_dir.path().string());
+    EnvVarGuard cache_guard("CATEGORIZATION_CACHE_FILE", std::nullopt);
+    const auto db_path = base_dir.path() / "categorization_results.db";
+    {
+        sqlite3* raw = nullptr;
+        REQUIRE(sqlite3_open(db_path.string().c_str(), &raw) == SQLITE_OK);
+        REQUIRE(sqlite3_exec(raw,
+                             "CREATE TABLE file_categorization (id INTEGER PRIMARY KEY AUTOINCREMENT, "
+                             "file_name TEXT NOT NULL, file_type TEXT NOT NULL, dir_path TEXT NOT NULL, "
+                             "category TEXT NOT NULL, subcategory TEXT, "
+                             "timestamp DATETIME DEFAULT CURRENT_TIMESTAMP, "
+                             "UNIQUE(file_name, file_type, dir_path));"
+                             "INSERT INTO file_categorization (file_name, file_type, dir_path, category, subcategory) "
+                             "VALUES ('setup.EXE', 'F', '/dl', 'Software', 'Installers'),"
+                             "       ('notes', 'F', '/dl', 'Documents', 'Notes');",
+                             nullptr, nullptr, nullptr) == SQLITE_OK);
+        sqlite3_close(raw);
+    }
+
+    DatabaseManager db(base_dir.path().string());
+    const auto exe_hints = db.get_recent_categories_for_extension(".exe", FileType::File, 3);
+    REQUIRE(exe_hints.size() == 1);
+    CHECK(exe_hints[0].first == "Software");
+    const auto bare = db.get_recent_categories_for_extension("", FileType::File, 3);
+    REQUIRE(bare.size() == 1);
+    CHECK(bare[0].second == "Notes");
+}
+
+TEST_CASE("DatabaseManager cache throughput benchmark", "[.][benchmark]") {
+    constexpr int kRows = 5000;
+    TempDir base_dir;
+    EnvVarGuard config_guard("AI_FILE_SORTER_CONFIG_DIR", base_dir.path().string());
+    EnvVarGuard cache_guard("CATEGORIZATION_CACHE_FILE", std::nullopt);
+
+    const BaselineRates baseline = run_uncached_baseline(base_dir.path() / "baseline.db", kRows);
+    CHECK(baseline.hits == kRows);
+
+    DatabaseManager db(base_dir.path().string());
+    const auto resolved = db.resolve_category("Documents", "Reports");
+
+    const auto insert_start = std::chrono::steady_clock::now();
+    for (int i = 0; i < kRows; ++i) {
+        db.insert_or_update_file_with_categorization(bench_file_name(i), "F", bench_dir(i), resolved, false);
+    }
+    const double inserts_per_second = per_second(kRows, std::chrono::steady_clock::now() - insert_start);
+
+    int hits = 0;
+    const auto lookup_start = std::chrono::steady_clock::now();
+    for (int i = 0; i < kRows; ++i) {
+        if (!db.get_categorization_from_db(bench_dir(i), bench_file_name(i), FileType::File).empty()) {
+            ++hits;
+        }
+    }
+    const double lookups_per_second = per_second(kRows, std::chrono::steady_clock::now() - lookup_start);
+    CHECK(hits == kRows);
+
+    std::vector<DatabaseManager::CategorizationRecord> records;
+    records.reserve(kRows);
+    for (int i = 0; i < kRows; ++i) {
+        records.push_back({"batch_" + bench_file_name(i), "F", bench_dir(i), resolved, false, ""});
+    }
+    const auto batch_start = std::chrono::steady_clock::now();
+    REQUIRE(db.insert_or_update_files_with_categorization(records));
+    const double batch_inserts_per_second = per_second(kRows, std::chrono::steady_clock::now() - batch_start);
+
+    WARN("Uncached rollback-journal baseline: " << baseline.inserts_per_second << " inserts/s, "
+         << baseline.lookups_per_second << " lookups/s");
+    WARN("DatabaseManager (WAL + statement cache): " << inserts_per_second << " inserts/s, "
+         << lookups_per_second << " lookups/s");
+    WARN("DatabaseManager single-transaction batch: " << batch_inserts_per_second << " inserts/s");
+}
@@ -0,0 +1,136 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include "DatabaseManager.hpp"
+#include "DocumentAnalysisCache.hpp"
+#include "TestHelpers.hpp"
+
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+namespace {
+
+void write_text(const std::filesystem::path& path, const std::string& text)
+{
+    std::ofstream out(path, std::ios::binary);
+    out << text;
+}
+
+void shift_mtime(const std::filesystem::path& path, std::chrono::seconds delta)
+{
+    std::filesystem::last_write_time(path, std::filesystem::last_write_time(path) + delta);
+}
+
+DocumentAnalysisResult make_result(const std::string& summary, const std::string& name)
+{
+    DocumentAnalysisResult result;
+    result.summary = summary;
+    result.suggested_name = name;
+    return result;
+}
+
+} // namespace
+
+TEST_CASE("DocumentAnalysisCache reuses analyses of unchanged documents") {
+    TempDir dir;
+    EnvVarGuard config_guard("AI_FILE_SORTER_CONFIG_DIR", dir.path().string());
+    DatabaseManager db(dir.path().string());
+    DocumentAnalysisCache cache(db);
+
+    const auto doc = dir.path() / "notes.txt";
+    const std::string content(4096, 'x');
+    write_text(doc, content);
+    const std::string path = doc.string();
+
+    CHECK_FALSE(cache.lookup(path).has_value());
+    cache.store(path, "excerpt", make_result("Budget notes", "budget_notes.txt"));
+
+    auto hit = cache.lookup(path);
+    REQUIRE(hit.has_value());
+    CHECK(hit->summary == "Budget notes");
+    CHECK(hit->suggested_name == "budget_notes.txt");
+
+    SECTION("a touched file with the same content still hits through its fingerprint") {
+        shift_mtime(doc, std::chrono::seconds(5));
+        CHECK(cache.lookup(path).has_value());
+    }
+
+    SECTION("without fingerprints a touched file misses") {
+        EnvVarGuard fingerprint_guard("AI_FILE_SORTER_CONTENT_FINGERPRINT", "0");
+        shift_mtime(doc, std::chrono::seconds(5));
+        CHECK_FALSE(cache.lookup(path).has_value());
+    }
+
+    SECTION("edited content misses") {
+        write_text(doc, content + "more");
+        CHECK_FALSE(cache.lookup(path).has_value());
+
+        std::string same_size = content;
+        same_size[10] = 'y';
+        write_text(doc, same_size);
+        shift_mtime(doc, std::chrono::seconds(5));
+        CHECK_FALSE(cache.lookup(path).has_value());
+    }
+
+    SECTION("missing files miss") {
+        std::filesystem::remove(doc);
+        CHECK_FALSE(cache.lookup(path).has_value());
+    }
+}
+
+TEST_CASE("DocumentAnalysisCache skips inference when the excerpt is unchanged") {
+    TempDir dir;
+    EnvVarGuard config_guard("AI_FILE_SORTER_CONFIG_DIR", dir.path().string());
+    DatabaseManager db(dir.path().string());
+    DocumentAnalysisCache cache(db);
+
+    const auto doc = dir.path() / "report.docx";
+    write_text(doc, "version one");
+    const std::string path = doc.string();
+    cache.store(path, "Quarterly report", make_result("Quarterly figures", "quarterly_report.docx"));
+
+    // Saved again with different bytes but the same visible text.
+    write_text(doc, "version two, longer");
+    CHECK_FALSE(cache.lookup(path).has_value());
+    CHECK_FALSE(cache.lookup_excerpt(path, "Annual report").has_value());
+    CHECK_FALSE(cache.lookup_excerpt(path, "").has_value());
+
+    auto reused = cache.lookup_excerpt(path, "Quarterly report");
+    REQUIRE(reused.has_value());
+    CHECK(reused->suggested_name == "quarterly_report.docx");
+
+    // The stored stamp was refreshed, so the next run does not even extract.
+    CHECK(cache.lookup(path).has_value());
+    CHECK(DocumentAnalysisCache::hash_excerpt("Quarterly report") ==
+          DocumentAnalysisCache::hash_excerpt("Quarterly report"));
+    CHECK(DocumentAnalysisCache::hash_excerpt("Quarterly report").size() == 16);
+}
+
+TEST_CASE("Recategorizing a folder drops its cached document analyses") {
+    TempDir dir;
+    EnvVarGuard config_guard("AI_FILE_SORTER_CONFIG_DIR", dir.path().string());
+    DatabaseManager db(dir.path().string());
+    DocumentAnalysisCache cache(db);
+
+    const auto folder = dir.path() / "docs";
+    const auto sibling = dir.path() / "docs-old";
+    std::filesystem::create_directories(folder / "nested");
+    std::filesystem::create_directories(sibling);
+    const std::string top = (folder / "top.txt").string();
+    const std::string nested = (folder / "nested" / "inner.txt").string();
+    const std::string other = (sibling / "other.txt").string();
+    for (const auto& path : {top, nested, other}) {
+        write_text(path, "contents of " + path);
+        cache.store(path, "excerpt", make_result("Summary", "summary.txt"));
+    }
+
+    REQUIRE(db.clear_directory_categorizations(folder.string()));
+    CHECK_FALSE(cache.lookup(top).has_value());
+    CHECK(cache.lookup(nested).has_value());
+    CHECK(cache.lookup(other).has_value());
+
+    REQUIRE(db.clear_directory_categorizations(folder.string(), true));
+    CHECK_FALSE(cache.lookup(nested).has_value());
+    CHECK(cache.lookup(other).has_value());
+}
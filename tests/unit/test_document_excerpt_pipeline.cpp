@@ -0,0 +1,115 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include "DocumentExcerptPipeline.hpp"
+#include "TestHelpers.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+std::vector<std::filesystem::path> numbered_paths(int count)
+{
+    std::vector<std::filesystem::path> paths;
+    for (int i = 0; i < count; ++i) {
+        paths.emplace_back("doc" + std::to_string(i) + ".txt");
+    }
+    return paths;
+}
+
+} // namespace
+
+TEST_CASE("DocumentExcerptPipeline returns excerpts in order") {
+    DocumentExcerptPipeline pipeline(
+        numbered_paths(12),
+        [](const std::filesystem::path& path) {
+            const std::string name = path.stem().string();
+            const int index = std::stoi(name.substr(3));
+            // Later documents finish first so results complete out of order.
+            std::this_thread::sleep_for(std::chrono::milliseconds((12 - index) % 4 * 5));
+            if (index == 5) {
+                throw std::runtime_error("corrupt archive");
+            }
+            return index == 7 ? std::string() : "text " + name;
+        },
+        4,
+        6);
+
+    for (int i = 0; i < 12; ++i) {
+        auto excerpt = pipeline.next();
+        REQUIRE(excerpt.has_value());
+        const std::string name = "doc" + std::to_string(i);
+        CHECK(excerpt->path == std::filesystem::path(name + ".txt"));
+        if (i == 5) {
+            REQUIRE(excerpt->error.has_value());
+            CHECK(*excerpt->error == "corrupt archive");
+        } else if (i == 7) {
+            CHECK_FALSE(excerpt->error.has_value());
+            CHECK(excerpt->text.empty());
+        } else {
+            CHECK(excerpt->text == "text " + name);
+        }
+    }
+    CHECK_FALSE(pipeline.next().has_value());
+}
+
+TEST_CASE("DocumentExcerptPipeline stays within the lookahead window") {
+    constexpr std::size_t kLookahead = 3;
+    std::atomic<std::size_t> started{0};
+    DocumentExcerptPipeline pipeline(
+        numbered_paths(10),
+        [&started](const std::filesystem::path& path) {
+            ++started;
+            return path.string();
+        },
+        4,
+        kLookahead);
+
+    for (std::size_t taken = 0; taken < 10; ++taken) {
+        // Give the workers time to run ahead as far as they are allowed to.
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        CHECK(started.load() <= taken + kLookahead);
+        REQUIRE(pipeline.next().has_value());
+    }
+    CHECK(started.load() == 10);
+}
+
+TEST_CASE("DocumentExcerptPipeline stops extracting once cancelled") {
+    std::atomic<std::size_t> started{0};
+    {
+        DocumentExcerptPipeline pipeline(
+            numbered_paths(50),
+            [&started](const std::filesystem::path& path) {
+                ++started;
+                return path.string();
+            },
+            2,
+            2);
+        REQUIRE(pipeline.next().has_value());
+        pipeline.cancel();
+        CHECK_FALSE(pipeline.next().has_value());
+    }
+    CHECK(started.load() <= 3);
+}
+
+TEST_CASE("DocumentExcerptPipeline thread count honors the environment override") {
+    {
+        EnvVarGuard guard("AI_FILE_SORTER_DOCUMENT_THREADS", "3");
+        CHECK(DocumentExcerptPipeline::resolve_thread_count() == 3);
+    }
+    {
+        EnvVarGuard guard("AI_FILE_SORTER_DOCUMENT_THREADS", "1000");
+        CHECK(DocumentExcerptPipeline::resolve_thread_count() == 32);
+    }
+    {
+        EnvVarGuard guard("AI_FILE_SORTER_DOCUMENT_THREADS", "0");
+        const std::size_t threads = DocumentExcerptPipeline::resolve_thread_count();
+        CHECK(threads >= 1);
+        CHECK(threads <= 4);
+    }
+}
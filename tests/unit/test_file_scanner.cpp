@@ -2,6 +2,7 @@
 #include "FileScanner.hpp"
 #include "TestHelpers.hpp"
 #include <algorithm>
+#include <chrono>
 #include <fstream>
 #include <filesystem>
 #ifdef _WIN32
@@ -87,6 +88,103 @@ TEST_CASE("recursive scans include nested files") {
     }));
 }
 
+namespace {
+
+// Builds a tree with nested directories, hidden entries, junk files and a bundle.
+void build_scan_tree(const std::filesystem::path& root, int breadth, int depth) {
+    for (int i = 0; i < breadth; ++i) {
+        const auto dir = root / ("dir_" + std::to_string(i));
+        std::filesystem::create_directories(dir);
+        write_file(dir / ("file_" + std::to_string(i) + ".txt"));
+        write_file(dir / ".hidden.txt");
+        write_file(dir / ".DS_Store");
+        if (i == 0) {
+            std::filesystem::create_directories(dir / "Tool.app" / "Contents");
+            write_file(dir / "Tool.app" / "Contents" / "inner.txt");
+            write_file(dir / ".cache" / "cached.txt");
+        }
+        if (depth > 1) {
+            build_scan_tree(dir, breadth, depth - 1);
+        }
+    }
+}
+
+std::vector<std::string> describe(const std::vector<FileEntry>& entries) {
+    std::vector<std::string> described;
+    described.reserve(entries.size());
+    for (const auto& entry : entries) {
+        described.push_back(entry.full_path + "|" + entry.file_name + "|" + to_string(entry.type));
+    }
+    return described;
+}
+
+} // namespace
+
+TEST_CASE("parallel recursive scans match the sequential scan order") {
+    TempDir temp_dir;
+    build_scan_tree(temp_dir.path(), 4, 4);
+    const auto options = FileScanOptions::Files | FileScanOptions::Directories | FileScanOptions::Recursive;
+
+    FileScanner scanner;
+    std::vector<FileEntry> sequential;
+    {
+        EnvVarGuard threads("AI_FILE_SORTER_SCAN_THREADS", std::string("1"));
+        sequential = scanner.get_directory_entries(temp_dir.path().string(), options);
+    }
+    // 340 directories, 340 text files and 85 bundles; hidden, junk and bundle contents are excluded.
+    REQUIRE(sequential.size() == 765);
+    CHECK(std::any_of(sequential.begin(), sequential.end(), [](const FileEntry& entry) {
+        return entry.file_name == "Tool.app" && entry.type == FileType::File;
+    }));
+
+    for (const char* thread_count : {"2", "8"}) {
+        EnvVarGuard threads("AI_FILE_SORTER_SCAN_THREADS", std::string(thread_count));
+        for (int round = 0; round < 3; ++round) {
+            const auto parallel = scanner.get_directory_entries(temp_dir.path().string(), options);
+            REQUIRE(describe(parallel) == describe(sequential));
+        }
+    }
+
+    EnvVarGuard threads("AI_FILE_SORTER_SCAN_THREADS", std::string("4"));
+    CHECK_THROWS(scanner.get_directory_entries((temp_dir.path() / "missing").string(), options));
+}
+
+TEST_CASE("streaming scans deliver scan results in order and in batches") {
+    TempDir temp_dir;
+    build_scan_tree(temp_dir.path(), 3, 3);
+    const auto options = FileScanOptions::Files | FileScanOptions::Directories | FileScanOptions::Recursive;
+    EnvVarGuard threads("AI_FILE_SORTER_SCAN_THREADS", std::string("1"));
+
+    FileScanner scanner;
+    const auto expected = scanner.get_directory_entries(temp_dir.path().string(), options);
+
+    // With more than one scan thread the directories are listed ahead of the walk.
+    for (const char* thread_count : {"1", "4"}) {
+        EnvVarGuard streaming_threads("AI_FILE_SORTER_SCAN_THREADS", std::string(thread_count));
+        std::vector<FileEntry> streamed;
+        std::size_t batches = 0;
+        scanner.scan_directory_entries(temp_dir.path().string(), options, 7,
+                                       [&](std::vector<FileEntry>&& batch) {
+                                           CHECK_FALSE(batch.empty());
+                                           CHECK(batch.size() <= 7);
+                                           ++batches;
+                                           streamed.insert(streamed.end(), batch.begin(), batch.end());
+                                           return true;
+                                       });
+        CHECK(describe(streamed) == describe(expected));
+        CHECK(batches >= expected.size() / 7);
+    }
+
+    std::size_t delivered = 0;
+    EnvVarGuard stopped_threads("AI_FILE_SORTER_SCAN_THREADS", std::string("4"));
+    scanner.scan_directory_entries(temp_dir.path().string(), options, 5,
+                                   [&](std::vector<FileEntry>&& batch) {
+                                       delivered += batch.size();
+                                       return false;
+                                   });
+    CHECK(delivered == 5);
+}
+
 #ifndef _WIN32
 class PermissionRestore {
 public:
@@ -142,3 +240,64 @@ TEST_CASE("recursive scans skip unreadable directories and continue") {
     CHECK(entries.front().file_name == "keep.txt");
 }
 #endif
+
+#ifdef __linux__
+TEST_CASE("getdents scan backend matches the std::filesystem backend") {
+    TempDir temp_dir;
+    build_scan_tree(temp_dir.path(), 3, 3);
+    std::filesystem::create_directory_symlink(temp_dir.path() / "dir_1", temp_dir.path() / "dir_link");
+    std::filesystem::create_symlink(temp_dir.path() / "dir_0" / "file_0.txt", temp_dir.path() / "file_link.txt");
+    std::filesystem::create_symlink(temp_dir.path() / "missing.txt", temp_dir.path() / "dangling.txt");
+
+    FileScanner scanner;
+    const auto run = [&](const char* backend, FileScanOptions options) {
+        EnvVarGuard guard("AI_FILE_SORTER_SCAN_BACKEND", std::string(backend));
+        EnvVarGuard threads("AI_FILE_SORTER_SCAN_THREADS", std::string("1"));
+        return describe(scanner.get_directory_entries(temp_dir.path().string(), options));
+    };
+
+    const auto all = FileScanOptions::Files | FileScanOptions::Directories;
+    for (const auto options : {all, all | FileScanOptions::HiddenFiles,
+                               all | FileScanOptions::Recursive,
+                               FileScanOptions::Files | FileScanOptions::Recursive}) {
+        const auto native = run("native", options);
+        CHECK_FALSE(native.empty());
+        CHECK(native == run("std", options));
+    }
+
+    const auto top_level = run("native", all);
+    CHECK(std::find(top_level.begin(), top_level.end(),
+                    (temp_dir.path() / "dir_link").string() + "|dir_link|Directory") != top_level.end());
+    CHECK(std::find(top_level.begin(), top_level.end(),
+                    (temp_dir.path() / "file_link.txt").string() + "|file_link.txt|File") != top_level.end());
+
+    EnvVarGuard guard("AI_FILE_SORTER_SCAN_BACKEND", std::string("native"));
+    CHECK_THROWS(scanner.get_directory_entries((temp_dir.path() / "missing").string(), all));
+}
+
+TEST_CASE("Scan backend benchmark", "[.][benchmark]") {
+    TempDir temp_dir;
+    build_scan_tree(temp_dir.path(), 8, 4);
+    const auto options = FileScanOptions::Files | FileScanOptions::Directories | FileScanOptions::Recursive;
+    EnvVarGuard threads("AI_FILE_SORTER_SCAN_THREADS", std::string("1"));
+    FileScanner scanner;
+
+    const auto time_backend = [&](const char* backend, std::size_t& count) {
+        EnvVarGuard guard("AI_FILE_SORTER_SCAN_BACKEND", std::string(backend));
+        const auto start = std::chrono::steady_clock::now();
+        for (int round = 0; round < 5; ++round) {
+            count = scanner.get_directory_entries(temp_dir.path().string(), options).size();
+        }
+        return std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - start).count() / 5;
+    };
+
+    std::size_t std_count = 0;
+    std::size_t native_count = 0;
+    const auto std_micros = time_backend("std", std_count);
+    const auto native_micros = time_backend("native", native_count);
+    CHECK(std_count == native_count);
+    WARN("Recursive scan of " << std_count << " entries: std::filesystem " << std_micros
+         << " us; getdents64 " << native_micros << " us");
+}
+#endif
@@ -0,0 +1,214 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include "FileScanner.hpp"
+#include "FolderWatcher.hpp"
+#include "TestHelpers.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+void write_file(const std::filesystem::path& path)
+{
+    std::filesystem::create_directories(path.parent_path());
+    std::ofstream out(path);
+    out << "data";
+}
+
+// Collects batches from the watcher thread and lets the test wait for them.
+class BatchRecorder {
+public:
+    FolderWatcher::BatchCallback callback()
+    {
+        return [this](std::vector<FileEntry>&& batch) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            batches_.push_back(std::move(batch));
+            cv_.notify_all();
+        };
+    }
+
+    bool wait_for_names(const std::set<std::string>& expected,
+                        std::chrono::seconds timeout = std::chrono::seconds(10))
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        return cv_.wait_for(lock, timeout, [&] {
+            const auto seen = names_locked();
+            return std::includes(seen.begin(), seen.end(), expected.begin(), expected.end());
+        });
+    }
+
+    std::vector<std::vector<FileEntry>> batches()
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return batches_;
+    }
+
+    std::set<std::string> names()
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return names_locked();
+    }
+
+private:
+    std::set<std::string> names_locked() const
+    {
+        std::set<std::string> names;
+        for (const auto& batch : batches_) {
+            for (const auto& entry : batch) {
+                names.insert(entry.file_name);
+            }
+        }
+        return names;
+    }
+
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    std::vector<std::vector<FileEntry>> batches_;
+};
+
+FolderWatcher::Options fast_options(bool force_polling)
+{
+    FolderWatcher::Options options;
+    options.debounce = std::chrono::milliseconds(200);
+    options.max_delay = std::chrono::milliseconds(2000);
+    options.poll_interval = std::chrono::milliseconds(100);
+    options.force_polling = force_polling;
+    return options;
+}
+
+} // namespace
+
+TEST_CASE("Polling watcher coalesces a burst into batches of new files only") {
+    TempDir dir;
+    write_file(dir.path() / "existing.txt");
+
+    FileScanner scanner;
+    auto options = fast_options(true);
+    options.batch_size = 2;
+    FolderWatcher watcher(scanner, dir.path().string(), FileScanOptions::Files, options);
+    BatchRecorder recorder;
+    watcher.start(recorder.callback());
+    CHECK(watcher.is_running());
+    REQUIRE(watcher.wait_until_watching(std::chrono::seconds(10)));
+    CHECK(watcher.backend() == FolderWatcher::Backend::Polling);
+
+    write_file(dir.path() / "a.txt");
+    write_file(dir.path() / "b.txt");
+    write_file(dir.path() / "c.txt");
+
+    REQUIRE(recorder.wait_for_names({"a.txt", "b.txt", "c.txt"}));
+    watcher.stop();
+    CHECK_FALSE(watcher.is_running());
+
+    CHECK(recorder.names() == std::set<std::string>{"a.txt", "b.txt", "c.txt"});
+    for (const auto& batch : recorder.batches()) {
+        CHECK(batch.size() <= 2);
+    }
+}
+
+TEST_CASE("Watcher start fails for a missing folder") {
+    TempDir dir;
+    FileScanner scanner;
+    FolderWatcher watcher(scanner, (dir.path() / "missing").string(), FileScanOptions::Files, fast_options(true));
+    CHECK_THROWS_AS(watcher.start([](std::vector<FileEntry>&&) {}), std::filesystem::filesystem_error);
+    CHECK_FALSE(watcher.is_running());
+    CHECK_FALSE(watcher.wait_until_watching(std::chrono::milliseconds(10)));
+}
+
+TEST_CASE("Watcher start returns before the initial walk and stop cancels it") {
+    TempDir dir;
+    for (int i = 0; i < 200; ++i) {
+        write_file(dir.path() / ("d" + std::to_string(i)) / "nested" / "file.txt");
+    }
+
+    FileScanner scanner;
+    FolderWatcher watcher(scanner,
+                          dir.path().string(),
+                          FileScanOptions::Files | FileScanOptions::Recursive,
+                          fast_options(false));
+    watcher.start([](std::vector<FileEntry>&&) {});
+    CHECK(watcher.is_running());
+    watcher.stop();
+    CHECK_FALSE(watcher.is_running());
+    CHECK_FALSE(watcher.wait_until_watching(std::chrono::milliseconds(10)));
+
+    BatchRecorder recorder;
+    watcher.start(recorder.callback());
+    REQUIRE(watcher.wait_until_watching(std::chrono::seconds(10)));
+    write_file(dir.path() / "d7" / "nested" / "new.txt");
+    CHECK(recorder.wait_for_names({"new.txt"}));
+    watcher.stop();
+}
+
+TEST_CASE("Watcher reports requeued entries again with its next flush") {
+    TempDir dir;
+    FileScanner scanner;
+    FolderWatcher watcher(scanner, dir.path().string(), FileScanOptions::Files, fast_options(true));
+    CHECK(watcher.watched_path() == dir.path().string());
+    CHECK(watcher.watched_scan_options() == FileScanOptions::Files);
+    BatchRecorder recorder;
+    watcher.start(recorder.callback());
+    REQUIRE(watcher.wait_until_watching(std::chrono::seconds(10)));
+
+    write_file(dir.path() / "kept.txt");
+    write_file(dir.path() / "removed.txt");
+    REQUIRE(recorder.wait_for_names({"kept.txt", "removed.txt"}));
+    std::vector<FileEntry> skipped;
+    for (auto& batch : recorder.batches()) {
+        skipped.insert(skipped.end(), batch.begin(), batch.end());
+    }
+    const auto first_pass = recorder.batches().size();
+
+    // Entries gone by the next flush are dropped.
+    std::filesystem::remove(dir.path() / "removed.txt");
+    watcher.requeue(skipped);
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+    while (recorder.batches().size() == first_pass && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    }
+    watcher.stop();
+
+    const auto batches = recorder.batches();
+    REQUIRE(batches.size() == first_pass + 1);
+    REQUIRE(batches.back().size() == 1);
+    CHECK(batches.back().front().file_name == "kept.txt");
+}
+
+#ifdef __linux__
+TEST_CASE("Inotify watcher reports finished downloads and new subfolders") {
+    TempDir dir;
+    FileScanner scanner;
+    FolderWatcher watcher(scanner,
+                          dir.path().string(),
+                          FileScanOptions::Files | FileScanOptions::Recursive,
+                          fast_options(false));
+    BatchRecorder recorder;
+    watcher.start(recorder.callback());
+    REQUIRE(watcher.wait_until_watching(std::chrono::seconds(10)));
+    if (watcher.backend() != FolderWatcher::Backend::Inotify) {
+        SKIP("inotify is not available here");
+    }
+
+    // A partial download renamed into place shows up once, under its final name.
+    write_file(dir.path() / "report.pdf.part");
+    std::filesystem::rename(dir.path() / "report.pdf.part", dir.path() / "report.pdf");
+    write_file(dir.path() / "incoming" / "nested" / "photo.jpg");
+
+    REQUIRE(recorder.wait_for_names({"report.pdf", "photo.jpg"}));
+    CHECK(recorder.names() == std::set<std::string>{"report.pdf", "photo.jpg"});
+
+    // The new subfolders are watched from now on.
+    write_file(dir.path() / "incoming" / "nested" / "later.txt");
+    CHECK(recorder.wait_for_names({"later.txt"}));
+    watcher.stop();
+}
+#endif
@@ -0,0 +1,258 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include "DatabaseManager.hpp"
+#include "FileScanner.hpp"
+#include "IncrementalScanner.hpp"
+#include "TestHelpers.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace {
+
+void write_file(const std::filesystem::path& path)
+{
+    std::filesystem::create_directories(path.parent_path());
+    std::ofstream out(path);
+    out << "data";
+}
+
+// Pushes every directory mtime well before the scan so the racy-window check does not force a relisting.
+void age_directories(const std::filesystem::path& root)
+{
+    const auto old_time = std::filesystem::file_time_type::clock::now() - std::chrono::hours(1);
+    std::filesystem::last_write_time(root, old_time);
+    for (const auto& entry : std::filesystem::recursive_directory_iterator(root)) {
+        if (entry.is_directory()) {
+            std::filesystem::last_write_time(entry.path(), old_time);
+        }
+    }
+}
+
+std::size_t count_directories(const std::filesystem::path& root)
+{
+    std::size_t count = 1;
+    for (const auto& entry : std::filesystem::recursive_directory_iterator(root)) {
+        count += entry.is_directory() ? 1 : 0;
+    }
+    return count;
+}
+
+std::vector<std::string> describe(const std::vector<FileEntry>& entries)
+{
+    std::vector<std::string> described;
+    described.reserve(entries.size());
+    for (const auto& entry : entries) {
+        described.push_back(entry.full_path + (entry.type == FileType::File ? " F" : " D"));
+    }
+    return described;
+}
+
+std::set<std::string> names_of(const std::vector<FileEntry>& entries)
+{
+    std::set<std::string> names;
+    for (const auto& entry : entries) {
+        names.insert(entry.file_name);
+    }
+    return names;
+}
+
+void build_tree(const std::filesystem::path& root)
+{
+    write_file(root / "top.txt");
+    write_file(root / "alpha" / "a1.txt");
+    write_file(root / "alpha" / "a2.txt");
+    write_file(root / "alpha" / "deep" / "d1.txt");
+    write_file(root / "beta" / "b1.txt");
+    write_file(root / "stable" / "s1.txt");
+    write_file(root / "gone" / "g1.txt");
+    write_file(root / "gone" / "inner" / "g2.txt");
+}
+
+} // namespace
+
+TEST_CASE("Incremental rescans reuse unchanged directories and match a full scan") {
+    TempDir config_dir;
+    TempDir tree_dir;
+    EnvVarGuard cache_guard("CATEGORIZATION_CACHE_FILE", std::nullopt);
+    build_tree(tree_dir.path());
+    age_directories(tree_dir.path());
+
+    DatabaseManager db(config_dir.path().string());
+    FileScanner scanner;
+    IncrementalScanner incremental(scanner, db);
+    const std::string root = tree_dir.path().string();
+    const auto options = FileScanOptions::Files | FileScanOptions::Directories | FileScanOptions::Recursive;
+    const auto expected = describe(scanner.get_directory_entries(root, options));
+    const std::size_t directory_count = count_directories(tree_dir.path());
+
+    const auto first = incremental.scan(root, options);
+    CHECK_FALSE(first.had_snapshot);
+    CHECK(first.directories_listed == directory_count);
+    CHECK(first.added.empty());
+    CHECK(describe(first.entries) == expected);
+
+    const auto second = incremental.scan(root, options);
+    CHECK(second.had_snapshot);
+    CHECK(second.directories_listed == 0);
+    CHECK(second.directories_reused == directory_count);
+    CHECK(second.added.empty());
+    CHECK(second.removed.empty());
+    CHECK(second.renamed.empty());
+    CHECK(describe(second.entries) == expected);
+
+    SECTION("snapshots are kept per option mask") {
+        const auto files_only = FileScanOptions::Files | FileScanOptions::Recursive;
+        const auto files = incremental.scan(root, files_only);
+        CHECK_FALSE(files.had_snapshot);
+        CHECK(describe(files.entries) == describe(scanner.get_directory_entries(root, files_only)));
+        CHECK(incremental.scan(root, files_only).directories_listed == 0);
+    }
+}
+
+TEST_CASE("Incremental rescans report added, removed and renamed entries") {
+    TempDir config_dir;
+    TempDir tree_dir;
+    EnvVarGuard cache_guard("CATEGORIZATION_CACHE_FILE", std::nullopt);
+    build_tree(tree_dir.path());
+    age_directories(tree_dir.path());
+
+    DatabaseManager db(config_dir.path().string());
+    FileScanner scanner;
+    IncrementalScanner incremental(scanner, db);
+    const std::string root = tree_dir.path().string();
+    const auto options = FileScanOptions::Files | FileScanOptions::Recursive;
+    incremental.scan(root, options);
+
+    write_file(tree_dir.path() / "beta" / "b2.txt");
+    std::filesystem::remove(tree_dir.path() / "alpha" / "a2.txt");
+    std::filesystem::remove_all(tree_dir.path() / "gone");
+    std::filesystem::rename(tree_dir.path() / "alpha" / "deep" / "d1.txt",
+                            tree_dir.path() / "beta" / "moved.txt");
+
+    const auto delta = incremental.scan(root, options);
+    CHECK(delta.had_snapshot);
+    CHECK(describe(delta.entries) == describe(scanner.get_directory_entries(root, options)));
+    CHECK(delta.directories_reused == 1);
+    CHECK(names_of(delta.added) == std::set<std::string>{"b2.txt"});
+    CHECK(names_of(delta.removed) == std::set<std::string>{"a2.txt", "g1.txt", "g2.txt"});
+#ifndef _WIN32
+    REQUIRE(delta.renamed.size() == 1);
+    CHECK(delta.renamed.front().from.file_name == "d1.txt");
+    CHECK(delta.renamed.front().to.full_path == (tree_dir.path() / "beta" / "moved.txt").string());
+#endif
+
+    // Directories touched moments ago stay within the racy window and are listed again.
+    const auto again = incremental.scan(root, options);
+    CHECK(again.directories_listed > 0);
+    CHECK(again.added.empty());
+    CHECK(again.removed.empty());
+    CHECK(again.renamed.empty());
+    CHECK(describe(again.entries) == describe(scanner.get_directory_entries(root, options)));
+}
+
+TEST_CASE("Incremental rescans without change tracking leave the delta lists empty") {
+    TempDir config_dir;
+    TempDir tree_dir;
+    EnvVarGuard cache_guard("CATEGORIZATION_CACHE_FILE", std::nullopt);
+    build_tree(tree_dir.path());
+    age_directories(tree_dir.path());
+
+    DatabaseManager db(config_dir.path().string());
+    FileScanner scanner;
+    IncrementalScanner incremental(scanner, db);
+    const std::string root = tree_dir.path().string();
+    const auto options = FileScanOptions::Files | FileScanOptions::Recursive;
+    incremental.scan(root, options, false);
+
+    write_file(tree_dir.path() / "beta" / "b2.txt");
+    std::filesystem::remove_all(tree_dir.path() / "gone");
+
+    const auto delta = incremental.scan(root, options, false);
+    CHECK(delta.had_snapshot);
+    CHECK(delta.directories_reused > 0);
+    CHECK(delta.added.empty());
+    CHECK(delta.removed.empty());
+    CHECK(delta.renamed.empty());
+    CHECK(describe(delta.entries) == describe(scanner.get_directory_entries(root, options)));
+}
+
+TEST_CASE("Streaming incremental scans deliver the full listing in batches") {
+    TempDir config_dir;
+    TempDir tree_dir;
+    EnvVarGuard cache_guard("CATEGORIZATION_CACHE_FILE", std::nullopt);
+    build_tree(tree_dir.path());
+    age_directories(tree_dir.path());
+
+    DatabaseManager db(config_dir.path().string());
+    FileScanner scanner;
+    IncrementalScanner incremental(scanner, db);
+    const std::string root = tree_dir.path().string();
+    const auto options = FileScanOptions::Files | FileScanOptions::Recursive;
+
+    SECTION("a stopped scan leaves no snapshot behind") {
+        std::size_t batches = 0;
+        incremental.scan(root, options, 1, [&](std::vector<FileEntry>&&) {
+            ++batches;
+            return false;
+        });
+        CHECK(batches == 1);
+        CHECK_FALSE(incremental.scan(root, options).had_snapshot);
+    }
+
+    SECTION("streamed entries match a full scan before and after the snapshot exists") {
+        for (int pass = 0; pass < 2; ++pass) {
+            std::vector<FileEntry> streamed;
+            const auto delta = incremental.scan(root, options, 2, [&](std::vector<FileEntry>&& batch) {
+                CHECK(batch.size() <= 2);
+                streamed.insert(streamed.end(), batch.begin(), batch.end());
+                return true;
+            });
+            CHECK(delta.entries.empty());
+            CHECK(delta.had_snapshot == (pass == 1));
+            CHECK(describe(streamed) == describe(scanner.get_directory_entries(root, options)));
+        }
+    }
+}
+
+TEST_CASE("Incremental rescan benchmark", "[.][benchmark]") {
+    TempDir config_dir;
+    TempDir tree_dir;
+    EnvVarGuard cache_guard("CATEGORIZATION_CACHE_FILE", std::nullopt);
+    for (int dir = 0; dir < 500; ++dir) {
+        const auto path = tree_dir.path() / ("dir_" + std::to_string(dir / 50)) / ("sub_" + std::to_string(dir));
+        for (int file = 0; file < 100; ++file) {
+            write_file(path / ("file_" + std::to_string(file) + ".txt"));
+        }
+    }
+    age_directories(tree_dir.path());
+
+    DatabaseManager db(config_dir.path().string());
+    FileScanner scanner;
+    IncrementalScanner incremental(scanner, db);
+    const std::string root = tree_dir.path().string();
+    const auto options = FileScanOptions::Files | FileScanOptions::Recursive;
+
+    const auto time_micros = [](auto&& run) {
+        const auto start = std::chrono::steady_clock::now();
+        run();
+        return std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - start).count();
+    };
+
+    std::size_t full_count = 0;
+    const auto full_micros = time_micros([&] { full_count = scanner.get_directory_entries(root, options).size(); });
+    const auto first_micros = time_micros([&] { incremental.scan(root, options); });
+    IncrementalScanner::ScanDelta rescan;
+    const auto rescan_micros = time_micros([&] { rescan = incremental.scan(root, options); });
+    CHECK(rescan.entries.size() == full_count);
+    CHECK(rescan.directories_listed == 0);
+    WARN("Scan of " << full_count << " entries: full " << full_micros << " us; first incremental "
+         << first_micros << " us; unchanged rescan " << rescan_micros << " us");
+}
@@ -28,6 +28,23 @@ TEST_CASE("LlavaImageAnalyzer uses conservative default visual batch sizing") {
 #endif
 }
 
+TEST_CASE("LlavaImageAnalyzer asks for the filename in the description context by default") {
+    {
+        EnvVarGuard single_pass("AI_FILE_SORTER_VISUAL_SINGLE_PASS", std::nullopt);
+        CHECK(LlavaImageAnalyzer::Settings{}.single_pass);
+        CHECK(LlavaImageAnalyzerTestAccess::resolve_single_pass(true));
+        CHECK_FALSE(LlavaImageAnalyzerTestAccess::resolve_single_pass(false));
+    }
+    {
+        EnvVarGuard single_pass("AI_FILE_SORTER_VISUAL_SINGLE_PASS", "0");
+        CHECK_FALSE(LlavaImageAnalyzerTestAccess::resolve_single_pass(true));
+    }
+    {
+        EnvVarGuard single_pass("AI_FILE_SORTER_VISUAL_SINGLE_PASS", "1");
+        CHECK(LlavaImageAnalyzerTestAccess::resolve_single_pass(false));
+    }
+}
+
 #ifndef GGML_USE_METAL
 TEST_CASE("LlavaImageAnalyzer ignores global GPU layer override by default") {
     TempModelFile model(48, 8 * 1024 * 1024);
@@ -0,0 +1,98 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include "PdfTextExtractor.hpp"
+#include "TestHelpers.hpp"
+
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace {
+
+#if defined(AI_FILE_SORTER_USE_PDFIUM)
+// Writes a minimal PDF with one line of Helvetica text per page.
+void write_pdf(const std::filesystem::path& path, const std::vector<std::string>& pages)
+{
+    std::vector<std::string> objects;
+    std::string kids;
+    for (std::size_t i = 0; i < pages.size(); ++i) {
+        kids += std::to_string(4 + 2 * i) + " 0 R ";
+    }
+    objects.push_back("<< /Type /Catalog /Pages 2 0 R >>");
+    objects.push_back("<< /Type /Pages /Kids [" + kids + "] /Count " + std::to_string(pages.size()) + " >>");
+    objects.push_back("<< /Type /Font /Subtype /Type1 /BaseFont /Helvetica >>");
+    for (std::size_t i = 0; i < pages.size(); ++i) {
+        const std::string stream = "BT /F1 12 Tf 72 712 Td (" + pages[i] + ") Tj ET";
+        objects.push_back("<< /Type /Page /Parent 2 0 R /MediaBox [0 0 612 792] "
+                          "/Resources << /Font << /F1 3 0 R >> >> /Contents " +
+                          std::to_string(5 + 2 * i) + " 0 R >>");
+        objects.push_back("<< /Length " + std::to_string(stream.size()) + " >>\nstream\n" + stream +
+                          "\nendstream");
+    }
+
+    std::string pdf = "%PDF-1.4\n";
+    std::vector<std::size_t> offsets;
+    for (std::size_t i = 0; i < objects.size(); ++i) {
+        offsets.push_back(pdf.size());
+        pdf += std::to_string(i + 1) + " 0 obj\n" + objects[i] + "\nendobj\n";
+    }
+    const std::size_t xref = pdf.size();
+    pdf += "xref\n0 " + std::to_string(objects.size() + 1) + "\n0000000000 65535 f \n";
+    for (const std::size_t offset : offsets) {
+        char line[32];
+        std::snprintf(line, sizeof(line), "%010zu 00000 n \n", offset);
+        pdf += line;
+    }
+    pdf += "trailer\n<< /Size " + std::to_string(objects.size() + 1) + " /Root 1 0 R >>\nstartxref\n" +
+           std::to_string(xref) + "\n%%EOF\n";
+
+    std::ofstream out(path, std::ios::binary);
+    out << pdf;
+}
+#endif
+
+} // namespace
+
+TEST_CASE("PdfTextExtractor converts UTF-16 without Qt") {
+    const std::vector<std::uint16_t> units = {
+        u'A', 0x00E9, 0x20AC, 0xD83D, 0xDE00, 0xD800, u'B', 0xDC00
+    };
+    std::string out = "x";
+    PdfTextExtractor::append_utf16(units.data(), units.size(), out);
+    CHECK(out == "xA\xC3\xA9\xE2\x82\xAC\xF0\x9F\x98\x80\xEF\xBF\xBD" "B\xEF\xBF\xBD");
+}
+
+#if defined(AI_FILE_SORTER_USE_PDFIUM)
+TEST_CASE("PdfTextExtractor honors the page and character budgets") {
+    TempDir dir;
+    const auto pdf = dir.path() / "three_pages.pdf";
+    write_pdf(pdf, {"Alpha invoice", "Beta invoice", "Gamma invoice"});
+    auto& extractor = PdfTextExtractor::instance();
+    const auto before = extractor.metrics();
+
+    PdfTextExtractor::Budget budget;
+    const std::string all = extractor.extract(pdf, budget);
+    CHECK(all.find("Alpha invoice") != std::string::npos);
+    CHECK(all.find("Gamma invoice") != std::string::npos);
+
+    budget.max_pages = 1;
+    const std::string first = extractor.extract(pdf, budget);
+    CHECK(first.find("Alpha invoice") != std::string::npos);
+    CHECK(first.find("Beta") == std::string::npos);
+
+    budget.max_pages = 50;
+    budget.max_characters = 5;
+    CHECK(extractor.extract(pdf, budget) == "Alpha");
+
+    CHECK(extractor.extract(dir.path() / "missing.pdf", budget).empty());
+
+    const auto after = extractor.metrics();
+    CHECK(after.documents - before.documents == 3);
+    CHECK(after.pages - before.pages == 5);
+    CHECK(after.budget_stops - before.budget_stops == 1);
+    CHECK(after.pages_per_second() > 0.0);
+}
+#endif
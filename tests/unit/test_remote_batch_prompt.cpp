@@ -0,0 +1,145 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include "RemoteBatchPrompt.hpp"
+#include "TestHelpers.hpp"
+
+#include <string>
+#include <vector>
+
+namespace {
+std::vector<CategorizationRequest> make_requests()
+{
+    return {
+        CategorizationRequest{"setup.exe", "/home/user/Downloads/setup.exe", FileType::File, "shared hint"},
+        CategorizationRequest{"taxes.pdf", "/home/user/Documents/taxes.pdf", FileType::File, "shared hint"},
+        CategorizationRequest{"Photos", "/home/user/Photos", FileType::Directory, "shared hint"},
+    };
+}
+} // namespace
+
+TEST_CASE("Remote batch prompt lists items by id and shares identical context") {
+    const auto requests = make_requests();
+    const std::string prompt = RemoteBatchPrompt::build_user_prompt(requests);
+
+    CHECK(prompt.find("{\"id\":1,") != std::string::npos);
+    CHECK(prompt.find("{\"id\":3,") != std::string::npos);
+    CHECK(prompt.find("\"type\":\"directory\"") != std::string::npos);
+    CHECK(prompt.find("/home/user/Documents/taxes.pdf") != std::string::npos);
+
+    const auto first = prompt.find("shared hint");
+    REQUIRE(first != std::string::npos);
+    CHECK(prompt.find("shared hint", first + 1) == std::string::npos);
+    CHECK(prompt.find("\"context\"") == std::string::npos);
+
+    auto mixed = requests;
+    mixed[1].consistency_context = "other hint";
+    const std::string mixed_prompt = RemoteBatchPrompt::build_user_prompt(mixed);
+    CHECK(mixed_prompt.find("\"context\":\"other hint\"") != std::string::npos);
+    CHECK(mixed_prompt.find("\"context\":\"shared hint\"") != std::string::npos);
+}
+
+TEST_CASE("Remote batch prompt sends common context blocks once and keeps per-item hints inline") {
+    const std::string language = "Use English labels.";
+    const std::string whitelist = "Allowed main categories:\n1) Documents\n2) Software";
+    auto requests = make_requests();
+    requests[0].consistency_context = language + "\n\n" + whitelist + "\n\nRecent assignments: exe";
+    requests[1].consistency_context = language + "\n\n" + whitelist + "\n\nRecent assignments: pdf";
+    requests[2].consistency_context = language + "\n\n" + whitelist;
+
+    const std::string prompt = RemoteBatchPrompt::build_user_prompt(requests);
+
+    const auto shared = prompt.find("Applies to every item:\n" + language + "\n\n" + whitelist);
+    REQUIRE(shared != std::string::npos);
+    CHECK(prompt.find(language, prompt.find(language) + 1) == std::string::npos);
+    CHECK(prompt.find("1) Documents", prompt.find("1) Documents") + 1) == std::string::npos);
+    CHECK(prompt.find("{\"context\":\"Recent assignments: exe\",\"id\":1") != std::string::npos);
+    CHECK(prompt.find("{\"context\":\"Recent assignments: pdf\",\"id\":2") != std::string::npos);
+    CHECK(prompt.find("\"id\":3,\"name\":\"Photos\",\"path\":\"/home/user/Photos\",\"type\":\"directory\"}") !=
+          std::string::npos);
+}
+
+TEST_CASE("Remote batch reply parsing maps ids to items and leaves gaps for fallback") {
+    SECTION("Structured JSON wrapped in a code fence") {
+        const std::string reply =
+            "```json\n"
+            "{\"items\":[{\"id\":3,\"category\":\"Images\",\"subcategory\":\"Albums\"},"
+            "{\"id\":1,\"category\":\" Software \",\"subcategory\":\"Installers\"},"
+            "{\"id\":1,\"category\":\"Duplicates\",\"subcategory\":\"Ignored\"},"
+            "{\"id\":9,\"category\":\"Out\",\"subcategory\":\"Of range\"}]}\n"
+            "```";
+        const auto parsed = RemoteBatchPrompt::parse_response(reply, 3, nullptr);
+
+        REQUIRE(parsed.size() == 3);
+        CHECK_FALSE(parsed[0].has_value());
+        CHECK_FALSE(parsed[1].has_value());
+        REQUIRE(parsed[2].has_value());
+        CHECK(*parsed[2] == "Images : Albums");
+    }
+
+    SECTION("Bare array with string ids; entries without a subcategory stay empty") {
+        const std::string reply =
+            "[{\"id\":\"2\",\"category\":\"Documents\",\"subcategory\":\"Invoices\"},"
+            "{\"id\":\"x\",\"category\":\"Bad\"},{\"id\":3,\"category\":\"Documents\"},"
+            "{\"id\":1,\"category\":\"Media\",\"subcategory\":\" \"}]";
+        const auto parsed = RemoteBatchPrompt::parse_response(reply, 3, nullptr);
+
+        CHECK_FALSE(parsed[0].has_value());
+        REQUIRE(parsed[1].has_value());
+        CHECK(*parsed[1] == "Documents : Invoices");
+        CHECK_FALSE(parsed[2].has_value());
+    }
+
+    SECTION("An id answered twice is left empty even when the answers agree") {
+        const std::string reply =
+            "{\"items\":[{\"id\":1,\"category\":\"Software\",\"subcategory\":\"Installers\"},"
+            "{\"id\":2,\"category\":\"Documents\",\"subcategory\":\"Taxes\"},"
+            "{\"id\":1,\"category\":\"Software\",\"subcategory\":\"Installers\"},"
+            "{\"id\":3},{\"id\":3,\"category\":\"Images\",\"subcategory\":\"Albums\"}]}";
+        const auto parsed = RemoteBatchPrompt::parse_response(reply, 3, nullptr);
+
+        CHECK_FALSE(parsed[0].has_value());
+        REQUIRE(parsed[1].has_value());
+        CHECK(*parsed[1] == "Documents : Taxes");
+        CHECK_FALSE(parsed[2].has_value());
+
+        const auto lines = RemoteBatchPrompt::parse_response("1 => A : B\n2 => C : D\n2 => C : E\n", 2, nullptr);
+        REQUIRE(lines[0].has_value());
+        CHECK_FALSE(lines[1].has_value());
+    }
+
+    SECTION("Line-based replies from models that ignore the JSON instruction") {
+        const std::string reply = "1 => Software : Installers\nnoise\n2 => Documents : Tax forms\n";
+        const auto parsed = RemoteBatchPrompt::parse_response(reply, 2, nullptr);
+
+        REQUIRE(parsed[0].has_value());
+        CHECK(*parsed[0] == "Software : Installers");
+        REQUIRE(parsed[1].has_value());
+        CHECK(*parsed[1] == "Documents : Tax forms");
+    }
+}
+
+TEST_CASE("Remote batch schema rejections are told apart from other request errors") {
+    CHECK(RemoteBatchPrompt::is_schema_rejection(
+        "Client Error: Invalid parameter: 'response_format' of type 'json_schema' is not supported with this model."));
+    CHECK(RemoteBatchPrompt::is_schema_rejection(
+        "Gemini API error (INVALID_ARGUMENT): Invalid JSON payload received. Unknown name \"responseSchema\""));
+    CHECK_FALSE(RemoteBatchPrompt::is_schema_rejection("Authentication Error: Invalid or missing API key."));
+    CHECK_FALSE(RemoteBatchPrompt::is_schema_rejection("Client Error: The model `gpt-x` does not exist"));
+    CHECK_FALSE(RemoteBatchPrompt::is_schema_rejection("Gemini API error (INVALID_ARGUMENT): API key not valid."));
+    CHECK_FALSE(RemoteBatchPrompt::is_schema_rejection("Server Error: json_schema backend crashed"));
+}
+
+TEST_CASE("Remote batch size honors the environment override") {
+    {
+        EnvVarGuard guard("AI_FILE_SORTER_REMOTE_BATCH_SIZE", std::nullopt);
+        CHECK(RemoteBatchPrompt::resolve_batch_size() == 20);
+    }
+    {
+        EnvVarGuard guard("AI_FILE_SORTER_REMOTE_BATCH_SIZE", std::string("200"));
+        CHECK(RemoteBatchPrompt::resolve_batch_size() == 50);
+    }
+    {
+        EnvVarGuard guard("AI_FILE_SORTER_REMOTE_BATCH_SIZE", std::string("0"));
+        CHECK(RemoteBatchPrompt::resolve_batch_size() == 20);
+    }
+}
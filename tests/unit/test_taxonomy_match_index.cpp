@@ -0,0 +1,204 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include "DatabaseManager.hpp"
+#include "TaxonomyMatchIndex.hpp"
+#include "TestHelpers.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+std::size_t reference_distance(const std::string& a, const std::string& b)
+{
+    std::vector<std::vector<std::size_t>> dp(a.size() + 1, std::vector<std::size_t>(b.size() + 1));
+    for (std::size_t i = 0; i <= a.size(); ++i) {
+        dp[i][0] = i;
+    }
+    for (std::size_t j = 0; j <= b.size(); ++j) {
+        dp[0][j] = j;
+    }
+    for (std::size_t i = 1; i <= a.size(); ++i) {
+        for (std::size_t j = 1; j <= b.size(); ++j) {
+            const std::size_t cost = a[i - 1] == b[j - 1] ? 0 : 1;
+            dp[i][j] = std::min({dp[i - 1][j] + 1, dp[i][j - 1] + 1, dp[i - 1][j - 1] + cost});
+        }
+    }
+    return dp[a.size()][b.size()];
+}
+
+std::string random_label(std::mt19937& rng, std::size_t min_length, std::size_t max_length)
+{
+    static const std::string alphabet = "abcdeilmnorst ";
+    std::uniform_int_distribution<std::size_t> length(min_length, max_length);
+    std::uniform_int_distribution<std::size_t> letter(0, alphabet.size() - 1);
+    std::string label(length(rng), ' ');
+    for (auto& ch : label) {
+        ch = alphabet[letter(rng)];
+    }
+    return label;
+}
+
+std::string mutate(std::mt19937& rng, std::string label)
+{
+    std::uniform_int_distribution<int> edits(0, 2);
+    std::uniform_int_distribution<int> kind(0, 2);
+    for (int i = edits(rng); i > 0 && !label.empty(); --i) {
+        std::uniform_int_distribution<std::size_t> at(0, label.size() - 1);
+        switch (kind(rng)) {
+        case 0: label.erase(at(rng), 1); break;
+        case 1: label.insert(at(rng), 1, 'x'); break;
+        default: label[at(rng)] = 'z'; break;
+        }
+    }
+    return label;
+}
+
+struct Label {
+    std::string category;
+    std::string subcategory;
+};
+
+// The linear scan the index replaces: first entry with the highest mean score wins.
+std::optional<TaxonomyMatchIndex::Match> brute_force_match(const std::vector<Label>& labels,
+                                                           const Label& query,
+                                                           double threshold)
+{
+    double best_score = 0.0;
+    std::optional<std::size_t> best_position;
+    for (std::size_t i = 0; i < labels.size(); ++i) {
+        const double combined = (TaxonomyMatchIndex::similarity(query.category, labels[i].category) +
+                                 TaxonomyMatchIndex::similarity(query.subcategory, labels[i].subcategory)) / 2.0;
+        if (combined > best_score) {
+            best_score = combined;
+            best_position = i;
+        }
+    }
+    if (best_position && best_score >= threshold) {
+        return TaxonomyMatchIndex::Match{*best_position, best_score};
+    }
+    return std::nullopt;
+}
+
+std::vector<Label> build_taxonomy(std::mt19937& rng, std::size_t categories, std::size_t per_category)
+{
+    std::vector<Label> labels;
+    for (std::size_t c = 0; c < categories; ++c) {
+        const std::string category = random_label(rng, 4, 14);
+        for (std::size_t s = 0; s < per_category; ++s) {
+            labels.push_back({category, random_label(rng, 3, 18)});
+        }
+    }
+    return labels;
+}
+
+} // namespace
+
+TEST_CASE("Bit-parallel edit distance matches the dynamic-programming reference") {
+    std::mt19937 rng(7);
+    CHECK(TaxonomyMatchIndex::edit_distance("", "") == 0);
+    CHECK(TaxonomyMatchIndex::edit_distance("", "abc") == 3);
+    CHECK(TaxonomyMatchIndex::edit_distance("kitten", "sitting") == 3);
+    CHECK(TaxonomyMatchIndex::similarity("", "") == 1.0);
+    CHECK(TaxonomyMatchIndex::similarity("", "docs") == 0.0);
+
+    for (int i = 0; i < 2000; ++i) {
+        const std::string a = random_label(rng, 0, i % 10 == 0 ? 90 : 20);
+        const std::string b = i % 2 == 0 ? mutate(rng, a) : random_label(rng, 0, 70);
+        REQUIRE(TaxonomyMatchIndex::edit_distance(a, b) == reference_distance(a, b));
+        REQUIRE(TaxonomyMatchIndex::edit_distance(b, a) == reference_distance(a, b));
+    }
+}
+
+TEST_CASE("Taxonomy match index returns the same entry as a linear scan") {
+    std::mt19937 rng(11);
+    const auto labels = build_taxonomy(rng, 40, 25);
+    TaxonomyMatchIndex index;
+    for (std::size_t i = 0; i < labels.size(); ++i) {
+        index.insert(i, labels[i].category, labels[i].subcategory);
+    }
+    REQUIRE(index.size() == labels.size());
+
+    std::uniform_int_distribution<std::size_t> pick(0, labels.size() - 1);
+    int matched = 0;
+    for (int i = 0; i < 500; ++i) {
+        const Label& source = labels[pick(rng)];
+        const Label query = i % 5 == 0 ? Label{random_label(rng, 3, 12), random_label(rng, 3, 12)}
+                                       : Label{mutate(rng, source.category), mutate(rng, source.subcategory)};
+        for (const double threshold : {0.85, 0.6}) {
+            const auto expected = brute_force_match(labels, query, threshold);
+            const auto actual = index.find_best_match(query.category, query.subcategory, threshold);
+            REQUIRE(expected.has_value() == actual.has_value());
+            if (expected) {
+                ++matched;
+                CHECK(actual->position == expected->position);
+                CHECK(actual->score == expected->score);
+            }
+        }
+    }
+    CHECK(matched > 0);
+
+    index.clear();
+    CHECK(index.size() == 0);
+    CHECK_FALSE(index.find_best_match(labels[0].category, labels[0].subcategory, 0.85).has_value());
+}
+
+TEST_CASE("DatabaseManager resolves near-duplicate labels through the fuzzy index") {
+    TempDir base_dir;
+    EnvVarGuard config_guard("AI_FILE_SORTER_CONFIG_DIR", base_dir.path().string());
+    const DatabaseManager::ResolvedCategory reference = [&] {
+        DatabaseManager db(base_dir.path().string());
+        const auto created = db.resolve_category("Finances", "Bank statements");
+        const auto typo = db.resolve_category("Finances", "Bank statemnts");
+        CHECK(typo.taxonomy_id == created.taxonomy_id);
+        CHECK(typo.subcategory == "Bank statements");
+        return created;
+    }();
+
+    // A fresh manager rebuilds the index from the database.
+    DatabaseManager reloaded(base_dir.path().string());
+    const auto match = reloaded.resolve_category("Finance", "Bank statement");
+    CHECK(match.taxonomy_id == reference.taxonomy_id);
+    const auto distinct = reloaded.resolve_category("Music", "Playlists");
+    CHECK(distinct.taxonomy_id != reference.taxonomy_id);
+}
+
+TEST_CASE("Taxonomy match index benchmark", "[.][benchmark]") {
+    std::mt19937 rng(3);
+    const auto labels = build_taxonomy(rng, 200, 25);
+    TaxonomyMatchIndex index;
+    for (std::size_t i = 0; i < labels.size(); ++i) {
+        index.insert(i, labels[i].category, labels[i].subcategory);
+    }
+
+    std::vector<Label> queries;
+    std::uniform_int_distribution<std::size_t> pick(0, labels.size() - 1);
+    for (int i = 0; i < 500; ++i) {
+        const Label& source = labels[pick(rng)];
+        queries.push_back({mutate(rng, source.category), mutate(rng, source.subcategory)});
+    }
+
+    const auto scan_start = std::chrono::steady_clock::now();
+    int scan_hits = 0;
+    for (const auto& query : queries) {
+        scan_hits += brute_force_match(labels, query, 0.85).has_value() ? 1 : 0;
+    }
+    const auto scan_elapsed = std::chrono::steady_clock::now() - scan_start;
+
+    const auto index_start = std::chrono::steady_clock::now();
+    int index_hits = 0;
+    for (const auto& query : queries) {
+        index_hits += index.find_best_match(query.category, query.subcategory, 0.85).has_value() ? 1 : 0;
+    }
+    const auto index_elapsed = std::chrono::steady_clock::now() - index_start;
+
+    CHECK(scan_hits == index_hits);
+    const auto micros = [](auto elapsed) {
+        return std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count();
+    };
+    WARN("Linear scan over " << labels.size() << " entries: " << micros(scan_elapsed) / queries.size()
+         << " us/query; index: " << micros(index_elapsed) / queries.size() << " us/query");
+}
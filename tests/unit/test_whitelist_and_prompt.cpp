@@ -80,6 +80,34 @@ private:
     std::string categorize_response_;
     std::deque<std::string> translation_responses_;
 };
+
+class WhitelistRecordingLLM : public ILLMClient {
+public:
+    explicit WhitelistRecordingLLM(std::shared_ptr<std::vector<std::string>> categories)
+        : categories_(std::move(categories)) {}
+
+    std::string categorize_file(const std::string&,
+                                const std::string&,
+                                FileType,
+                                const std::string&) override {
+        return "CatB : Reports";
+    }
+
+    std::string complete_prompt(const std::string&, int) override {
+        return std::string();
+    }
+
+    void set_prompt_logging_enabled(bool) override {
+    }
+
+    void set_category_whitelist(const std::vector<std::string>& categories,
+                                const std::vector<std::string>&) override {
+        *categories_ = categories;
+    }
+
+private:
+    std::shared_ptr<std::vector<std::string>> categories_;
+};
 } // namespace
 
 TEST_CASE("WhitelistStore initializes from settings and persists defaults") {
@@ -206,6 +234,65 @@ TEST_CASE("LocalLLM sanitizer strips inline subcategory label artifacts from cat
     REQUIRE(LocalLLMTestAccess::sanitize_output_for_testing(output) == "Images : Funny seals");
 }
 
+TEST_CASE("LocalLLM category grammar restricts output to whitelisted labels") {
+    const std::string grammar =
+        LocalLLMTestAccess::build_category_grammar_for_testing({"CatA", "Cat \"B\""}, {});
+
+    CHECK(grammar.find("root ::= category \" : \" subcategory \"\\n\"") != std::string::npos);
+    CHECK(grammar.find("category ::= \"CatA\" | \"Cat \\\"B\\\"\"") != std::string::npos);
+    CHECK(grammar.find("subcategory ::= label") != std::string::npos);
+
+    const std::string free_form = LocalLLMTestAccess::build_category_grammar_for_testing({}, {});
+    CHECK(free_form.find("\ncategory ::= label") != std::string::npos);
+}
+
+TEST_CASE("LocalLLM prompts keep the shared context ahead of the file-specific lines") {
+    const std::string context = "Known categories:\n1. Documents : Reports\n2. Images : Photos";
+
+    const std::string report =
+        LocalLLMTestAccess::make_prompt_for_testing("report.pdf", "/data/report.pdf", FileType::File, context);
+    const std::string photo =
+        LocalLLMTestAccess::make_prompt_for_testing("photo.jpg", "/data/photos/photo.jpg", FileType::File, context);
+
+    CHECK(report == context + "\n\nCategorize this file.\nFull path: /data/report.pdf\nFile name: report.pdf\n");
+    // Everything up to the per-file lines is identical, so it can stay in the KV cache between requests.
+    const std::string shared_prefix = context + "\n\nCategorize this file.\n";
+    CHECK(report.starts_with(shared_prefix));
+    CHECK(photo.starts_with(shared_prefix));
+    CHECK(photo.substr(shared_prefix.size()) == "Full path: /data/photos/photo.jpg\nFile name: photo.jpg\n");
+
+    CHECK(LocalLLMTestAccess::make_prompt_for_testing("Invoices", "", FileType::Directory, "") ==
+          "Categorize this directory.\nDirectory name: Invoices\n");
+}
+
+TEST_CASE("CategorizationService passes the active whitelist to LLM clients") {
+    TempDir base_dir;
+    EnvVarGuard config_guard("AI_FILE_SORTER_CONFIG_DIR", base_dir.path().string());
+    Settings settings;
+    settings.set_use_whitelist(true);
+    settings.set_allowed_categories({"CatA", "CatB"});
+    settings.set_allowed_subcategories({});
+    DatabaseManager db(settings.get_config_dir());
+    CategorizationService service(settings, db, nullptr);
+
+    TempDir data_dir;
+    const std::string file_name = "report.pdf";
+    const std::vector<FileEntry> files = {
+        FileEntry{(data_dir.path() / file_name).string(), file_name, FileType::File}};
+
+    std::atomic<bool> stop_flag{false};
+    auto recorded = std::make_shared<std::vector<std::string>>();
+    auto factory = [recorded]() {
+        return std::make_unique<WhitelistRecordingLLM>(recorded);
+    };
+
+    const auto categorized = service.categorize_entries(files, true, stop_flag, {}, {}, {}, {}, factory);
+
+    CHECK(*recorded == std::vector<std::string>{"CatA", "CatB"});
+    REQUIRE(categorized.size() == 1);
+    CHECK(categorized.front().category == "CatB");
+}
+
 TEST_CASE("CategorizationService parses category output without spaced colon delimiters") {
     TempDir base_dir;
     EnvVarGuard config_guard("AI_FILE_SORTER_CONFIG_DIR", base_dir.path().string());
@@ -0,0 +1,70 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include "XmlTextStream.hpp"
+
+#include <string>
+#include <string_view>
+
+namespace {
+
+constexpr std::string_view kDocument =
+    "<?xml version=\"1.0\" encoding=\"UTF-8\" standalone=\"yes\"?>\n"
+    "<w:document xmlns:w=\"http://schemas.openxmlformats.org/wordprocessingml/2006/main\">"
+    "<!-- generated -> by <hand> -->"
+    "<w:body><w:p w:rsidR=\"00A1\" w:note='a > b'><w:r><w:t>Quarterly</w:t></w:r>"
+    "<w:r><w:t xml:space=\"preserve\">  revenue   &amp; costs </w:t></w:r></w:p>"
+    "<w:p><w:r><w:t>Caf&#233; &#x20AC;5 &lt;net&gt; &quot;ok&quot; &apos;x&apos; &bogus; AT&T</w:t></w:r></w:p>"
+    "<w:p><w:r><w:t><![CDATA[a]]b]]]></w:t></w:r></w:p>"
+    "</w:body></w:document>";
+
+constexpr std::string_view kExpected =
+    "Quarterly revenue & costs Caf\xC3\xA9 \xE2\x82\xAC" "5 <net> \"ok\" 'x' &bogus; AT&T a]]b]";
+
+std::string extract(std::string_view xml, std::size_t chunk_size, std::size_t budget = 8000)
+{
+    XmlTextStream stream(budget);
+    for (std::size_t offset = 0; offset < xml.size(); offset += chunk_size) {
+        if (!stream.feed(xml.substr(offset, chunk_size))) {
+            break;
+        }
+    }
+    return stream.take();
+}
+
+} // namespace
+
+TEST_CASE("XmlTextStream extracts text runs regardless of chunk boundaries") {
+    CHECK(extract(kDocument, kDocument.size()) == kExpected);
+    for (std::size_t chunk_size = 1; chunk_size <= 16; ++chunk_size) {
+        INFO("chunk size " << chunk_size);
+        CHECK(extract(kDocument, chunk_size) == kExpected);
+    }
+}
+
+TEST_CASE("XmlTextStream stops at the byte budget") {
+    const std::string xml = "<t>" + std::string(100, 'a') + " caf\xC3\xA9</t><t>never read</t>";
+
+    XmlTextStream stream(105);
+    CHECK_FALSE(stream.feed(xml));
+    CHECK(stream.full());
+    // The budget lands inside "é"; the partial sequence is dropped.
+    CHECK(stream.text() == std::string(100, 'a') + " caf");
+    CHECK_FALSE(stream.feed("<t>more</t>"));
+
+    const std::string taken = stream.take();
+    CHECK(taken.size() == 104);
+    CHECK_FALSE(stream.full());
+    CHECK(stream.text().empty());
+    CHECK(stream.feed("<t>next</t>"));
+    CHECK(stream.text() == "next");
+
+    XmlTextStream separator_at_budget(3);
+    CHECK_FALSE(separator_at_budget.feed("<a>ab</a><b>cd</b>"));
+    CHECK(separator_at_budget.text() == "ab");
+}
+
+TEST_CASE("XmlTextStream ignores declarations and collapses whitespace") {
+    CHECK(extract("<!DOCTYPE note><note>\n\t hello \r\n world </note>", 3) == "hello world");
+    CHECK(extract("<a/><b></b>   ", 2).empty());
+    CHECK(extract("text & more<br/>end", 4) == "text & more end");
+}